@@ -7,6 +7,10 @@
  *      Modified by: Michael E. Tryby,
  *                   Bryant McDonnell
  *
+ *      Results saved by the engine in reduced precision (2-byte half
+ *      floats or scaled 2-byte integers) are converted back to 4-byte
+ *      reals as they are read.
+ *
  */
 
 
@@ -35,6 +39,13 @@
 #define DATESIZE 8    // Dates are stored as 8 byte word size
 
 #define NELEMENTTYPES 5    // Number of element types
+#define NRESULTTYPES 3     // Subcatch, node & link results may be quantized
+#define QUANT_MAGICNUMBER 516114526    // Magic number of quantized file
+
+// Storage formats of quantized result variables
+#define FLOAT_STORAGE 0
+#define HALF_STORAGE 1
+#define INT16_STORAGE 2
 #define MEMCHECK(x) (((x) == NULL) ? 414 : 0)
 
 
@@ -75,6 +86,12 @@ typedef struct Handle {
     F_OFF ResultsPos;        // file position where results start
     F_OFF BytesPerPeriod;    // bytes used for results in each period
 
+    int    Quantized;                     // TRUE if results are quantized
+    int   *VarFormat[NRESULTTYPES];       // storage format of each variable
+    float *VarScale[NRESULTTYPES];        // scale of each INT16 variable
+    int   *VarPos[NRESULTTYPES];          // byte position of each variable
+    int    ElementBytes[NRESULTTYPES];    // bytes used by each element
+
     error_handle_t* error_handle;
 } data_t, *SMO_Handle;
 
@@ -92,6 +109,12 @@ float  getNodeValue(data_t *p_data, int timeIndex, int nodeIndex, SMO_nodeAttrib
 float  getLinkValue(data_t *p_data, int timeIndex, int linkIndex, SMO_linkAttribute attr);
 float  getSystemValue(data_t *p_data, int timeIndex, SMO_systemAttribute attr);
 
+int    initLayouts(data_t *p_data);
+F_OFF  getElementOffset(data_t *p_data, int timeIndex, int type, int index);
+float  readValue(data_t *p_data, int type, int attr);
+void   readElement(data_t *p_data, int type, float *values);
+float  halfToFloat(unsigned short h);
+
 int   _fopen(FILE **f, const char *name, const char *mode);
 int   _fseek(FILE *stream, F_OFF offset, int whence);
 F_OFF _ftell(FILE *stream);
@@ -151,6 +174,12 @@ int EXPORT_OUT_API SMO_close(SMO_Handle p_handle)
             free(p_data->elementNames);
         }
 
+        for (i = 0; i < NRESULTTYPES; i++) {
+            free(p_data->VarFormat[i]);
+            free(p_data->VarScale[i]);
+            free(p_data->VarPos[i]);
+        }
+
         dst_errormanager(p_data->error_handle);
 
         if (p_data->file != NULL)
@@ -222,6 +251,14 @@ int EXPORT_OUT_API SMO_open(SMO_Handle p_handle, const char *path)
             fread(&(p_data->SysVars), RECORDSIZE, 1,
                   p_data->file);    // # System variables
 
+            // --- read storage format of each variable (which follows the
+            //     system variable codes in a quantized file)
+            _fseek(p_data->file, p_data->SysVars * RECORDSIZE, SEEK_CUR);
+            errorcode = initLayouts(p_data);
+        }
+
+        if (errorcode < 400) {
+
             // --- read data just before start of output results
             offset = p_data->ResultsPos - 3 * RECORDSIZE;
             _fseek(p_data->file, offset, SEEK_SET);
@@ -232,10 +269,10 @@ int EXPORT_OUT_API SMO_open(SMO_Handle p_handle, const char *path)
             // period
             p_data->BytesPerPeriod =
                 DATESIZE +
-                (p_data->Nsubcatch * p_data->SubcatchVars +
-                 p_data->Nnodes * p_data->NodeVars +
-                 p_data->Nlinks * p_data->LinkVars + p_data->SysVars) *
-                    RECORDSIZE;
+                (F_OFF)p_data->Nsubcatch * p_data->ElementBytes[0] +
+                (F_OFF)p_data->Nnodes * p_data->ElementBytes[1] +
+                (F_OFF)p_data->Nlinks * p_data->ElementBytes[2] +
+                p_data->SysVars * RECORDSIZE;
         }
     }
     // If error close the binary file
@@ -760,13 +797,10 @@ int EXPORT_OUT_API SMO_getSubcatchResult(SMO_Handle p_handle, int periodIndex,
         MEMCHECK(temp = newFloatArray(p_data->SubcatchVars)) errorcode = 411;
     else {
         // --- compute offset into output file
-        offset = p_data->ResultsPos + (periodIndex)*p_data->BytesPerPeriod +
-                 2 * RECORDSIZE;
-        // add offset for subcatchment
-        offset += (subcatchIndex * p_data->SubcatchVars) * RECORDSIZE;
+        offset = getElementOffset(p_data, periodIndex, 0, subcatchIndex);
 
         _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->SubcatchVars, p_data->file);
+        readElement(p_data, 0, temp);
 
         *outValueArray = temp;
         *arrayLength   = p_data->SubcatchVars;
@@ -798,15 +832,10 @@ int EXPORT_OUT_API SMO_getNodeResult(SMO_Handle p_handle, int periodIndex,
         MEMCHECK(temp = newFloatArray(p_data->NodeVars)) errorcode = 411;
     else {
         // calculate byte offset to start time for series
-        offset = p_data->ResultsPos + (periodIndex)*p_data->BytesPerPeriod +
-                 2 * RECORDSIZE;
-        // add offset for subcatchment and node
-        offset += (p_data->Nsubcatch * p_data->SubcatchVars +
-                   nodeIndex * p_data->NodeVars) *
-                  RECORDSIZE;
+        offset = getElementOffset(p_data, periodIndex, 1, nodeIndex);
 
         _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->NodeVars, p_data->file);
+        readElement(p_data, 1, temp);
 
         *outValueArray = temp;
         *arrayLength   = p_data->NodeVars;
@@ -838,16 +867,10 @@ int EXPORT_OUT_API SMO_getLinkResult(SMO_Handle p_handle, int periodIndex,
         MEMCHECK(temp = newFloatArray(p_data->LinkVars)) errorcode = 411;
     else {
         // calculate byte offset to start time for series
-        offset = p_data->ResultsPos + (periodIndex)*p_data->BytesPerPeriod +
-                 2 * RECORDSIZE;
-        // add offset for subcatchment and node and link
-        offset +=
-            (p_data->Nsubcatch * p_data->SubcatchVars +
-             p_data->Nnodes * p_data->NodeVars + linkIndex * p_data->LinkVars) *
-            RECORDSIZE;
+        offset = getElementOffset(p_data, periodIndex, 2, linkIndex);
 
         _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->LinkVars, p_data->file);
+        readElement(p_data, 2, temp);
 
         *outValueArray = temp;
         *arrayLength   = p_data->LinkVars;
@@ -876,15 +899,9 @@ int EXPORT_OUT_API SMO_getSystemResult(SMO_Handle p_handle, int periodIndex,
     else if
         MEMCHECK(temp = newFloatArray(p_data->SysVars)) errorcode = 411;
     {
-        // calculate byte offset to start time for series
-        offset = p_data->ResultsPos + (periodIndex)*p_data->BytesPerPeriod +
-                 2 * RECORDSIZE;
-        // add offset for subcatchment and node and link (system starts after
-        // the last link)
-        offset += (p_data->Nsubcatch * p_data->SubcatchVars +
-                   p_data->Nnodes * p_data->NodeVars +
-                   p_data->Nlinks * p_data->LinkVars) *
-                  RECORDSIZE;
+        // calculate byte offset to start time for series (system starts
+        // after the last link)
+        offset = getElementOffset(p_data, periodIndex, NRESULTTYPES, 0);
 
         _fseek(p_data->file, offset, SEEK_SET);
         fread(temp, RECORDSIZE, p_data->SysVars, p_data->file);
@@ -991,6 +1008,9 @@ int validateFile(data_t *p_data) {
     _fseek(p_data->file, 0L, SEEK_SET);
     fread(&magic1, RECORDSIZE, 1, p_data->file);
 
+    // Are its results quantized?
+    p_data->Quantized = (magic1 == QUANT_MAGICNUMBER);
+
     // Is this a valid SWMM binary output file?
     if (magic1 != magic2)
         errorcode = 435;
@@ -1046,60 +1066,39 @@ float getSubcatchValue(data_t *p_data, int timeIndex, int subcatchIndex,
     SMO_subcatchAttribute attr) {
 
     F_OFF offset;
-    float value;
 
     // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex * p_data->BytesPerPeriod +
-             2 * RECORDSIZE;
-    // offset for subcatch
-    offset += RECORDSIZE * (subcatchIndex * p_data->SubcatchVars + attr);
+    offset = getElementOffset(p_data, timeIndex, 0, subcatchIndex);
 
     // --- re-position the file and read the result
-    _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
-
-    return value;
+    _fseek(p_data->file, offset + p_data->VarPos[0][attr], SEEK_SET);
+    return readValue(p_data, 0, attr);
 }
 
 float getNodeValue(data_t *p_data, int timeIndex, int nodeIndex,
     SMO_nodeAttribute attr) {
 
     F_OFF offset;
-    float value;
 
     // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex * p_data->BytesPerPeriod +
-             2 * RECORDSIZE;
-    // offset for node
-    offset += RECORDSIZE * (p_data->Nsubcatch * p_data->SubcatchVars +
-                            nodeIndex * p_data->NodeVars + attr);
+    offset = getElementOffset(p_data, timeIndex, 1, nodeIndex);
 
     // --- re-position the file and read the result
-    _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
-
-    return value;
+    _fseek(p_data->file, offset + p_data->VarPos[1][attr], SEEK_SET);
+    return readValue(p_data, 1, attr);
 }
 
 float getLinkValue(data_t *p_data, int timeIndex, int linkIndex,
     SMO_linkAttribute attr) {
 
     F_OFF offset;
-    float value;
 
     // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex * p_data->BytesPerPeriod +
-             2 * RECORDSIZE;
-    // offset for link
-    offset += RECORDSIZE * (p_data->Nsubcatch * p_data->SubcatchVars +
-                            p_data->Nnodes * p_data->NodeVars +
-                            linkIndex * p_data->LinkVars + attr);
+    offset = getElementOffset(p_data, timeIndex, 2, linkIndex);
 
     // --- re-position the file and read the result
-    _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
-
-    return value;
+    _fseek(p_data->file, offset + p_data->VarPos[2][attr], SEEK_SET);
+    return readValue(p_data, 2, attr);
 }
 
 float getSystemValue(data_t *p_data, int timeIndex, SMO_systemAttribute attr) {
@@ -1108,12 +1107,9 @@ float getSystemValue(data_t *p_data, int timeIndex, SMO_systemAttribute attr) {
     float value;
 
     // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex * p_data->BytesPerPeriod +
-             2 * RECORDSIZE;
+    offset = getElementOffset(p_data, timeIndex, NRESULTTYPES, 0);
     //  offset for system
-    offset += RECORDSIZE * (p_data->Nsubcatch * p_data->SubcatchVars +
-                            p_data->Nnodes * p_data->NodeVars +
-                            p_data->Nlinks * p_data->LinkVars + attr);
+    offset += RECORDSIZE * attr;
 
     // --- re-position the file and read the result
     _fseek(p_data->file, offset, SEEK_SET);
@@ -1122,6 +1118,138 @@ float getSystemValue(data_t *p_data, int timeIndex, SMO_systemAttribute attr) {
     return value;
 }
 
+int initLayouts(data_t *p_data)
+//
+//  Purpose: Finds where each subcatch, node & link variable is stored in
+//           an element's results and in what format. The file must be
+//           positioned just past the system variable codes.
+//
+{
+    int i, j, nVars[NRESULTTYPES], pos;
+    INT4 format;
+    REAL4 scale;
+
+    nVars[0] = p_data->SubcatchVars;
+    nVars[1] = p_data->NodeVars;
+    nVars[2] = p_data->LinkVars;
+
+    for (i = 0; i < NRESULTTYPES; i++) {
+        p_data->VarFormat[i] = newIntArray(nVars[i] + 1);
+        p_data->VarScale[i] = newFloatArray(nVars[i] + 1);
+        p_data->VarPos[i] = newIntArray(nVars[i] + 1);
+        if (p_data->VarFormat[i] == NULL || p_data->VarScale[i] == NULL ||
+            p_data->VarPos[i] == NULL)
+            return 411;
+
+        pos = 0;
+        for (j = 0; j < nVars[i]; j++) {
+            format = FLOAT_STORAGE;
+            scale = 1.0f;
+            if (p_data->Quantized) {
+                fread(&format, RECORDSIZE, 1, p_data->file);
+                fread(&scale, RECORDSIZE, 1, p_data->file);
+            }
+            p_data->VarFormat[i][j] = format;
+            p_data->VarScale[i][j] = scale;
+            p_data->VarPos[i][j] = pos;
+            pos += (format == FLOAT_STORAGE) ? RECORDSIZE : 2;
+        }
+        p_data->ElementBytes[i] = pos;
+    }
+    return 0;
+}
+
+F_OFF getElementOffset(data_t *p_data, int timeIndex, int type, int index)
+//
+//  Purpose: Computes the file position where the results of an element of
+//           a given type (0 = subcatch, 1 = node, 2 = link, 3 = system)
+//           start in a reporting period.
+//
+{
+    int   counts[NRESULTTYPES];
+    int   i;
+    F_OFF offset;
+
+    counts[0] = p_data->Nsubcatch;
+    counts[1] = p_data->Nnodes;
+    counts[2] = p_data->Nlinks;
+
+    offset = p_data->ResultsPos + timeIndex * p_data->BytesPerPeriod +
+             2 * RECORDSIZE;
+    for (i = 0; i < type; i++)
+        offset += (F_OFF)counts[i] * p_data->ElementBytes[i];
+    if (type < NRESULTTYPES)
+        offset += (F_OFF)index * p_data->ElementBytes[type];
+    return offset;
+}
+
+float readValue(data_t *p_data, int type, int attr)
+//
+//  Purpose: Reads a variable's value from the current file position,
+//           converting it from its storage format.
+//
+{
+    float          value = 0.0f;
+    unsigned short h;
+    short          k;
+
+    switch (p_data->VarFormat[type][attr]) {
+    case HALF_STORAGE:
+        fread(&h, 2, 1, p_data->file);
+        value = halfToFloat(h);
+        break;
+    case INT16_STORAGE:
+        fread(&k, 2, 1, p_data->file);
+        value = (float)(k * p_data->VarScale[type][attr]);
+        break;
+    default:
+        fread(&value, RECORDSIZE, 1, p_data->file);
+    }
+    return value;
+}
+
+void readElement(data_t *p_data, int type, float *values)
+//
+//  Purpose: Reads all of an element's results from the current file
+//           position.
+//
+{
+    int j, nVars;
+
+    nVars = (type == 0) ? p_data->SubcatchVars :
+            (type == 1) ? p_data->NodeVars : p_data->LinkVars;
+
+    if (!p_data->Quantized)
+        fread(values, RECORDSIZE, nVars, p_data->file);
+    else {
+        for (j = 0; j < nVars; j++)
+            values[j] = readValue(p_data, type, j);
+    }
+}
+
+float halfToFloat(unsigned short h)
+//
+//  Purpose: Converts an IEEE 754 half-precision value to a 4-byte real.
+//
+{
+    unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+    unsigned int e = (h >> 10) & 0x1F;
+    unsigned int m = h & 0x3FF;
+    unsigned int f;
+    float        x;
+
+    if (e == 0) {
+        x = (float)m / 16777216.0f;
+        return sign ? -x : x;
+    }
+    if (e == 31)
+        f = sign | 0x7F800000 | (m << 13);
+    else
+        f = sign | ((e - 15 + 127) << 23) | (m << 13);
+    memcpy(&x, &f, sizeof(float));
+    return x;
+}
+
 int _fopen(FILE **f, const char *name, const char *mode) {
     //
     //  Purpose: Substitute for fopen_s on platforms where it doesn't exist
@@ -0,0 +1,255 @@
+/*
+ *  couple.c - Runs a chain of coupled SWMM models concurrently
+ *
+ *  Created on: October 17, 2026
+ *  Updated on:
+ *
+ *  The engine keeps its project in global data, so coupled models cannot
+ *  share a process. Each model is forked into a process of its own and
+ *  the routing interface file joining two models is a named pipe (FIFO).
+ *  The pipe's kernel buffer is the bounded queue between them: the
+ *  upstream model blocks when it gets too far ahead and the downstream
+ *  model blocks until the outflows it needs have been computed, so the
+ *  chain finishes in about the time of its slowest model.
+ *
+ *  Models are forked without exec, so a child inherits the OpenMP state
+ *  of the caller. Once the caller has run a parallel region (any earlier
+ *  swmm_run in the same process has), the forked copy of its thread pool
+ *  has no threads behind it and a child using more than one thread would
+ *  wait on them for ever. Each model therefore runs on a single thread;
+ *  the chain's concurrency comes from its processes.
+ */
+
+#include <stdio.h>
+
+#include "couple.h"
+
+// Public project includes
+#include "swmm5.h"
+
+
+#ifdef _WIN32
+
+int couple_run(int n_models, char **files, char **channels)
+{
+    printf("\nError:\n");
+    printf("\tCoupled runs require named pipes (not available on Windows)\n\n");
+    return -1;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define RELEASE_WAIT_NSEC 10000000L    // time between tries to release a reader
+
+
+static int make_channel(char *name)
+//
+//  Input:   name = name of a routing interface file joining two models
+//  Output:  returns 1 if a named pipe was created, 0 if one already
+//           existed, or -1 on error
+//  Purpose: creates the named pipe that carries one model's outflows
+//           to the next model in the chain.
+//
+{
+    struct stat st;
+
+    if (stat(name, &st) == 0) {
+        if (S_ISFIFO(st.st_mode))
+            return 0;
+        printf("\nError:\n");
+        printf("\t%s already exists and is not a named pipe\n\n", name);
+        return -1;
+    }
+    if (mkfifo(name, 0600) != 0) {
+        printf("\nError:\n");
+        printf("\tcannot create named pipe %s\n\n", name);
+        return -1;
+    }
+    return 1;
+}
+
+
+static int release_reader(char *name)
+//
+//  Input:   name = name of the named pipe a model writes its outflows to
+//  Output:  returns 1 if the pipe had a reader, 0 if not
+//  Purpose: lets the model reading from a pipe see its end once the model
+//           writing to it has exited.
+//
+//  Note: a reader still waiting to open the pipe (because the writer
+//        ended before opening it) is released by this open and then sees
+//        end of file when it is closed. The open fails when the reader
+//        has yet to open the pipe, so it must be tried again later.
+//
+{
+    int fd = open(name, O_WRONLY | O_NONBLOCK);
+
+    if (fd < 0)
+        return 0;
+    close(fd);
+    return 1;
+}
+
+
+static void run_model(char *f1, char *f2, char *f3)
+//
+//  Input:   f1 = name of input file
+//           f2 = name of report file
+//           f3 = name of binary output file
+//  Output:  none (exits the process)
+//  Purpose: runs one model of the chain in a child process.
+//
+{
+    int err;
+
+    // --- a downstream model that ends early closes its pipe; let the
+    //     upstream model's writes fail rather than kill it
+    signal(SIGPIPE, SIG_IGN);
+
+    // --- the thread pool inherited from the caller can't be used
+#ifdef _OPENMP
+    omp_set_num_threads(1);
+#endif
+
+    err = swmm_run(f1, f2, f3);
+    exit(err == 0 ? 0 : 1);
+}
+
+
+int couple_run(int n_models, char **files, char **channels)
+//
+//  Input:   n_models = number of models in the chain
+//           files = input, report & output file names of each model
+//           channels = names of the n_models-1 interface files joining
+//                      consecutive models
+//  Output:  returns number of models that failed, or -1 if the chain
+//           could not be started
+//  Purpose: runs the models of a chain concurrently, each in its own
+//           process.
+//
+{
+    int    i, j, status, n_running, n_releasing, n_failed = 0;
+    int   *created;
+    int   *failed;
+    int   *releasing;
+    pid_t *pids;
+    pid_t  pid;
+    struct timespec pause = {0, RELEASE_WAIT_NSEC};
+
+    created = (int *)calloc(n_models, sizeof(int));
+    failed = (int *)calloc(n_models, sizeof(int));
+    releasing = (int *)calloc(n_models, sizeof(int));
+    pids = (pid_t *)calloc(n_models, sizeof(pid_t));
+    if (!created || !failed || !releasing || !pids) {
+        free(created); free(failed); free(releasing); free(pids);
+        return -1;
+    }
+
+    // --- create the named pipes joining the models
+    for (i = 0; i < n_models - 1; i++) {
+        created[i] = make_channel(channels[i]);
+        if (created[i] < 0) {
+            n_failed = -1;
+            break;
+        }
+    }
+
+    // --- start each model in a process of its own
+    n_running = 0;
+    fflush(stdout);
+    for (i = 0; i < n_models && n_failed == 0; i++) {
+        pid = fork();
+        if (pid == 0)
+            run_model(files[3*i], files[3*i + 1], files[3*i + 2]);
+        if (pid < 0) {
+            printf("\nError:\n");
+            printf("\tcannot start a process for %s\n\n", files[3*i]);
+            n_failed = -1;
+            break;
+        }
+        pids[i] = pid;
+        n_running++;
+    }
+    if (n_failed < 0) {
+        for (i = 0; i < n_models; i++) {
+            if (pids[i] > 0)
+                kill(pids[i], SIGTERM);
+        }
+    }
+
+    // --- wait for the models to finish; once one fails the others
+    //     may be left waiting on their pipes, so stop them
+    while (n_running > 0) {
+
+        // --- keep trying to release the readers of pipes whose writers
+        //     have exited until they have opened the pipe or exited too
+        n_releasing = 0;
+        for (i = 0; i < n_models - 1; i++) {
+            if (releasing[i] && (pids[i + 1] == 0 ||
+                                 release_reader(channels[i])))
+                releasing[i] = 0;
+            n_releasing += releasing[i];
+        }
+
+        pid = waitpid(-1, &status, n_releasing > 0 ? WNOHANG : 0);
+        if (pid == 0) {
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        if (pid < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (i = 0; i < n_models && pids[i] != pid; i++);
+        if (i == n_models)
+            continue;
+        pids[i] = 0;
+        n_running--;
+        if (i < n_models - 1)
+            releasing[i] = 1;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            continue;
+        failed[i] = 1;
+        for (j = 0; j < n_models; j++) {
+            if (pids[j] > 0)
+                kill(pids[j], SIGTERM);
+        }
+    }
+
+    // --- report each model's outcome
+    if (n_failed == 0) {
+        for (i = 0; i < n_models; i++) {
+            printf("\n... %s %s", files[3*i],
+                failed[i] ? "failed or was stopped" : "completed");
+            n_failed += failed[i];
+        }
+    }
+
+    // --- remove the named pipes this run created
+    for (i = 0; i < n_models - 1; i++) {
+        if (created[i] > 0)
+            unlink(channels[i]);
+    }
+    free(created);
+    free(failed);
+    free(releasing);
+    free(pids);
+    return n_failed;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ *  couple.h - Runs a chain of coupled SWMM models concurrently
+ *
+ *  Created on: October 17, 2026
+ *  Updated on:
+ *
+ *  Each model runs in its own process (and so has its own project data)
+ *  while the outflows of one model stream to the next through a named
+ *  pipe. The upstream model must save its OUTFLOWS interface file in
+ *  BINARY format under the pipe's name and the downstream model must
+ *  USE it as its INFLOWS file.
+ *
+ *  The models are forked from the calling process without exec. Each one
+ *  runs on a single OpenMP thread, since a thread pool the caller created
+ *  before the fork (e.g., by an earlier swmm_run) is unusable in a child.
+ *  Any other OpenMP code a caller runs in a forked child is unsafe in the
+ *  same way.
+ */
+
+#ifndef COUPLE_H
+#define COUPLE_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+// Returns the number of models that failed or -1 if the run could not start
+int couple_run(int n_models, char **files, char **channels);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+
+#endif //COUPLE_H
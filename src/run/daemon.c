@@ -0,0 +1,655 @@
+/*
+ *  daemon.c - Runs forecast jobs against a project kept loaded in memory
+ *
+ *  Created on: October 17, 2026
+ *  Updated on:
+ *
+ *  A forecasting service re-runs the same model every few minutes with
+ *  fresh rainfall and boundary data. Parsing the input file and building
+ *  the project for each run costs as much as a short run itself, and
+ *  starting each run from a cold, dry state needs a long spin-up period.
+ *  The daemon opens the project once, applies each job's data through the
+ *  toolkit and starts the job from the state snapshot saved in memory by
+ *  an earlier job.
+ *
+ *  Jobs are written as lines of text, one command per line:
+ *
+ *    SERIES <id> <date> <value> <date> <value> ...
+ *                      replaces all of a time series' data
+ *    START <date>      sets the simulation start (default: the time of the
+ *                      last snapshot, if there is one)
+ *    END <date>        sets the simulation end
+ *    SAVE <date>       saves a snapshot once the run reaches <date>
+ *    NODE <id>         adds a node to the results summary
+ *    LINK <id>         adds a link to the results summary
+ *    RUN               runs the job and replies with RESULT lines
+ *    QUIT              ends the session
+ *    SHUTDOWN          ends the session and stops the daemon
+ *
+ *  where <date> is written as yyyy-mm-ddThh:mm[:ss]. Every command is
+ *  answered with an OK or ERROR <code> line, where <code> is 1 for a
+ *  malformed command, 2 for a lack of memory, 3 for an unknown ID or else
+ *  a toolkit error code. START, END and SAVE apply to the next RUN only
+ *  while time series data and summary objects persist. Replies to jobs
+ *  read from stdin go to stdout and the engine's messages to stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "daemon.h"
+
+// Public project includes
+#include "swmm5.h"
+#include "toolkit.h"
+
+
+#define ERR_SYNTAX 1            // error code for a malformed command
+#define ERR_MEMORY 2            // error code for a lack of memory
+#define ERR_UNKNOWN 3           // error code for an unknown object ID
+
+typedef struct
+{
+    int    has_start;           // TRUE if START was given
+    double start;               // simulation start (decimal days)
+    int    has_end;             // TRUE if END was given
+    double end;                 // simulation end (decimal days)
+    int    has_save;            // TRUE if SAVE was given
+    double save;                // time to save a snapshot (decimal days)
+}  TJob;
+
+typedef struct
+{
+    int    count;               // number of objects
+    int   *index;               // object indexes
+    char **id;                  // object ID names
+}  TObjList;
+
+static TJob     Job;            // settings of the next job
+static TObjList Nodes;          // nodes in the results summary
+static TObjList Links;          // links in the results summary
+static int      HasSnapshot;    // TRUE once a snapshot has been saved
+static double   SnapshotDate;   // time of the last snapshot (decimal days)
+
+
+static long day_number(int y, int m, int d)
+//
+//  Input:   y, m, d = year, month & day
+//  Output:  returns number of days since 03/01/0000
+//  Purpose: counts the days in the proleptic Gregorian calendar.
+//
+{
+    if (m <= 2) {
+        y -= 1;
+        m += 12;
+    }
+    return 365L*y + y/4 - y/100 + y/400 + (153*(m - 3) + 2)/5 + d - 1;
+}
+
+
+static double encode_date(int y, int mo, int d, int h, int mi, int s)
+//
+//  Input:   y, mo, d = year, month & day
+//           h, mi, s = hours, minutes & seconds
+//  Output:  returns the date as decimal days since 12/30/1899
+//  Purpose: encodes a date the way the engine does.
+//
+{
+    return (double)(day_number(y, mo, d) - day_number(1899, 12, 30)) +
+        (3600.0*h + 60.0*mi + s) / 86400.0;
+}
+
+
+static void decode_date(double date, int *y, int *mo, int *d,
+                        int *h, int *mi, int *s)
+//
+//  Input:   date = decimal days since 12/30/1899
+//  Output:  y, mo, d = year, month & day
+//           h, mi, s = hours, minutes & seconds
+//  Purpose: decodes a date, rounded to the nearest second.
+//
+{
+    long secs = lround(date * 86400.0);
+    long days = (long)floor(secs / 86400.0);
+    long n, yy, doy, mp;
+
+    secs -= days * 86400L;
+    *h = (int)(secs / 3600);
+    *mi = (int)(secs % 3600 / 60);
+    *s = (int)(secs % 60);
+
+    // --- count years & months from 03/01/0000 so that the leap day
+    //     falls at the end of a year
+    n = days + day_number(1899, 12, 30);
+    yy = (10000L*n + 14780) / 3652425;
+    doy = n - (365*yy + yy/4 - yy/100 + yy/400);
+    if (doy < 0) {
+        yy--;
+        doy = n - (365*yy + yy/4 - yy/100 + yy/400);
+    }
+    mp = (100*doy + 52) / 3060;
+    *d = (int)(doy - (mp*306 + 5)/10 + 1);
+    *mo = (int)((mp + 2) % 12 + 1);
+    *y = (int)(yy + (mp + 2) / 12);
+}
+
+
+static int parse_date(char *s, double *date)
+//
+//  Input:   s = date written as yyyy-mm-ddThh:mm[:ss]
+//  Output:  date = decimal days since 12/30/1899;
+//           returns TRUE if s is a valid date, FALSE if not
+//  Purpose: reads a date from a job command.
+//
+{
+    int y, mo, d, h, mi, sec = 0;
+    int n = sscanf(s, "%d-%d-%dT%d:%d:%d", &y, &mo, &d, &h, &mi, &sec);
+
+    if (n < 5 || mo < 1 || mo > 12 || d < 1 || d > 31 || h < 0 || h > 23 ||
+        mi < 0 || mi > 59 || sec < 0 || sec > 59)
+        return 0;
+    *date = encode_date(y, mo, d, h, mi, sec);
+    return 1;
+}
+
+
+static void format_date(double date, char *s)
+//
+//  Input:   date = decimal days since 12/30/1899
+//  Output:  s = date written as yyyy-mm-ddThh:mm:ss
+//  Purpose: writes a date into a reply.
+//
+{
+    int y, mo, d, h, mi, sec;
+
+    decode_date(date, &y, &mo, &d, &h, &mi, &sec);
+    sprintf(s, "%04d-%02d-%02dT%02d:%02d:%02d", y, mo, d, h, mi, sec);
+}
+
+
+static char *read_line(FILE *in)
+//
+//  Input:   in = stream that jobs are read from
+//  Output:  returns the next line (without its newline) or NULL at end of
+//           stream; the caller frees the line
+//  Purpose: reads a command line of any length.
+//
+{
+    size_t size = 256, len = 0;
+    char  *line = (char *)malloc(size);
+    char  *more;
+    int    c;
+
+    if (!line)
+        return NULL;
+    while ((c = fgetc(in)) != EOF && c != '\n') {
+        if (len + 1 == size) {
+            size *= 2;
+            more = (char *)realloc(line, size);
+            if (!more) {
+                free(line);
+                return NULL;
+            }
+            line = more;
+        }
+        line[len++] = (char)c;
+    }
+    if (c == EOF && len == 0) {
+        free(line);
+        return NULL;
+    }
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+    line[len] = '\0';
+    return line;
+}
+
+
+static int set_job_date(char *arg, double *date, int *given)
+//
+//  Input:   arg = date argument of a START, END or SAVE command
+//  Output:  date = decimal days since 12/30/1899
+//           given = set to TRUE if arg is a valid date;
+//           returns 0 or ERR_SYNTAX
+//  Purpose: records one of the next job's dates.
+//
+{
+    if (arg == NULL || !parse_date(arg, date))
+        return ERR_SYNTAX;
+    *given = 1;
+    return 0;
+}
+
+
+static int set_date(SM_TimePropety type, double date)
+//
+//  Input:   type = which of the simulation's dates to set
+//           date = decimal days since 12/30/1899
+//  Output:  returns a toolkit error code
+//  Purpose: sets one of the simulation's dates.
+//
+{
+    int y, mo, d, h, mi, s;
+
+    decode_date(date, &y, &mo, &d, &h, &mi, &s);
+    return swmm_setSimulationDateTime(type, y, mo, d, h, mi, s);
+}
+
+
+static int add_object(TObjList *list, SM_ObjectType type, char *id)
+//
+//  Input:   list = objects in the results summary
+//           type = type of object
+//           id = object's ID name
+//  Output:  returns a toolkit error code
+//  Purpose: adds an object to the results summary.
+//
+{
+    int    index, err;
+    int   *indexes;
+    char **ids;
+
+    err = swmm_getObjectIndex(type, id, &index);
+    if (err)
+        return err;
+    if (index < 0)
+        return ERR_UNKNOWN;
+    indexes = (int *)realloc(list->index, (list->count + 1) * sizeof(int));
+    if (indexes)
+        list->index = indexes;
+    ids = (char **)realloc(list->id, (list->count + 1) * sizeof(char *));
+    if (ids)
+        list->id = ids;
+    if (!indexes || !ids)
+        return ERR_MEMORY;
+    list->id[list->count] = (char *)malloc(strlen(id) + 1);
+    if (!list->id[list->count])
+        return ERR_MEMORY;
+    strcpy(list->id[list->count], id);
+    list->index[list->count] = index;
+    list->count++;
+    return 0;
+}
+
+
+static void free_objects(TObjList *list)
+//
+//  Input:   list = objects in the results summary
+//  Output:  none
+//  Purpose: frees the memory used by a results summary list.
+//
+{
+    int i;
+
+    for (i = 0; i < list->count; i++)
+        free(list->id[i]);
+    free(list->id);
+    free(list->index);
+    memset(list, 0, sizeof(TObjList));
+}
+
+
+static int replace_series(char *id)
+//
+//  Input:   id = time series ID name (its data follows in strtok's buffer)
+//  Output:  returns a toolkit error code
+//  Purpose: replaces all of a time series' data with the date-value pairs
+//           of a SERIES command.
+//
+{
+    int     index, n = 0, size = 64, err;
+    double *dates = (double *)malloc(size * sizeof(double));
+    double *values = (double *)malloc(size * sizeof(double));
+    double *more;
+    char   *tok, *end;
+
+    err = swmm_getObjectIndex(SM_TSERIES, id, &index);
+    if (!err && index < 0)
+        err = ERR_UNKNOWN;
+    if (!err && (!dates || !values))
+        err = ERR_MEMORY;
+    while (!err && (tok = strtok(NULL, " \t")) != NULL) {
+        if (n == size) {
+            size *= 2;
+            more = (double *)realloc(dates, size * sizeof(double));
+            if (!more) {
+                err = ERR_MEMORY;
+                break;
+            }
+            dates = more;
+            more = (double *)realloc(values, size * sizeof(double));
+            if (!more) {
+                err = ERR_MEMORY;
+                break;
+            }
+            values = more;
+        }
+        if (!parse_date(tok, &dates[n]) ||
+            (tok = strtok(NULL, " \t")) == NULL) {
+            err = ERR_SYNTAX;
+            break;
+        }
+        values[n] = strtod(tok, &end);
+        if (*end != '\0') {
+            err = ERR_SYNTAX;
+            break;
+        }
+        n++;
+    }
+    if (!err)
+        err = swmm_replaceTimeseries(index, n, dates, values);
+    free(dates);
+    free(values);
+    return err;
+}
+
+
+static int run_job(FILE *out)
+//
+//  Input:   out = stream that replies are written to
+//  Output:  returns a toolkit error code
+//  Purpose: runs a job from the last snapshot (if any) and writes a
+//           summary of its results.
+//
+{
+    int    i, err = 0, saved = 0;
+    int    y, mo, d, h, mi, s;
+    double elapsed = 0.0, saveDate = 0.0;
+    float  runoffErr, flowErr, qualErr;
+    char   date[32];
+    SM_RunoffTotals  runoffTot;
+    SM_RoutingTotals routingTot;
+    SM_NodeStats     nodeStats;
+    SM_LinkStats     linkStats;
+
+    // --- start from the last snapshot, by default at the time it was saved
+    if (HasSnapshot) {
+        err = swmm_restoreState();
+        if (!err && !Job.has_start) {
+            Job.start = SnapshotDate;
+            Job.has_start = 1;
+        }
+    }
+    if (!err && Job.has_start) {
+        err = set_date(SM_STARTDATE, Job.start);
+        if (!err)
+            err = set_date(SM_REPORTDATE, Job.start);
+    }
+    if (!err && Job.has_end)
+        err = set_date(SM_ENDDATE, Job.end);
+    if (err)
+        return err;
+
+    // --- run the job, saving a snapshot once the SAVE time is reached
+    //     (which may be the end of the run)
+    err = swmm_start(1);
+    while (!err) {
+        err = swmm_step(&elapsed);
+        if (!err && Job.has_save && !saved) {
+            err = swmm_getCurrentDateTime(&y, &mo, &d, &h, &mi, &s);
+            saveDate = encode_date(y, mo, d, h, mi, s);
+            if (!err && saveDate >= Job.save) {
+                err = swmm_saveState();
+                saved = 1;
+            }
+        }
+        if (elapsed == 0.0)
+            break;
+    }
+
+    // --- summary results are only available until the run ends
+    if (!err)
+        err = swmm_getSystemRunoffTotals(&runoffTot);
+    if (!err)
+        err = swmm_getSystemRoutingTotals(&routingTot);
+    if (!err) {
+        fprintf(out, "RESULT RUNOFF %.6g %.6g\n", runoffTot.rainfall,
+            runoffTot.runoff);
+        fprintf(out, "RESULT ROUTING %.6g %.6g\n", routingTot.outflow,
+            routingTot.flooding);
+    }
+    for (i = 0; !err && i < Nodes.count; i++) {
+        err = swmm_getNodeStats(Nodes.index[i], &nodeStats);
+        if (!err)
+            fprintf(out, "RESULT NODE %s %.6g %.6g %.6g\n", Nodes.id[i],
+                nodeStats.maxDepth, nodeStats.maxInflow, nodeStats.volFlooded);
+    }
+    for (i = 0; !err && i < Links.count; i++) {
+        err = swmm_getLinkStats(Links.index[i], &linkStats);
+        if (!err)
+            fprintf(out, "RESULT LINK %s %.6g %.6g\n", Links.id[i],
+                linkStats.maxFlow, linkStats.maxDepth);
+    }
+    i = swmm_end();
+    if (!err)
+        err = i;
+    if (!err)
+        err = swmm_getMassBalErr(&runoffErr, &flowErr, &qualErr);
+    if (err)
+        return err;
+    fprintf(out, "RESULT CONTINUITY %.3f %.3f %.3f\n", runoffErr, flowErr,
+        qualErr);
+
+    // --- later jobs start from the new snapshot
+    if (saved) {
+        HasSnapshot = 1;
+        SnapshotDate = saveDate;
+        format_date(saveDate, date);
+        fprintf(out, "RESULT SAVED %s\n", date);
+    }
+    return 0;
+}
+
+
+static int serve(FILE *in, FILE *out)
+//
+//  Input:   in = stream that jobs are read from
+//           out = stream that replies are written to
+//  Output:  returns TRUE if the daemon should stop, FALSE if only the
+//           session has ended
+//  Purpose: reads and carries out the commands of one session.
+//
+{
+    int   err, stop = -1;
+    char *line, *cmd, *arg;
+
+    while (stop < 0 && (line = read_line(in)) != NULL) {
+        cmd = strtok(line, " \t");
+        if (cmd == NULL) {
+            free(line);
+            continue;
+        }
+        arg = strtok(NULL, " \t");
+        err = 0;
+
+        if (strcmp(cmd, "SERIES") == 0)
+            err = arg ? replace_series(arg) : ERR_SYNTAX;
+        else if (strcmp(cmd, "START") == 0)
+            err = set_job_date(arg, &Job.start, &Job.has_start);
+        else if (strcmp(cmd, "END") == 0)
+            err = set_job_date(arg, &Job.end, &Job.has_end);
+        else if (strcmp(cmd, "SAVE") == 0)
+            err = set_job_date(arg, &Job.save, &Job.has_save);
+        else if (strcmp(cmd, "NODE") == 0)
+            err = arg ? add_object(&Nodes, SM_NODE, arg) : ERR_SYNTAX;
+        else if (strcmp(cmd, "LINK") == 0)
+            err = arg ? add_object(&Links, SM_LINK, arg) : ERR_SYNTAX;
+        else if (strcmp(cmd, "RUN") == 0) {
+            err = run_job(out);
+            memset(&Job, 0, sizeof(TJob));
+        }
+        else if (strcmp(cmd, "QUIT") == 0)
+            stop = 0;
+        else if (strcmp(cmd, "SHUTDOWN") == 0)
+            stop = 1;
+        else
+            err = ERR_SYNTAX;
+
+        if (err)
+            fprintf(out, "ERROR %d\n", err);
+        else
+            fprintf(out, "OK\n");
+        fflush(out);
+        free(line);
+    }
+    return stop > 0;
+}
+
+
+#ifdef _WIN32
+
+static FILE *reply_stream(void)
+{
+    return stdout;
+}
+
+
+static int serve_socket(char *path)
+{
+    printf("\nError:\n");
+    printf("\tThe daemon's socket requires Unix domain sockets"
+           " (use stdin on Windows)\n\n");
+    return -1;
+}
+
+#else
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+static FILE *reply_stream(void)
+//
+//  Input:   none
+//  Output:  returns the stream that replies to jobs read from stdin are
+//           written to
+//  Purpose: keeps the stdout stream for replies only by sending the
+//           engine's console messages to stderr.
+//
+{
+    int   fd = dup(STDOUT_FILENO);
+    FILE *out = fd >= 0 ? fdopen(fd, "w") : NULL;
+
+    if (out == NULL) {
+        if (fd >= 0)
+            close(fd);
+        return stdout;
+    }
+    fflush(stdout);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    return out;
+}
+
+
+static int serve_socket(char *path)
+//
+//  Input:   path = name of the Unix domain socket to listen on
+//  Output:  returns 0 when stopped by a SHUTDOWN command or -1 on error
+//  Purpose: serves one client connection at a time until told to stop.
+//
+{
+    int    fd, conn, stop = 0;
+    FILE  *in, *out;
+    struct stat st;
+    struct sockaddr_un addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("\nError:\n");
+        printf("\tsocket name %s is too long\n\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // --- a socket left behind by an earlier daemon can be replaced
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(fd, 4) != 0) {
+        printf("\nError:\n");
+        printf("\tcannot listen on socket %s\n\n", path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    // --- a client that disconnects early must not kill the daemon
+    signal(SIGPIPE, SIG_IGN);
+
+    while (!stop) {
+        conn = accept(fd, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        in = fdopen(conn, "r");
+        out = fdopen(dup(conn), "w");
+        if (in && out)
+            stop = serve(in, out);
+        if (in)
+            fclose(in);
+        else
+            close(conn);
+        if (out)
+            fclose(out);
+    }
+    close(fd);
+    unlink(path);
+    return stop ? 0 : -1;
+}
+
+#endif
+
+
+int daemon_run(char *f1, char *f2, char *f3, char *socket_path)
+//
+//  Input:   f1 = name of input file
+//           f2 = name of report file
+//           f3 = name of binary output file
+//           socket_path = name of Unix domain socket to serve jobs on
+//                         (NULL to read jobs from stdin)
+//  Output:  returns 0 if the daemon ran or the error code of opening the
+//           project
+//  Purpose: opens a project once and serves jobs until told to stop.
+//
+{
+    int   err;
+    char  errMsg[128];
+    FILE *out = socket_path ? NULL : reply_stream();
+
+    err = swmm_open(f1, f2, f3);
+    if (err) {
+        swmm_getError(errMsg, 127);
+        printf("\nError:\n");
+        printf("\t%s\n\n", errMsg);
+        swmm_close();
+        if (out && out != stdout)
+            fclose(out);
+        return err;
+    }
+    memset(&Job, 0, sizeof(TJob));
+    HasSnapshot = 0;
+
+    if (socket_path)
+        serve_socket(socket_path);
+    else
+        serve(stdin, out);
+
+    free_objects(&Nodes);
+    free_objects(&Links);
+    swmm_close();
+    if (out && out != stdout)
+        fclose(out);
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ *  daemon.h - Runs forecast jobs against a project kept loaded in memory
+ *
+ *  Created on: October 17, 2026
+ *  Updated on:
+ *
+ *  The project is opened once and then serves a stream of jobs read from
+ *  stdin or, on POSIX systems, from clients of a Unix domain socket. A job
+ *  replaces the project's time series with forecast data, starts from the
+ *  last state snapshot it or an earlier job saved (a warm restart) and
+ *  returns a summary of the run's results.
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+// Returns 0 if the daemon ran and shut down normally or an error code
+int daemon_run(char *f1, char *f2, char *f3, char *socket_path);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+
+#endif //DAEMON_H
@@ -16,6 +16,8 @@
 
 // Private project includes
 #include "timer.h"
+#include "couple.h"
+#include "daemon.h"
 
 // Public project includes
 #include "swmm5.h"
@@ -24,6 +26,7 @@
 
 #define BAR_LEN 50l
 #define MSG_LEN 84
+#define MAX_ARGS 399
 
 static long Start;
 
@@ -75,9 +78,67 @@ int  main(int argc, char *argv[])
 //  where f1 = name of input file, f2 = name of report file, and
 //  f3 = name of binary output file if saved (or blank if not saved).
 //
+//  Coupled models are run with: swmm5 --couple f1 f2 f3 c f1 f2 f3 ...
+//  where c = name of the routing interface file joining two models.
+//
+//  A project is served jobs with: swmm5 --daemon f1 f2 f3 [--socket s]
+//  where s = name of a Unix domain socket (jobs are read from stdin if
+//  no socket is named).
+//
 {
+    // --- run a chain of coupled models
+    if (argc >= 9 && strcmp(argv[1], "--couple") == 0) {
+        int n_models = (argc - 2 + 1) / 4;
+        char *files[3 * ((MAX_ARGS + 1) / 4)];
+        char *channels[(MAX_ARGS + 1) / 4];
+
+        if ((argc - 2 + 1) % 4 != 0 || argc - 2 > MAX_ARGS) {
+            printf("\nUsage:\n");
+            printf("\trunswmm --couple <input file> <report file> <output file>"
+                   " <interface file> <input file> ...\n\n");
+            return 0;
+        }
+        for (int i = 0; i < n_models; i++) {
+            files[3*i] = argv[2 + 4*i];
+            files[3*i + 1] = argv[3 + 4*i];
+            files[3*i + 2] = argv[4 + 4*i];
+            if (i < n_models - 1)
+                channels[i] = argv[5 + 4*i];
+        }
+
+        Start = current_time_millis();
+        int n_failed = couple_run(n_models, files, channels);
+
+        long stop = current_time_millis();
+        char time[TIMER_LEN + 1] = {'\0'};
+
+        if (n_failed >= 0) {
+            printf("\n\n... EPA-SWMM coupled run completed in %s",
+                format_time(time, stop - Start));
+            if (n_failed > 0)
+                printf(" with errors.\n");
+            else
+                printf(" successfully.\n");
+        }
+    }
+
+    // --- serve jobs to a project kept in memory
+    else if (argc >= 5 && strcmp(argv[1], "--daemon") == 0) {
+        char *socketPath = NULL;
+
+        if (argc == 7 && strcmp(argv[5], "--socket") == 0)
+            socketPath = argv[6];
+        else if (argc != 5) {
+            printf("\nUsage:\n");
+            printf("\trunswmm --daemon <input file> <report file>"
+                   " <output file> [--socket <socket name>]\n\n");
+            return 0;
+        }
+        return daemon_run(argv[2], argv[3], argv[4], socketPath);
+    }
+
      // --- check for proper number of command line arguments
-    if (argc == 4) {
+    else if (argc == 4) {
         // --- extract file names from command line arguments
         char *inputFile = argv[1];
         char *reportFile = argv[2];
@@ -118,8 +179,15 @@ int  main(int argc, char *argv[])
             printf("Commands:\n");
             printf("\t--help (-h)       Help Docs\n");
             printf("\t--version (-v)    Build Version\n");
+            printf("\t--couple          Run coupled models concurrently\n");
+            printf("\t--daemon          Serve forecast jobs to a loaded project\n");
             printf("\nUsage:\n");
-            printf("\t swmm5 <input file> <report file> <output file>\n\n");
+            printf("\t swmm5 <input file> <report file> <output file>\n");
+            printf("\t swmm5 --couple <input file> <report file> <output file>"
+                   " <interface file> <input file> <report file>"
+                   " <output file> ...\n");
+            printf("\t swmm5 --daemon <input file> <report file> <output file>"
+                   " [--socket <socket name>]\n\n");
         }
         else if (strcmp(arg1, "--version") == 0 || strcmp(arg1, "-v") == 0) {
             int version = swmm_getVersion();
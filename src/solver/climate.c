@@ -9,6 +9,7 @@
 //            08/05/15 (Build 5.1.010)
 //            08/01/16 (Build 5.1.011)
 //            05/10/18 (Build 5.1.013)
+//            10/17/26 (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Climate related functions.
@@ -32,6 +33,11 @@
 //   Build 5.1.013:
 //   - Reads names of monthly adjustment patterns for various parameters
 //     of a subcatchment from the [ADJUSTMENTS] section of input file.
+//
+//   Build 5.1.015:
+//   - Climate state uses the calendar components of the current runoff date
+//     held in RunoffCalendar.
+//
 ///-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -633,12 +639,13 @@ void climate_setState(DateTime theDate)
 //  Purpose: sets climate variables for current date.
 //
 {
+    datetime_setCalendar(&RunoffCalendar, theDate);                            //(5.1.015)
     if ( Fclimate.mode == USE_FILE ) updateFileValues(theDate);
     if ( Temp.dataSource != NO_TEMP ) setTemp(theDate);
     setEvap(theDate);
     setWind(theDate);
-    Adjust.rainFactor = Adjust.rain[datetime_monthOfYear(theDate)-1];
-    Adjust.hydconFactor = Adjust.hydcon[datetime_monthOfYear(theDate)-1];
+    Adjust.rainFactor = Adjust.rain[RunoffCalendar.month-1];                   //(5.1.015)
+    Adjust.hydconFactor = Adjust.hydcon[RunoffCalendar.month-1];               //(5.1.015)
     setNextEvapDate(theDate);
 }
 
@@ -783,12 +790,12 @@ void setTemp(DateTime theDate)
     double   tmp;                      // temporary temperature
 
     // --- see if a new day has started
-    mon = datetime_monthOfYear(theDate);
+    mon = RunoffCalendar.month;                                                //(5.1.015)
     theDay = floor(theDate);
     if ( theDay > LastDay )
     {
         // --- update min. & max. temps & their time of day
-        day = datetime_dayOfYear(theDate);
+        day = RunoffCalendar.dayOfYear;                                        //(5.1.015)
         if ( Temp.dataSource == FILE_TEMP )
         {
             Tmin = FileValue[TMIN] + Adjust.temp[mon-1];
@@ -865,7 +872,7 @@ void setEvap(DateTime theDate)
 //
 {
     int k;
-    int mon = datetime_monthOfYear(theDate);
+    int mon = RunoffCalendar.month;                                            //(5.1.015)
 
     switch ( Evap.type )
     {
@@ -915,13 +922,10 @@ void setWind(DateTime theDate)
 //  Purpose: sets wind speed (mph) for a specified date.
 //
 {
-    int yr, mon, day;
-
     switch ( Wind.type )
     {
       case MONTHLY_WIND:
-        datetime_decodeDate(theDate, &yr, &mon, &day);
-        Wind.ws = Wind.aws[mon-1] / UCF(WINDSPEED);
+        Wind.ws = Wind.aws[RunoffCalendar.month-1] / UCF(WINDSPEED);          //(5.1.015)
         break;
 
       case FILE_WIND:
@@ -7,9 +7,15 @@
 //            08/01/16  (Build 5.1.011)
 //            05/10/18  (Build 5.1.013)
 //            03/01/20  (Build 5.1.014)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Various Constants
+//
+//   Build 5.1.015:
+//   - QUANT_MAGICNUMBER added for binary output files with reduced-precision
+//     results.
+//
 //-----------------------------------------------------------------------------
 
 //------------------
@@ -24,6 +30,7 @@
 #define   SEMVERSION_LEN     20             // Version String Len
 
 #define   MAGICNUMBER        516114522
+#define   QUANT_MAGICNUMBER  516114526      // Output file w/ quantized results//(5.1.015)
 #define   EOFMARK            0x1A           // Use 0x04 for UNIX systems
 #define   MAXTITLE           3              // Max. # title lines
 #define   MAXMSG             1024           // Max. # characters in message text
@@ -8,6 +8,7 @@
 //             04/30/15 (Build 5.1.009)
 //             08/05/15 (Build 5.1.010)
 //             08/01/16 (Build 5.1.011)
+//             10/17/26 (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Rule-based controls functions.
@@ -50,6 +51,9 @@
 //  - Support added for DAYOFYEAR attribute.
 //  - Modulated controls no longer included in reported control actions.
 //
+//  Build 5.1.015:
+//  - Date premises use the calendar components held in RoutingCalendar.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -300,6 +304,7 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
     // --- save date and time to shared variables
     CurrentDate = floor(currentTime);
     CurrentTime = currentTime - floor(currentTime);
+    datetime_setCalendar(&RoutingCalendar, currentTime);                       //(5.1.015)
     ElapsedTime = elapsedTime;
 
     // --- evaluate each rule
@@ -997,13 +1002,13 @@ double getVariableValue(struct TVariable v)
         return CurrentTime;
 
       case r_DAY:
-        return datetime_dayOfWeek(CurrentDate);
+        return RoutingCalendar.dayOfWeek;                                      //(5.1.015)
 
       case r_MONTH:
-        return datetime_monthOfYear(CurrentDate);
+        return RoutingCalendar.month;                                          //(5.1.015)
 
       case r_DAYOFYEAR:
-        return datetime_dayOfYear(CurrentDate);
+        return RoutingCalendar.dayOfYear;                                      //(5.1.015)
 
       case r_STATUS:
         if ( j < 0 ||
@@ -5,6 +5,7 @@
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
 //             08/01/16   (Build 5.1.011)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   DateTime functions.
@@ -13,6 +14,9 @@
 //   - decodeTime() no longer rounds up.
 //   - New getTimeStamp function added.
 //
+//   Build 5.1.015
+//   - New initCalendar and setCalendar functions added.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -512,6 +516,81 @@ int  datetime_daysPerMonth(int year, int month)
 
 //=============================================================================
 
+void datetime_initCalendar(TCalendar* cal)
+
+//  Input:   cal = a calendar structure
+//  Output:  none
+//  Purpose: marks a calendar as not yet referring to any date.
+
+{
+    cal->date = NO_DATE;
+    cal->dayNum = NO_DATE;
+    cal->year = 0;
+    cal->month = 1;
+    cal->day = 1;
+    cal->dayOfWeek = 1;
+    cal->dayOfYear = 1;
+    cal->hour = 0;
+}
+
+//=============================================================================
+
+void datetime_setCalendar(TCalendar* cal, DateTime date)
+
+//  Input:   cal = a calendar structure
+//           date = an encoded date/time value
+//  Output:  none
+//  Purpose: updates the calendar components of cal to those of date.
+//
+//  The full date decoding is only made when date falls on a day that
+//  neither equals nor directly follows the day the calendar last held,
+//  so a calendar advanced by a simulation clock is updated in constant
+//  time. The results are the same as those of datetime_decodeDate,
+//  datetime_dayOfWeek, datetime_dayOfYear and datetime_hourOfDay.
+
+{
+    int dayNum, hour, min, sec;
+
+    if ( date == cal->date ) return;
+    cal->date = date;
+
+    dayNum = (int)(floor(date));
+    if ( dayNum == cal->dayNum + 1 && cal->dayNum != NO_DATE )
+    {
+        // --- advance to the next day
+        cal->dayNum = dayNum;
+        cal->dayOfWeek = (cal->dayOfWeek % 7) + 1;
+        cal->dayOfYear++;
+        cal->day++;
+        if ( cal->day > datetime_daysPerMonth(cal->year, cal->month) )
+        {
+            cal->day = 1;
+            cal->month++;
+            if ( cal->month > 12 )
+            {
+                cal->month = 1;
+                cal->year++;
+                cal->dayOfYear = 1;
+            }
+        }
+    }
+    else if ( dayNum != cal->dayNum )
+    {
+        // --- decode a day that does not follow the current one
+        cal->dayNum = dayNum;
+        datetime_decodeDate(date, &cal->year, &cal->month, &cal->day);
+        cal->dayOfWeek = datetime_dayOfWeek(date);
+        cal->dayOfYear = dayNum -
+            (int)datetime_encodeDate(cal->year, 1, 1) + 1;
+    }
+
+    // --- time of day changes on every call
+    datetime_decodeTime(date, &hour, &min, &sec);
+    cal->hour = hour;
+}
+
+//=============================================================================
+
 void datetime_getTimeStamp(int fmt, DateTime aDate, int stampSize, char* timeStamp)
 
 //  Input:   fmt = desired date format code
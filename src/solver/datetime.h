@@ -5,6 +5,7 @@
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
 //             08/01/16   (Build 5.1.011)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   The DateTime type is used to store date and time values. It is
@@ -16,6 +17,9 @@
 //
 //   Build 5.1.011
 //   - New getTimeStamp function added.
+//
+//   Build 5.1.015
+//   - TCalendar structure and setCalendar function added.
 //-----------------------------------------------------------------------------
 
 typedef double DateTime;
@@ -27,6 +31,20 @@ typedef double DateTime;
 #define DATE_STR_SIZE 12
 #define TIME_STR_SIZE 9
 
+// Calendar components of a DateTime value, kept up to date incrementally
+// as the simulation clock advances (see datetime_setCalendar)
+typedef struct
+{
+    DateTime date;          // date/time the components refer to
+    int      dayNum;        // whole days since 12/30/1899 of date
+    int      year;          // 4-digit year
+    int      month;         // month of year (1-12)
+    int      day;           // day of month (1-31)
+    int      dayOfWeek;     // day of week (1 = Sunday)
+    int      dayOfYear;     // day of year (1-366)
+    int      hour;          // hour of day (0-23)
+}  TCalendar;
+
 // Functions for encoding a date or time value to a DateTime value
 DateTime datetime_encodeDate(int year, int month, int day);
 DateTime datetime_encodeTime(int hour, int minute, int second);
@@ -43,6 +61,10 @@ int  datetime_dayOfWeek(DateTime date);
 int  datetime_hourOfDay(DateTime date);
 int  datetime_daysPerMonth(int year, int month);
 
+// Functions for maintaining the calendar components of a changing date
+void datetime_initCalendar(TCalendar* cal);
+void datetime_setCalendar(TCalendar* cal, DateTime date);
+
 // Functions for converting a DateTime value to a string
 void datetime_dateToStr(DateTime date, char* s);
 void datetime_timeToStr(DateTime time, char* s);
@@ -8,6 +8,7 @@
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //             R. Dickinson (CDM)
@@ -29,6 +30,11 @@
 //   - Conduit evap. and seepage loss initialized to 0 in dwflow_findConduitFlow.
 //   - Most current flow (qLast) used instead of previous time period flow
 //     (qOld) in call to link_getLossRate. 
+//
+//   Build 5.1.015:
+//   - Conduits updated in batches whose flow areas and hyd. radii are found
+//     together by cross section shape (dwflow_findConduitFlows).
+//   - Friction slopes of the full force mains in a batch found together.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -37,6 +43,31 @@
 
 static const  double MAXVELOCITY =  50.;     // max. allowable velocity (ft/sec)
 
+#define DW_BATCH 64                    // max. number of conduits in a batch   //(5.1.015)
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct                                                                 //(5.1.015)
+{
+    int     n;                         // number of conduits in batch
+    int     link[DW_BATCH];            // link index of each conduit
+    TXsect* xsect[DW_BATCH];           // ptr. to each conduit's cross section
+    double  h1[DW_BATCH];              // upstream head (ft)
+    double  h2[DW_BATCH];              // downstream head (ft)
+    double  y[3*DW_BATCH];             // upstream, downstream & mid depths (ft)
+    double  a[3*DW_BATCH];             // areas at these depths (ft2)
+    double  r[3*DW_BATCH];             // hyd. radii at these depths (ft)
+    double  sf[DW_BATCH];              // friction slope of each full force
+                                       // main (not set for other conduits)
+}  TDwBatch;
+
+static void   findEndDepths(TDwBatch* b, int m);                               //(5.1.015)
+static void   findBatchGeometry(TDwBatch* b, int type);                        //(5.1.015)
+static void   findFricSlopes(TDwBatch* b);                                     //(5.1.015)
+static void   findNewFlow(TDwBatch* b, int m, int steps, double omega,         //(5.1.015)
+              double dt);                                                      //(5.1.015)
+
 static int    getFlowClass(int link, double q, double h1, double h2,
               double y1, double y2, double* criticalDepth, double* normalDepth,
               double* fasnh);
@@ -66,41 +97,90 @@ void  dwflow_findConduitFlow(int j, int steps, double omega, double dt)
 //           form of continuity and momentum equations.
 //
 {
+    dwflow_findConduitFlows(&j, 1, steps, omega, dt);                          //(5.1.015)
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  dwflow_findConduitFlows(int links[], int n, int steps, double omega,
+                              double dt)
+//
+//  Input:   links    = indexes of conduit links
+//           n        = number of links
+//           steps    = number of iteration steps taken
+//           omega    = under-relaxation parameter
+//           dt       = time step (sec)
+//  Output:  none
+//  Purpose: updates flows in a group of conduits, skipping any that are
+//           bypassed.
+//
+//  Note:    conduits are processed in batches. The flow depths at the ends
+//           of each conduit in a batch are found first, then the flow areas
+//           and hyd. radii of the whole batch, the friction slopes of its
+//           full force mains, and finally the new flows. When every conduit
+//           in a batch has the same shape (as when links are grouped by
+//           shape) the geometry is found by a single call to
+//           xsect_getAandRofY.
+//
+{
+    int      i, m, type;
+    TDwBatch b;
+
+    for (i = 0; i < n; )
+    {
+        // --- find end depths of the next batch of conduits
+        b.n = 0;
+        type = -1;
+        for ( ; i < n && b.n < DW_BATCH; i++ )
+        {
+            if ( Link[links[i]].bypassed ) continue;
+            m = b.n++;
+            b.link[m] = links[i];
+            b.xsect[m] = &Link[links[i]].xsect;
+            if ( m == 0 ) type = b.xsect[m]->type;
+            else if ( type != b.xsect[m]->type ) type = -1;
+            findEndDepths(&b, m);
+        }
+        if ( b.n == 0 ) continue;
+
+        // --- find areas & hyd. radii of the batch
+        findBatchGeometry(&b, type);
+
+        // --- find friction slopes of full force mains
+        findFricSlopes(&b);
+
+        // --- find new flows
+        for (m = 0; m < b.n; m++) findNewFlow(&b, m, steps, omega, dt);
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  findEndDepths(TDwBatch* b, int m)
+//
+//  Input:   b = batch of conduits
+//           m = position of a conduit in the batch
+//  Output:  none
+//  Purpose: finds the heads and flow depths at the ends of a conduit and
+//           its surface area contributions to its end nodes.
+//
+{
+    int    j = b->link[m];             // link index
     int    k;                          // index of conduit
     int    n1, n2;                     // indexes of end nodes
     double z1, z2;                     // upstream/downstream invert elev. (ft)
     double h1, h2;                     // upstream/dounstream flow heads (ft)
     double y1, y2;                     // upstream/downstream flow depths (ft)
-    double a1, a2;                     // upstream/downstream flow areas (ft2)
-    double r1;                         // upstream hyd. radius (ft)
-    double yMid, rMid, aMid;           // mid-stream or avg. values of y, r, & a
-    double aWtd, rWtd;                 // upstream weighted area & hyd. radius
     double qLast;                      // flow from previous iteration (cfs)
-    double qOld;                       // flow from previous time step (cfs)
-    double aOld;                       // area from previous time step (ft2)
-    double v;                          // velocity (ft/sec)
-    double rho;                        // upstream weighting factor
-    double sigma;                      // inertial damping factor
     double length;                     // effective conduit length (ft)
-    double wSlot;                      // Preissmann slot width (ft)           //(5.1.013)
-    double dq1, dq2, dq3, dq4, dq5,    // terms in momentum eqn.
-           dq6;                        // term for evap and infil losses
-    double denom;                      // denominator of flow update formula
-    double q;                          // new flow value (cfs)
-    double barrels;                    // number of barrels in conduit
-    TXsect* xsect = &Link[j].xsect;    // ptr. to conduit's cross section data
-    char   isFull = FALSE;             // TRUE if conduit flowing full
-    char   isClosed = FALSE;           // TRUE if conduit closed
-
+    TXsect* xsect = b->xsect[m];       // ptr. to conduit's cross section data
 
-
-    // --- adjust isClosed status by any control action
-    if ( Link[j].setting == 0 ) isClosed = TRUE;
-
-    // --- get flow from last time step & previous iteration
+    // --- get flow from previous iteration
     k =  Link[j].subIndex;
-    barrels = Conduit[k].barrels;
-    qOld = Link[j].oldFlow / barrels;
     qLast = Conduit[k].q1;
     Conduit[k].evapLossRate = 0.0;                                             //(5.1.014)
     Conduit[k].seepLossRate = 0.0;                                             //(5.1.014)
@@ -129,29 +209,193 @@ void  dwflow_findConduitFlow(int j, int steps, double omega, double dt)
         y2 = MIN(y2, xsect->yFull);
     }
 
-    // -- get area from solution at previous time step
-    aOld = Conduit[k].a2;
-    aOld = MAX(aOld, FUDGE);
-
     // --- use Courant-modified length instead of conduit's actual length
     length = Conduit[k].modLength;
 
     // --- find surface area contributions to upstream and downstream nodes
     //     based on previous iteration's flow estimate
     findSurfArea(j, qLast, length, &h1, &h2, &y1, &y2);
+    b->h1[m] = h1;
+    b->h2[m] = h2;
+    b->y[m] = y1;
+    b->y[DW_BATCH + m] = y2;
+    b->y[2*DW_BATCH + m] = 0.5 * (y1 + y2);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  findBatchGeometry(TDwBatch* b, int type)
+//
+//  Input:   b = batch of conduits
+//           type = shape shared by all conduits in the batch (-1 if mixed)
+//  Output:  none
+//  Purpose: finds flow areas at the ends & midpoint of each conduit in a
+//           batch and hyd. radii at its upstream end & midpoint.
+//
+//  Note:    the downstream hyd. radius is not needed and is left unset
+//           unless found by xsect_getAandRofY.
+//
+{
+    int     m, e;
+    double  y, wSlot;
+    TXsect* xsect[3*DW_BATCH];
+
+    // --- areas & hyd. radii of partly full sections by shape
+    if ( type >= 0 )
+    {
+        for (e = 0; e < 3; e++)
+        {
+            for (m = 0; m < b->n; m++) xsect[e*DW_BATCH + m] = b->xsect[m];
+        }
+        for (e = 0; e < 3; e++)
+        {
+            if ( !xsect_getAandRofY(type, &xsect[e*DW_BATCH], b->n,
+                 &b->y[e*DW_BATCH], &b->a[e*DW_BATCH], &b->r[e*DW_BATCH]) )
+            {
+                type = -1;
+                break;
+            }
+        }
+    }
+
+    // --- adjust for full sections & Preissmann slot (or evaluate each
+    //     section in turn if there is no batched form)
+    for (e = 0; e < 3; e++)
+    {
+        for (m = 0; m < b->n; m++)
+        {
+            y = b->y[e*DW_BATCH + m];
+            if ( type < 0 || y >= b->xsect[m]->yFull )
+            {
+                wSlot = getSlotWidth(b->xsect[m], y);
+                b->a[e*DW_BATCH + m] = getArea(b->xsect[m], y, wSlot);
+                if ( e != 1 ) b->r[e*DW_BATCH + m] = getHydRad(b->xsect[m], y);
+            }
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  findFricSlopes(TDwBatch* b)
+//
+//  Input:   b = batch of conduits
+//  Output:  none
+//  Purpose: finds the friction slopes of the force mains in a batch that
+//           are flowing full.
+//
+//  Note:    the velocity of each force main is found from its previous
+//           iteration's flow just as in findNewFlow.
+//
+{
+    int    m, n = 0;
+    int    j, k;
+    int    pos[DW_BATCH];              // batch position of each full main
+    int    links[DW_BATCH];            // link index of each full main
+    double v[DW_BATCH];                // velocity in each full main (ft/sec)
+    double r[DW_BATCH];                // mid hyd. radius of each (ft)
+    double slope[DW_BATCH];            // friction slope of each
+    double aMid, qLast;
+
+    for (m = 0; m < b->n; m++)
+    {
+        if ( b->xsect[m]->type != FORCE_MAIN ||
+             b->y[m] < b->xsect[m]->yFull ||
+             b->y[DW_BATCH + m] < b->xsect[m]->yFull ) continue;
+        aMid = b->a[2*DW_BATCH + m];
+        if ( aMid <= FUDGE ) continue;
+        j = b->link[m];
+        k = Link[j].subIndex;
+        qLast = Conduit[k].q1;
+        v[n] = qLast / aMid;
+        if ( fabs(v[n]) > MAXVELOCITY )  v[n] = MAXVELOCITY * SGN(qLast);
+        v[n] = fabs(v[n]);
+        r[n] = b->r[2*DW_BATCH + m];
+        links[n] = j;
+        pos[n++] = m;
+    }
+    if ( n == 0 ) return;
+    forcemain_getFricSlopes(n, links, v, r, slope);
+    for (m = 0; m < n; m++) b->sf[pos[m]] = slope[m];
+}
 
-    // --- compute area at each end of conduit & hyd. radius at upstream end
-    wSlot = getSlotWidth(xsect, y1);                                           //(5.1.013)
-    a1 = getArea(xsect, y1, wSlot);                                            //(5.1.013)
-    r1 = getHydRad(xsect, y1);
-    wSlot = getSlotWidth(xsect, y2);                                           //(5.1.013)
-    a2 = getArea(xsect, y2, wSlot);                                            //(5.1.013)
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  findNewFlow(TDwBatch* b, int m, int steps, double omega, double dt)
+//
+//  Input:   b        = batch of conduits
+//           m        = position of a conduit in the batch
+//           steps    = number of iteration steps taken
+//           omega    = under-relaxation parameter
+//           dt       = time step (sec)
+//  Output:  none
+//  Purpose: updates flow in a conduit by solving finite difference
+//           form of continuity and momentum equations.
+//
+//  Note:    this is the original body of dwflow_findConduitFlow following
+//           the computation of the conduit's end depths and geometry.
+//
+{
+    int    j = b->link[m];             // link index
+    int    k;                          // index of conduit
+    int    n1, n2;                     // indexes of end nodes
+    double h1, h2;                     // upstream/dounstream flow heads (ft)
+    double y1, y2;                     // upstream/downstream flow depths (ft)
+    double a1, a2;                     // upstream/downstream flow areas (ft2)
+    double r1;                         // upstream hyd. radius (ft)
+    double yMid, rMid, aMid;           // mid-stream or avg. values of y, r, & a
+    double aWtd, rWtd;                 // upstream weighted area & hyd. radius
+    double qLast;                      // flow from previous iteration (cfs)
+    double qOld;                       // flow from previous time step (cfs)
+    double aOld;                       // area from previous time step (ft2)
+    double v;                          // velocity (ft/sec)
+    double rho;                        // upstream weighting factor
+    double sigma;                      // inertial damping factor
+    double length;                     // effective conduit length (ft)
+    double dq1, dq2, dq3, dq4, dq5,    // terms in momentum eqn.
+           dq6;                        // term for evap and infil losses
+    double denom;                      // denominator of flow update formula
+    double q;                          // new flow value (cfs)
+    double barrels;                    // number of barrels in conduit
+    TXsect* xsect = b->xsect[m];       // ptr. to conduit's cross section data
+    char   isFull = FALSE;             // TRUE if conduit flowing full
+    char   isClosed = FALSE;           // TRUE if conduit closed
+
+    // --- adjust isClosed status by any control action
+    if ( Link[j].setting == 0 ) isClosed = TRUE;
+
+    // --- get flow from last time step & previous iteration
+    k =  Link[j].subIndex;
+    barrels = Conduit[k].barrels;
+    qOld = Link[j].oldFlow / barrels;
+    qLast = Conduit[k].q1;
+    n1 = Link[j].node1;
+    n2 = Link[j].node2;
+
+    // -- get area from solution at previous time step
+    aOld = Conduit[k].a2;
+    aOld = MAX(aOld, FUDGE);
+
+    // --- use Courant-modified length instead of conduit's actual length
+    length = Conduit[k].modLength;
 
-    // --- compute area & hyd. radius at midpoint
-    yMid = 0.5 * (y1 + y2);
-    wSlot = getSlotWidth(xsect, yMid);                                         //(5.1.013)
-    aMid = getArea(xsect, yMid, wSlot);                                        //(5.1.013)
-    rMid = getHydRad(xsect, yMid);
+    // --- retrieve end heads & depths and areas & hyd. radii
+    h1 = b->h1[m];
+    h2 = b->h2[m];
+    y1 = b->y[m];
+    y2 = b->y[DW_BATCH + m];
+    yMid = b->y[2*DW_BATCH + m];
+    a1 = b->a[m];
+    r1 = b->r[m];
+    a2 = b->a[DW_BATCH + m];
+    aMid = b->a[2*DW_BATCH + m];
+    rMid = b->r[2*DW_BATCH + m];
 
     // --- alternate approach not currently used, but might produce better
     //     Bernoulli energy balance for steady flows
@@ -211,7 +455,7 @@ void  dwflow_findConduitFlow(int j, int steps, double omega, double dt)
     // --- compute terms of momentum eqn.:
     // --- 1. friction slope term
     if ( xsect->type == FORCE_MAIN && isFull )
-         dq1 = dt * forcemain_getFricSlope(j, fabs(v), rMid);
+         dq1 = dt * b->sf[m];                                                  //(5.1.015)
     else dq1 = dt * Conduit[k].roughFactor / pow(rWtd, 1.33333) * fabs(v);
 
     // --- 2. energy slope term
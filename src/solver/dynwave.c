@@ -9,6 +9,7 @@
 //             03/19/15   (5.1.008)
 //             08/01/16   (5.1.011)
 //             05/10/18   (5.1.013)
+//             10/17/26   (5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //             R. Dickinson (CDM)
@@ -49,6 +50,15 @@
 //   - updateNodeFlows() modified to subtract conduit evap. and seepage losses
 //     from downstream node inflow instead of upstream node outflow.
 //
+//   Build 5.1.015:
+//   - Flows from non-dummy conduits gathered at each node in parallel by
+//     gatherNodeFlows() using the node's lists of incident links.
+//   - Force main friction terms prepared and freed with the routing method.
+//   - Flows through orifices, weirs and outlets found in parallel ahead of
+//     the serial pass over pumps and dummy conduits.
+//   - Conduits grouped by cross section shape into batches updated together
+//     by dwflow_findConduitFlows().
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -69,6 +79,7 @@ static const double DEFAULT_HEADTOL     = 0.005;  // Default head tolerance (ft)
 static const double EXTRAN_CROWN_CUTOFF = 0.96;   // crown cutoff for EXTRAN   //(5.1.013)
 static const double SLOT_CROWN_CUTOFF   = 0.985257; // crown cutoff for SLOT   //(5.1.013)
 static const int    DEFAULT_MAXTRIALS   = 8;       // Max. trials per time step
+static const int    MAXBATCH            = 64;      // Max. conduits per batch  //(5.1.015)
 
 
 //-----------------------------------------------------------------------------
@@ -91,6 +102,11 @@ static TXnode* Xnode;                  // extended nodal information
 
 static double  Omega;                  // actual under-relaxation parameter
 static int     Steps;                  // number of Picard iterations
+static int*    Regulators;             // indexes of orifices, weirs & outlets //(5.1.015)
+static int     Nregulators;            // number of regulator links            //(5.1.015)
+static int*    Conduits;               // non-dummy conduits sorted by shape   //(5.1.015)
+static int*    Batches;                // start of each batch in Conduits      //(5.1.015)
+static int     Nbatches;               // number of conduit batches            //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  Function declarations
@@ -102,10 +118,14 @@ static void   findLimitedLinks();
 
 static void   findLinkFlows(double dt);
 static int    isTrueConduit(int link);
+static int    isRegulator(int link);                                           //(5.1.015)
+static void   findRegulators(void);                                            //(5.1.015)
+static void   findConduitBatches(void);                                        //(5.1.015)
 static void   findNonConduitFlow(int link, double dt);
 static void   findNonConduitSurfArea(int link);
 static double getModPumpFlow(int link, double q, double dt);
 static void   updateNodeFlows(int link);
+static void   gatherNodeFlows(int node);                                       //(5.1.015)
 
 static int    findNodeDepths(double dt);
 static void   setNodeDepth(int node, double dt);
@@ -118,6 +138,8 @@ static double getNodeStep(double tMin, int *minNode);
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void dynwave_init()
 //
 //  Input:   none
@@ -136,6 +158,9 @@ void dynwave_init()
             " Not enough memory for dynamic wave routing.");
         return;
     }
+    forcemain_init();                                                          //(5.1.015)
+    findRegulators();                                                          //(5.1.015)
+    findConduitBatches();                                                      //(5.1.015)
 
     // --- initialize node surface areas & crown elev.
     for (i = 0; i < Nobjects[NODE]; i++ )
@@ -165,6 +190,8 @@ void dynwave_init()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void  dynwave_close()
 //
 //  Input:   none
@@ -173,6 +200,10 @@ void  dynwave_close()
 //
 {
     FREE(Xnode);
+    FREE(Regulators);                                                          //(5.1.015)
+    FREE(Conduits);                                                            //(5.1.015)
+    FREE(Batches);                                                             //(5.1.015)
+    forcemain_close();                                                         //(5.1.015)
 }
 
 //=============================================================================
@@ -378,33 +409,56 @@ void  findLimitedLinks()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void findLinkFlows(double dt)
+//
+//  Input:   dt = time step (sec)
+//  Output:  none
+//  Purpose: finds new flows in all links and adds them to their end nodes'
+//           inflows and outflows.
+//
+//  Note:    a regulator's flow depends only on the heads at its end nodes
+//           so all regulators can be evaluated at once. Pumps and dummy
+//           conduits draw on the inflow already gathered at their inlet
+//           nodes, which depends on the order in which links are processed,
+//           so they remain in the serial pass.
+//
 {
-    int i;
+    int i, m;                                                                  //(5.1.015)
 
-    // --- find new flow in each non-dummy conduit
+    // --- find new flow in each non-dummy conduit, one batch of
+    //     conduits of the same shape at a time                                //(5.1.015)
 #pragma omp parallel num_threads(NumThreads)
 {
     #pragma omp for
-    for ( i = 0; i < Nobjects[LINK]; i++)
-    {
-        if ( isTrueConduit(i) && !Link[i].bypassed )
-            dwflow_findConduitFlow(i, Steps, Omega, dt);
-    }
-}
+    for ( m = 0; m < Nbatches; m++)                                            //(5.1.015)
+    {                                                                          //(5.1.015)
+        dwflow_findConduitFlows(&Conduits[Batches[m]],                         //(5.1.015)
+            Batches[m+1] - Batches[m], Steps, Omega, dt);                      //(5.1.015)
+    }                                                                          //(5.1.015)
 
     // --- update inflow/outflows for nodes attached to non-dummy conduits
-    for ( i = 0; i < Nobjects[LINK]; i++)
-    {
-        if ( isTrueConduit(i) ) updateNodeFlows(i);
-    }
+    #pragma omp for
+    for ( i = 0; i < Nobjects[NODE]; i++) gatherNodeFlows(i);                  //(5.1.015)
+
+    // --- find new flows for all regulators                                   //(5.1.015)
+    #pragma omp for private(i)                                                 //(5.1.015)
+    for ( m = 0; m < Nregulators; m++ )                                        //(5.1.015)
+    {                                                                          //(5.1.015)
+        i = Regulators[m];                                                     //(5.1.015)
+        if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);                    //(5.1.015)
+    }                                                                          //(5.1.015)
+}
 
-    // --- find new flows for all dummy conduits, pumps & regulators
+    // --- find new flows for all dummy conduits & pumps and update
+    //     node flows for these and for regulators in order of link index      //(5.1.015)
     for ( i = 0; i < Nobjects[LINK]; i++)
     {
         if ( !isTrueConduit(i) )
         {	
-            if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);
+            if ( !Link[i].bypassed && !isRegulator(i) )                        //(5.1.015)
+                findNonConduitFlow(i, dt);                                     //(5.1.015)
             updateNodeFlows(i);
         }
     }
@@ -419,6 +473,106 @@ int isTrueConduit(int j)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int isRegulator(int j)
+{
+    return ( Link[j].type == ORIFICE || Link[j].type == WEIR ||
+             Link[j].type == OUTLET );
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void findRegulators()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lists the indexes of all orifices, weirs and outlets, grouped
+//           by type so that threads evaluate like links together.
+//
+{
+    int i, m, type;
+    int types[] = {ORIFICE, WEIR, OUTLET};
+
+    Nregulators = 0;
+    Regulators = NULL;
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( isRegulator(i) ) Nregulators++;
+    }
+    if ( Nregulators == 0 ) return;
+    Regulators = (int *) calloc(Nregulators, sizeof(int));
+    if ( Regulators == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+        Nregulators = 0;
+        return;
+    }
+    m = 0;
+    for (type = 0; type < 3; type++)
+    {
+        for (i = 0; i < Nobjects[LINK]; i++)
+        {
+            if ( Link[i].type == types[type] ) Regulators[m++] = i;
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void findConduitBatches()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: sorts the non-dummy conduits by cross section shape (and by
+//           link index within a shape) and divides them into batches of
+//           conduits of the same shape.
+//
+{
+    int i, m, n, type, start;
+
+    Conduits = NULL;
+    Batches = NULL;
+    Nbatches = 0;
+    n = 0;
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( isTrueConduit(i) ) n++;
+    }
+    if ( n == 0 ) return;
+    Conduits = (int *) calloc(n, sizeof(int));
+    Batches = (int *) calloc(n+1, sizeof(int));
+    if ( Conduits == NULL || Batches == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+        return;
+    }
+
+    // --- each shape's conduits start a new batch, which is split
+    //     once it holds MAXBATCH conduits
+    m = 0;
+    for (type = 0; type <= FORCE_MAIN; type++)
+    {
+        start = m;
+        for (i = 0; i < Nobjects[LINK]; i++)
+        {
+            if ( !isTrueConduit(i) || Link[i].xsect.type != type ) continue;
+            if ( m == start || m - Batches[Nbatches-1] == MAXBATCH )
+                Batches[Nbatches++] = m;
+            Conduits[m++] = i;
+        }
+    }
+    Batches[Nbatches] = m;
+}
+
+//=============================================================================
+
 void findNonConduitFlow(int i, double dt)
 //
 //  Input:   i = link index
@@ -579,6 +733,69 @@ void updateNodeFlows(int i)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void gatherNodeFlows(int n)
+//
+//  Input:   n = node index
+//  Output:  none
+//  Purpose: adds the flows, surface areas and dqdh values of the
+//           non-dummy conduits connected to a node to the node's totals.
+//
+//  Note:    a node's outlinks and inlinks are merged in order of link
+//           index so totals are summed in the same order as when
+//           updateNodeFlows() is called for each conduit in turn.
+{
+    int    i, k, k1, k2, end1, end2, isUpstream;
+    double q, uniformLossRate;
+    double barrels;
+
+    k1 = OutLinks.start[n];
+    end1 = OutLinks.start[n+1];
+    k2 = InLinks.start[n];
+    end2 = InLinks.start[n+1];
+    while ( k1 < end1 || k2 < end2 )
+    {
+        // --- pick the next link attached to the node
+        if ( k2 >= end2 ||
+             (k1 < end1 && OutLinks.links[k1] <= InLinks.links[k2]) )
+        {
+            i = OutLinks.links[k1++];
+            isUpstream = TRUE;
+        }
+        else
+        {
+            i = InLinks.links[k2++];
+            isUpstream = FALSE;
+        }
+        if ( !isTrueConduit(i) ) continue;
+
+        // --- compute any uniform seepage loss from the conduit
+        k = Link[i].subIndex;
+        uniformLossRate = Conduit[k].evapLossRate + Conduit[k].seepLossRate;
+        barrels = Conduit[k].barrels;
+        uniformLossRate *= barrels;
+        q = Link[i].newFlow;
+
+        // --- update node's inflow, outflow, surf. area & dqdh
+        if ( isUpstream )
+        {
+            if ( q >= 0.0 ) Node[n].outflow += q;
+            else            Node[n].inflow -= q + uniformLossRate;
+            Xnode[n].newSurfArea += Link[i].surfArea1 * barrels;
+        }
+        else
+        {
+            if ( q >= 0.0 ) Node[n].inflow += q - uniformLossRate;
+            else            Node[n].outflow -= q;
+            Xnode[n].newSurfArea += Link[i].surfArea2 * barrels;
+        }
+        Xnode[n].sumdqdh += Link[i].dqdh;
+    }
+}
+
+//=============================================================================
+
 int findNodeDepths(double dt)
 {
     int i;
@@ -10,6 +10,7 @@
 //            08/05/15  (Build 5.1.010)
 //            08/01/16  (Build 5.1.011)
 //            05/10/18  (Build 5.1.013)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Enumerated variables
@@ -37,6 +38,15 @@
 //   - SURCHARGE_METHOD and RULE_STEP options added.
 //   - WEIR_CURVE added as a curve type. 
 //
+//   Build 5.1.015:
+//   - GraphType enumeration added.
+//   - STATS_STRIDE option added.
+//   - STATS_TOP_N option added.
+//   - LID_RPT_FORMAT option and LidRptFormatType enumeration added.
+//   - IfaceFormatType enumeration added.
+//   - OutStorageType enumeration added.
+//   - FORCE_MAIN_TBL option added.
+//
 //-----------------------------------------------------------------------------
 
 //-------------------------------------
@@ -102,6 +112,24 @@
       USE_FILE,                        // use previously saved file
       SAVE_FILE};                      // save file currently in use
 
+////  Added to release 5.1.015.  ////                                          //(5.1.015)
+//-------------------------------------
+// Routing interface file formats
+//-------------------------------------
+ enum IfaceFormatType {
+      TEXT_IFACE,                      // text file
+      BINARY_IFACE,                    // binary file
+      PIPE_IFACE};                     // in-memory pipe between projects
+
+////  Added to release 5.1.015.  ////                                          //(5.1.015)
+//-------------------------------------
+// Binary output storage formats
+//-------------------------------------
+ enum OutStorageType {
+      FLOAT_STORAGE,                   // 4-byte real
+      HALF_STORAGE,                    // 2-byte (half precision) real
+      INT16_STORAGE};                  // 2-byte integer times a scale factor
+
 //-------------------------------------
 // Rain gage data types
 //-------------------------------------
@@ -368,6 +396,11 @@ enum  CompatibilityType {
       EXTRAN,                          // original EXTRAN method
       SLOT};                           // Preissmann slot method
 
+////  Added to release 5.1.015.  ////                                          //(5.1.015)
+ enum  LidRptFormatType {
+      TEXT_LID_RPT,                    // tab-delimited text file
+      BINARY_LID_RPT};                 // binary file
+
  enum InflowType {
       EXTERNAL_INFLOW,                 // user-supplied external inflow
       DRY_WEATHER_INFLOW,              // user-supplied dry weather inflow
@@ -409,6 +442,11 @@ enum  CompatibilityType {
       WEIR_DIVIDER,                    // diverted flow proportional to excess flow
       OVERFLOW_DIVIDER};               // diverted flow is flow > full conduit flow
 
+ enum GraphType {                                                              //(5.1.015)
+      OUTLINK_GRAPH,                   // links listed at their upstream node
+      INLINK_GRAPH,                    // links listed at their downstream node
+      UNDIRECTED_GRAPH};               // links listed at both end nodes
+
  enum PumpCurveType {
       TYPE1_PUMP,                      // flow varies stepwise with wet well volume
       TYPE2_PUMP,                      // flow varies stepwise with inlet depth 
@@ -470,7 +508,9 @@ enum  CompatibilityType {
     IGNORE_SNOWMELT, IGNORE_GWATER, IGNORE_ROUTING,
     IGNORE_QUALITY, MAX_TRIALS, HEAD_TOL,
     SYS_FLOW_TOL, LAT_FLOW_TOL, IGNORE_RDII,
-    MIN_ROUTE_STEP, NUM_THREADS, SURCHARGE_METHOD};                              //(5.1.013)
+    MIN_ROUTE_STEP, NUM_THREADS, SURCHARGE_METHOD,                               //(5.1.013)
+    GEOM_TBL_SIZE, STATS_STRIDE, STATS_TOP_N, LID_RPT_FORMAT,
+    FORCE_MAIN_TBL};                                                           //(5.1.015)
 
 enum  NoYesType {
       NO,
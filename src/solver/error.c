@@ -6,6 +6,7 @@
 //   Date:    03/20/14  (Build 5.1.001)
 //            03/19/15  (Build 5.1.008)
 //            08/05/15  (Build 5.1.010)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Error messages
@@ -16,6 +17,10 @@
 //   Build 5.1.010:
 //   - Text of Error 318 for rainfall data files modified.
 //
+//   Build 5.1.015:
+//   - Text of Error 405 modified since output file size is no longer limited
+//     to 2 GB.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -166,7 +171,7 @@
 #define ERR403 "\n  ERROR 403: project not open or last run not ended."
 #define ERR405 \
 "\n  ERROR 405: amount of output produced will exceed maximum file size;" \
-"\n             either reduce Ending Date or increase Reporting Time Step."
+"\n             project has too many objects to save in output file."         //(5.1.015)
 
 // API Error Keys
 #define ERR501 "\n API Key Error: Object Type Outside Bonds"
@@ -7,6 +7,7 @@
 //   Press, 1992).
 //
 //   Date:     11/19/13
+//             10/17/26  (batched Newton-Raphson method added)
 //   Author:   L. Rossman
 //-----------------------------------------------------------------------------
 
@@ -16,6 +17,9 @@
 #define SIGN(a,b) ((b) >= 0.0 ? fabs(a) : -fabs(a))
 #define MAXIT 60
 
+static int newtonStep(double* x, double* xlo, double* xhi, double* dx,
+                      double* dxold, double f, double df, double xacc);
+
 
 int findroot_Newton(double x1, double x2, double* rts, double xacc,
                     void (*func) (double x, double* f, double* df, void* p),
@@ -39,7 +43,7 @@ int findroot_Newton(double x1, double x2, double* rts, double xacc,
 {
     int j, n = 0;
     double df, dx, dxold, f, x;
-    double temp, xhi, xlo;
+    double xhi, xlo;
 
     // Initialize the "stepsize before last" and the last step.
     x = *rts;
@@ -53,29 +57,9 @@ int findroot_Newton(double x1, double x2, double* rts, double xacc,
     // Loop over allowed iterations.
     for (j=1; j<=MAXIT; j++)
     {
-        // Bisect if Newton out of range or not decreasing fast enough.
-        if ( ( ( (x-xhi)*df-f)*((x-xlo)*df-f) >= 0.0
-        || (fabs(2.0*f) > fabs(dxold*df) ) ) )
-        {
-            dxold = dx;
-            dx = 0.5*(xhi-xlo);
-            x = xlo + dx;
-            if ( xlo == x ) break;
-        }
-
-        // Newton step acceptable. Take it.
-        else
-        {
-            dxold = dx;
-            dx = f/df;
-            temp = x;
-            x -= dx;
-            if ( temp == x ) break;
-        }
+        // Take a Newton or bisection step, stopping once converged.
+        if ( !newtonStep(&x, &xlo, &xhi, &dx, &dxold, f, df, xacc) ) break;
 
-        // Convergence criterion.
-        if ( fabs(dx) < xacc ) break;
- 
         // Evaluate function. Maintain bracket on the root.
         func(x, &f, &df, p);
         n++;
@@ -88,6 +72,127 @@ int findroot_Newton(double x1, double x2, double* rts, double xacc,
 };
 
 
+void findroot_NewtonBatch(int n, double x1[], double x2[], double rts[],
+                          double xacc, int nFixed, int evals[],
+                          void (*func) (int n, int lanes[], double x[],
+                                        double f[], double df[], void* p),
+                          void* p)
+//
+//  Applies findroot_Newton to n independent functions (or "lanes") at once.
+//  Lane i is bracketed between x1[i] and x2[i] and its root is returned in
+//  rts[i] (which holds the initial guess on entry). func evaluates the
+//  functions and their derivatives at x[i] for each of the n lanes listed
+//  in lanes[], placing the results in f[i] and df[i]. The number of function
+//  evaluations used by each lane (or 0 if the maximum allowed iterations were
+//  exceeded) is returned in evals[].
+//
+// NOTES:
+// 1. n may not exceed FINDROOT_MAXBATCH.
+// 2. The first nFixed iterations are taken in lockstep across all lanes not
+//    yet converged so that func sees the largest possible batches; any lane
+//    still unconverged after that is finished one at a time.
+// 3. Each lane takes exactly the same steps, and returns exactly the same
+//    root, as findroot_Newton would.
+//
+{
+    int i, j, k, m, nActive;
+    int lanes[FINDROOT_MAXBATCH];
+    double f[FINDROOT_MAXBATCH], df[FINDROOT_MAXBATCH];
+    double dx[FINDROOT_MAXBATCH], dxold[FINDROOT_MAXBATCH];
+    double xlo[FINDROOT_MAXBATCH], xhi[FINDROOT_MAXBATCH];
+
+    // Initialize each lane and evaluate its function at the initial guess.
+    for (i=0; i<n; i++)
+    {
+        xlo[i] = x1[i];
+        xhi[i] = x2[i];
+        dxold[i] = fabs(x2[i]-x1[i]);
+        dx[i] = dxold[i];
+        evals[i] = 1;
+        lanes[i] = i;
+    }
+    nActive = n;
+    func(nActive, lanes, rts, f, df, p);
+
+    // Step all unconverged lanes together for the fixed iterations.
+    for (j=1; j<=MAXIT && j<=nFixed && nActive>0; j++)
+    {
+        m = 0;
+        for (k=0; k<nActive; k++)
+        {
+            i = lanes[k];
+            if ( newtonStep(&rts[i], &xlo[i], &xhi[i], &dx[i], &dxold[i],
+                            f[i], df[i], xacc) ) lanes[m++] = i;
+        }
+        nActive = m;
+        if ( nActive == 0 ) break;
+        func(nActive, lanes, rts, f, df, p);
+        for (k=0; k<nActive; k++)
+        {
+            i = lanes[k];
+            evals[i]++;
+            if ( f[i] < 0.0 ) xlo[i] = rts[i];
+            else              xhi[i] = rts[i];
+        }
+    }
+
+    // Finish any remaining lanes one at a time.
+    for (k=0; k<nActive; k++)
+    {
+        i = lanes[k];
+        for (m=j; m<=MAXIT; m++)
+        {
+            if ( !newtonStep(&rts[i], &xlo[i], &xhi[i], &dx[i], &dxold[i],
+                             f[i], df[i], xacc) ) break;
+            func(1, &i, rts, f, df, p);
+            evals[i]++;
+            if ( f[i] < 0.0 ) xlo[i] = rts[i];
+            else              xhi[i] = rts[i];
+        }
+    }
+    for (i=0; i<n; i++) if ( evals[i] > MAXIT ) evals[i] = 0;
+}
+
+
+int newtonStep(double* x, double* xlo, double* xhi, double* dx,
+               double* dxold, double f, double df, double xacc)
+//
+//  Takes a single step of the combined Newton-Raphson / bisection method
+//  used by findroot_Newton, updating the current root estimate x and the
+//  last two step sizes dx and dxold. Returns 0 if the iterations should
+//  stop (because the root has converged or can no longer be refined) or
+//  1 if the function should be evaluated at the new x and the iterations
+//  continued.
+//
+{
+    double temp;
+
+    // Bisect if Newton out of range or not decreasing fast enough.
+    if ( ( ( (*x-*xhi)*df-f)*((*x-*xlo)*df-f) >= 0.0
+    || (fabs(2.0*f) > fabs(*dxold*df) ) ) )
+    {
+        *dxold = *dx;
+        *dx = 0.5*(*xhi-*xlo);
+        *x = *xlo + *dx;
+        if ( *xlo == *x ) return 0;
+    }
+
+    // Newton step acceptable. Take it.
+    else
+    {
+        *dxold = *dx;
+        *dx = f/df;
+        temp = *x;
+        *x -= *dx;
+        if ( temp == *x ) return 0;
+    }
+
+    // Convergence criterion.
+    if ( fabs(*dx) < xacc ) return 0;
+    return 1;
+}
+
+
 double findroot_Ridder(double x1, double x2, double xacc,
 	double (*func)(double, void* p), void* p)
 {
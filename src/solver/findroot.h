@@ -3,10 +3,17 @@
 //
 //   Header file for root finding method contained in findroot.c
 //
-//   Last modified on 11/19/13.
+//   Last modified on 10/17/26.
 //-----------------------------------------------------------------------------
+#define FINDROOT_MAXBATCH 64   // max. number of lanes in a batched solution
+
 int findroot_Newton(double x1, double x2, double* rts, double xacc,
                     void (*func) (double x, double* f, double* df, void* p),
 					void* p);
+void findroot_NewtonBatch(int n, double x1[], double x2[], double rts[],
+                          double xacc, int nFixed, int evals[],
+                          void (*func) (int n, int lanes[], double x[],
+                                        double f[], double df[], void* p),
+                          void* p);
 double findroot_Ridder(double x1, double x2, double xacc,
 	                   double (*func)(double, void* p), void* p);
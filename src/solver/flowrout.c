@@ -8,6 +8,7 @@
 //             03/19/15  (Build 5.1.008)
 //             03/14/17  (Build 5.1.012)
 //             03/01/20  (Build 5.1.014)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -29,6 +30,12 @@
 //   Build 5.1.014:
 //   - Arguments to function link_getLossRate changed.
 //
+//   Build 5.1.015:
+//   - Steady and Kin. Wave links are grouped into levels of independent tasks
+//     that are routed in parallel when more than one thread is used.
+//   - Lone Kin. Wave conduits on the same level are routed in batches by
+//     kinwave_executeBatch(), with a single thread as well.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -42,6 +49,23 @@
 static const double OMEGA   = 0.55;    // under-relaxation parameter
 static const int    MAXITER = 10;      // max. iterations for storage updating
 static const double STOPTOL = 0.005;   // storage updating stopping tolerance
+static const int    KW_BATCH = 64;     // tasks per batched Kin. Wave solution //(5.1.015)
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+//  Level schedule used to route Steady & Kin. Wave flow in parallel. A task
+//  is the run of topo-sorted links leaving the same upstream node; a task's
+//  level is one more than that of any task feeding its upstream node, so
+//  tasks on the same level can be routed concurrently.
+static int   NumLevels;                // number of task levels
+static int*  LevelStart;               // start of each level in LevelTasks
+static int*  LevelTasks;               // sorted link position of each task
+static TGraph Inlets;                  // topo-sorted links entering each node
+static int*  BatchLinks;               // Kin. Wave conduit of each lone-link
+                                       // task (or -1) awaiting batched routing
+static double* BatchQin;               // inflow to each BatchLinks conduit
+static double* BatchQout;              // outflow from each BatchLinks conduit
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -60,6 +84,13 @@ static void   initNodes(void);
 static void   initLinks(int routingModel);
 static void   validateTreeLayout(void);      
 static void   validateGeneralLayout(void);
+static int    createLevels(int links[]);
+static void   freeLevels(void);
+static double routeLink(int i, int links[], int routingModel, double dt);
+static double routeLinkTask(int t, int links[], int routingModel, double dt);
+static double routeBatch(int t1, int t2, double dt);                           //(5.1.015)
+static double getRoutedInflow(int i, int links[], double dt);                  //(5.1.015)
+static void   gatherNodeInflow(int node);
 static void   updateStorageState(int i, int j, int links[], double dt);
 static double getStorageOutflow(int node, int j, int links[], double dt);
 static double getLinkInflow(int link, double dt);
@@ -72,13 +103,16 @@ static int    steadyflow_execute(int link, double* qin, double* qout,
 
 //=============================================================================
 
-void flowrout_init(int routingModel)
+void flowrout_init(int routingModel, int links[])
 //
 //  Input:   routingModel = routing model code
+//           links = array of link indexes in topo-sorted order
 //  Output:  none
 //  Purpose: initializes flow routing system.
 //
 {
+    NumLevels = 0;                                                             //(5.1.015)
+
     // --- initialize for dynamic wave routing 
     if ( routingModel == DW )
     {
@@ -95,7 +129,13 @@ void flowrout_init(int routingModel)
     }
 
     // --- validate network layout for kinematic wave routing
-    else validateTreeLayout();
+    //     and schedule its links for parallel or batched routing
+    else
+    {
+        validateTreeLayout();
+        if ( !ErrorCode && (NumThreads > 1 || routingModel == KW) )            //(5.1.015)
+            createLevels(links);                                               //(5.1.015)
+    }
 
     // --- initialize node & link volumes
     initNodes();
@@ -112,6 +152,7 @@ void  flowrout_close(int routingModel)
 //
 {
     if ( routingModel == DW ) dynwave_close();
+    freeLevels();                                                              //(5.1.015)
 }
 
 //=============================================================================
@@ -143,9 +184,7 @@ int flowrout_execute(int links[], int routingModel, double tStep)
 //
 {
     int   i, j;
-    int   n1;                          // upstream node of link
-    double qin;                        // link inflow (cfs)
-    double qout;                       // link outflow (cfs)
+    int   level;                       // task level                           //(5.1.015)
     double steps;                      // computational step count
 
     // --- set overflows to drain any ponded water
@@ -167,27 +206,45 @@ int flowrout_execute(int links[], int routingModel, double tStep)
         return dynwave_execute(tStep);
     }
 
-    // --- otherwise examine each link, moving from upstream to downstream
+    // --- route each level of link tasks concurrently, moving from
+    //     upstream to downstream                                              //(5.1.015)
     steps = 0.0;
-    for (i = 0; i < Nobjects[LINK]; i++)
+    if ( NumLevels > 0 )
     {
-        // --- see if upstream node is a storage unit whose state needs updating
-        j = links[i];
-        n1 = Link[j].node1;
-        if ( Node[n1].type == STORAGE ) updateStorageState(n1, i, links, tStep);
-
-        // --- retrieve inflow at upstream end of link
-        qin  = getLinkInflow(j, tStep);
+#pragma omp parallel num_threads(NumThreads) private(level)
+{
+        for (level = 0; level < NumLevels; level++)
+        {
+            #pragma omp for schedule(dynamic, 16) reduction(+:steps)
+            for (i = LevelStart[level]; i < LevelStart[level+1]; i++)
+            {
+                steps += routeLinkTask(i, links, routingModel, tStep);
+            }
 
-        // route flow through link
-        if ( routingModel == SF )
-            steps += steadyflow_execute(j, &qin, &qout, tStep);
-        else steps += kinwave_execute(j, &qin, &qout, tStep);
-        Link[j].newFlow = qout;
+            // --- route the level's lone Kin. Wave conduits in batches
+            if ( routingModel != KW ) continue;
+            #pragma omp for schedule(dynamic, 1) reduction(+:steps)
+            for (i = LevelStart[level]; i < LevelStart[level+1]; i += KW_BATCH)
+            {
+                steps += routeBatch(i, MIN(i+KW_BATCH, LevelStart[level+1]),
+                                    tStep);
+            }
+        }
+}
+        // --- add flow into nodes that have no outflow links
+        for (j = 0; j < Nobjects[NODE]; j++)
+        {
+            if ( Node[j].degree <= 0 ) gatherNodeInflow(j);
+        }
+    }
 
-        // adjust outflow at upstream node and inflow at downstream node
-        Node[ Link[j].node1 ].outflow += qin;
-        Node[ Link[j].node2 ].inflow += qout;
+    // --- otherwise examine each link, moving from upstream to downstream
+    else for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        // --- route flow through link & add its outflow to downstream node
+        steps += routeLink(i, links, routingModel, tStep);
+        j = links[i];
+        Node[ Link[j].node2 ].inflow += Link[j].newFlow;
     }
     if ( Nobjects[LINK] > 0 ) steps /= Nobjects[LINK];
 
@@ -199,6 +256,247 @@ int flowrout_execute(int links[], int routingModel, double tStep)
 
 //=============================================================================
 
+int createLevels(int links[])
+//
+//  Input:   links = array of link indexes in topo-sorted order
+//  Output:  returns an error code
+//  Purpose: partitions the topo-sorted links into tasks grouped by level
+//           for parallel Steady or Kin. Wave flow routing.
+//
+{
+    int i, k, n, n1, n2;
+    int numTasks = 0;
+    int* taskLevel;
+    int* nodeLevel;
+
+    // --- allocate memory
+    NumLevels = 0;
+    LevelTasks = (int *) calloc(Nobjects[LINK], sizeof(int));
+    LevelStart = (int *) calloc(Nobjects[LINK]+1, sizeof(int));
+    BatchLinks = (int *) calloc(Nobjects[LINK], sizeof(int));
+    BatchQin   = (double *) calloc(Nobjects[LINK], sizeof(double));
+    BatchQout  = (double *) calloc(Nobjects[LINK], sizeof(double));
+    taskLevel  = (int *) calloc(Nobjects[LINK], sizeof(int));
+    nodeLevel  = (int *) calloc(Nobjects[NODE], sizeof(int));
+    if ( !LevelTasks || !LevelStart ||
+         !BatchLinks || !BatchQin || !BatchQout ||
+         !toposort_createGraph(&Inlets, INLINK_GRAPH, links) ||
+         !taskLevel || !nodeLevel )
+    {
+        FREE(taskLevel);
+        FREE(nodeLevel);
+        freeLevels();
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return ErrorCode;
+    }
+
+    // --- assign each task the level of its upstream node and push
+    //     that level + 1 onto the task's downstream nodes
+    for (n = 0; n < Nobjects[NODE]; n++) nodeLevel[n] = 0;
+    i = 0;
+    while ( i < Nobjects[LINK] )
+    {
+        n1 = Link[links[i]].node1;
+        k = nodeLevel[n1];
+        taskLevel[i] = k;
+        LevelStart[k+1]++;
+        NumLevels = MAX(NumLevels, k+1);
+        numTasks++;
+        for ( ; i < Nobjects[LINK] && Link[links[i]].node1 == n1; i++)
+        {
+            n2 = Link[links[i]].node2;
+            nodeLevel[n2] = MAX(nodeLevel[n2], k+1);
+        }
+    }
+
+    // --- bucket the tasks by level, preserving topo-sorted order
+    //     (nodeLevel again serves as a fill position)
+    for (k = 0; k < NumLevels; k++) LevelStart[k+1] += LevelStart[k];
+    for (k = 0; k < NumLevels; k++) nodeLevel[k] = LevelStart[k];
+    i = 0;
+    while ( i < Nobjects[LINK] )
+    {
+        k = taskLevel[i];
+        LevelTasks[nodeLevel[k]++] = i;
+        n1 = Link[links[i]].node1;
+        for ( ; i < Nobjects[LINK] && Link[links[i]].node1 == n1; i++);
+    }
+    FREE(taskLevel);
+    FREE(nodeLevel);
+    return 0;
+}
+
+//=============================================================================
+
+void freeLevels()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees memory used for the parallel link routing schedule.
+//
+{
+    NumLevels = 0;
+    FREE(LevelTasks);
+    FREE(LevelStart);
+    FREE(BatchLinks);
+    FREE(BatchQin);
+    FREE(BatchQout);
+    toposort_deleteGraph(&Inlets);
+}
+
+//=============================================================================
+
+double routeLink(int i, int links[], int routingModel, double dt)
+//
+//  Input:   i = position in links array
+//           links = array of topo-sorted link indexes
+//           routingModel = SF or KW
+//           dt = routing time step (sec)
+//  Output:  returns number of computational steps taken
+//  Purpose: routes flow through the link at position i of the sorted links
+//           under Steady or Kin. Wave routing.
+//
+{
+    int    j = links[i];
+    int    steps;                      // computational step count
+    double qin;                        // link inflow (cfs)
+    double qout;                       // link outflow (cfs)
+
+    // --- retrieve inflow at upstream end of link
+    qin  = getRoutedInflow(i, links, dt);                                      //(5.1.015)
+
+    // route flow through link
+    if ( routingModel == SF )
+        steps = steadyflow_execute(j, &qin, &qout, dt);
+    else steps = kinwave_execute(j, &qin, &qout, dt);
+    Link[j].newFlow = qout;
+
+    // adjust outflow at upstream node
+    Node[Link[j].node1].outflow += qin;                                        //(5.1.015)
+    return steps;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double getRoutedInflow(int i, int links[], double dt)
+//
+//  Input:   i = position in links array
+//           links = array of topo-sorted link indexes
+//           dt = routing time step (sec)
+//  Output:  returns link inflow (cfs)
+//  Purpose: updates the upstream node of the link at position i of the
+//           sorted links if it is a storage unit and then finds the
+//           link's inflow.
+//
+{
+    int    j = links[i];
+    int    n1 = Link[j].node1;         // upstream node of link
+
+    // --- see if upstream node is a storage unit whose state needs updating
+    if ( Node[n1].type == STORAGE ) updateStorageState(n1, i, links, dt);
+    return getLinkInflow(j, dt);
+}
+
+//=============================================================================
+
+double routeLinkTask(int t, int links[], int routingModel, double dt)
+//
+//  Input:   t = task index in LevelTasks
+//           links = array of topo-sorted link indexes
+//           routingModel = SF or KW
+//           dt = routing time step (sec)
+//  Output:  returns number of computational steps taken
+//  Purpose: routes flow through the run of links leaving the same upstream
+//           node, or finds the inflow of a task's lone Kin. Wave conduit
+//           so that it can be routed along with others by routeBatch.
+//
+//  Note: all tasks on lower levels have already been routed, so the flows
+//        entering the upstream node are final and only this task writes
+//        to that node.
+{
+    int    i = LevelTasks[t];
+    int    j = links[i];
+    int    n1 = Link[j].node1;
+    double steps = 0.0;
+
+    gatherNodeInflow(n1);
+    BatchLinks[t] = -1;
+
+    // --- defer routing of a lone Kin. Wave conduit
+    if ( routingModel == KW && Link[j].type == CONDUIT &&
+         Link[j].xsect.type != DUMMY &&
+         (i+1 == Nobjects[LINK] || Link[links[i+1]].node1 != n1) )
+    {
+        BatchQin[t] = getRoutedInflow(i, links, dt);
+        BatchLinks[t] = j;
+        return 0.0;
+    }
+
+    // --- otherwise route each of the task's links in turn
+    for ( ; i < Nobjects[LINK] && Link[links[i]].node1 == n1; i++)
+    {
+        steps += routeLink(i, links, routingModel, dt);
+    }
+    return steps;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double routeBatch(int t1, int t2, double dt)
+//
+//  Input:   t1, t2 = range of task indexes in LevelTasks
+//           dt = routing time step (sec)
+//  Output:  returns number of computational steps taken
+//  Purpose: routes the lone Kin. Wave conduits of tasks t1 to t2-1
+//           together.
+//
+{
+    int    t, m = t1;
+    double steps;
+
+    // --- pack the tasks' deferred conduits at the start of the range
+    for (t = t1; t < t2; t++)
+    {
+        if ( BatchLinks[t] < 0 ) continue;
+        BatchLinks[m] = BatchLinks[t];
+        BatchQin[m] = BatchQin[t];
+        m++;
+    }
+    if ( m == t1 ) return 0.0;
+
+    // --- route the conduits and update their upstream nodes
+    steps = kinwave_executeBatch(m-t1, &BatchLinks[t1], &BatchQin[t1],
+                                 &BatchQout[t1], dt);
+    for (t = t1; t < m; t++)
+    {
+        Link[BatchLinks[t]].newFlow = BatchQout[t];
+        Node[Link[BatchLinks[t]].node1].outflow += BatchQin[t];
+    }
+    return steps;
+}
+
+//=============================================================================
+
+void gatherNodeInflow(int n)
+//
+//  Input:   n = node index
+//  Output:  none
+//  Purpose: adds the outflows of the links entering a node to its inflow.
+//
+{
+    int k;
+    for (k = Inlets.start[n]; k < Inlets.start[n+1]; k++)
+    {
+        Node[n].inflow += Link[Inlets.links[k]].newFlow;
+    }
+}
+
+//=============================================================================
+
 void validateTreeLayout()
 //
 //  Input:   none
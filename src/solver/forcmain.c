@@ -4,9 +4,18 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Special Non-Manning Force Main functions
+//
+//   Build 5.1.015:
+//   - Terms of the friction slope that depend only on a force main's
+//     full-flow geometry are computed once per run.
+//   - An optional table of Darcy-Weisbach friction factors indexed by
+//     Reynolds number and relative roughness added (FORCE_MAIN_TABLE).
+//   - Friction slopes of a batch of force mains found together
+//     (forcemain_getFricSlopes).
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -19,18 +28,55 @@
 static const double VISCOS = 1.1E-5;   // Kinematic viscosity of water
                                        // @ 20 deg C (sq ft/sec)
 
+// --- friction factor table spacing in log10(Reynolds No.) and in             //(5.1.015)
+//     log10(relative roughness); bilinear interpolation of 1/sqrt(f)
+//     on this grid is within 0.05% of the Swamee-Jain friction factor
+#define  FRIC_TBL_NRE  129             // Reynolds Nos. from 10^3.6 to 10^10   //(5.1.015)
+#define  FRIC_TBL_NRR  113             // rel. roughness from 10^-8 to 10^-1   //(5.1.015)
+static const double LOG_RE_MIN  = 3.6;                                         //(5.1.015)
+static const double LOG_RE_STEP = 0.05;                                        //(5.1.015)
+static const double LOG_RR_MIN  = -8.0;                                        //(5.1.015)
+static const double LOG_RR_STEP = 0.0625;                                      //(5.1.015)
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct                                                                 //(5.1.015)
+{
+    double  hrad;             // full hydraulic radius (ft)
+    double  hwFactor;         // H-W roughness factor / hrad^1.1667
+    double  eTerm;            // D-W roughness height / 3.7 / diameter
+    double  f4000;            // D-W friction factor at Reynolds No. 4000
+    int     col;              // friction table column below rel. roughness
+                              // (-1 if off the table)
+    double  colWt;            // weight given to the next column
+}  TFricTerms;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TFricTerms* FricTerms;          // friction terms of each conduit       //(5.1.015)
+static double FricTbl[FRIC_TBL_NRE][FRIC_TBL_NRR]; // 1/sqrt(friction factor)  //(5.1.015)
+static int    FricTblBuilt;            // TRUE once FricTbl is filled          //(5.1.015)
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 // forcemain_getEquivN
 // forcemain_getRoughFactor
 // forcemain_getFricSlope
+// forcemain_getFricSlopes               (called by dwflow_findConduitFlows)   //(5.1.015)
+// forcemain_init                        (called by dynwave_init)              //(5.1.015)
+// forcemain_close                       (called by dynwave_close)             //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static double forcemain_getFricFactor(double e, double hrad, double re);
 static double forcemain_getReynolds(double v, double hrad);
+static double forcemain_getTermsFricFactor(TFricTerms* t, double re);          //(5.1.015)
+static TFricTerms* forcemain_getFricTerms(int j, double hrad);                 //(5.1.015)
+static void   forcemain_buildFricTbl(void);                                    //(5.1.015)
 
 //=============================================================================
 
@@ -85,6 +131,8 @@ double forcemain_getRoughFactor(int j, double lengthFactor)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double forcemain_getFricSlope(int j, double v, double hrad)
 //
 //  Input:   j = link index
@@ -94,22 +142,126 @@ double forcemain_getFricSlope(int j, double v, double hrad)
 //  Purpose: computes the headloss per unit length used in dynamic wave
 //           flow routing for a pressurized force main using either the
 //           Hazen-Williams or Darcy-Weisbach flow equations.
+//
+{
+    double slope;                                                              //(5.1.015)
+    forcemain_getFricSlopes(1, &j, &v, &hrad, &slope);                         //(5.1.015)
+    return slope;                                                              //(5.1.015)
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void forcemain_getFricSlopes(int n, int links[], double v[], double hrad[],
+                             double slope[])
+//
+//  Input:   n = number of force mains
+//           links = link index of each force main
+//           v = flow velocity in each force main (ft/sec)
+//           hrad = hydraulic radius of each force main (ft)
+//  Output:  slope = friction slope of each force main
+//  Purpose: computes the headloss per unit length of a batch of pressurized
+//           force mains using either the Hazen-Williams or Darcy-Weisbach
+//           flow equations.
 //  Note:    the pipe's roughness factor was saved in xsect.sBot in
 //           conduit_validate() in LINK.C.
 //
 {
+    int    i;
     double re, f;
-    TXsect xsect = Link[j].xsect;
+    TXsect* xsect;
+    TFricTerms* t;
+
     switch ( ForceMainEqn )
     {
       case H_W:
-        return xsect.sBot * pow(v, 0.852) / pow(hrad, 1.1667);
+        for (i = 0; i < n; i++)
+        {
+            t = forcemain_getFricTerms(links[i], hrad[i]);
+            if ( t ) slope[i] = t->hwFactor * pow(v[i], 0.852);
+            else
+            {
+                xsect = &Link[links[i]].xsect;
+                slope[i] = xsect->sBot * pow(v[i], 0.852) /
+                           pow(hrad[i], 1.1667);
+            }
+        }
+        break;
       case D_W:
-        re = forcemain_getReynolds(v, hrad);
-        f = forcemain_getFricFactor(xsect.rBot, hrad, re);
-        return f * xsect.sBot * v / hrad;
+        for (i = 0; i < n; i++)
+        {
+            xsect = &Link[links[i]].xsect;
+            t = forcemain_getFricTerms(links[i], hrad[i]);
+            re = forcemain_getReynolds(v[i], hrad[i]);
+            if ( t ) f = forcemain_getTermsFricFactor(t, re);
+            else     f = forcemain_getFricFactor(xsect->rBot, hrad[i], re);
+            slope[i] = f * xsect->sBot * v[i] / hrad[i];
+        }
+        break;
+      default:
+        for (i = 0; i < n; i++) slope[i] = 0.0;
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void forcemain_init()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: computes the terms of each force main's friction slope that
+//           depend only on its full-flow geometry.
+//  Note:    the terms are computed after conduit_validate() has saved the
+//           pipe's roughness factor in xsect.sBot.
+//
+{
+    int    j, k;
+    double hrad, w;
+    TXsect* xsect;
+
+    FricTerms = NULL;
+    if ( Nlinks[CONDUIT] == 0 ) return;
+    FricTerms = (TFricTerms *) calloc(Nlinks[CONDUIT], sizeof(TFricTerms));
+    if ( FricTerms == NULL ) return;
+    if ( ForceMainEqn == D_W && ForceMainTbl ) forcemain_buildFricTbl();
+
+    for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        xsect = &Link[j].xsect;
+        if ( Link[j].type != CONDUIT || xsect->type != FORCE_MAIN ) continue;
+        k = Link[j].subIndex;
+        hrad = xsect->rFull;
+        FricTerms[k].hrad = hrad;
+        FricTerms[k].hwFactor = xsect->sBot / pow(hrad, 1.1667);
+        FricTerms[k].eTerm = xsect->rBot/3.7/(4.0*hrad);
+        FricTerms[k].f4000 = forcemain_getFricFactor(xsect->rBot, hrad, 4000.0);
+
+        // --- locate the pipe's relative roughness in the friction table
+        FricTerms[k].col = -1;
+        if ( ForceMainEqn != D_W || !ForceMainTbl || xsect->rBot <= 0.0 )
+            continue;
+        w = (log10(xsect->rBot / (4.0*hrad)) - LOG_RR_MIN) / LOG_RR_STEP;
+        if ( w < 0.0 || w > FRIC_TBL_NRR - 1 ) continue;
+        FricTerms[k].col = MIN((int)w, FRIC_TBL_NRR - 2);
+        FricTerms[k].colWt = w - FricTerms[k].col;
     }
-    return 0.0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void forcemain_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used for force main friction terms.
+//
+{
+    FREE(FricTerms);
 }
 
 //=============================================================================
@@ -155,3 +307,96 @@ double forcemain_getFricFactor(double e, double hrad, double re)
     }
     return f;
 }
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+TFricTerms* forcemain_getFricTerms(int j, double hrad)
+//
+//  Input:   j = link index
+//           hrad = hydraulic radius (ft)
+//  Output:  returns the friction terms saved for a force main, or NULL if
+//           they do not apply
+//  Purpose: retrieves the friction terms of a force main whose hyd. radius
+//           is its full one (the radius used whenever the pipe flows full).
+//
+{
+    if ( FricTerms && FricTerms[Link[j].subIndex].hrad == hrad )
+        return &FricTerms[Link[j].subIndex];
+    return NULL;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double forcemain_getTermsFricFactor(TFricTerms* t, double re)
+//
+//  Input:   t = friction terms of a force main flowing full
+//           re = Reynolds number
+//  Output:  returns a Darcy-Weisbach friction factor
+//  Purpose: computes the same friction factor as forcemain_getFricFactor
+//           from a force main's saved terms, looking it up in the friction
+//           factor table instead when that option is used.
+//
+{
+    int    i, c;
+    double f, u, a, b;
+
+    if ( re < 10.0 ) re = 10.0;
+    if ( re <= 2000.0 ) return 64.0 / re;
+    if ( re < 4000.0 )
+        return 0.032 + (t->f4000 - 0.032) * ( re - 2000.0) / 2000.0;
+
+    // --- bilinear interpolation of 1/sqrt(f) within the table
+    if ( t->col >= 0 && re < 1.0e10 )
+    {
+        u = (log10(re) - LOG_RE_MIN) / LOG_RE_STEP;
+        i = MIN((int)u, FRIC_TBL_NRE - 2);
+        a = u - i;
+        c = t->col;
+        b = t->colWt;
+        f = (1.0 - a) * ((1.0 - b) * FricTbl[i][c] + b * FricTbl[i][c+1]) +
+            a * ((1.0 - b) * FricTbl[i+1][c] + b * FricTbl[i+1][c+1]);
+        return 1.0 / (f * f);
+    }
+
+    // --- Swamee and Jain approximation
+    f = t->eTerm;
+    if ( re < 1.0e10 ) f += 5.74/pow(re, 0.9);
+    f = log10(f);
+    return 0.25 / f / f;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void forcemain_buildFricTbl()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: tabulates 1/sqrt(f) for the Swamee and Jain friction factor f
+//           over a grid of Reynolds numbers and relative roughnesses.
+//
+//  Since 1/sqrt(f) = -2*log10(e/3.7/D + 5.74/Re^0.9) varies smoothly in
+//  both log10(Re) and log10(e/D), it interpolates more accurately than f.
+//  The table never changes so it is built only once.
+//
+{
+    int    i, c;
+    double re, rr;
+
+    if ( FricTblBuilt ) return;
+    for (i = 0; i < FRIC_TBL_NRE; i++)
+    {
+        re = pow(10.0, LOG_RE_MIN + i * LOG_RE_STEP);
+        for (c = 0; c < FRIC_TBL_NRR; c++)
+        {
+            rr = pow(10.0, LOG_RR_MIN + c * LOG_RR_STEP);
+            FricTbl[i][c] = -2.0 * log10(rr/3.7 + 5.74/pow(re, 0.9));
+        }
+    }
+    FricTblBuilt = TRUE;
+}
@@ -9,6 +9,7 @@
 //             08/05/15  (Build 5.1.010)
 //             05/10/18  (Build 5.1.013)
 //             03/01/20  (Build 5.1.014)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -31,6 +32,21 @@
 //   Build 5.1.014:
 //   - Arguments to link_getLossRate function changed.
 //
+//   Build 5.1.015:
+//   - Inflow schedule functions added to the inflow module.
+//   - Adaptive geometry table functions added.
+//   - Link-node incidence graph functions added.
+//   - Functions for reading blocks of binary output results added.
+//   - Fast fixed-point number formatting functions added to report module.
+//   - Routing interface file conversion function added.
+//   - Function for appending entries to a time series at run time added.
+//   - Functions for saving & restoring a project's state in memory added.
+//   - Force main initialization & closing functions added.
+//   - Batched conduit flow and cross section geometry functions added.
+//   - Batched Kin. Wave routing function added.
+//   - Batched force main friction slope function added.
+//   - Rainfall data line scanning function added.
+//
 //-----------------------------------------------------------------------------
 
 void     project_open(char *f1, char *f2, char *f3);
@@ -61,6 +77,8 @@ int     input_readData(void);
 int     report_readOptions(char* tok[], int ntoks);
 
 void    report_writeLine(char* line);
+int     report_formatFixed(char* s, double x, int width, int prec);          //(5.1.015)
+void    report_writeFixed(char* prefix, double x, int width, int prec);       //(5.1.015)
 void    report_writeSysTime(void);
 void    report_writeLogo(void);
 void    report_writeTitle(void);
@@ -111,6 +129,7 @@ DateTime climate_getNextEvapDate(void);
 //-----------------------------------------------------------------------------
 void    rain_open(void);
 void    rain_close(void);
+int     rain_scanLine(char* s, const char* format, ...);                       //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Snowmelt Processing Methods
@@ -159,6 +178,8 @@ void    output_readDateTime(int period, DateTime *aDate);
 void    output_readSubcatchResults(int period, int area);
 void    output_readNodeResults(int period, int node);
 void    output_readLinkResults(int period, int link);
+int     output_getNumVars(int objType);                                        //(5.1.015)
+int     output_readResultsBlock(int objType, int index, int n, float* x);      //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Groundwater Methods
@@ -212,13 +233,17 @@ double  landuse_getCoPollutLoad(int p, double washoff[]);
 //-----------------------------------------------------------------------------
 //   Flow/Quality Routing Methods
 //-----------------------------------------------------------------------------
-void    flowrout_init(int routingModel);
+void    flowrout_init(int routingModel, int links[]);
 void    flowrout_close(int routingModel);
 double  flowrout_getRoutingStep(int routingModel, double fixedStep);
 int     flowrout_execute(int links[], int routingModel, double tStep);
 
 void    toposort_sortLinks(int links[]);
+int     toposort_createGraph(TGraph* graph, int graphType, int links[]);       //(5.1.015)
+void    toposort_deleteGraph(TGraph* graph);                                   //(5.1.015)
 int     kinwave_execute(int link, double* qin, double* qout, double tStep);
+int     kinwave_executeBatch(int n, int links[], double qin[], double qout[],  //(5.1.015)
+        double tStep);                                                         //(5.1.015)
 
 void    dynwave_validate(void);
 void    dynwave_init(void);
@@ -226,6 +251,8 @@ void    dynwave_close(void);
 double  dynwave_getRoutingStep(double fixedStep);
 int     dynwave_execute(double tStep);
 void    dwflow_findConduitFlow(int j, int steps, double omega, double dt);
+void    dwflow_findConduitFlows(int links[], int n, int steps, double omega,   //(5.1.015)
+        double dt);                                                            //(5.1.015)
 
 void    qualrout_init(void);
 void    qualrout_execute(double tStep);
@@ -375,6 +402,10 @@ double  inflow_getPatternFactor(int p, int month, int day, int hour);
 void    inflow_deleteExtInflows(int node);
 void    inflow_deleteDwfInflows(int node);
 
+int     inflow_openSchedule(void);
+void    inflow_closeSchedule(void);
+void    inflow_addScheduledInflows(DateTime aDate);
+
 //-----------------------------------------------------------------------------
 //   Routing Interface File Methods
 //-----------------------------------------------------------------------------
@@ -386,12 +417,17 @@ int     iface_getIfaceNode(int index);
 double  iface_getIfaceFlow(int index);
 double  iface_getIfaceQual(int index, int pollut);
 void    iface_saveOutletResults(DateTime reportDate, FILE* file);
+int     iface_convertFile(char* inFile, char* outFile);                        //(5.1.015)
+void    iface_deletePipes(void);                                               //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Hot Start File Methods
 //-----------------------------------------------------------------------------
 int     hotstart_open(void);
 void    hotstart_close(void);
+int     hotstart_saveState(void);                                              //(5.1.015)
+int     hotstart_useState(void);                                               //(5.1.015)
+void    hotstart_deleteState(void);                                            //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Conveyance System Link Methods
@@ -439,7 +475,17 @@ double  xsect_getdSdA(TXsect* xsect, double area);
 double  xsect_getAofY(TXsect* xsect, double y);
 double  xsect_getRofY(TXsect* xsect, double y);
 double  xsect_getWofY(TXsect* xsect, double y);
+int     xsect_getAandRofY(int type, TXsect* xsect[], int n, double y[],        //(5.1.015)
+        double a[], double r[]);                                               //(5.1.015)
+int     xsect_getSanddSdA(int type, TXsect* xsect[], int n, double a[],        //(5.1.015)
+        double s[], double dsda[]);                                            //(5.1.015)
 double  xsect_getYcrit(TXsect* xsect, double q);
+void    xsect_deleteTables(void);                                            //(5.1.015)
+int     xsect_createGeomTbl(TGeomTbl* tbl, int nBreaks, double yBreaks[],       //(5.1.015)
+        double aScale, int (*getGeom)(int n, double y[], double a[],
+        double r[], double w[], void* p), void* p);
+void    xsect_deleteGeomTbl(TGeomTbl* tbl);                                   //(5.1.015)
+double  xsect_getGeomTblSmax(TGeomTbl* tbl, double* aMax);                     //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Culvert/Roadway Methods
@@ -454,6 +500,10 @@ double  roadway_getInflow(int link, double dir, double hcrest, double h1,
 double  forcemain_getEquivN(int j, int k);
 double  forcemain_getRoughFactor(int j, double lengthFactor);
 double  forcemain_getFricSlope(int j, double v, double hrad);
+void    forcemain_getFricSlopes(int n, int links[], double v[], double hrad[], //(5.1.015)
+        double slope[]);                                                       //(5.1.015)
+void    forcemain_init(void);                                                  //(5.1.015)
+void    forcemain_close(void);                                                 //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Cross-Section Transect Methods
@@ -467,6 +517,7 @@ void    transect_validate(int j);
 //   Custom Shape Cross-Section Methods
 //-----------------------------------------------------------------------------
 int     shape_validate(TShape *shape, TTable *curve);
+void    shape_delete(TShape *shape);                                           //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //   Control Rule Methods
@@ -484,6 +535,8 @@ int     table_readCurve(char* tok[], int ntoks);
 int     table_readTimeseries(char* tok[], int ntoks);
 
 int     table_addEntry(TTable* table, double x, double y);
+int     table_appendEntries(TTable* table, int n, double* x, double* y);       //(5.1.015)
+int     table_replaceEntries(TTable* table, int n, double* x, double* y);      //(5.1.015)
 int     table_getFirstEntry(TTable* table, double* x, double* y);
 int     table_getNextEntry(TTable* table, double* x, double* y);
 void    table_deleteEntries(TTable* table);
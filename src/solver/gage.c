@@ -6,6 +6,7 @@
 //   Date:     03/20/10  (Build 5.1.001)
 //             09/15/14  (Build 5.1.007)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Rain gage functions.
@@ -16,6 +17,12 @@
 //   Build 5.1.013:
 //   - Validation no longer performed on unused gages.
 //
+//   Build 5.1.015:
+//   - Rainfall appended to a gage's time series after the gage reached the end
+//     of its record is picked up.
+//   - A rain file gage whose simulation starts well into its record finds its
+//     starting record by a search of the rain file.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -45,6 +52,9 @@ static int    readGageSeriesFormat(char* tok[], int ntoks, double x[]);
 static int    readGageFileFormat(char* tok[], int ntoks, double x[]);
 static int    getFirstRainfall(int gage);
 static int    getNextRainfall(int gage);
+static int    resumeRainfall(int gage);                                        //(5.1.015)
+static int    skipRainfall(int gage, DateTime t);                              //(5.1.015)
+static int    readRainRecd(int gage, long k, DateTime* date, float* v);        //(5.1.015)
 static double convertRainfall(int gage, double rain);
 
 
@@ -315,6 +325,8 @@ void  gage_initState(int j)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void gage_setState(int j, DateTime t)
 //
 //  Input:   j = rain gage index
@@ -374,7 +386,8 @@ void gage_setState(int j, DateTime t)
         }
 
         // --- no rainfall if t >= interval end date & no next interval exists
-        if ( Gage[j].nextDate == NO_DATE)
+        //     (unless rainfall was appended to the gage's time series)        //(5.1.015)
+        if ( Gage[j].nextDate == NO_DATE && !resumeRainfall(j) )               //(5.1.015)
         {
             Gage[j].rainfall = 0.0;
             return;
@@ -387,6 +400,9 @@ void gage_setState(int j, DateTime t)
             return;
         }
 
+        // --- move past file records whose intervals end by t                 //(5.1.015)
+        if ( Gage[j].dataSource == RAIN_FILE ) skipRainfall(j, t);             //(5.1.015)
+
         // --- otherwise update next rainfall interval date
         Gage[j].startDate = Gage[j].nextDate;
         Gage[j].endDate = datetime_addSeconds(Gage[j].startDate,
@@ -597,6 +613,147 @@ int getNextRainfall(int j)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int resumeRainfall(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns 1 if the gage has a next rainfall; 0 if not
+//  Purpose: picks up rainfall appended to a gage's time series (through
+//           the toolkit API) after the gage reached the end of its record.
+//
+{
+    TTable* tseries;
+
+    if ( Gage[j].dataSource != RAIN_TSERIES || Gage[j].tSeries < 0 ) return 0;
+    tseries = &Tseries[Gage[j].tSeries];
+
+    // --- the series' current entry must still be the last one the gage
+    //     read (another object using the series could have moved it back)
+    if ( tseries->thisEntry == NULL || tseries->thisEntry->next == NULL ||
+         tseries->thisEntry->x < Gage[j].startDate ) return 0;
+
+    if ( getNextRainfall(j) ) return 1;
+    Gage[j].nextDate = NO_DATE;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int skipRainfall(int j, DateTime t)
+//
+//  Input:   j = rain gage index
+//           t = a calendar date/time
+//  Output:  returns 1 if the gage's next rainfall was moved ahead; 0 if not
+//  Purpose: makes a rain file gage's next rainfall the last one whose
+//           interval ends by date t.
+//
+//  Note: gage_setState would march through every record before that one,
+//        which is slow when a simulation starts well into a long record.
+//        The records of a gage are in date order on the rain interface
+//        file, so they are searched in place, first with steps that double
+//        in size from the current record and then by bisection. Dates are
+//        checked as they are read and the search is abandoned if they are
+//        found out of order.
+{
+    long     k0;                       // index of next rainfall's record
+    long     n;                        // number of records for the gage
+    long     lo, hi, k, step;
+    DateTime loDate, hiDate, date;
+    float    v;
+    long     filePos = Gage[j].currentFilePos;
+    DateTime nextDate = Gage[j].nextDate;
+    double   nextRainfall = Gage[j].nextRainfall;
+    long     recdSize = sizeof(DateTime) + sizeof(float);
+
+    // --- there is nothing to skip unless the interval of the record that
+    //     follows the next rainfall also ends by t
+    if ( !Frain.file || Gage[j].rainType == CUMULATIVE_RAINFALL ) return 0;
+    if ( datetime_addSeconds(nextDate, Gage[j].rainInterval) > t ) return 0;
+    k0 = (filePos - Gage[j].startFilePos) / recdSize - 1;
+    n = (Gage[j].endFilePos - Gage[j].startFilePos) / recdSize;
+    if ( k0 < 0 || k0 + 1 >= n ) return 0;
+
+    // --- bracket the last record whose interval ends by t between
+    //     records lo (ends by t) and hi (ends after t or is past the end)
+    lo = k0;
+    loDate = nextDate;
+    hiDate = loDate;
+    for (step = 1; ; step *= 2)
+    {
+        hi = lo + step;
+        if ( hi >= n )
+        {
+            hi = n;
+            break;
+        }
+        if ( !readRainRecd(j, hi, &hiDate, &v) || hiDate < loDate ) return 0;
+        if ( datetime_addSeconds(hiDate, Gage[j].rainInterval) > t ) break;
+        lo = hi;
+        loDate = hiDate;
+    }
+
+    // --- narrow the bracket down to that record
+    while ( hi - lo > 1 )
+    {
+        k = (lo + hi) / 2;
+        if ( !readRainRecd(j, k, &date, &v) ) return 0;
+        if ( date < loDate || (hi < n && date > hiDate) ) return 0;
+        if ( datetime_addSeconds(date, Gage[j].rainInterval) > t )
+        {
+            hi = k;
+            hiDate = date;
+        }
+        else
+        {
+            lo = k;
+            loDate = date;
+        }
+    }
+
+    // --- back up to a record with non-zero rainfall
+    for (k = lo; k > k0; k--)
+    {
+        if ( !readRainRecd(j, k, &date, &v) ) return 0;
+        if ( v != 0.0f ) break;
+    }
+    if ( k == k0 ) return 0;
+
+    // --- make that record the next rainfall (restoring the current one
+    //     if it is not read back with non-zero rainfall)
+    Gage[j].currentFilePos = Gage[j].startFilePos + k * recdSize;
+    if ( getNextRainfall(j) && Gage[j].nextDate == date ) return 1;
+    Gage[j].currentFilePos = filePos;
+    Gage[j].nextDate = nextDate;
+    Gage[j].nextRainfall = nextRainfall;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readRainRecd(int j, long k, DateTime* date, float* v)
+//
+//  Input:   j = rain gage index
+//           k = index of one of the gage's records on the rain file
+//  Output:  date = start date of the record's rainfall interval
+//           v = the record's rainfall volume (inches)
+//           returns 1 if the record was read; 0 if not
+//  Purpose: reads a record of a gage's rainfall from the rain interface file.
+//
+{
+    long pos = Gage[j].startFilePos + k * (sizeof(DateTime) + sizeof(float));
+    if ( fseek(Frain.file, pos, SEEK_SET) != 0 ) return 0;
+    if ( fread(date, sizeof(DateTime), 1, Frain.file) != 1 ) return 0;
+    if ( fread(v, sizeof(float), 1, Frain.file) != 1 ) return 0;
+    return 1;
+}
+
+//=============================================================================
+
 double convertRainfall(int j, double r)
 //
 //  Input:   j = rain gage index
@@ -10,6 +10,7 @@
 //            08/01/16  (Build 5.1.011)
 //            03/14/17  (Build 5.1.012)
 //            05/10/18  (Build 5.1.013)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Global Variables
@@ -35,6 +36,16 @@
 //
 //   Build 5.1.013:
 //   - CrownCutoff and RuleStep added as analysis option variables.
+//
+//   Build 5.1.015:
+//   - Calendar components of the current runoff and routing dates added.
+//   - GeomTblSize option added.
+//   - InLinks and OutLinks node incidence lists added.
+//   - StatsStride option added.
+//   - StatsTopN option added.
+//   - LidRptFormat option added.
+//   - Binary output storage formats of result variables added.
+//   - ForceMainTbl option added.
 //-----------------------------------------------------------------------------
 
 EXTERN TFile
@@ -64,6 +75,11 @@ EXTERN char
 EXTERN TRptFlags
                   RptFlags;                 // Reporting options
 
+EXTERN TOutStorage                                                             //(5.1.015)
+                  SubcatchOutStorage[MAX_SUBCATCH_RESULTS], // Binary storage of
+                  NodeOutStorage[MAX_NODE_RESULTS],         // each type of
+                  LinkOutStorage[MAX_LINK_RESULTS];         // result variable
+
 EXTERN int
                   Nobjects[MAX_OBJ_TYPES],  // Number of each object type
                   Nnodes[MAX_NODE_TYPES],   // Number of each node sub-type
@@ -73,8 +89,10 @@ EXTERN int
                   InfilModel,               // Infiltration method
                   RouteModel,               // Flow routing method
                   ForceMainEqn,             // Flow equation for force mains
+                  ForceMainTbl,             // Use D-W friction factor table   //(5.1.015)
                   LinkOffsets,              // Link offset convention
                   SurchargeMethod,          // EXTRAN or SLOT method           //(5.1.013)
+                  LidRptFormat,             // TEXT or BINARY LID report file  //(5.1.015)
                   AllowPonding,             // Allow water to pond at nodes
                   InertDamping,             // Degree of inertial damping
                   NormalFlowLtd,            // Normal flow limited
@@ -97,6 +115,9 @@ EXTERN int
                   SweepEnd,                 // Day of year when sweeping ends
                   MaxTrials,                // Max. trials for DW routing
                   NumThreads,               // Number of parallel threads used
+                  GeomTblSize,              // Base size of xsect geometry tbls//(5.1.015)
+                  StatsStride,              // Steps between duration stats    //(5.1.015)
+                  StatsTopN,                // Max. elements in ranked tables  //(5.1.015)
                   NumEvents;                // Number of detailed events
                 //InSteadyState;            // System flows remain constant
 
@@ -128,6 +149,10 @@ EXTERN DateTime
                   ReportStartTime,          // Report start time
                   ReportStart;              // Report start Date+Time
 
+EXTERN TCalendar
+                  RunoffCalendar,           // Calendar of current runoff date
+                  RoutingCalendar;          // Calendar of current routing date
+
 EXTERN double
                   ReportTime,               // Current reporting time (msec)
                   OldRunoffTime,            // Previous runoff time (msec)
@@ -142,6 +167,8 @@ EXTERN TEvap      Evap;                     // Evaporation data
 EXTERN TWind      Wind;                     // Wind speed data
 EXTERN TSnow      Snow;                     // Snow melt data
 EXTERN TAdjust    Adjust;                   // Climate adjustments
+EXTERN TGraph     InLinks;                  // Links entering each node //(5.1.015)
+EXTERN TGraph     OutLinks;                 // Links leaving each node  //(5.1.015)
 
 EXTERN TSnowmelt* Snowmelt;                 // Array of snow melt objects
 EXTERN TGage*     Gage;                     // Array of rain gages
@@ -8,6 +8,7 @@
 //             04/23/14  (Build 5.1.005)
 //             03/19/15  (Build 5.1.008)
 //             08/01/16  (Build 5.1.011)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //
 //   Hot Start file functions.
@@ -37,6 +38,11 @@
 //   Build 5.1.011:
 //   - Link control setting bug when reading a hot start file fixed.    
 //
+//   Build 5.1.015:
+//   - The state of an open project can be saved during a run and used to
+//     start a later run of the project without a hot start file (see
+//     swmm_saveState and swmm_restoreState in the toolkit API).
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -49,32 +55,45 @@
 //-----------------------------------------------------------------------------
 //  Local Variables
 //-----------------------------------------------------------------------------
-static int fileVersion;
+static int   fileVersion;
+static FILE* StateFile = NULL;         // latest saved state of the project    //(5.1.015)
+static int   UseStateFile = FALSE;     // TRUE if next run starts from it      //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 // hotstart_open                          (called by swmm_start in swmm5.c)
 // hotstart_close                         (called by swmm_end in swmm5.c)
+// hotstart_saveState                     (called by swmm_saveState)           //(5.1.015)
+// hotstart_useState                      (called by swmm_restoreState)        //(5.1.015)
+// hotstart_deleteState                   (called by swmm_close in swmm5.c)    //(5.1.015)
 
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
 static int  openHotstartFile1(void); 
 static int  openHotstartFile2(void);       
-static void readRunoff(void);
-static void saveRunoff(void);
-static void readRouting(void);
-static void saveRouting(void);
+static int  readStateFile(void);                                               //(5.1.015)
+static void readRunoff(FILE* f);                                               //(5.1.015)
+static void saveRunoff(FILE* f);                                               //(5.1.015)
+static void readRouting(FILE* f);                                              //(5.1.015)
+static void saveRouting(FILE* f);                                              //(5.1.015)
 static int  readFloat(float *x, FILE* f);
 static int  readDouble(double* x, FILE* f);
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int hotstart_open()
 {
     // --- open hot start files
-    if ( !openHotstartFile1() ) return FALSE;       //input hot start file
+    //     (a saved project state, if requested, replaces the input file)      //(5.1.015)
+    if ( UseStateFile )                                                        //(5.1.015)
+    {                                                                          //(5.1.015)
+        if ( !readStateFile() ) return FALSE;                                  //(5.1.015)
+    }                                                                          //(5.1.015)
+    else if ( !openHotstartFile1() ) return FALSE;  //input hot start file     //(5.1.015)
     if ( !openHotstartFile2() ) return FALSE;       //output hot start file
     return TRUE;
 }
@@ -85,14 +104,71 @@ void hotstart_close()
 {
     if ( Fhotstart2.file )
     {
-        saveRunoff();
-        saveRouting();
+        saveRunoff(Fhotstart2.file);                                           //(5.1.015)
+        saveRouting(Fhotstart2.file);                                          //(5.1.015)
         fclose(Fhotstart2.file);
     }
 }
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int hotstart_saveState()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: saves the current state of the project so that a later run of
+//           the project (while it remains open) can start from it.
+//
+//  NOTE: the state is kept in the same form as a hot start file, in an
+//        anonymous temporary file that is removed when the project closes.
+//
+{
+    FILE* f = tmpfile();
+
+    if ( f == NULL ) return ERR_HOTSTART_FILE_OPEN;
+    saveRunoff(f);
+    saveRouting(f);
+    if ( StateFile ) fclose(StateFile);
+    StateFile = f;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int hotstart_useState()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: has the next run of the project start from its last saved state.
+//
+{
+    if ( StateFile == NULL ) return ERR_HOTSTART_FILE_READ;
+    UseStateFile = TRUE;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void hotstart_deleteState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: discards the project's saved state.
+//
+{
+    if ( StateFile ) fclose(StateFile);
+    StateFile = NULL;
+    UseStateFile = FALSE;
+}
+
+//=============================================================================
+
 int openHotstartFile1()
 //
 //  Input:   none
@@ -170,8 +246,8 @@ int openHotstartFile1()
     }
 
     // --- read contents of the file and close it
-    if ( fileVersion >= 3 ) readRunoff();
-    readRouting();
+    if ( fileVersion >= 3 ) readRunoff(Fhotstart1.file);                       //(5.1.015)
+    readRouting(Fhotstart1.file);                                              //(5.1.015)
     fclose(Fhotstart1.file);
     if ( ErrorCode ) return FALSE;
     else return TRUE;
@@ -221,9 +297,31 @@ int openHotstartFile2()
 
 //=============================================================================
 
-void  saveRouting()
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readStateFile()
 //
 //  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: initializes the project from its last saved state.
+//
+{
+    UseStateFile = FALSE;
+    rewind(StateFile);
+    fileVersion = 4;
+    readRunoff(StateFile);
+    readRouting(StateFile);
+    if ( ErrorCode ) return FALSE;
+    else return TRUE;
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void  saveRouting(FILE* f)
+//
+//  Input:   f = hot start file being written
 //  Output:  none
 //  Purpose: saves current state of all nodes and links to hotstart file.
 //
@@ -235,19 +333,19 @@ void  saveRouting()
     {
         x[0] = (float)Node[i].newDepth;
         x[1] = (float)Node[i].newLatFlow;
-        fwrite(x, sizeof(float), 2, Fhotstart2.file);
+        fwrite(x, sizeof(float), 2, f);                                        //(5.1.015)
 
         if ( Node[i].type == STORAGE )
         {
             j = Node[i].subIndex;
             x[0] = (float)Storage[j].hrt;
-            fwrite(&x[0], sizeof(float), 1, Fhotstart2.file);
+            fwrite(&x[0], sizeof(float), 1, f);                                //(5.1.015)
         }
 
         for (j = 0; j < Nobjects[POLLUT]; j++)
         {
             x[0] = (float)Node[i].newQual[j];
-            fwrite(&x[0], sizeof(float), 1, Fhotstart2.file);
+            fwrite(&x[0], sizeof(float), 1, f);                                //(5.1.015)
         }
     }
     for (i = 0; i < Nobjects[LINK]; i++)
@@ -255,20 +353,22 @@ void  saveRouting()
         x[0] = (float)Link[i].newFlow;
         x[1] = (float)Link[i].newDepth;
         x[2] = (float)Link[i].setting;
-        fwrite(x, sizeof(float), 3, Fhotstart2.file);
+        fwrite(x, sizeof(float), 3, f);                                        //(5.1.015)
         for (j = 0; j < Nobjects[POLLUT]; j++)
         {
             x[0] = (float)Link[i].newQual[j];
-            fwrite(&x[0], sizeof(float), 1, Fhotstart2.file);
+            fwrite(&x[0], sizeof(float), 1, f);                                //(5.1.015)
         }
     }
 }
 
 //=============================================================================
 
-void readRouting()
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void readRouting(FILE* f)
 //
-//  Input:   none 
+//  Input:   f = hot start file being read
 //  Output:  none
 //  Purpose: reads initial state of all nodes, links and groundwater objects
 //           from hotstart file.
@@ -277,7 +377,6 @@ void readRouting()
     int   i, j;
     float x;
     double xgw[4];
-    FILE* f = Fhotstart1.file;
 
     // --- for file format 2, assign GW moisture content and lower depth
     if ( fileVersion == 2 )
@@ -355,16 +454,17 @@ void readRouting()
 
 //=============================================================================
 
-void  saveRunoff(void)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void  saveRunoff(FILE* f)
 //
-//  Input:   none
+//  Input:   f = hot start file being written
 //  Output:  none
 //  Purpose: saves current state of all subcatchments to hotstart file.
 //
 {
     int   i, j, k, sizeX;
     double* x;
-    FILE*  f = Fhotstart2.file;
 
     sizeX = MAX(6, Nobjects[POLLUT]+1);
     x = (double *) calloc(sizeX, sizeof(double));
@@ -425,16 +525,17 @@ void  saveRunoff(void)
 
 //=============================================================================
 
-void  readRunoff()
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void  readRunoff(FILE* f)
 //
-//  Input:   none
+//  Input:   f = hot start file being read
 //  Output:  none
 //  Purpose: reads saved state of all subcatchments from a hot start file.
 //
 {
     int    i, j, k;
     double x[6];
-    FILE*  f = Fhotstart1.file;
 
     for (i = 0; i < Nobjects[SUBCATCH]; i++)
     {
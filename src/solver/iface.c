@@ -4,16 +4,81 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Routing interface file functions.
+//
+//   Build 5.1.015:
+//   - A binary format for routing interface files was added. The format of
+//     an inflows file is detected when it is opened.
+//   - An outflows "file" can be an in-memory pipe that a project run later
+//     in the same process reads as its inflows file. A pipe is freed once
+//     it has been read (or by iface_deletePipes if it never is).
+//   - iface_convertFile converts interface files between text and binary.
+//   - Binary interface files are read and written sequentially so that
+//     they can be named pipes joining models run by separate processes.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdlib.h>
 #include <string.h>
+#ifndef _WIN32                                                                 //(5.1.015)
+  #include <sys/stat.h>
+#endif
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+//  A binary interface file (or pipe) contains:
+//    INT4 magic number, INT4 version, title, INT4 reporting time step (sec),
+//    INT4 flow units, INT4 number of pollutants, then each pollutant's ID
+//    and INT4 concentration units, INT4 number of nodes, then each node's ID,
+//  where each string is an INT4 length followed by its characters, and then
+//  a fixed-size record for each reporting period consisting of a REAL8 date
+//  followed by REAL8 flow & pollutant concentrations for each node.
+#define IFACE_MAGIC     516114523                                              //(5.1.015)
+#define PIPE_BLOCK_SIZE 65536          // initial size of a pipe (bytes)       //(5.1.015)
+
+// Definition of 4-byte integer and 8-byte real types                          //(5.1.015)
+#define INT4  int
+#define REAL8 double
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+// In-memory interface file shared by projects run in the same process         //(5.1.015)
+typedef struct IfacePipe
+{
+    char   name[MAXFNAME+1];           // pipe name
+    char*  data;                       // interface file contents
+    size_t size;                       // bytes of data written
+    size_t capacity;                   // bytes allocated for data
+    struct IfacePipe* next;            // next pipe in list
+}  TIfacePipe;
+
+// Source or destination of interface file data                                //(5.1.015)
+typedef struct
+{
+    FILE*       file;                  // file (if not a pipe)
+    TIfacePipe* pipe;                  // pipe (if not a file)
+    size_t      pos;                   // read position in pipe
+}  TIfaceStream;
+
+// Contents of an interface file's header                                      //(5.1.015)
+typedef struct
+{
+    char   title[MAXLINE+1];           // project title
+    int    step;                       // reporting time step (sec)
+    int    flowUnits;                  // flow units code
+    int    nPolluts;                   // number of pollutants
+    char** pollutIDs;                  // pollutant names
+    int*   pollutUnits;                // pollutant concen. units codes
+    int    nNodes;                     // number of nodes
+    char** nodeIDs;                    // node names
+}  TIfaceHeader;
+
 //-----------------------------------------------------------------------------
 //  Imported variables
 //-----------------------------------------------------------------------------
@@ -35,6 +100,17 @@ static double   IfaceFrac;             // fraction of interface file time step
 static DateTime OldIfaceDate;          // previous date of interface values
 static DateTime NewIfaceDate;          // next date of interface values
 
+static int      IfaceInFormat;         // format of inflows interface file     //(5.1.015)
+static int      IfaceOutFormat;        // format of outflows interface file    //(5.1.015)
+static TIfaceStream InStream;          // source of inflows interface data     //(5.1.015)
+static TIfaceStream OutStream;         // destination of outflows data         //(5.1.015)
+static int      OutIsFifo;             // TRUE if outflows file is a FIFO      //(5.1.015)
+static REAL8*   InRecord;              // record read from inflows file        //(5.1.015)
+static REAL8*   OutRecord;             // record saved to outflows file        //(5.1.015)
+static TIfaceHeader OutHeader;         // header of outflows file              //(5.1.015)
+static int*     OutletNodes;           // indexes of outlet nodes              //(5.1.015)
+static TIfacePipe* IfacePipes = NULL;  // pipes kept between projects          //(5.1.015)
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -46,21 +122,44 @@ static DateTime NewIfaceDate;          // next date of interface values
 //  iface_getIfaceFlow       (called by addIfaceInflows in routing.c)
 //  iface_getIfaceQual       (called by addIfaceInflows in routing.c)
 //  iface_saveOutletResults  (called by output_saveResults)
+//  iface_convertFile        (called by swmm_convertIfaceFile)
+//  iface_deletePipes        (called by swmm_deleteIfacePipes)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static void  openFileForOutput(void);
 static void  openFileForInput(void);
-static int   getIfaceFilePolluts(void);
-static int   getIfaceFileNodes(void);
+static int   getIfaceFilePolluts(TIfaceHeader* h);                             //(5.1.015)
+static int   getIfaceFileNodes(TIfaceHeader* h);                               //(5.1.015)
 static void  setOldIfaceValues(void);
 static void  readNewIfaceValues(void);
 static int   isOutletNode(int node);
 
+static int   getIfaceFormat(char* tok[], int ntoks);                           //(5.1.015)
+static int   readTextHeader(FILE* f, TIfaceHeader* h);                         //(5.1.015)
+static void  writeTextHeader(FILE* f, TIfaceHeader* h);                        //(5.1.015)
+static int   readTextRecord(FILE* f, int nNodes, int nPolluts, REAL8* record); //(5.1.015)
+static void  writeTextRecord(FILE* f, TIfaceHeader* h, REAL8* record);         //(5.1.015)
+static int   readBinaryHeader(TIfaceStream* s, TIfaceHeader* h);               //(5.1.015)
+static void  writeBinaryHeader(TIfaceStream* s, TIfaceHeader* h);              //(5.1.015)
+static int   allocHeader(TIfaceHeader* h);                                     //(5.1.015)
+static void  freeHeader(TIfaceHeader* h, int freeIDs);                         //(5.1.015)
+static TIfacePipe* findPipe(char* name);                                       //(5.1.015)
+static TIfacePipe* createPipe(char* name);                                     //(5.1.015)
+static void  deletePipe(TIfacePipe* pipe);                                     //(5.1.015)
+static int   readStream(TIfaceStream* s, void* data, size_t size);             //(5.1.015)
+static int   writeStream(TIfaceStream* s, void* data, size_t size);            //(5.1.015)
+static char* readString(TIfaceStream* s);                                      //(5.1.015)
+static char* copyString(char* s);                                              //(5.1.015)
+static void  writeString(TIfaceStream* s, char* str);                          //(5.1.015)
+static int   isFifo(FILE* f);                                                  //(5.1.015)
+
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int iface_readFileParams(char* tok[], int ntoks)
 //
 //  Input:   tok[] = array of string tokens
@@ -69,11 +168,15 @@ int iface_readFileParams(char* tok[], int ntoks)
 //  Purpose: reads interface file information from a line of input data.
 //
 //  Data format is:
-//  USE/SAVE  FileType  FileName
+//  USE/SAVE  FileType  FileName  (Format)
+//
+//  where the optional Format (TEXT, BINARY or PIPE) applies to INFLOWS
+//  and OUTFLOWS files.
 //
 {
     char  k;
     int   j;
+    int   m;                                                                   //(5.1.015)
 
     // --- determine file disposition and type
     if ( ntoks < 2 ) return error_setInpError(ERR_ITEMS, "");
@@ -118,12 +221,18 @@ int iface_readFileParams(char* tok[], int ntoks)
         if ( k != USE_FILE ) return error_setInpError(ERR_ITEMS, "");
         Finflows.mode = k;
         sstrncpy(Finflows.name, tok[2], MAXFNAME);
+        m = getIfaceFormat(tok, ntoks);                                        //(5.1.015)
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, tok[3]);            //(5.1.015)
+        IfaceInFormat = m;                                                     //(5.1.015)
         break;
 
       case OUTFLOWS_FILE:
         if ( k != SAVE_FILE ) return error_setInpError(ERR_ITEMS, "");
         Foutflows.mode = k;
         sstrncpy(Foutflows.name, tok[2], MAXFNAME);
+        m = getIfaceFormat(tok, ntoks);                                        //(5.1.015)
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, tok[3]);            //(5.1.015)
+        IfaceOutFormat = m;                                                    //(5.1.015)
         break;
     }
     return 0;
@@ -131,6 +240,24 @@ int iface_readFileParams(char* tok[], int ntoks)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int getIfaceFormat(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an IfaceFormatType code or -1 if not recognized
+//  Purpose: reads the optional format of a routing interface file.
+//
+{
+    if ( ntoks < 4 ) return TEXT_IFACE;
+    return findmatch(tok[3], IfaceFormatWords);
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void iface_openRoutingFiles()
 //
 //  Input:   none
@@ -145,6 +272,13 @@ void iface_openRoutingFiles()
     IfaceNodes = NULL;
     OldIfaceValues = NULL;
     NewIfaceValues = NULL;
+    InRecord = NULL;                                                           //(5.1.015)
+    OutRecord = NULL;                                                          //(5.1.015)
+    OutletNodes = NULL;                                                        //(5.1.015)
+    memset(&InStream, 0, sizeof(TIfaceStream));                                //(5.1.015)
+    memset(&OutStream, 0, sizeof(TIfaceStream));                               //(5.1.015)
+    memset(&OutHeader, 0, sizeof(TIfaceHeader));                               //(5.1.015)
+    OutIsFifo = FALSE;                                                         //(5.1.015)
 
     // --- check that inflows & outflows files are not the same
     if ( Foutflows.mode != NO_FILE && Finflows.mode != NO_FILE )
@@ -163,6 +297,8 @@ void iface_openRoutingFiles()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void iface_closeRoutingFiles()
 //
 //  Input:   none
@@ -174,8 +310,19 @@ void iface_closeRoutingFiles()
     FREE(IfaceNodes);
     if ( OldIfaceValues != NULL ) project_freeMatrix(OldIfaceValues);
     if ( NewIfaceValues != NULL ) project_freeMatrix(NewIfaceValues);
+    FREE(InRecord);                                                            //(5.1.015)
+    FREE(OutRecord);                                                           //(5.1.015)
+    FREE(OutletNodes);                                                         //(5.1.015)
+    freeHeader(&OutHeader, FALSE);                                             //(5.1.015)
     if ( Finflows.file )  fclose(Finflows.file);
     if ( Foutflows.file ) fclose(Foutflows.file);
+    Finflows.file = NULL;                                                      //(5.1.015)
+    Foutflows.file = NULL;                                                     //(5.1.015)
+
+    // --- a pipe is read only once, so free it once its reader is done        //(5.1.015)
+    if ( InStream.pipe ) deletePipe(InStream.pipe);                            //(5.1.015)
+    memset(&InStream, 0, sizeof(TIfaceStream));                                //(5.1.015)
+    memset(&OutStream, 0, sizeof(TIfaceStream));                               //(5.1.015)
 }
 
 //=============================================================================
@@ -274,6 +421,8 @@ double iface_getIfaceQual(int index, int pollut)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void iface_saveOutletResults(DateTime reportDate, FILE* file)
 //
 //  Input:   reportDate = reporting date/time
@@ -282,30 +431,154 @@ void iface_saveOutletResults(DateTime reportDate, FILE* file)
 //  Purpose: saves system outflows to routing interface file.
 //
 {
-    int i, p, yr, mon, day, hr, min, sec;
-    char theDate[25];
+    int i, k, p, n;
+    int yr, mon, day, hr, min, sec;
+
+    // --- place flow and quality of each outlet node in a record
+    OutRecord[0] = reportDate;
+    n = 1;
+    for (k = 0; k < OutHeader.nNodes; k++)
+    {
+        i = OutletNodes[k];
+        OutRecord[n++] = Node[i].inflow * UCF(FLOW);
+        for ( p = 0; p < Nobjects[POLLUT]; p++ )
+        {
+            OutRecord[n++] = Node[i].newQual[p];
+        }
+    }
+
+    // --- write record to text file
+    if ( IfaceOutFormat == TEXT_IFACE )
+    {
+        writeTextRecord(file, &OutHeader, OutRecord);
+        return;
+    }
+
+    // --- round date to nearest second (as done for text files) and
+    //     write record to binary file or pipe
     datetime_decodeDate(reportDate, &yr, &mon, &day);
     datetime_decodeTime(reportDate, &hr, &min, &sec);
-    sprintf(theDate, " %04d %02d  %02d  %02d  %02d  %02d ",
-            yr, mon, day, hr, min, sec);
-    for (i=0; i<Nobjects[NODE]; i++)
+    OutRecord[0] = datetime_encodeDate(yr, mon, day) +
+                   datetime_encodeTime(hr, min, sec);
+    if ( !writeStream(&OutStream, OutRecord, n * sizeof(REAL8)) &&
+         OutStream.pipe ) report_writeErrorMsg(ERR_MEMORY, "");
+
+    // --- pass record on to any process reading the file through a
+    //     named pipe
+    if ( OutIsFifo ) fflush(OutStream.file);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int iface_convertFile(char* inFile, char* outFile)
+//
+//  Input:   inFile = name of existing routing interface file
+//           outFile = name of interface file to create
+//  Output:  returns an error code
+//  Purpose: converts a text routing interface file to binary format or
+//           a binary one to text format.
+//
+{
+    int    err = 0;
+    int    isBinary;
+    size_t recordSize = 0;
+    INT4   magic = 0;
+    REAL8* record = NULL;
+    TIfaceHeader h;
+    TIfaceStream in;
+    TIfaceStream out;
+
+    // --- open input file and detect its format
+    memset(&h, 0, sizeof(TIfaceHeader));
+    memset(&in, 0, sizeof(TIfaceStream));
+    memset(&out, 0, sizeof(TIfaceStream));
+    if ( strcomp(inFile, outFile) ) return ERR_ROUTING_FILE_NAMES;
+    in.file = fopen(inFile, "rb");
+    if ( in.file == NULL ) return ERR_ROUTING_FILE_OPEN;
+    isBinary = (fread(&magic, sizeof(INT4), 1, in.file) == 1 &&
+                magic == IFACE_MAGIC);
+    if ( !isBinary )
     {
-        // --- check that node is an outlet node
-        if ( !isOutletNode(i) ) continue;
+        fclose(in.file);
+        in.file = fopen(inFile, "rt");
+        if ( in.file == NULL ) return ERR_ROUTING_FILE_OPEN;
+    }
 
-        // --- write node ID, date, flow, and quality to file
-        fprintf(file, "\n%-16s", Node[i].ID);
-        fprintf(file, "%s", theDate);
-        fprintf(file, " %-10f", Node[i].inflow * UCF(FLOW));
-        for ( p = 0; p < Nobjects[POLLUT]; p++ )
+    // --- read input file's header
+    if ( isBinary ) err = readBinaryHeader(&in, &h);
+    else err = readTextHeader(in.file, &h);
+
+    // --- allocate a record of node flows & quality
+    if ( !err )
+    {
+        recordSize = 1 + h.nNodes * (1 + h.nPolluts);
+        record = (REAL8 *) calloc(recordSize, sizeof(REAL8));
+        if ( record == NULL ) err = ERR_MEMORY;
+    }
+
+    // --- open output file in the other format
+    if ( !err )
+    {
+        if ( isBinary ) out.file = fopen(outFile, "wt");
+        else out.file = fopen(outFile, "wb");
+        if ( out.file == NULL ) err = ERR_ROUTING_FILE_OPEN;
+    }
+
+    // --- copy header and each record from input to output file
+    if ( !err )
+    {
+        recordSize *= sizeof(REAL8);
+        if ( isBinary )
         {
-            fprintf(file, " %-10f", Node[i].newQual[p]);
+            writeTextHeader(out.file, &h);
+            while ( readStream(&in, record, recordSize) )
+                writeTextRecord(out.file, &h, record);
         }
+        else
+        {
+            writeBinaryHeader(&out, &h);
+            while ( readTextRecord(in.file, h.nNodes, h.nPolluts, record) )
+                writeStream(&out, record, recordSize);
+        }
+    }
+
+    // --- close files and free memory
+    fclose(in.file);
+    if ( out.file ) fclose(out.file);
+    FREE(record);
+    freeHeader(&h, TRUE);
+    return err;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void iface_deletePipes()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the in-memory interface files that no project run has
+//           read, except one being written to by the current project.
+//
+{
+    TIfacePipe* p = IfacePipes;
+    TIfacePipe* next;
+
+    while ( p != NULL )
+    {
+        next = p->next;
+        if ( p != OutStream.pipe ) deletePipe(p);
+        p = next;
     }
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void openFileForOutput()
 //
 //  Input:   none
@@ -315,50 +588,75 @@ void openFileForOutput()
 {
     int i, n;
 
-    // --- open the routing file for writing text
-    Foutflows.file = fopen(Foutflows.name, "wt");
-    if ( Foutflows.file == NULL )
+    // --- count number of outlet nodes
+    n = 0;
+    for (i=0; i<Nobjects[NODE]; i++)
     {
-        report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Foutflows.name);
-        return;
+        if ( isOutletNode(i) ) n++;
     }
 
-    // --- write title & reporting time step to file
-    fprintf(Foutflows.file, "SWMM5 Interface File");
-    fprintf(Foutflows.file, "\n%s", Title[0]);
-    fprintf(Foutflows.file, "\n%-4d - reporting time step in sec", ReportStep);
-
-    // --- write number & names of each constituent (including flow) to file
-    fprintf(Foutflows.file, "\n%-4d - number of constituents as listed below:",
-            Nobjects[POLLUT] + 1);
-    fprintf(Foutflows.file, "\nFLOW %s", FlowUnitWords[FlowUnits]);
+    // --- create header describing the file's contents
+    sstrncpy(OutHeader.title, Title[0], MAXLINE);
+    OutHeader.step = ReportStep;
+    OutHeader.flowUnits = FlowUnits;
+    OutHeader.nPolluts = Nobjects[POLLUT];
+    OutHeader.nNodes = n;
+    OutletNodes = (int *) calloc(n + 1, sizeof(int));
+    OutRecord = (REAL8 *) calloc(1 + n * (1 + Nobjects[POLLUT]),
+                                 sizeof(REAL8));
+    if ( allocHeader(&OutHeader) || !OutletNodes || !OutRecord )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
     for (i=0; i<Nobjects[POLLUT]; i++)
     {
-        fprintf(Foutflows.file, "\n%s %s", Pollut[i].ID,
-            QualUnitsWords[Pollut[i].units]);
+        OutHeader.pollutIDs[i] = Pollut[i].ID;
+        OutHeader.pollutUnits[i] = Pollut[i].units;
     }
-
-    // --- count number of outlet nodes
     n = 0;
     for (i=0; i<Nobjects[NODE]; i++)
     {
-        if ( isOutletNode(i) ) n++;
+        if ( !isOutletNode(i) ) continue;
+        OutletNodes[n] = i;
+        OutHeader.nodeIDs[n] = Node[i].ID;
+        n++;
     }
 
-    // --- write number and names of outlet nodes to file
-    fprintf(Foutflows.file, "\n%-4d - number of nodes as listed below:", n);
-    for (i=0; i<Nobjects[NODE]; i++)
+    // --- open a pipe or a binary file and write its header
+    if ( IfaceOutFormat == PIPE_IFACE )
+    {
+        OutStream.pipe = createPipe(Foutflows.name);
+        if ( OutStream.pipe == NULL )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return;
+        }
+        writeBinaryHeader(&OutStream, &OutHeader);
+    }
+    else if ( IfaceOutFormat == BINARY_IFACE )
     {
-          if ( isOutletNode(i) )
-            fprintf(Foutflows.file, "\n%s", Node[i].ID);
+        Foutflows.file = fopen(Foutflows.name, "wb");
+        if ( Foutflows.file == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Foutflows.name);
+            return;
+        }
+        OutStream.file = Foutflows.file;
+        OutIsFifo = isFifo(Foutflows.file);
+        writeBinaryHeader(&OutStream, &OutHeader);
     }
 
-    // --- write column headings
-    fprintf(Foutflows.file,
-        "\nNode             Year Mon Day Hr  Min Sec FLOW      ");
-    for (i=0; i<Nobjects[POLLUT]; i++)
+    // --- open the routing file for writing text
+    else
     {
-        fprintf(Foutflows.file, " %-10s", Pollut[i].ID);
+        Foutflows.file = fopen(Foutflows.name, "wt");
+        if ( Foutflows.file == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Foutflows.name);
+            return;
+        }
+        writeTextHeader(Foutflows.file, &OutHeader);
     }
 
     // --- if reporting starts immediately, save initial outlet values
@@ -370,6 +668,8 @@ void openFileForOutput()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void openFileForInput()
 //
 //  Input:   none
@@ -378,49 +678,73 @@ void openFileForInput()
 //
 {
     int   err;                         // error code
-    char  line[MAXLINE+1];             // line from Routing interface file
-    char  s[MAXLINE+1];                // general string variable
-
-    // --- open the routing interface file for reading text
-    Finflows.file = fopen(Finflows.name, "rt");
-    if ( Finflows.file == NULL )
-    {
-        report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
-        return;
-    }
+    INT4  magic = 0;                   // binary file's magic number
+    TIfaceHeader h;                    // interface file header
 
-    // --- check for correct file type
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%s", s);
-    if ( !strcomp(s, "SWMM5") )
+    // --- find the pipe being read from
+    if ( IfaceInFormat == PIPE_IFACE )
     {
-        report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
-        return;
+        InStream.pipe = findPipe(Finflows.name);
+        if ( InStream.pipe == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
+            return;
+        }
+        if ( !readStream(&InStream, &magic, sizeof(INT4)) ||
+             magic != IFACE_MAGIC )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
+            return;
+        }
     }
 
-    // --- skip title line
-    fgets(line, MAXLINE, Finflows.file);
-
-    // --- read reporting time step (sec)
-    IfaceStep = 0;
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%d", &IfaceStep);
-    if ( IfaceStep <= 0 )
+    // --- open the routing interface file and detect its format
+    //     (a binary file is read sequentially from here on so that it
+    //     can also be a named pipe fed by another process)
+    else
     {
-        report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
-        return;
+        Finflows.file = fopen(Finflows.name, "rb");
+        if ( Finflows.file == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
+            return;
+        }
+        if ( fread(&magic, sizeof(INT4), 1, Finflows.file) == 1 &&
+             magic == IFACE_MAGIC )
+        {
+            IfaceInFormat = BINARY_IFACE;
+            InStream.file = Finflows.file;
+        }
+        else
+        {
+            // --- re-open the file for reading text (which a named pipe
+            //     can't be since its first bytes were already read)
+            IfaceInFormat = TEXT_IFACE;
+            if ( isFifo(Finflows.file) )
+            {
+                report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
+                return;
+            }
+            fclose(Finflows.file);
+            Finflows.file = fopen(Finflows.name, "rt");
+            if ( Finflows.file == NULL )
+            {
+                report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
+                return;
+            }
+        }
     }
 
-    // --- match constituents in file with those in project
-    err = getIfaceFilePolluts();
-    if ( err > 0 )
-    {
-        report_writeErrorMsg(err, Finflows.name);
-        return;
-    }
+    // --- read the file's header
+    memset(&h, 0, sizeof(TIfaceHeader));
+    if ( IfaceInFormat == TEXT_IFACE ) err = readTextHeader(Finflows.file, &h);
+    else err = readBinaryHeader(&InStream, &h);
+    IfaceStep = h.step;
 
-    // --- match nodes in file with those in project
-    err = getIfaceFileNodes();
+    // --- match constituents & nodes in file with those in project
+    if ( !err ) err = getIfaceFilePolluts(&h);
+    if ( !err ) err = getIfaceFileNodes(&h);
+    freeHeader(&h, TRUE);
     if ( err > 0 )
     {
         report_writeErrorMsg(err, Finflows.name);
@@ -432,7 +756,10 @@ void openFileForInput()
                                          1+NumIfacePolluts);
     NewIfaceValues = project_createMatrix(NumIfaceNodes,
                                          1+NumIfacePolluts);
-    if ( OldIfaceValues == NULL || NewIfaceValues == NULL )
+    InRecord = (REAL8 *) calloc(1 + NumIfaceNodes * (1 + NumIfacePolluts),
+                                sizeof(REAL8));
+    if ( OldIfaceValues == NULL || NewIfaceValues == NULL ||
+         InRecord == NULL )
     {
         report_writeErrorMsg(ERR_MEMORY, "");
         return;
@@ -445,30 +772,21 @@ void openFileForInput()
 
 //=============================================================================
 
-int  getIfaceFilePolluts()
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int  getIfaceFilePolluts(TIfaceHeader* h)
 //
-//  Input:   none
+//  Input:   h = contents of inflows interface file header
 //  Output:  returns an error code
-//  Purpose: reads names of pollutants saved on the inflows interface file.
+//  Purpose: matches pollutants saved on the inflows interface file
+//           with those of the project.
 //
 {
     int   i, j;
-    char  line[MAXLINE+1];             // line from inflows interface file
-    char  s1[MAXLINE+1];               // general string variable
-    char  s2[MAXLINE+1];         
 
-    // --- read number of pollutants (minus FLOW)
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%d", &NumIfacePolluts);
-    NumIfacePolluts--;
-    if ( NumIfacePolluts < 0 ) return ERR_ROUTING_FILE_FORMAT;
-
-    // --- read flow units
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%s %s", s1, s2);
-    if ( !strcomp(s1, "FLOW") )  return ERR_ROUTING_FILE_FORMAT;
-    IfaceFlowUnits = findmatch(s2, FlowUnitWords);
-    if ( IfaceFlowUnits < 0 ) return ERR_ROUTING_FILE_FORMAT;
+    // --- save number of pollutants (minus FLOW) & flow units
+    NumIfacePolluts = h->nPolluts;
+    IfaceFlowUnits = h->flowUnits;
 
     // --- allocate memory for pollutant index array
     if ( Nobjects[POLLUT] > 0 )
@@ -478,23 +796,16 @@ int  getIfaceFilePolluts()
         for (i=0; i<Nobjects[POLLUT]; i++) IfacePolluts[i] = -1;
     }
 
-    // --- read pollutant names & units
-    if ( NumIfacePolluts > 0 )
+    // --- check each pollutant name on file with project's pollutants
+    if ( Nobjects[POLLUT] > 0 )
     {
-        // --- check each pollutant name on file with project's pollutants
         for (i=0; i<NumIfacePolluts; i++)
         {
-            if ( feof(Finflows.file) ) return ERR_ROUTING_FILE_FORMAT;
-            fgets(line, MAXLINE, Finflows.file);
-            sscanf(line, "%s %s", s1, s2);
-            if ( Nobjects[POLLUT] > 0 )
-            {
-                j = project_findObject(POLLUT, s1);
-                if ( j < 0 ) continue;
-                if ( !strcomp(s2, QualUnitsWords[Pollut[j].units]) )
-                    return ERR_ROUTING_FILE_NOMATCH;
-                IfacePolluts[j] = i;
-            }
+            j = project_findObject(POLLUT, h->pollutIDs[i]);
+            if ( j < 0 ) continue;
+            if ( h->pollutUnits[i] != Pollut[j].units )
+                return ERR_ROUTING_FILE_NOMATCH;
+            IfacePolluts[j] = i;
         }
     }
     return 0;
@@ -502,43 +813,38 @@ int  getIfaceFilePolluts()
 
 //=============================================================================
 
-int getIfaceFileNodes()
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int getIfaceFileNodes(TIfaceHeader* h)
 //
-//  Input:   none
+//  Input:   h = contents of inflows interface file header
 //  Output:  returns an error code
-//  Purpose: reads names of nodes contained on inflows interface file.
+//  Purpose: matches nodes contained on inflows interface file with
+//           those of the project.
 //
 {
     int   i;
-    char  line[MAXLINE+1];             // line from inflows interface file
-    char  s[MAXLINE+1];                // general string variable
 
-    // --- read number of interface nodes
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%d", &NumIfaceNodes);
+    // --- save number of interface nodes
+    NumIfaceNodes = h->nNodes;
     if ( NumIfaceNodes <= 0 ) return ERR_ROUTING_FILE_FORMAT;
 
     // --- allocate memory for interface nodes index array
     IfaceNodes = (int *) calloc(NumIfaceNodes, sizeof(int));
     if ( !IfaceNodes ) return ERR_MEMORY;
 
-    // --- read names of interface nodes from file & save their indexes
+    // --- save indexes of interface nodes
     for ( i=0; i<NumIfaceNodes; i++ )
     {
-        if ( feof(Finflows.file) ) return ERR_ROUTING_FILE_FORMAT;
-        fgets(line, MAXLINE, Finflows.file);
-        sscanf(line, "%s", s);
-        IfaceNodes[i] = project_findObject(NODE, s);
+        IfaceNodes[i] = project_findObject(NODE, h->nodeIDs[i]);
     }
-
-    // --- skip over column headings line
-    if ( feof(Finflows.file) ) return ERR_ROUTING_FILE_FORMAT;
-    fgets(line, MAXLINE, Finflows.file);
     return 0;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void readNewIfaceValues()
 //
 //  Input:   none
@@ -546,95 +852,649 @@ void readNewIfaceValues()
 //  Purpose: reads data from inflows interface file for next date.
 //
 {
-    int    i, j;
+    int    i, j, n;
+    size_t recordSize;
+
+    // --- read a record of flows & WQ values for each interface node
+    NewIfaceDate = NO_DATE;
+    if ( IfaceInFormat == TEXT_IFACE )
+    {
+        if ( !readTextRecord(Finflows.file, NumIfaceNodes, NumIfacePolluts,
+                             InRecord) ) return;
+    }
+    else
+    {
+        recordSize = 1 + NumIfaceNodes * (1 + NumIfacePolluts);
+        if ( !readStream(&InStream, InRecord, recordSize * sizeof(REAL8)) )
+            return;
+    }
+
+    // --- convert flows to internal units
+    n = 1;
+    for (i=0; i<NumIfaceNodes; i++)
+    {
+        NewIfaceValues[i][0] = InRecord[n++] / Qcf[IfaceFlowUnits];
+        for (j=1; j<=NumIfacePolluts; j++)
+        {
+            NewIfaceValues[i][j] = InRecord[n++];
+        }
+    }
+    NewIfaceDate = InRecord[0];
+}
+
+//=============================================================================
+
+void setOldIfaceValues()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: replaces old values read from routing interface file with new ones. 
+//
+{
+    int i, j;
+    OldIfaceDate = NewIfaceDate;
+    for ( i=0; i<NumIfaceNodes; i++)
+    {
+        for ( j=0; j<NumIfacePolluts+1; j++ )
+        {
+            OldIfaceValues[i][j] = NewIfaceValues[i][j];
+        }
+    }
+}
+
+//=============================================================================
+
+int  isOutletNode(int i)
+//
+//  Input:   i = node index
+//  Output:  returns 1 if node is an outlet, 0 if not.
+//  Purpose: determines if a node is an outlet point or not.
+//
+{
+    // --- for DW routing only outfalls are outlets
+    if ( RouteModel == DW )
+    {
+        return (Node[i].type == OUTFALL);
+    }
+
+    // --- otherwise outlets are nodes with no outflow links (degree is 0)
+    else return (Node[i].degree == 0);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readTextHeader(FILE* f, TIfaceHeader* h)
+//
+//  Input:   f = ptr. to a text routing interface file
+//  Output:  h = contents of the file's header;
+//           returns an error code
+//  Purpose: reads the header of a text routing interface file.
+//
+{
+    int   i, n = 0;
+    char  line[MAXLINE+1];             // line from interface file
+    char  s1[MAXLINE+1];               // general string variables
+    char  s2[MAXLINE+1];
+
+    // --- check for correct file type
+    line[0] = '\0';
+    s1[0] = '\0';
+    fgets(line, MAXLINE, f);
+    sscanf(line, "%s", s1);
+    if ( !strcomp(s1, "SWMM5") ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read title line
+    fgets(line, MAXLINE, f);
+    line[strcspn(line, "\r\n")] = '\0';
+    sstrncpy(h->title, line, MAXLINE);
+
+    // --- read reporting time step (sec)
+    fgets(line, MAXLINE, f);
+    sscanf(line, "%d", &h->step);
+    if ( h->step <= 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read number of pollutants (minus FLOW)
+    fgets(line, MAXLINE, f);
+    sscanf(line, "%d", &n);
+    h->nPolluts = n - 1;
+    if ( h->nPolluts < 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read flow units
+    s1[0] = '\0';
+    s2[0] = '\0';
+    fgets(line, MAXLINE, f);
+    sscanf(line, "%s %s", s1, s2);
+    if ( !strcomp(s1, "FLOW") )  return ERR_ROUTING_FILE_FORMAT;
+    h->flowUnits = findmatch(s2, FlowUnitWords);
+    if ( h->flowUnits < 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read pollutant names & units
+    if ( allocHeader(h) ) return ERR_MEMORY;
+    for (i=0; i<h->nPolluts; i++)
+    {
+        if ( feof(f) ) return ERR_ROUTING_FILE_FORMAT;
+        fgets(line, MAXLINE, f);
+        sscanf(line, "%s %s", s1, s2);
+        h->pollutIDs[i] = copyString(s1);
+        if ( h->pollutIDs[i] == NULL ) return ERR_MEMORY;
+        h->pollutUnits[i] = findmatch(s2, QualUnitsWords);
+    }
+
+    // --- read number of interface nodes
+    if ( feof(f) ) return ERR_ROUTING_FILE_FORMAT;
+    fgets(line, MAXLINE, f);
+    sscanf(line, "%d", &h->nNodes);
+    if ( h->nNodes < 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read names of interface nodes
+    FREE(h->nodeIDs);
+    if ( allocHeader(h) ) return ERR_MEMORY;
+    for ( i=0; i<h->nNodes; i++ )
+    {
+        if ( feof(f) ) return ERR_ROUTING_FILE_FORMAT;
+        fgets(line, MAXLINE, f);
+        sscanf(line, "%s", s1);
+        h->nodeIDs[i] = copyString(s1);
+        if ( h->nodeIDs[i] == NULL ) return ERR_MEMORY;
+    }
+
+    // --- skip over column headings line
+    if ( feof(f) ) return ERR_ROUTING_FILE_FORMAT;
+    fgets(line, MAXLINE, f);
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeTextHeader(FILE* f, TIfaceHeader* h)
+//
+//  Input:   f = ptr. to a text routing interface file
+//           h = contents of the file's header
+//  Output:  none
+//  Purpose: writes the header of a text routing interface file.
+//
+{
+    int i;
+
+    // --- write title & reporting time step to file
+    fprintf(f, "SWMM5 Interface File");
+    fprintf(f, "\n%s", h->title);
+    fprintf(f, "\n%-4d - reporting time step in sec", h->step);
+
+    // --- write number & names of each constituent (including flow) to file
+    fprintf(f, "\n%-4d - number of constituents as listed below:",
+            h->nPolluts + 1);
+    fprintf(f, "\nFLOW %s", FlowUnitWords[h->flowUnits]);
+    for (i=0; i<h->nPolluts; i++)
+    {
+        fprintf(f, "\n%s %s", h->pollutIDs[i],
+            QualUnitsWords[h->pollutUnits[i]]);
+    }
+
+    // --- write number and names of outlet nodes to file
+    fprintf(f, "\n%-4d - number of nodes as listed below:", h->nNodes);
+    for (i=0; i<h->nNodes; i++)
+    {
+        fprintf(f, "\n%s", h->nodeIDs[i]);
+    }
+
+    // --- write column headings
+    fprintf(f, "\nNode             Year Mon Day Hr  Min Sec FLOW      ");
+    for (i=0; i<h->nPolluts; i++)
+    {
+        fprintf(f, " %-10s", h->pollutIDs[i]);
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readTextRecord(FILE* f, int nNodes, int nPolluts, REAL8* record)
+//
+//  Input:   f = ptr. to a text routing interface file
+//           nNodes = number of nodes on the file
+//           nPolluts = number of pollutants on the file
+//  Output:  record = date followed by flow & quality of each node;
+//           returns TRUE if a complete record was read, FALSE if not
+//  Purpose: reads the lines of a text interface file for its next date.
+//
+{
+    int    i, j, n;
     char*  s;
     int    yr = 0, mon = 0, day = 0,
-		   hr = 0, min = 0, sec = 0;   // year, month, day, hour, minute, second
+           hr = 0, min = 0, sec = 0;   // year, month, day, hour, minute, second
     char   line[MAXLINE+1];            // line from interface file
 
     // --- read a line for each interface node
-    NewIfaceDate = NO_DATE;
-    for (i=0; i<NumIfaceNodes; i++)
+    n = 1;
+    for (i=0; i<nNodes; i++)
     {
-        if ( feof(Finflows.file) ) return;
-        fgets(line, MAXLINE, Finflows.file);
+        if ( feof(f) ) return FALSE;
+        if ( fgets(line, MAXLINE, f) == NULL ) return FALSE;
 
         // --- parse date & time from line
-        if ( strtok(line, SEPSTR) == NULL ) return;
+        if ( strtok(line, SEPSTR) == NULL ) return FALSE;
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         yr  = atoi(s);
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         mon = atoi(s);
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         day = atoi(s);
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         hr  = atoi(s);
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         min = atoi(s);
         s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
+        if ( s == NULL ) return FALSE;
         sec = atoi(s);
 
-        // --- parse flow value
-        s = strtok(NULL, SEPSTR);
-        if ( s == NULL ) return;
-        NewIfaceValues[i][0] = atof(s) / Qcf[IfaceFlowUnits]; 
-
-        // --- parse pollutant values
-        for (j=1; j<=NumIfacePolluts; j++)
+        // --- parse flow & pollutant values
+        for (j=0; j<=nPolluts; j++)
         {
             s = strtok(NULL, SEPSTR);
-            if ( s == NULL ) return;
-            NewIfaceValues[i][j] = atof(s);
+            if ( s == NULL ) return FALSE;
+            record[n++] = atof(s);
         }
-
     }
 
     // --- encode date & time values
-    NewIfaceDate = datetime_encodeDate(yr, mon, day) +
-                   datetime_encodeTime(hr, min, sec);
+    record[0] = datetime_encodeDate(yr, mon, day) +
+                datetime_encodeTime(hr, min, sec);
+    return TRUE;
 }
 
 //=============================================================================
 
-void setOldIfaceValues()
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeTextRecord(FILE* f, TIfaceHeader* h, REAL8* record)
 //
-//  Input:   none
+//  Input:   f = ptr. to a text routing interface file
+//           h = contents of the file's header
+//           record = date followed by flow & quality of each node
 //  Output:  none
-//  Purpose: replaces old values read from routing interface file with new ones. 
+//  Purpose: writes the lines of a text interface file for a given date.
 //
 {
-    int i, j;
-    OldIfaceDate = NewIfaceDate;
-    for ( i=0; i<NumIfaceNodes; i++)
+    int  i, j, n;
+    int  yr, mon, day, hr, min, sec;
+    char theDate[25];
+
+    datetime_decodeDate(record[0], &yr, &mon, &day);
+    datetime_decodeTime(record[0], &hr, &min, &sec);
+    sprintf(theDate, " %04d %02d  %02d  %02d  %02d  %02d ",
+            yr, mon, day, hr, min, sec);
+    n = 1;
+    for (i=0; i<h->nNodes; i++)
     {
-        for ( j=0; j<NumIfacePolluts+1; j++ )
+        // --- write node ID, date, flow, and quality to file
+        fprintf(f, "\n%-16s", h->nodeIDs[i]);
+        fprintf(f, "%s", theDate);
+        for (j=0; j<=h->nPolluts; j++)
         {
-            OldIfaceValues[i][j] = NewIfaceValues[i][j];
+            fprintf(f, " %-10f", record[n++]);
         }
     }
 }
 
 //=============================================================================
 
-int  isOutletNode(int i)
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readBinaryHeader(TIfaceStream* s, TIfaceHeader* h)
 //
-//  Input:   i = node index
-//  Output:  returns 1 if node is an outlet, 0 if not.
-//  Purpose: determines if a node is an outlet point or not.
+//  Input:   s = binary routing interface file or pipe positioned
+//               after its magic number
+//  Output:  h = contents of the file's header;
+//           returns an error code
+//  Purpose: reads the header of a binary routing interface file.
 //
 {
-    // --- for DW routing only outfalls are outlets
-    if ( RouteModel == DW )
+    int   i;
+    INT4  k[3];
+    char* title;
+
+    // --- skip version number
+    if ( !readStream(s, k, sizeof(INT4)) ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read title, time step, flow units & number of pollutants
+    title = readString(s);
+    if ( title == NULL ) return ERR_ROUTING_FILE_FORMAT;
+    sstrncpy(h->title, title, MAXLINE);
+    free(title);
+    if ( !readStream(s, k, 3*sizeof(INT4)) ) return ERR_ROUTING_FILE_FORMAT;
+    h->step = k[0];
+    h->flowUnits = k[1];
+    h->nPolluts = k[2];
+    if ( h->step <= 0 || h->flowUnits < 0 || h->flowUnits > MLD ||
+         h->nPolluts < 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- read pollutant names & units
+    if ( allocHeader(h) ) return ERR_MEMORY;
+    for (i=0; i<h->nPolluts; i++)
     {
-        return (Node[i].type == OUTFALL);
+        h->pollutIDs[i] = readString(s);
+        if ( h->pollutIDs[i] == NULL || !readStream(s, k, sizeof(INT4)) ||
+             k[0] < 0 || k[0] > COUNT ) return ERR_ROUTING_FILE_FORMAT;
+        h->pollutUnits[i] = k[0];
     }
 
-    // --- otherwise outlets are nodes with no outflow links (degree is 0)
-    else return (Node[i].degree == 0);
+    // --- read number & names of nodes
+    if ( !readStream(s, k, sizeof(INT4)) || k[0] < 0 )
+        return ERR_ROUTING_FILE_FORMAT;
+    h->nNodes = k[0];
+    FREE(h->nodeIDs);
+    if ( allocHeader(h) ) return ERR_MEMORY;
+    for (i=0; i<h->nNodes; i++)
+    {
+        h->nodeIDs[i] = readString(s);
+        if ( h->nodeIDs[i] == NULL ) return ERR_ROUTING_FILE_FORMAT;
+    }
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeBinaryHeader(TIfaceStream* s, TIfaceHeader* h)
+//
+//  Input:   s = binary routing interface file or pipe
+//           h = contents of the file's header
+//  Output:  none
+//  Purpose: writes the header of a binary routing interface file.
+//
+{
+    int  i;
+    INT4 k[3];
+
+    k[0] = IFACE_MAGIC;
+    k[1] = VERSION;
+    writeStream(s, k, 2*sizeof(INT4));
+    writeString(s, h->title);
+    k[0] = h->step;
+    k[1] = h->flowUnits;
+    k[2] = h->nPolluts;
+    writeStream(s, k, 3*sizeof(INT4));
+    for (i=0; i<h->nPolluts; i++)
+    {
+        writeString(s, h->pollutIDs[i]);
+        k[0] = h->pollutUnits[i];
+        writeStream(s, k, sizeof(INT4));
+    }
+    k[0] = h->nNodes;
+    writeStream(s, k, sizeof(INT4));
+    for (i=0; i<h->nNodes; i++) writeString(s, h->nodeIDs[i]);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int allocHeader(TIfaceHeader* h)
+//
+//  Input:   h = an interface file header
+//  Output:  returns an error code
+//  Purpose: allocates the header's pollutant and node arrays that have
+//           not already been allocated.
+//
+{
+    if ( h->pollutIDs == NULL )
+    {
+        h->pollutIDs = (char **) calloc(h->nPolluts + 1, sizeof(char *));
+        h->pollutUnits = (int *) calloc(h->nPolluts + 1, sizeof(int));
+    }
+    if ( h->nodeIDs == NULL )
+    {
+        h->nodeIDs = (char **) calloc(h->nNodes + 1, sizeof(char *));
+    }
+    if ( !h->pollutIDs || !h->pollutUnits || !h->nodeIDs ) return ERR_MEMORY;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void freeHeader(TIfaceHeader* h, int freeIDs)
+//
+//  Input:   h = an interface file header
+//           freeIDs = TRUE if the header owns its ID strings
+//  Output:  none
+//  Purpose: frees the memory allocated for an interface file header.
+//
+{
+    int i;
+
+    if ( freeIDs )
+    {
+        for (i=0; h->pollutIDs && i<h->nPolluts; i++) FREE(h->pollutIDs[i]);
+        for (i=0; h->nodeIDs && i<h->nNodes; i++) FREE(h->nodeIDs[i]);
+    }
+    FREE(h->pollutIDs);
+    FREE(h->pollutUnits);
+    FREE(h->nodeIDs);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+TIfacePipe* findPipe(char* name)
+//
+//  Input:   name = name of a pipe
+//  Output:  returns ptr. to the pipe or NULL if it does not exist
+//  Purpose: finds an in-memory interface file by name.
+//
+{
+    TIfacePipe* p;
+
+    for (p = IfacePipes; p != NULL; p = p->next)
+    {
+        if ( strcomp(p->name, name) ) return p;
+    }
+    return NULL;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+TIfacePipe* createPipe(char* name)
+//
+//  Input:   name = name of a pipe
+//  Output:  returns ptr. to an empty pipe or NULL if out of memory
+//  Purpose: creates an in-memory interface file or empties an existing
+//           one with the same name.
+//
+{
+    TIfacePipe* p = findPipe(name);
+
+    if ( p != NULL )
+    {
+        p->size = 0;
+        return p;
+    }
+    p = (TIfacePipe *) calloc(1, sizeof(TIfacePipe));
+    if ( p == NULL ) return NULL;
+    p->data = (char *) malloc(PIPE_BLOCK_SIZE);
+    if ( p->data == NULL )
+    {
+        free(p);
+        return NULL;
+    }
+    sstrncpy(p->name, name, MAXFNAME);
+    p->capacity = PIPE_BLOCK_SIZE;
+    p->next = IfacePipes;
+    IfacePipes = p;
+    return p;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void deletePipe(TIfacePipe* pipe)
+//
+//  Input:   pipe = ptr. to a pipe
+//  Output:  none
+//  Purpose: removes an in-memory interface file from the list of pipes
+//           and frees it.
+//
+{
+    TIfacePipe** p = &IfacePipes;
+
+    while ( *p != NULL && *p != pipe ) p = &(*p)->next;
+    if ( *p == NULL ) return;
+    *p = pipe->next;
+    free(pipe->data);
+    free(pipe);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int readStream(TIfaceStream* s, void* data, size_t size)
+//
+//  Input:   s = binary routing interface file or pipe
+//           size = number of bytes to read
+//  Output:  data = bytes read;
+//           returns TRUE if all bytes were read, FALSE if not
+//  Purpose: reads bytes from a binary interface file or pipe.
+//
+{
+    TIfacePipe* p = s->pipe;
+
+    if ( p == NULL ) return fread(data, 1, size, s->file) == size;
+    if ( size > p->size - s->pos ) return FALSE;
+    memcpy(data, p->data + s->pos, size);
+    s->pos += size;
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int writeStream(TIfaceStream* s, void* data, size_t size)
+//
+//  Input:   s = binary routing interface file or pipe
+//           data = bytes to write
+//           size = number of bytes to write
+//  Output:  returns TRUE if all bytes were written, FALSE if not
+//  Purpose: writes bytes to a binary interface file or pipe.
+//
+{
+    TIfacePipe* p = s->pipe;
+    size_t      capacity;
+    char*       newData;
+
+    if ( p == NULL ) return fwrite(data, 1, size, s->file) == size;
+
+    // --- grow the pipe's storage by doubling it
+    if ( p->size + size > p->capacity )
+    {
+        capacity = p->capacity;
+        while ( p->size + size > capacity ) capacity *= 2;
+        newData = (char *) realloc(p->data, capacity);
+        if ( newData == NULL ) return FALSE;
+        p->data = newData;
+        p->capacity = capacity;
+    }
+    memcpy(p->data + p->size, data, size);
+    p->size += size;
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+char* readString(TIfaceStream* s)
+//
+//  Input:   s = binary routing interface file or pipe
+//  Output:  returns a newly allocated string or NULL if none could be read
+//  Purpose: reads a length-prefixed string from a binary interface file.
+//
+{
+    INT4  n;
+    char* str;
+
+    if ( !readStream(s, &n, sizeof(INT4)) || n < 0 || n > MAXLINE )
+        return NULL;
+    str = (char *) malloc(n + 1);
+    if ( str == NULL ) return NULL;
+    if ( !readStream(s, str, n) )
+    {
+        free(str);
+        return NULL;
+    }
+    str[n] = '\0';
+    return str;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeString(TIfaceStream* s, char* str)
+//
+//  Input:   s = binary routing interface file or pipe
+//           str = a string
+//  Output:  none
+//  Purpose: writes a length-prefixed string to a binary interface file.
+//
+{
+    INT4 n = (INT4)strlen(str);
+
+    writeStream(s, &n, sizeof(INT4));
+    writeStream(s, str, n);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+char* copyString(char* s)
+//
+//  Input:   s = a string
+//  Output:  returns a newly allocated copy of s or NULL if out of memory
+//  Purpose: copies an ID name read from an interface file.
+//
+{
+    char* str = (char *) malloc(strlen(s) + 1);
+
+    if ( str != NULL ) strcpy(str, s);
+    return str;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int isFifo(FILE* f)
+//
+//  Input:   f = an open file
+//  Output:  returns TRUE if the file is a named pipe, FALSE if not
+//  Purpose: checks if a routing interface file is a named pipe (FIFO).
+//
+{
+#ifdef _WIN32
+    return FALSE;
+#else
+    struct stat st;
+    if ( fstat(fileno(f), &st) != 0 ) return FALSE;
+    return S_ISFIFO(st.st_mode);
+#endif
 }
@@ -66,6 +66,21 @@ int  DLLEXPORT   swmm_run_cb(const char *f1, const char *f2, const char *f3,
 */
 int DLLEXPORT swmm_getAPIError(int errorCode, char **errorMsg);
 
+/**
+ @brief Convert a routing interface file between text and binary formats.
+ @param inFile Name of an existing routing interface file (either format)
+ @param outFile Name of the file to create in the other format
+ @return Error code
+*/
+int DLLEXPORT swmm_convertIfaceFile(const char *inFile, const char *outFile);
+
+/**
+ @brief Free the in-memory routing interface files (PIPE format) that no
+ project run has read. A pipe is otherwise freed once a run has read it.
+ @return Error code
+*/
+int DLLEXPORT swmm_deleteIfacePipes(void);
+
 /**
  @brief Finds the index of an object given its ID.
  @param type An object type (see @ref SM_ObjectType)
@@ -562,6 +577,61 @@ int DLLEXPORT swmm_setOutfallStage(int index, double stage);
 */
 int DLLEXPORT swmm_setGagePrecip(int index, double total_precip);
 
+/**
+ @brief Append data points to the end of a time series. May be called before
+ or while a simulation runs so that newly observed data can be streamed in.
+ @param index The time series index.
+ @param n The number of data points to append.
+ @param dates The dates of the points as decimal days (the date encoding used
+ by the binary output file). They must be in ascending order and later than
+ the series' last point.
+ @param values The values of the points in the units used for the series in
+ the input file.
+ @return Error code
+*/
+int DLLEXPORT swmm_appendTimeseries(int index, int n, double *dates,
+    double *values);
+
+/**
+ @brief Append rainfall readings to the time series a rain gage uses.
+ @param index The gage index.
+ @param n The number of readings to append.
+ @param dates The dates of the readings as decimal days, in ascending order.
+ @param values The readings in the gage's rain format and units.
+ @return Error code
+*/
+int DLLEXPORT swmm_appendGageData(int index, int n, double *dates,
+    double *values);
+
+/**
+ @brief Replace all of a time series' data points. Can only be called while
+ no simulation is running.
+ @param index The time series index.
+ @param n The number of data points (at least 1).
+ @param dates The dates of the points as decimal days, in ascending order.
+ @param values The values of the points in the units used for the series in
+ the input file.
+ @return Error code
+*/
+int DLLEXPORT swmm_replaceTimeseries(int index, int n, double *dates,
+    double *values);
+
+/**
+ @brief Save the current state of a running simulation in memory. A later
+ run of the same open project can start from it (see swmm_restoreState).
+ Only the last state saved is kept; it is discarded when the project closes.
+ @return Error code
+*/
+int DLLEXPORT swmm_saveState(void);
+
+/**
+ @brief Start the next simulation (begun with swmm_start) from the state last
+ saved with swmm_saveState instead of from initial conditions or a hot start
+ file. Must be called before swmm_start.
+ @return Error code
+*/
+int DLLEXPORT swmm_restoreState(void);
+
 /**
  @brief Helper function to free memory array allocated in SWMM.
  @param array The pointer to the array
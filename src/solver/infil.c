@@ -9,6 +9,7 @@
 //             08/05/15  (Build 5.1.010)
 //             08/01/16  (Build 5.1.011)
 //             05/10/17  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Infiltration functions.
@@ -33,6 +34,10 @@
 //   Build 5.1.013:
 //   - Support added for subcatchment-specific time patterns that adjust
 //     hydraulic conductivity.
+//
+//   Build 5.1.015:
+//   - Monthly conductivity pattern uses the month held in RunoffCalendar.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -287,7 +292,7 @@ void infil_setInfilFactor(int j)
         p = Subcatch[j].infilPattern;
         if (p >= 0 && Pattern[p].type == MONTHLY_PATTERN)
         {
-            m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
+            m = RunoffCalendar.month - 1;                                      //(5.1.015)
             InfilFactor = Pattern[p].factor[m];
         }
     }
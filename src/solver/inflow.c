@@ -4,17 +4,57 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14  (Build 5.1.001)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Manages any Direct External or Dry Weather Flow inflows
 //   that have been assigned to nodes of the drainage system.
+//
+//   Build 5.1.015:
+//   - External and dry weather inflows are compiled into a dense inflow
+//     schedule at the start of routing and evaluated in a single pass
+//     over the nodes that have them each routing time step.
+//   - Dry weather inflow pattern products are only re-evaluated when
+//     the month, day of week or hour of day changes.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Inflow schedule data
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int     node;                 // index of node receiving inflows
+    int     firstExt;             // position of first external inflow
+    int     lastExt;              // position past last external inflow
+    int     firstDwf;             // position of first DWF inflow
+    int     lastDwf;              // position past last DWF inflow
+    char    hasExtFlow;           // TRUE if first external inflow is FLOW
+    char    hasDwfFlow;           // TRUE if first DWF inflow is FLOW
+}  TSchedNode;
+
+static TSchedNode*   SchedNodes;  // nodes with external or DWF inflows
+static int           NumSchedNodes;
+static TExtInflow**  ExtEntries;  // external inflows ordered by node
+static TDwfInflow**  DwfEntries;  // DWF inflows ordered by node
+static double*       DwfValues;   // DWF values at current pattern period
+static int           DwfPeriod;   // month/day/hour code of DwfValues
+static int           SchedStale;  // TRUE if schedule must be rebuilt
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int    buildSchedule(void);
+static void   freeSchedule(void);
+static void   updateDwfValues(int month, int day, int hour);
+static double getExtInflowValue(TExtInflow* inflow, DateTime aDate,
+              int month, int day, int hour);
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -23,9 +63,12 @@
 //  inflow_readDwfInflow    (called by input_readLine)
 //  inflow_deleteExtInflows (called by deleteObjects in project.c)
 //  inflow_deleteDwfInflows (called by deleteObjects in project.c)
-//  inflow_getExtInflow     (called by addExternalInflows in routing.c)
-//  inflow_getDwfInflow     (called by addDryWeatherInflows in routing.c)
+//  inflow_getExtInflow
+//  inflow_getDwfInflow
 //  inflow_getPatternFactor
+//  inflow_openSchedule     (called by routing_open)
+//  inflow_closeSchedule    (called by routing_close)
+//  inflow_addScheduledInflows (called by routing_execute)
 
 //=============================================================================
 
@@ -212,6 +255,7 @@ int inflow_setExtInflow(int j, int param, int type, int tseries, int basePat,
 			}
 			inflow->next = Node[j].extInflow;
 			Node[j].extInflow = inflow;
+			SchedStale = TRUE;
 		}
 		
 		// Assigning Values to the inflow object 
@@ -258,7 +302,32 @@ double inflow_getExtInflow(TExtInflow* inflow, DateTime aDate)
 //           date and time.
 //
 {
-    int    month, day, hour;
+    int month = -1, day = -1, hour = -1;
+
+    if ( inflow->basePat >= 0 )
+    {
+        month = datetime_monthOfYear(aDate) - 1;
+        day   = datetime_dayOfWeek(aDate) - 1;
+        hour  = datetime_hourOfDay(aDate);
+    }
+    return getExtInflowValue(inflow, aDate, month, day, hour);
+}
+
+//=============================================================================
+
+double getExtInflowValue(TExtInflow* inflow, DateTime aDate, int month,
+                         int day, int hour)
+//
+//  Input:   inflow = external inflow data structure
+//           aDate = current simulation date/time
+//           month = month of year of aDate (zero-based)
+//           day = day of week of aDate (zero-based)
+//           hour = hour of day of aDate
+//  Output:  returns current value of external inflow parameter
+//  Purpose: evaluates an external inflow using a pre-computed calendar
+//           decomposition of the current date.
+//
+{
     int    p = inflow->basePat;      // baseline pattern
     int    k = inflow->tSeries;      // time series index
     double cf = inflow->cFactor;     // units conversion factor
@@ -267,13 +336,7 @@ double inflow_getExtInflow(TExtInflow* inflow, DateTime aDate)
     double tsv = 0.0;                // time series value
 	double extIfaceInflow = inflow->extIfaceInflow;// external interfacing inflow
 
-    if ( p >= 0 )
-    {
-        month = datetime_monthOfYear(aDate) - 1;
-        day   = datetime_dayOfWeek(aDate) - 1;
-        hour  = datetime_hourOfDay(aDate);
-        blv  *= inflow_getPatternFactor(p, month, day, hour);
-    }
+    if ( p >= 0 ) blv *= inflow_getPatternFactor(p, month, day, hour);
     if ( k >= 0 ) tsv = table_tseriesLookup(&Tseries[k], aDate, FALSE) * sf;
     return cf * (tsv + blv) + cf * extIfaceInflow;
 }
@@ -529,4 +592,299 @@ double inflow_getPatternFactor(int p, int month, int day, int hour)
     return 1.0;
 }
 
-//=============================================================================
\ No newline at end of file
+//=============================================================================
+int inflow_openSchedule()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: compiles the external and dry weather inflows assigned to nodes
+//           into an inflow schedule used throughout a routing run.
+//
+{
+    SchedNodes = NULL;
+    ExtEntries = NULL;
+    DwfEntries = NULL;
+    DwfValues = NULL;
+    NumSchedNodes = 0;
+    if ( !buildSchedule() ) report_writeErrorMsg(ERR_MEMORY, "");
+    return ErrorCode;
+}
+
+//=============================================================================
+
+void inflow_closeSchedule()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used by the inflow schedule.
+//
+{
+    freeSchedule();
+}
+
+//=============================================================================
+
+void inflow_addScheduledInflows(DateTime aDate)
+//
+//  Input:   aDate = current date/time
+//  Output:  none
+//  Purpose: adds direct external and dry weather inflows to the lateral
+//           inflow and pollutant loads of nodes at the current date.
+//
+{
+    int     i, j, k, p;
+    int     month, day, hour;
+    double  q, qDwf, w;
+    TSchedNode* sn;
+    TExtInflow* inflow;
+
+    // --- re-compile the schedule if new inflows were added at run time
+    if ( SchedStale && !buildSchedule() )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    if ( NumSchedNodes == 0 ) return;
+
+    // --- get month (zero-based), day-of-week (zero-based),
+    //     & hour-of-day for routing date/time
+    datetime_setCalendar(&RoutingCalendar, aDate);
+    month = RoutingCalendar.month - 1;
+    day   = RoutingCalendar.dayOfWeek - 1;
+    hour  = RoutingCalendar.hour;
+
+    // --- update DWF values if the pattern period has changed
+    updateDwfValues(month, day, hour);
+
+    // --- add external inflows to each node that has them
+    for (i = 0; i < NumSchedNodes; i++)
+    {
+        sn = &SchedNodes[i];
+        if ( sn->firstExt == sn->lastExt ) continue;
+        j = sn->node;
+
+        // --- get flow inflow (listed first in the node's entries)
+        k = sn->firstExt;
+        q = 0.0;
+        if ( sn->hasExtFlow )
+        {
+            q = getExtInflowValue(ExtEntries[k], aDate, month, day, hour);
+            k++;
+        }
+        if ( fabs(q) < FLOW_TOL ) q = 0.0;
+
+        // --- add flow inflow to node's lateral inflow
+        Node[j].newLatFlow += q;
+        massbal_addInflowFlow(EXTERNAL_INFLOW, q);
+
+        // --- add on any inflow (i.e., reverse flow) through an outfall
+        if ( Node[j].type == OUTFALL && Node[j].oldNetInflow < 0.0 )
+        {
+            q = q - Node[j].oldNetInflow;
+        }
+
+        // --- get pollutant mass inflows
+        for ( ; k < sn->lastExt; k++)
+        {
+            inflow = ExtEntries[k];
+            p = inflow->param;
+            w = getExtInflowValue(inflow, aDate, month, day, hour);
+            if ( inflow->type == CONCEN_INFLOW ) w *= q;
+            Node[j].newQual[p] += w;
+            massbal_addInflowQual(EXTERNAL_INFLOW, p, w);
+        }
+    }
+
+    // --- add dry weather inflows to each node that has them
+    for (i = 0; i < NumSchedNodes; i++)
+    {
+        sn = &SchedNodes[i];
+        if ( sn->firstDwf == sn->lastDwf ) continue;
+        j = sn->node;
+
+        // --- get flow inflow (listed first in the node's entries)
+        k = sn->firstDwf;
+        qDwf = 0.0;
+        if ( sn->hasDwfFlow )
+        {
+            qDwf = DwfValues[k];
+            k++;
+        }
+        if ( fabs(qDwf) < FLOW_TOL ) qDwf = 0.0;
+
+        // --- add flow inflow to node's lateral inflow
+        Node[j].newLatFlow += qDwf;
+        massbal_addInflowFlow(DRY_WEATHER_INFLOW, qDwf);
+
+        // --- stop if inflow is non-positive
+        if ( qDwf <= 0.0 ) continue;
+
+        // --- add default DWF pollutant inflows
+        for ( p = 0; p < Nobjects[POLLUT]; p++)
+        {
+            if ( Pollut[p].dwfConcen > 0.0 )
+            {
+                w = qDwf * Pollut[p].dwfConcen;
+                Node[j].newQual[p] += w;
+                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
+            }
+        }
+
+        // --- get pollutant mass inflows
+        for ( ; k < sn->lastDwf; k++)
+        {
+            p = DwfEntries[k]->param;
+            w = qDwf * DwfValues[k];
+            Node[j].newQual[p] += w;
+            massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
+
+            // --- subtract off any default inflow
+            if ( Pollut[p].dwfConcen > 0.0 )
+            {
+                w = qDwf * Pollut[p].dwfConcen;
+                Node[j].newQual[p] -= w;
+                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, -w);
+            }
+        }
+    }
+}
+
+//=============================================================================
+
+int buildSchedule()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: fills the inflow schedule's arrays from the external and dry
+//           weather inflow lists attached to each node.
+//
+//  Each node's entries are stored contiguously with its FLOW inflow (if
+//  any) placed first, followed by its pollutant inflows in list order.
+//
+{
+    int j, n, nExt = 0, nDwf = 0;
+    TExtInflow* extInflow;
+    TDwfInflow* dwfInflow;
+    TSchedNode* sn;
+
+    // --- count nodes and inflow entries to be scheduled
+    freeSchedule();
+    SchedStale = FALSE;
+    DwfPeriod = -1;
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        if ( !Node[j].extInflow && !Node[j].dwfInflow ) continue;
+        NumSchedNodes++;
+        for (extInflow = Node[j].extInflow; extInflow;
+             extInflow = extInflow->next) nExt++;
+        for (dwfInflow = Node[j].dwfInflow; dwfInflow;
+             dwfInflow = dwfInflow->next) nDwf++;
+    }
+    if ( NumSchedNodes == 0 ) return TRUE;
+
+    // --- allocate schedule arrays
+    SchedNodes = (TSchedNode *) calloc(NumSchedNodes, sizeof(TSchedNode));
+    ExtEntries = (TExtInflow **) calloc(nExt + 1, sizeof(TExtInflow *));
+    DwfEntries = (TDwfInflow **) calloc(nDwf + 1, sizeof(TDwfInflow *));
+    DwfValues  = (double *) calloc(nDwf + 1, sizeof(double));
+    if ( !SchedNodes || !ExtEntries || !DwfEntries || !DwfValues )
+    {
+        freeSchedule();
+        return FALSE;
+    }
+
+    // --- fill the schedule node by node
+    nExt = 0;
+    nDwf = 0;
+    n = 0;
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        if ( !Node[j].extInflow && !Node[j].dwfInflow ) continue;
+        sn = &SchedNodes[n++];
+        sn->node = j;
+
+        // --- external inflows, with the first FLOW inflow placed first
+        //     (matching the search made when the lists were walked)
+        sn->firstExt = nExt;
+        for (extInflow = Node[j].extInflow; extInflow;
+             extInflow = extInflow->next)
+        {
+            if ( extInflow->type == FLOW_INFLOW )
+            {
+                ExtEntries[nExt++] = extInflow;
+                sn->hasExtFlow = TRUE;
+                break;
+            }
+        }
+        for (extInflow = Node[j].extInflow; extInflow;
+             extInflow = extInflow->next)
+        {
+            if ( extInflow->type != FLOW_INFLOW )
+                ExtEntries[nExt++] = extInflow;
+        }
+        sn->lastExt = nExt;
+
+        // --- DWF inflows, with the first FLOW inflow placed first
+        sn->firstDwf = nDwf;
+        for (dwfInflow = Node[j].dwfInflow; dwfInflow;
+             dwfInflow = dwfInflow->next)
+        {
+            if ( dwfInflow->param < 0 )
+            {
+                DwfEntries[nDwf++] = dwfInflow;
+                sn->hasDwfFlow = TRUE;
+                break;
+            }
+        }
+        for (dwfInflow = Node[j].dwfInflow; dwfInflow;
+             dwfInflow = dwfInflow->next)
+        {
+            if ( dwfInflow->param >= 0 ) DwfEntries[nDwf++] = dwfInflow;
+        }
+        sn->lastDwf = nDwf;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void freeSchedule()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the inflow schedule's arrays.
+//
+{
+    FREE(SchedNodes);
+    FREE(ExtEntries);
+    FREE(DwfEntries);
+    FREE(DwfValues);
+    NumSchedNodes = 0;
+}
+
+//=============================================================================
+
+void updateDwfValues(int month, int day, int hour)
+//
+//  Input:   month = current month of year of simulation
+//           day = current day of week of simulation
+//           hour = current hour of day of simulation
+//  Output:  none
+//  Purpose: re-evaluates the pattern-adjusted value of each scheduled dry
+//           weather inflow when the pattern period changes.
+//
+{
+    int k, n;
+    int period = (month * 7 + day) * 24 + hour;
+
+    if ( period == DwfPeriod ) return;
+    DwfPeriod = period;
+    if ( NumSchedNodes == 0 ) return;
+    n = SchedNodes[NumSchedNodes-1].lastDwf;
+    for (k = 0; k < n; k++)
+    {
+        DwfValues[k] = inflow_getDwfInflow(DwfEntries[k], month, day, hour);
+    }
+}
+
+//=============================================================================
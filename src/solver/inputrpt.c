@@ -4,10 +4,15 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14 (Build 5.1.001)
+//             10/17/26 (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Report writing functions for input data summary.
 //
+//   Build 5.1.015:
+//   - Shape and transect geometry tables are formatted into a line buffer
+//     instead of with one fprintf call per entry.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -18,6 +23,11 @@
 
 #define WRITE(x) (report_writeLine((x)))
 
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static void writeGeomTable(char* label, double* table, int n);                 //(5.1.015)
+
 //=============================================================================
 
 void inputrpt_writeInput()
@@ -27,7 +37,6 @@ void inputrpt_writeInput()
 //  Purpose: writes summary of input data to report file.
 //
 {
-    int m;
     int i, k;
     int lidCount = 0;
     if ( ErrorCode ) return;
@@ -261,24 +270,9 @@ void inputrpt_writeInput()
         {
             k = Shape[i].curve;
             fprintf(Frpt.file, "\n\n  Shape %s", Curve[k].ID);
-            fprintf(Frpt.file, "\n  Area:  ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Shape[i].areaTbl[m]);
-            }
-            fprintf(Frpt.file, "\n  Hrad:  ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Shape[i].hradTbl[m]);
-            }
-            fprintf(Frpt.file, "\n  Width: ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Shape[i].widthTbl[m]);
-            }
+            writeGeomTable("Area:  ", Shape[i].areaTbl, N_SHAPE_TBL);          //(5.1.015)
+            writeGeomTable("Hrad:  ", Shape[i].hradTbl, N_SHAPE_TBL);          //(5.1.015)
+            writeGeomTable("Width: ", Shape[i].widthTbl, N_SHAPE_TBL);         //(5.1.015)
         }
     }
     WRITE("");
@@ -293,25 +287,44 @@ void inputrpt_writeInput()
         for (i = 0; i < Nobjects[TRANSECT]; i++)
         {
             fprintf(Frpt.file, "\n\n  Transect %s", Transect[i].ID);
-            fprintf(Frpt.file, "\n  Area:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Transect[i].areaTbl[m]);
-            }
-            fprintf(Frpt.file, "\n  Hrad:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Transect[i].hradTbl[m]);
-            }
-            fprintf(Frpt.file, "\n  Width: ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
-            {
-                 if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
-                 fprintf(Frpt.file, "%10.4f ", Transect[i].widthTbl[m]);
-            }
+            writeGeomTable("Area:  ", Transect[i].areaTbl, N_TRANSECT_TBL);    //(5.1.015)
+            writeGeomTable("Hrad:  ", Transect[i].hradTbl, N_TRANSECT_TBL);    //(5.1.015)
+            writeGeomTable("Width: ", Transect[i].widthTbl, N_TRANSECT_TBL);   //(5.1.015)
         }
     }
     WRITE("");
 }
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeGeomTable(char* label, double* table, int n)
+//
+//  Input:   label = table label
+//           table = array of normalized geometry values
+//           n = size of table
+//  Output:  none
+//  Purpose: writes the entries 1 to n-1 of a geometry table to the report
+//           file, five entries per line.
+//
+{
+    int  m, len;
+    char line[MAXLINE+1];
+
+    len = sprintf(line, "\n  %s", label);
+    for ( m = 1; m < n; m++ )
+    {
+        if ( m % 5 == 1 ) len += sprintf(line+len, "\n          ");
+        len += report_formatFixed(line+len, table[m], 10, 4);
+        line[len++] = ' ';
+
+        // --- flush the line buffer before it can overflow
+        if ( len > MAXLINE - 64 )
+        {
+            fwrite(line, sizeof(char), len, Frpt.file);
+            len = 0;
+        }
+    }
+    fwrite(line, sizeof(char), len, Frpt.file);
+}
@@ -10,6 +10,7 @@
 //            08/05/15  (Build 5.1.010)
 //            08/01/16  (Build 5.1.011)
 //            05/10/18  (Build 5.1.013)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Exportable keyword dictionary
@@ -37,6 +38,16 @@
 //   Build 5.1.013:
 //   - New option keywords w_SURCHARGE_METHOD, w_RULE_STEP, w_AVERAGES 
 //     and w_WEIR added.
+//
+//   Build 5.1.015:
+//   - GEOMETRY_TBL_SIZE, STATISTICS_STRIDE and STATISTICS_TOP_N option
+//     keywords added.
+//   - LID_REPORT_FORMAT option keyword and LidRptFormatWords added.
+//   - IfaceFormatWords added.
+//   - QUANTIZE report keyword, OutStorageWords and result variable keyword
+//     arrays added.
+//   - FORCE_MAIN_TABLE option keyword added.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -57,13 +68,19 @@ char* FileModeWords[]      = { w_NO, w_SCRATCH, w_USE, w_SAVE, NULL};
 char* FlowUnitWords[]      = { w_CFS, w_GPM, w_MGD, w_CMS, w_LPS, w_MLD, NULL};
 char* ForceMainEqnWords[]  = { w_H_W, w_D_W, NULL};
 char* GageDataWords[]      = { w_TIMESERIES, w_FILE, NULL};
+char* IfaceFormatWords[]   = { w_TEXT, w_BINARY, w_PIPE, NULL};                //(5.1.015)
 char* InfilModelWords[]    = { w_HORTON, w_MOD_HORTON, w_GREEN_AMPT,
                                w_MOD_GREEN_AMPT, w_CURVE_NUMEBR, NULL};
 char* InertDampingWords[]  = { w_NONE, w_PARTIAL, w_FULL, NULL};
+char* LidRptFormatWords[]  = { w_TEXT, w_BINARY, NULL};                        //(5.1.015)
 char* LinkOffsetWords[]    = { w_DEPTH, w_ELEVATION, NULL};
+char* LinkResultWords[]    = { w_FLOW, w_DEPTH, w_VELOCITY, w_VOLUME,          //(5.1.015)
+                               w_CAPACITY, w_QUALITY, NULL};                   //(5.1.015)
 char* LinkTypeWords[]      = { w_CONDUIT, w_PUMP, w_ORIFICE,
                                w_WEIR, w_OUTLET };
 char* LoadUnitsWords[]     = { w_LBS, w_KG, w_LOGN };
+char* NodeResultWords[]    = { w_DEPTH, w_HEAD, w_VOLUME, w_LATERAL_INFLOW,    //(5.1.015)
+                               w_TOTAL_INFLOW, w_FLOODING, w_QUALITY, NULL};   //(5.1.015)
 char* NodeTypeWords[]      = { w_JUNCTION, w_OUTFALL,
                                w_STORAGE, w_DIVIDER };
 char* NoneAllWords[]       = { w_NONE, w_ALL, NULL};
@@ -94,10 +111,14 @@ char* OptionWords[]        = { w_FLOW_UNITS,        w_INFIL_MODEL,
                                w_SYS_FLOW_TOL,      w_LAT_FLOW_TOL,
                                w_IGNORE_RDII,       w_MIN_ROUTE_STEP,
                                w_NUM_THREADS,       w_SURCHARGE_METHOD,        //(5.1.013)
+                               w_GEOM_TBL_SIZE,     w_STATS_STRIDE,            //(5.1.015)
+                               w_STATS_TOP_N,       w_LID_RPT_FORMAT,          //(5.1.015)
+                               w_FORCE_MAIN_TBL,                               //(5.1.015)
                                NULL };
 char* OrificeTypeWords[]   = { w_SIDE, w_BOTTOM, NULL};
 char* OutfallTypeWords[]   = { w_FREE, w_NORMAL, w_FIXED, w_TIDAL,
                                w_TIMESERIES, NULL};
+char* OutStorageWords[]    = { w_FLOAT, w_HALF, w_INT16, NULL};                //(5.1.015)
 char* PatternTypeWords[]   = { w_MONTHLY, w_DAILY, w_HOURLY, w_WEEKEND, NULL};
 char* PondingUnitsWords[]  = { w_PONDED_FEET, w_PONDED_METERS };
 char* ProcessVarWords[]    = { w_HRT, w_DT, w_FLOW, w_DEPTH, w_AREA, NULL};
@@ -108,7 +129,8 @@ char* RainUnitsWords[]     = { w_INCHES, w_MMETER, NULL};
 char* RelationWords[]      = { w_TABULAR, w_FUNCTIONAL, NULL};
 char* ReportWords[]        = { w_INPUT, w_CONTINUITY, w_FLOWSTATS,
                                w_CONTROLS, w_SUBCATCH, w_NODE, w_LINK,
-                               w_NODESTATS, w_AVERAGES, NULL};                 //(5.1.013)
+                               w_NODESTATS, w_AVERAGES,                        //(5.1.013)
+                               w_QUANTIZE, NULL};                              //(5.1.015)
 char* RouteModelWords[]    = { w_NONE, w_STEADY, w_KINWAVE, w_XKINWAVE,
                                w_DYNWAVE, NULL};
 char* RuleKeyWords[]       = { w_RULE, w_IF, w_AND, w_OR, w_THEN, w_ELSE, 
@@ -143,6 +165,9 @@ char* SectWords[]          = { ws_TITLE,          ws_OPTION,
                                NULL};                       
 char* SnowmeltWords[]      = { w_PLOWABLE, w_IMPERV, w_PERV, w_REMOVAL, NULL};
 char* SurchargeWords[]     = { w_EXTRAN, w_SLOT, NULL};                        //(5.1.013)
+char* SubcatchResultWords[] = { w_RAINFALL, w_SNOW_DEPTH, w_EVAPORATION,       //(5.1.015)
+                               w_INFILTRATION, w_RUNOFF, w_GW_FLOW,            //(5.1.015)
+                               w_GW_ELEV, w_SOIL_MOISTURE, w_WASHOFF, NULL};   //(5.1.015)
 char* TempKeyWords[]       = { w_TIMESERIES, w_FILE, w_WINDSPEED, w_SNOWMELT,
                                w_ADC, NULL};
 char* TransectKeyWords[]   = { w_NC, w_X1, w_GR, NULL};
@@ -6,6 +6,7 @@
 //   Date:    03/19/14   (Build 5.1.000)
 //            03/19/15   (Build 5.1.008)
 //            05/10/18   (Build 5.1.013)
+//            10/17/26   (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Exportable keyword dictionary
@@ -15,6 +16,12 @@
 //
 //   Build 5.1.013:
 //   - New keyword array defined for surcharge method.
+//
+//   Build 5.1.015:
+//   - LidRptFormatWords added.
+//   - IfaceFormatWords added.
+//   - OutStorageWords and result variable keyword arrays added.
+//
 //-----------------------------------------------------------------------------
 
 extern char* BuildupTypeWords[];
@@ -27,11 +34,15 @@ extern char* FileTypeWords[];
 extern char* FlowUnitWords[];
 extern char* ForceMainEqnWords[];
 extern char* GageDataWords[];
+extern char* IfaceFormatWords[];                                               //(5.1.015)
 extern char* InertDampingWords[];
 extern char* InfilModelWords[];
+extern char* LidRptFormatWords[];                                              //(5.1.015)
 extern char* LinkOffsetWords[];
+extern char* LinkResultWords[];                                                //(5.1.015)
 extern char* LinkTypeWords[];
 extern char* LoadUnitsWords[];
+extern char* NodeResultWords[];                                                //(5.1.015)
 extern char* NodeTypeWords[];
 extern char* NoneAllWords[];
 extern char* NormalFlowWords[];
@@ -42,6 +53,7 @@ extern char* OffOnWords[];
 extern char* OptionWords[];
 extern char* OrificeTypeWords[];
 extern char* OutfallTypeWords[];
+extern char* OutStorageWords[];                                                //(5.1.015)
 extern char* PatternTypeWords[];
 extern char* PondingUnitsWords[];
 extern char* ProcessVarWords[];
@@ -55,6 +67,7 @@ extern char* RouteModelWords[];
 extern char* RuleKeyWords[];
 extern char* SectWords[];
 extern char* SnowmeltWords[];
+extern char* SubcatchResultWords[];                                            //(5.1.015)
 extern char* SurchargeWords[];                                                 //(5.1.013)
 extern char* TempKeyWords[];
 extern char* TransectKeyWords[];
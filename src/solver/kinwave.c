@@ -6,6 +6,7 @@
 //   Date:     03/20/14  (Build 5.1.001)
 //             03/19/15  (Build 5.1.008)
 //             03/01/20  (Build 5.1.014)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -17,6 +18,13 @@
 //   Build 5.1.014:
 //   - Arguments to function link_getLossRate changed.
 //
+//   Build 5.1.015:
+//   - Module-level shared variables replaced with a per-call TKinwave
+//     structure so that conduits can be routed concurrently.
+//   - kinwave_executeBatch() added to route a group of independent conduits
+//     whose continuity eqns. are solved together by findroot_NewtonBatch(),
+//     one batch for each shape of cross section.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -30,27 +38,51 @@
 static const double WX      = 0.6;     // distance weighting
 static const double WT      = 0.6;     // time weighting
 static const double EPSIL   = 0.001;   // convergence criterion
+static const int    NEWTON_STEPS = 4;  // batched Newton steps taken in lockstep
 
 //-----------------------------------------------------------------------------
-//  Shared variables
+//  Data Structures
 //-----------------------------------------------------------------------------
-static double   Beta1;
-static double   C1;
-static double   C2;
-static double   Afull;
-static double   Qfull;
-static TXsect*  pXsect;
+typedef struct                         // a conduit being routed
+{
+    int      link;                     // link index
+    double   qin;                      // normalized inflow
+    double   ain;                      // normalized inlet area
+    double   aout;                     // normalized outlet area
+    double   qout;                     // normalized outflow
+    double   beta1;                    // section factor coeff. / full flow
+    double   c1;                       // coeff. of outlet area
+    double   c2;                       // constant term
+    double   aFull;                    // full flow area (ft2)
+    double   qFull;                    // full flow (cfs)
+    TXsect*  xsect;                    // conduit's cross section
+}  TKinwave;
+
+typedef struct                         // conduits solved together
+{
+    int        type;                   // shape of their cross sections
+    TKinwave** kw;                     // each conduit being routed
+}  TKinwaveBatch;
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
-//  kinwave_execute  (called by flowrout_execute)
+//  kinwave_execute       (called by flowrout_execute)
+//  kinwave_executeBatch  (called by flowrout_execute)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
-static int   solveContinuity(double qin, double ain, double* aout);
+static int   initConduit(TKinwave* kw, int j, double qinflow, double tStep);
+static int   findBounds(TKinwave* kw, double* aLo, double* aHi);
+static int   solveContinuity(TKinwave* kw);
+static int   getOutflow(TKinwave* kw, int* result);
+static void  saveConduitState(TKinwave* kw, double* qinflow,
+             double* qoutflow);
+static void  solveBatch(int n, TKinwave* kw[], int result[]);
 static void  evalContinuity(double a, double* f, double* df, void* p);
+static void  evalContinuityBatch(int n, int lanes[], double a[], double f[],
+             double df[], void* p);
 
 //=============================================================================
 
@@ -73,12 +105,8 @@ int kinwave_execute(int j, double* qinflow, double* qoutflow, double tStep)
 //
 //
 {
-    int    k;
     int    result = 1;
-    double dxdt, dq;
-    double ain, aout;
-    double qin, qout;
-    double a1, a2, q1, q2, q3;
+    TKinwave kw;
 
     // --- no routing for non-conduit link
     (*qoutflow) = (*qinflow); 
@@ -87,131 +115,261 @@ int kinwave_execute(int j, double* qinflow, double* qoutflow, double tStep)
     // --- no routing for dummy xsection
     if ( Link[j].xsect.type == DUMMY ) return result;
 
-    // --- assign module-level variables
-    pXsect = &Link[j].xsect;
-    Qfull = Link[j].qFull;
-    Afull = Link[j].xsect.aFull;
+    // --- solve finite difference form of continuity eqn. unless
+    //     there is no flow
+    if ( initConduit(&kw, j, *qinflow, tStep) )
+    {
+        result = solveContinuity(&kw);
+        if ( !getOutflow(&kw, &result) ) return 1;
+    }
+
+    // --- save new flows and areas
+    saveConduitState(&kw, qinflow, qoutflow);
+    return result;
+}
+
+//=============================================================================
+
+int kinwave_executeBatch(int n, int links[], double qinflow[],
+                         double qoutflow[], double tStep)
+//
+//  Input:   n = number of links
+//           links = array of link indexes
+//           qinflow = inflow to each link at current time (cfs)
+//           tStep = time step (sec)
+//  Output:  qinflow = adjusted inflow to each link (cfs)
+//           qoutflow = outflow from each link at current time (cfs),
+//           returns total number of iterations used
+//  Purpose: performs Kinematic Wave flow routing through a group of links
+//           whose inflows do not depend on one another.
+//
+//  Note: the continuity equations of the group's conduits are solved
+//        together, with conduits having the same shape of cross section
+//        placed next to each other, and give exactly the same results as
+//        kinwave_execute would for each link.
+{
+    int    i, j, k, m, first, last;
+    int    steps = 0;
+    int    nSolve;
+    int    order[FINDROOT_MAXBATCH];
+    int    start[FORCE_MAIN+1];        // start of each shape's conduits
+    int    result[FINDROOT_MAXBATCH];
+    TKinwave  kw[FINDROOT_MAXBATCH];
+    TKinwave* solveKw[FINDROOT_MAXBATCH];
+
+    for (first = 0; first < n; first += FINDROOT_MAXBATCH)
+    {
+        last = MIN(first + FINDROOT_MAXBATCH, n);
+
+        // --- set up each conduit's continuity eqn., counting those that
+        //     need to be solved by cross section type
+        nSolve = 0;
+        for (m = 0; m <= FORCE_MAIN; m++) start[m] = 0;
+        for (i = first; i < last; i++)
+        {
+            k = i - first;
+            j = links[i];
+            qoutflow[i] = qinflow[i];
+            kw[k].link = -1;
+            if ( Link[j].type != CONDUIT ) continue;
+            if ( Link[j].xsect.type == DUMMY ) continue;
+            if ( !initConduit(&kw[k], j, qinflow[i], tStep) ) continue;
+            order[nSolve++] = k;
+            start[kw[k].xsect->type]++;
+        }
+
+        // --- list the conduits to be solved in order of cross section type
+        for (m = 0, k = 0; m <= FORCE_MAIN; m++)
+        {
+            j = start[m];
+            start[m] = k;
+            k += j;
+        }
+        for (m = 0; m < nSolve; m++)
+        {
+            k = order[m];
+            solveKw[start[kw[k].xsect->type]++] = &kw[k];
+        }
+
+        // --- solve the continuity eqns. together and find outflows
+        //     (a conduit whose eqn. can't be solved is left as is)
+        solveBatch(nSolve, solveKw, result);
+        for (m = 0; m < nSolve; m++)
+        {
+            if ( !getOutflow(solveKw[m], &result[m]) )
+            {
+                solveKw[m]->link = -1;
+                result[m] = 1;
+            }
+            steps += result[m];
+        }
+        steps += (last - first) - nSolve;
+
+        // --- save new flows and areas
+        for (i = first; i < last; i++)
+        {
+            k = i - first;
+            if ( kw[k].link >= 0 )
+                saveConduitState(&kw[k], &qinflow[i], &qoutflow[i]);
+        }
+    }
+    return steps;
+}
+
+//=============================================================================
+
+int initConduit(TKinwave* kw, int j, double qinflow, double tStep)
+//
+//  Input:   kw = conduit being routed
+//           j = link index
+//           qinflow = inflow at current time (cfs)
+//           tStep = time step (sec)
+//  Output:  returns TRUE if continuity eqn. must be solved for outlet area,
+//           FALSE if there is no flow through the conduit
+//  Purpose: assigns terms of a conduit's continuity eqn.
+//
+{
+    int    k;
+    double dxdt, dq;
+    double a1, a2, q1, q2, q3;
+    double Qfull, Afull;
+
+    // --- assign continuity eqn. variables
+    kw->link = j;
+    kw->xsect = &Link[j].xsect;
+    kw->qFull = Qfull = Link[j].qFull;
+    kw->aFull = Afull = Link[j].xsect.aFull;
     k = Link[j].subIndex;
-    Beta1 = Conduit[k].beta / Qfull;
+    kw->beta1 = Conduit[k].beta / Qfull;
  
     // --- normalize previous flows
     q1 = Conduit[k].q1 / Qfull;
     q2 = Conduit[k].q2 / Qfull;
 
     // --- normalize inflow
-    qin = (*qinflow) / Conduit[k].barrels / Qfull;
+    kw->qin = qinflow / Conduit[k].barrels / Qfull;
 
     // --- compute evaporation and infiltration loss rate
-	q3 = link_getLossRate(j, qin*Qfull) / Qfull;                               //(5.1.014)
+    q3 = link_getLossRate(j, kw->qin*Qfull) / Qfull;                           //(5.1.014)
 
     // --- normalize previous areas
     a1 = Conduit[k].a1 / Afull;
     a2 = Conduit[k].a2 / Afull;
 
     // --- use full area when inlet flow >= full flow
-    if ( qin >= 1.0 ) ain = 1.0;
+    if ( kw->qin >= 1.0 ) kw->ain = 1.0;
 
     // --- get normalized inlet area corresponding to inlet flow
-    else ain = xsect_getAofS(pXsect, qin/Beta1) / Afull;
+    else kw->ain = xsect_getAofS(kw->xsect, kw->qin/kw->beta1) / Afull;
 
     // --- check for no flow
-    if ( qin <= TINY && q2 <= TINY )
+    if ( kw->qin <= TINY && q2 <= TINY )
     {
-        qout = 0.0;
-        aout = 0.0;
+        kw->qout = 0.0;
+        kw->aout = 0.0;
+        return FALSE;
     }
 
-    // --- otherwise solve finite difference form of continuity eqn.
-    else
-    {
-        // --- compute constant factors
-        dxdt = link_getLength(j) / tStep * Afull / Qfull;
-        dq   = q2 - q1;
-        C1   = dxdt * WT / WX;
-        C2   = (1.0 - WT) * (ain - a1);
-        C2   = C2 - WT * a2;
-        C2   = C2 * dxdt / WX;
-        C2   = C2 + (1.0 - WX) / WX * dq - qin;
-        C2   = C2 + q3 / WX;
-
-        // --- starting guess for aout is value from previous time step
-        aout = a2;
-
-        // --- solve continuity equation for aout
-        result = solveContinuity(qin, ain, &aout);
-
-        // --- report error if continuity eqn. not solved
-        if ( result == -1 )
-        {
-            report_writeErrorMsg(ERR_KINWAVE, Link[j].ID);
-            return 1;
-        }
-        if ( result <= 0 ) result = 1;
+    // --- compute constant factors
+    dxdt = link_getLength(j) / tStep * Afull / Qfull;
+    dq   = q2 - q1;
+    kw->c1 = dxdt * WT / WX;
+    kw->c2 = (1.0 - WT) * (kw->ain - a1);
+    kw->c2 = kw->c2 - WT * a2;
+    kw->c2 = kw->c2 * dxdt / WX;
+    kw->c2 = kw->c2 + (1.0 - WX) / WX * dq - kw->qin;
+    kw->c2 = kw->c2 + q3 / WX;
+
+    // --- starting guess for aout is value from previous time step
+    kw->aout = a2;
+    return TRUE;
+}
+
+//=============================================================================
 
-        // --- compute normalized outlet flow from outlet area
-        qout = Beta1 * xsect_getSofA(pXsect, aout*Afull);
-        if ( qin > 1.0 ) qin = 1.0;
+int getOutflow(TKinwave* kw, int* result)
+//
+//  Input:   kw = conduit being routed
+//           result = result code returned by solveContinuity
+//  Output:  result = number of iterations used;
+//           returns FALSE if continuity eqn. could not be solved
+//  Purpose: computes normalized outflow from a conduit's outlet area.
+//
+{
+    // --- report error if continuity eqn. not solved
+    //     (conduits may be routed concurrently by flowrout_execute)
+    if ( *result == -1 )
+    {
+        #pragma omp critical
+        report_writeErrorMsg(ERR_KINWAVE, Link[kw->link].ID);
+        return FALSE;
     }
+    if ( *result <= 0 ) *result = 1;
 
-    // --- save new flows and areas
-    Conduit[k].q1 = qin * Qfull;
-    Conduit[k].a1 = ain * Afull;
-    Conduit[k].q2 = qout * Qfull;
-    Conduit[k].a2 = aout * Afull;
+    // --- compute normalized outlet flow from outlet area
+    kw->qout = kw->beta1 * xsect_getSofA(kw->xsect, kw->aout*kw->aFull);
+    if ( kw->qin > 1.0 ) kw->qin = 1.0;
+    return TRUE;
+}
+
+//=============================================================================
+
+void saveConduitState(TKinwave* kw, double* qinflow, double* qoutflow)
+//
+//  Input:   kw = conduit being routed
+//  Output:  qinflow = adjusted inflow at current time (cfs)
+//           qoutflow = outflow at current time (cfs)
+//  Purpose: saves a conduit's new flows and areas.
+//
+{
+    int    k = Link[kw->link].subIndex;
+    double Qfull = kw->qFull;
+    double Afull = kw->aFull;
+
+    Conduit[k].q1 = kw->qin * Qfull;
+    Conduit[k].a1 = kw->ain * Afull;
+    Conduit[k].q2 = kw->qout * Qfull;
+    Conduit[k].a2 = kw->aout * Afull;
     Conduit[k].fullState =
         link_getFullState(Conduit[k].a1, Conduit[k].a2, Afull);
     (*qinflow)  = Conduit[k].q1 * Conduit[k].barrels;
     (*qoutflow) = Conduit[k].q2 * Conduit[k].barrels;
-    return result;
 }
 
 //=============================================================================
 
-int solveContinuity(double qin, double ain, double* aout)
-//
-//  Input:   qin = upstream normalized flow
-//           ain = upstream normalized area
-//           aout = downstream normalized area
-//  Output:  new value for aout; returns an error code
-//  Purpose: solves continuity equation f(a) = Beta1*S(a) + C1*a + C2 = 0
-//           for 'a' using the Newton-Raphson root finder function.
-//           Return code has the following meanings:
-//           >= 0 number of function evaluations used
-//           -1   Newton function failed
-//           -2   flow always above max. flow
-//           -3   flow always below zero
+int findBounds(TKinwave* kw, double* aLo, double* aHi)
 //
-//     Note: pXsect (pointer to conduit's cross-section), and constants Beta1,
-//           C1, and C2 are module-level shared variables assigned values
-//           in kinwave_execute().
+//  Input:   kw = conduit being routed
+//  Output:  aLo, aHi = bounds on normalized outlet area that bracket the
+//           root of the continuity eqn. (aLo having the lower function
+//           value); returns 0 if such bounds exist or one of the error
+//           codes described in solveContinuity if not
+//  Purpose: finds bounds on the solution of a conduit's continuity eqn.
 //
 {
-    int    n;                          // # evaluations or error code
-    double aLo, aHi, aTmp;             // lower/upper bounds on a
+    double aTmp;                       // lower/upper bounds on a
     double fLo, fHi;                   // lower/upper bounds on f
-    double tol = EPSIL;                // absolute convergence tol.
-
-    // --- first determine bounds on 'a' so that f(a) passes through 0.
 
     // --- set upper bound to area at full flow
-    aHi = 1.0;
-    fHi = 1.0 + C1 + C2;
+    *aHi = 1.0;
+    fHi = 1.0 + kw->c1 + kw->c2;
 
     // --- try setting lower bound to area where section factor is maximum
-    aLo = xsect_getAmax(pXsect) / Afull;
-    if ( aLo < aHi )
+    *aLo = xsect_getAmax(kw->xsect) / kw->aFull;
+    if ( *aLo < *aHi )
     {
-        fLo = ( Beta1 * pXsect->sMax ) + (C1 * aLo) + C2;
+        fLo = ( kw->beta1 * kw->xsect->sMax ) + (kw->c1 * *aLo) + kw->c2;
     }
     else fLo = fHi;
 
     // --- if fLo and fHi have same sign then set lower bound to 0
     if ( fHi*fLo > 0.0 )
     {
-        aHi = aLo;
+        *aHi = *aLo;
         fHi = fLo;
-        aLo = 0.0;
-        fLo = C2;
+        *aLo = 0.0;
+        fLo = kw->c2;
     }
 
     // --- proceed with search for root if fLo and fHi have different signs
@@ -219,56 +377,188 @@ int solveContinuity(double qin, double ain, double* aout)
     {
         // --- start search at midpoint of lower/upper bounds
         //     if initial value outside of these bounds
-		if ( *aout < aLo || *aout > aHi ) *aout = 0.5*(aLo + aHi);
+        if ( kw->aout < *aLo || kw->aout > *aHi )
+            kw->aout = 0.5*(*aLo + *aHi);
 
         // --- if fLo > fHi then switch aLo and aHi
         if ( fLo > fHi )
         {
-            aTmp = aLo;
-            aLo  = aHi;
-            aHi  = aTmp;
+            aTmp = *aLo;
+            *aLo = *aHi;
+            *aHi = aTmp;
         }
-
-        // --- call the Newton root finder method passing it the 
-        //     evalContinuity function to evaluate the function
-        //     and its derivatives
-        n = findroot_Newton(aLo, aHi, aout, tol, evalContinuity, NULL);
-
-        // --- check if root finder succeeded
-        if ( n <= 0 ) n = -1;
+        return 0;
     }
 
     // --- if lower/upper bound functions both negative then use full flow
     else if ( fLo < 0.0 )
     {
-        if ( qin > 1.0 ) *aout = ain;
-        else *aout = 1.0;
-        n = -2;
+        if ( kw->qin > 1.0 ) kw->aout = kw->ain;
+        else kw->aout = 1.0;
+        return -2;
     }
 
     // --- if lower/upper bound functions both positive then use no flow
     else if ( fLo > 0 )
     {
-        *aout = 0.0;
-        n = -3;
+        kw->aout = 0.0;
+        return -3;
     }
-    else n = -1;
+    return -1;
+}
+
+//=============================================================================
+
+int solveContinuity(TKinwave* kw)
+//
+//  Input:   kw = conduit being routed
+//  Output:  new value for kw->aout; returns an error code
+//  Purpose: solves continuity equation f(a) = Beta1*S(a) + C1*a + C2 = 0
+//           for 'a' using the Newton-Raphson root finder function.
+//           Return code has the following meanings:
+//           >= 0 number of function evaluations used
+//           -1   Newton function failed
+//           -2   flow always above max. flow
+//           -3   flow always below zero
+//
+//     Note: kw holds the conduit's cross-section and the constants Beta1,
+//           C1, and C2 assigned values in initConduit().
+//
+{
+    int    n;                          // # evaluations or error code
+    double aLo, aHi;                   // lower/upper bounds on a
+    double tol = EPSIL;                // absolute convergence tol.
+
+    // --- first determine bounds on 'a' so that f(a) passes through 0.
+    n = findBounds(kw, &aLo, &aHi);
+    if ( n < 0 ) return n;
+
+    // --- call the Newton root finder method passing it the 
+    //     evalContinuity function to evaluate the function
+    //     and its derivatives
+    n = findroot_Newton(aLo, aHi, &kw->aout, tol, evalContinuity, kw);
+
+    // --- check if root finder succeeded
+    if ( n <= 0 ) n = -1;
     return n;
 }
 
 //=============================================================================
 
+void solveBatch(int n, TKinwave* kw[], int result[])
+//
+//  Input:   n = number of conduits
+//           kw = conduits being routed, in order of cross section type
+//  Output:  new value for each kw[]->aout; result = error code for each
+//           conduit (see solveContinuity)
+//  Purpose: solves the continuity equations of a batch of conduits.
+//
+{
+    int    i, m, len;
+    int    lanes[FINDROOT_MAXBATCH];
+    int    evals[FINDROOT_MAXBATCH];
+    double aLo[FINDROOT_MAXBATCH], aHi[FINDROOT_MAXBATCH];
+    double aout[FINDROOT_MAXBATCH];
+    TKinwave* laneKw[FINDROOT_MAXBATCH];
+    TKinwaveBatch batch;
+
+    // --- find bounds on each conduit's root, setting aside those
+    //     with no bracketed root
+    m = 0;
+    for (i = 0; i < n; i++)
+    {
+        result[i] = findBounds(kw[i], &aLo[m], &aHi[m]);
+        if ( result[i] < 0 ) continue;
+        lanes[m] = i;
+        laneKw[m] = kw[i];
+        aout[m] = kw[i]->aout;
+        m++;
+    }
+
+    // --- solve for the bracketed roots of conduits with the same shape
+    //     of cross section together
+    for (i = 0; i < m; i += len)
+    {
+        batch.type = laneKw[i]->xsect->type;
+        batch.kw = &laneKw[i];
+        for (len = 1; i+len < m && laneKw[i+len]->xsect->type == batch.type;
+             len++);
+        findroot_NewtonBatch(len, &aLo[i], &aHi[i], &aout[i], EPSIL,
+                             NEWTON_STEPS, &evals[i], evalContinuityBatch,
+                             &batch);
+    }
+    for (i = 0; i < m; i++)
+    {
+        laneKw[i]->aout = aout[i];
+        result[lanes[i]] = evals[i] > 0 ? evals[i] : -1;
+    }
+}
+
+//=============================================================================
+
 void evalContinuity(double a, double* f, double* df, void* p)
 //
 //  Input:   a = outlet normalized area
+//           p = pointer to the conduit's TKinwave terms
 //  Output:  f = value of continuity eqn.
 //           df = derivative of continuity eqn.
 //  Purpose: computes value of continuity equation (f) and its derivative (df)
 //           w.r.t. normalized area for link with normalized outlet area 'a'.
 //
 {
-    *f  = (Beta1 * xsect_getSofA(pXsect, a*Afull)) + (C1 * a) + C2;
-    *df = (Beta1 * Afull * xsect_getdSdA(pXsect, a*Afull)) + C1;
+    TKinwave* kw = (TKinwave *)p;
+    *f  = (kw->beta1 * xsect_getSofA(kw->xsect, a*kw->aFull)) +
+          (kw->c1 * a) + kw->c2;
+    *df = (kw->beta1 * kw->aFull * xsect_getdSdA(kw->xsect, a*kw->aFull)) +
+          kw->c1;
+}
+
+//=============================================================================
+
+void evalContinuityBatch(int n, int lanes[], double a[], double f[],
+                         double df[], void* p)
+//
+//  Input:   n = number of lanes to evaluate
+//           lanes = indexes of the lanes to evaluate
+//           a = outlet normalized area of each lane
+//           p = pointer to the TKinwaveBatch of conduits being solved
+//  Output:  f = value of each lane's continuity eqn.
+//           df = derivative of each lane's continuity eqn.
+//  Purpose: evaluates the continuity equations of a batch of conduits
+//           whose cross sections have the same shape.
+//
+{
+    int       k, i;
+    double    area[FINDROOT_MAXBATCH];
+    double    s[FINDROOT_MAXBATCH], dsda[FINDROOT_MAXBATCH];
+    TXsect*   xsect[FINDROOT_MAXBATCH];
+    TKinwave* kw;
+    TKinwaveBatch* batch = (TKinwaveBatch *)p;
+
+    // --- find the section factor of each lane's outlet area
+    for (k = 0; k < n; k++)
+    {
+        kw = batch->kw[lanes[k]];
+        xsect[k] = kw->xsect;
+        area[k] = a[lanes[k]] * kw->aFull;
+    }
+    if ( !xsect_getSanddSdA(batch->type, xsect, n, area, s, dsda) )
+    {
+        for (k = 0; k < n; k++)
+        {
+            s[k] = xsect_getSofA(xsect[k], area[k]);
+            dsda[k] = xsect_getdSdA(xsect[k], area[k]);
+        }
+    }
+
+    // --- evaluate the continuity eqns. as evalContinuity does
+    for (k = 0; k < n; k++)
+    {
+        i = lanes[k];
+        kw = batch->kw[i];
+        f[i]  = (kw->beta1 * s[k]) + (kw->c1 * a[i]) + kw->c2;
+        df[i] = (kw->beta1 * kw->aFull * dsda[k]) + kw->c1;
+    }
 }
 
 //=============================================================================
@@ -13,6 +13,7 @@
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (US EPA)
 //
 //   This module handles all data processing involving LID (Low Impact
@@ -77,6 +78,11 @@
 //   Build 5.1.014:
 //   - Fixed bug in creating LidProcs when there are no subcatchments.
 //   - Fixed bug in adding underdrain pollutant loads to mass balances.
+//
+//   Build 5.1.015:
+//   - Detailed LID report files are written from a memory buffer and can be
+//     written in a compact binary format (LID_REPORT_FORMAT BINARY option).
+//   - Buffered LID report results are written at the end of each run.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -84,6 +90,9 @@
 #include "headers.h"
 #include "lid.h"
 
+// Definition of 4-byte integer used in binary LID report files                //(5.1.015)
+#define INT4  int
+
 #define ERR_PAVE_LAYER " - check pavement layer parameters"
 #define ERR_SOIL_LAYER " - check soil layer parameters"
 #define ERR_STOR_LAYER " - check storage layer parameters"
@@ -184,6 +193,7 @@ extern char       HasWetLids;          // TRUE if any LIDs are wet
 
 //  lid_writeSummary         called by inputrpt_writeInput
 //  lid_writeWaterBalance    called by statsrpt_writeReport
+//  lid_flushRptFiles        called by runoff_close
 
 //  lid_getLidUnitCount      called by LID API toolkit in toolkitAPI.c
 //  lid_getLidUnit           called by LID API toolkit in toolkitAPI.c
@@ -209,6 +219,9 @@ static int    readRemovalsData(int j, char* toks[], int ntoks);                /
 static int    addLidUnit(int j, int k, int n, double x[], char* fname,
               int drainSubcatch, int drainNode);
 static int    createLidRptFile(TLidUnit* lidUnit, char* fname);
+static void   closeLidRptFile(TLidRptFile* rptFile);                           //(5.1.015)
+static void   flushLidRptFile(TLidRptFile* rptFile);                           //(5.1.015)
+static void   writeRptString(FILE* f, char* s);                                //(5.1.015)
 static void   initLidRptFile(char* title, char* lidID, char* subcatchID,
               TLidUnit* lidUnit);
 static void   validateLidProc(int j);
@@ -328,11 +341,7 @@ void freeLidGroup(int j)
     while (lidList)
     {
         lidUnit = lidList->lidUnit;
-        if ( lidUnit->rptFile )
-        {
-            if ( lidUnit->rptFile->file ) fclose(lidUnit->rptFile->file);
-            free(lidUnit->rptFile);
-        }
+        if ( lidUnit->rptFile ) closeLidRptFile(lidUnit->rptFile);             //(5.1.015)
         nextLidUnit = lidList->nextLidUnit;
         free(lidUnit);
         free(lidList);
@@ -556,6 +565,8 @@ int addLidUnit(int j, int k, int n, double x[], char* fname,
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int createLidRptFile(TLidUnit* lidUnit, char* fname)
 {
     TLidRptFile* rptFile;
@@ -563,13 +574,70 @@ int createLidRptFile(TLidUnit* lidUnit, char* fname)
     rptFile = (TLidRptFile *) malloc(sizeof(TLidRptFile));
     if ( rptFile == NULL ) return 0;
     lidUnit->rptFile = rptFile;
-    rptFile->file = fopen(fname, "wt");
-    if ( rptFile->file == NULL ) return 0;
+    rptFile->binary = (LidRptFormat == BINARY_LID_RPT);
+    rptFile->buffer = (char *) malloc(LIDRPT_BUFSIZE);
+    rptFile->bufferLen = 0;
+    rptFile->periods = 0;
+    rptFile->inRun = FALSE;
+    if ( rptFile->binary ) rptFile->file = fopen(fname, "wb");
+    else                   rptFile->file = fopen(fname, "wt");
+    if ( rptFile->file == NULL || rptFile->buffer == NULL ) return 0;
     return 1;
 }
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void closeLidRptFile(TLidRptFile* rptFile)
+//
+//  Purpose: writes any buffered results to an LID report file and closes it.
+//  Input:   rptFile = ptr. to LID report file
+//  Output:  none
+//
+{
+    if ( rptFile->file )
+    {
+        flushLidRptFile(rptFile);
+        fclose(rptFile->file);
+    }
+    FREE(rptFile->buffer);
+    free(rptFile);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void flushLidRptFile(TLidRptFile* rptFile)
+//
+//  Purpose: writes the buffered results of the current run to an LID
+//           report file and finishes the run's section of the file.
+//  Input:   rptFile = ptr. to LID report file
+//  Output:  none
+//
+{
+    INT4 k;
+
+    if ( rptFile->file == NULL || !rptFile->inRun ) return;
+    if ( rptFile->buffer && rptFile->bufferLen > 0 )
+        fwrite(rptFile->buffer, 1, rptFile->bufferLen, rptFile->file);
+    rptFile->bufferLen = 0;
+
+    //... a binary run's results end with the number of periods & magic number
+    if ( rptFile->binary )
+    {
+        k = rptFile->periods;
+        fwrite(&k, sizeof(INT4), 1, rptFile->file);
+        k = LIDRPT_MAGIC;
+        fwrite(&k, sizeof(INT4), 1, rptFile->file);
+    }
+    fflush(rptFile->file);
+    rptFile->inRun = FALSE;
+}
+
+//=============================================================================
+
 int readSurfaceData(int j, char* toks[], int ntoks)
 //
 //  Purpose: reads surface layer data for a LID process from line of input
@@ -1957,6 +2025,36 @@ void lid_writeWaterBalance()
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void lid_flushRptFiles()
+//
+//  Purpose: writes the buffered results of each LID report file at the
+//           end of a run.
+//  Input:   none
+//  Output:  none
+//
+{
+    int        j;
+    TLidList*  lidList;
+
+    for ( j = 0; j < GroupCount; j++ )
+    {
+        if ( LidGroups[j] == NULL ) continue;
+        lidList = LidGroups[j]->lidList;
+        while ( lidList )
+        {
+            if ( lidList->lidUnit->rptFile )
+                flushLidRptFile(lidList->lidUnit->rptFile);
+            lidList = lidList->nextLidUnit;
+        }
+    }
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void initLidRptFile(char* title, char* lidID, char* subcatchID, TLidUnit* lidUnit)
 //
 //  Purpose: initializes the report file used for a specific LID unit
@@ -1990,11 +2088,40 @@ void initLidRptFile(char* title, char* lidID, char* subcatchID, TLidUnit* lidUni
         "  Content\t", "       mm"};
     static char line9[] = " ---------";
     int   i;
+    INT4  k;                                                                   //(5.1.015)
     FILE* f = lidUnit->rptFile->file;
 
     //... check that file was opened
     if ( f ==  NULL ) return;
 
+    //... finish any previous run's results before starting a new run          //(5.1.015)
+    flushLidRptFile(lidUnit->rptFile);
+    lidUnit->rptFile->inRun = TRUE;
+
+    //... initialize LID dryness state & results buffer                        //(5.1.015)
+    lidUnit->rptFile->wasDry = 1;
+    strcpy(lidUnit->rptFile->results, "");
+    lidUnit->rptFile->resultsLen = 0;
+    lidUnit->rptFile->bufferLen = 0;
+    lidUnit->rptFile->periods = 0;
+
+    //... write header of binary file                                          //(5.1.015)
+    if ( lidUnit->rptFile->binary )
+    {
+        k = LIDRPT_MAGIC;
+        fwrite(&k, sizeof(INT4), 1, f);
+        k = VERSION;
+        fwrite(&k, sizeof(INT4), 1, f);
+        k = UnitSystem;
+        fwrite(&k, sizeof(INT4), 1, f);
+        k = colCount - 2;
+        fwrite(&k, sizeof(INT4), 1, f);
+        writeRptString(f, title);
+        writeRptString(f, lidID);
+        writeRptString(f, subcatchID);
+        return;
+    }
+
     //... write title lines
     fprintf(f, "SWMM5 LID Report File\n");
     fprintf(f, "\nProject:  %s", title);
@@ -2010,10 +2137,23 @@ void initLidRptFile(char* title, char* lidID, char* subcatchID, TLidUnit* lidUni
     else for ( i = 0; i < colCount; i++) fprintf(f, "%s", units2[i]);
     fprintf(f, "\n----------- --------");
     for ( i = 1; i < colCount; i++) fprintf(f, "\t%s", line9);
+}
 
-    //... initialize LID dryness state
-    lidUnit->rptFile->wasDry = 1;
-    strcpy(lidUnit->rptFile->results, "");
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeRptString(FILE* f, char* s)
+//
+//  Purpose: writes a string to a binary LID report file.
+//  Input:   f = ptr. to LID report file
+//           s = a string
+//  Output:  none
+//
+{
+    INT4 n = (INT4)strlen(s);
+    fwrite(&n, sizeof(INT4), 1, f);
+    fwrite(s, sizeof(char), n, f);
 }
 
 
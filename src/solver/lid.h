@@ -8,6 +8,7 @@
 //            08/01/16   (Build 5.1.011)
 //            03/14/17   (Build 5.1.012)
 //            05/10/18   (Build 5.1.013)
+//            10/17/26   (Build 5.1.015)
 //   Author:  L. Rossman (US EPA)
 //
 //   Public interface for LID functions.
@@ -36,6 +37,10 @@
 //   - New members added to TPavementLayer and TLidUnit to support
 //     unclogging permeable pavement at fixed intervals.
 //
+//   Build 5.1.015:
+//   - New members added to TLidRptFile to buffer the results written to a
+//     detailed LID report file and to support a binary report format.
+//
 //-----------------------------------------------------------------------------
 
 #ifndef LID_H
@@ -180,11 +185,33 @@ typedef struct
 } TWaterRate;
 
 // LID Report File
+//
+//  Results are collected in a buffer that is written to the file once it
+//  fills up, rather than with a separate write for each time period, and
+//  at the end of each run.
+//
+//  A binary LID report file (LID_REPORT_FORMAT BINARY) holds:
+//    INT4 magic number, INT4 version, INT4 unit system, INT4 no. of variables,
+//    then INT4 length followed by the characters of the project title,
+//    the LID ID and the subcatchment ID,
+//    then for each reported period REAL8 date/time, REAL4 elapsed hours and
+//    REAL4 value of each reported variable (same units as the text format),
+//    and finally INT4 number of periods and INT4 magic number.
+//  Each run made while the project is open adds another such section.
+#define LIDRPT_BUFSIZE 16384                                                   //(5.1.015)
+#define LIDRPT_MAGIC   516114525                                               //(5.1.015)
+
 typedef struct
 {
     FILE*     file;               // file pointer
     int       wasDry;             // number of successive dry periods
     char      results[256];       // results for current time period
+    int       resultsLen;         // length of results (bytes)                 //(5.1.015)
+    int       binary;             // TRUE if binary format used                //(5.1.015)
+    int       periods;            // number of periods written                 //(5.1.015)
+    char*     buffer;             // results not yet written to file           //(5.1.015)
+    int       bufferLen;          // length of buffered results                //(5.1.015)
+    int       inRun;              // TRUE if a run's results are unfinished    //(5.1.015)
 }   TLidRptFile;
 
 // LID Unit - specific LID process applied over a given area
@@ -264,6 +291,7 @@ void     lid_addDrainInflow(int subcatch, double f);
 void     lid_getRunoff(int subcatch, double tStep);
 void     lid_writeSummary(void);
 void     lid_writeWaterBalance(void);
+void     lid_flushRptFiles(void);                                              //(5.1.015)
 
 int         lid_getLidUnitCount(int index);
 TLidUnit*   lid_getLidUnit(int index, int lidIndex, int* errcode);
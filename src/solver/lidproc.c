@@ -13,6 +13,7 @@
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (US EPA)
 //
 //   This module computes the hydrologic performance of an LID (Low Impact
@@ -64,6 +65,10 @@
 //   - Fixed failure to initialize all LID layer moisture volumes to 0 before
 //     computing LID unit performance in lidproc_getOutflow.
 //
+//   Build 5.1.015:
+//   - Results written to an LID report file are formatted without fprintf,
+//     collected in the file's buffer and can be saved in binary form.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -73,6 +78,10 @@
 #include "lid.h"
 #include "headers.h"
 
+// Definition of 4-byte real and 8-byte real types                             //(5.1.015)
+#define REAL4 float
+#define REAL8 double
+
 //-----------------------------------------------------------------------------
 //  Constants
 //-----------------------------------------------------------------------------
@@ -141,6 +150,9 @@ static double     StorageVolume;  // volume in storage layer (ft)
 
 static double     Xold[MAX_LAYERS];  // previous moisture level in LID layers
 
+static DateTime   RptDate = -1.0;    // date of last report time stamp         //(5.1.015)
+static char       RptTimeStamp[24];  // time stamp of LID report results       //(5.1.015)
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in lid.h)
 //-----------------------------------------------------------------------------
@@ -158,6 +170,9 @@ static void   pavementFluxRates(double x[], double f[]);
 static void   trenchFluxRates(double x[], double f[]);
 static void   swaleFluxRates(double x[], double f[]);
 static void   roofFluxRates(double x[], double f[]);
+static void   formatRptResults(TLidRptFile* rptFile, double elapsedHrs,        //(5.1.015)
+              double rptVars[]);
+static void   writeRptResults(TLidRptFile* rptFile);                           //(5.1.015)
 
 static double getSurfaceOutflowRate(double depth);
 static double getSurfaceOverflowRate(double* surfaceDepth);
@@ -393,6 +408,8 @@ double lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc, double inflow,
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDepth)
 //
 //  Purpose: updates the mass balance for an LID unit and saves
@@ -408,7 +425,6 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
     double totalVolume;                // total volume stored in LID (ft)
     double rptVars[MAX_RPT_VARS];      // array of reporting variables
     int    isDry = FALSE;              // true if current state of LID is dry
-    char   timeStamp[24];              // date/time stamp
     double elapsedHrs;                 // elapsed hours
 
     //... find total evap. rate and stored volume
@@ -462,20 +478,13 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
         //    to the report file thus marking the end of a dry period
         if ( !isDry && theLidUnit->rptFile->wasDry > 1)
         {
-            fprintf(theLidUnit->rptFile->file, "%s",
-				  theLidUnit->rptFile->results);
+            writeRptResults(theLidUnit->rptFile);                              //(5.1.015)
         }
 
         //... write the current results to a string which is saved between
         //    reporting periods
         elapsedHrs = NewRunoffTime / 1000.0 / 3600.0;
-        datetime_getTimeStamp(M_D_Y, getDateTime(NewRunoffTime), 24, timeStamp);
-        sprintf(theLidUnit->rptFile->results,
-             "\n%20s\t %8.3f\t %8.3f\t %8.4f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t"
-             "%8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f",
-             timeStamp, elapsedHrs, rptVars[0], rptVars[1], rptVars[2],
-             rptVars[3], rptVars[4], rptVars[5], rptVars[6], rptVars[7],
-             rptVars[8], rptVars[9], rptVars[10], rptVars[11]);
+        formatRptResults(theLidUnit->rptFile, elapsedHrs, rptVars);            //(5.1.015)
 
         //... if the current LID state is dry
         if ( isDry )
@@ -484,8 +493,7 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
             //    results to file marking the start of a dry period
             if ( theLidUnit->rptFile->wasDry == 0 )
             {
-                fprintf(theLidUnit->rptFile->file, "%s",
-					theLidUnit->rptFile->results);
+                writeRptResults(theLidUnit->rptFile);                          //(5.1.015)
             }
 
             //... increment the number of successive dry periods
@@ -496,8 +504,7 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
         else
         {
             //... write the current results to the report file
-			fprintf(theLidUnit->rptFile->file, "%s",
-			    theLidUnit->rptFile->results);
+            writeRptResults(theLidUnit->rptFile);                              //(5.1.015)
 
             //... re-set the number of successive dry periods to 0
             theLidUnit->rptFile->wasDry = 0; 
@@ -507,6 +514,96 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void formatRptResults(TLidRptFile* rptFile, double elapsedHrs, double rptVars[])
+//
+//  Purpose: saves the current results of an LID unit in the format used
+//           by its report file.
+//  Input:   rptFile = ptr. to the LID unit's report file
+//           elapsedHrs = elapsed simulation hours
+//           rptVars = array of reporting variables
+//  Output:  none
+//
+//  The date/time stamp is shared by all LID units reporting the same
+//  time period so it is only formatted once.
+//
+{
+    int    i, len, prec;
+    char*  s = rptFile->results;
+    DateTime currentDate = getDateTime(NewRunoffTime);
+    REAL8  x8;
+    REAL4  x4;
+
+    //... write date, elapsed hours & variables as binary values
+    if ( rptFile->binary )
+    {
+        x8 = currentDate;
+        memcpy(s, &x8, sizeof(REAL8));
+        len = sizeof(REAL8);
+        x4 = (REAL4)elapsedHrs;
+        memcpy(s + len, &x4, sizeof(REAL4));
+        len += sizeof(REAL4);
+        for ( i = 0; i < MAX_RPT_VARS; i++ )
+        {
+            x4 = (REAL4)rptVars[i];
+            memcpy(s + len, &x4, sizeof(REAL4));
+            len += sizeof(REAL4);
+        }
+        rptFile->resultsLen = len;
+        return;
+    }
+
+    //... write the same text as
+    //    "\n%20s\t %8.3f\t %8.3f\t %8.4f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t"
+    //    "%8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f"
+    if ( currentDate != RptDate )
+    {
+        datetime_getTimeStamp(M_D_Y, currentDate, 24, RptTimeStamp);
+        RptDate = currentDate;
+    }
+    len = sprintf(s, "\n%20s\t ", RptTimeStamp);
+    len += report_formatFixed(s + len, elapsedHrs, 8, 3);
+    for ( i = 0; i < MAX_RPT_VARS; i++ )
+    {
+        if ( i == SURF_OUTFLOW ) s[len++] = '\t';
+        else
+        {
+            s[len++] = '\t';
+            s[len++] = ' ';
+        }
+        if ( i == TOTAL_EVAP ) prec = 4;
+        else                   prec = 3;
+        len += report_formatFixed(s + len, rptVars[i], 8, prec);
+    }
+    rptFile->resultsLen = len;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeRptResults(TLidRptFile* rptFile)
+//
+//  Purpose: adds the saved results of an LID unit to its report file's
+//           buffer, writing the buffer to file when it is full.
+//  Input:   rptFile = ptr. to the LID unit's report file
+//  Output:  none
+//
+{
+    if ( rptFile->bufferLen + rptFile->resultsLen > LIDRPT_BUFSIZE )
+    {
+        fwrite(rptFile->buffer, 1, rptFile->bufferLen, rptFile->file);
+        rptFile->bufferLen = 0;
+    }
+    memcpy(rptFile->buffer + rptFile->bufferLen, rptFile->results,
+           rptFile->resultsLen);
+    rptFile->bufferLen += rptFile->resultsLen;
+    rptFile->periods++;
+}
+
+//=============================================================================
+
 void roofFluxRates(double x[], double f[])
 //
 //  Purpose: computes flux rates for roof disconnection.
@@ -11,6 +11,7 @@
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -50,6 +51,11 @@
 //  Build 5.1.014:
 //  - Conduit evap. and seepage losses initialized to 0 in conduit_initState()
 //    and not allowed to exceed current flow rate in conduit_getLossRate().
+//
+//  Build 5.1.015:
+//  - Opening areas and widths of orifices and weirs that depend only on their
+//    settings are saved when the setting changes.
+//  - Orifice and weir settings re-applied when a link's state is initialized.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -120,6 +126,7 @@ static double orifice_getFlow(int j, int k, double head, double f,
 static int    weir_readParams(int j, int k, char* tok[], int ntoks);
 static void   weir_validate(int j, int k);
 static void   weir_setSetting(int j);
+static void   weir_setOpening(int j, int k);                                   //(5.1.015)
 static double weir_getInflow(int j);
 static double weir_getOpenArea(int j, double y);
 static void   weir_getFlow(int j, int k, double head, double dir,
@@ -485,6 +492,8 @@ double link_getOffsetHeight(int j, double offset, double elev)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void link_initState(int j)
 //
 //  Input:   j = link index
@@ -509,6 +518,10 @@ void link_initState(int j)
     if ( Link[j].type == CONDUIT ) conduit_initState(j, Link[j].subIndex);
     if ( Link[j].type == PUMP    ) pump_initState(j, Link[j].subIndex);
 
+    // --- re-apply full opening to regulators' saved coefficients             //(5.1.015)
+    if ( Link[j].type == ORIFICE || Link[j].type == WEIR )                     //(5.1.015)
+        link_setSetting(j, 0.0);                                               //(5.1.015)
+
     // --- initialize water quality state
     for (p = 0; p < Nobjects[POLLUT]; p++)
     {
@@ -1691,6 +1704,8 @@ void  orifice_validate(int j, int k)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void  orifice_setSetting(int j, double tstep)
 //
 //  Input:   j = link index
@@ -1719,7 +1734,8 @@ void  orifice_setSetting(int j, double tstep)
 
     // --- find effective orifice discharge coeff.
     h = Link[j].setting * Link[j].xsect.yFull;
-    f = xsect_getAofY(&Link[j].xsect, h) * sqrt(2.0 * GRAVITY);
+    Orifice[k].aOpen = xsect_getAofY(&Link[j].xsect, h);                       //(5.1.015)
+    f = Orifice[k].aOpen * sqrt(2.0 * GRAVITY);                                //(5.1.015)
     Orifice[k].cOrif = Orifice[k].cDisch * f;
 
     // --- find equiv. discharge coeff. for when weir flow occurs
@@ -1774,6 +1790,8 @@ double orifice_getWeirCoeff(int j, int k, double h)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double orifice_getInflow(int j)
 //
 //  Input:   j = link index
@@ -1883,7 +1901,7 @@ double orifice_getInflow(int j)
     else
     {
         Link[j].newDepth = y1;
-        Orifice[k].surfArea = xsect_getAofY(&Link[j].xsect, y1);
+        Orifice[k].surfArea = Orifice[k].aOpen;                                //(5.1.015)
     }
 
     // --- find flow through the orifice
@@ -1900,6 +1918,8 @@ double orifice_getInflow(int j)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double orifice_getFlow(int j, int k,  double head, double f, int hasFlapGate)
 //
 //  Input:   j = link index
@@ -1940,8 +1960,7 @@ double orifice_getFlow(int j, int k,  double head, double f, int hasFlapGate)
     if ( hasFlapGate )
     {
         // --- compute velocity for current orifice flow
-        area = xsect_getAofY(&Link[j].xsect,
-                             Link[j].setting * Link[j].xsect.yFull);
+        area = Orifice[k].aOpen;                                               //(5.1.015)
         veloc = q / area;
 
         // --- compute head loss from gate
@@ -2065,6 +2084,8 @@ int   weir_readParams(int j, int k, char* tok[], int ntoks)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void  weir_validate(int j, int k)
 //
 //  Input:   j = link index
@@ -2115,6 +2136,7 @@ void  weir_validate(int j, int k)
     Weir[k].length = 2.0 * RouteStep * sqrt(GRAVITY * Link[j].xsect.yFull);
     Weir[k].length = MAX(200.0, Weir[k].length);
     Weir[k].surfArea = 0.0;
+    weir_setOpening(j, k);                                                     //(5.1.015)
 
     // --- find flow through weir when water level equals weir height
     head = Link[j].xsect.yFull;
@@ -2128,6 +2150,8 @@ void  weir_validate(int j, int k)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void weir_setSetting(int j)
 //
 //  Input:   j = link index
@@ -2140,6 +2164,7 @@ void weir_setSetting(int j)
 
     // --- adjust weir setting
     Link[j].setting = Link[j].targetSetting;
+    weir_setOpening(j, k);                                                     //(5.1.015)
     if ( !Weir[k].canSurcharge ) return;
     if ( Weir[k].type == ROADWAY_WEIR ) return;
 
@@ -2160,6 +2185,24 @@ void weir_setSetting(int j)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void weir_setOpening(int j, int k)
+//
+//  Input:   j = link index
+//           k = weir index
+//  Output:  none
+//  Purpose: saves the area below and the width at a weir's crest after it
+//           has been raised by the weir's current setting.
+//
+{
+    double z = (1.0 - Link[j].setting) * Link[j].xsect.yFull;
+    Weir[k].aOffset = xsect_getAofY(&Link[j].xsect, z);
+    Weir[k].wOffset = xsect_getWofY(&Link[j].xsect, z);
+}
+
+//=============================================================================
+
 double weir_getInflow(int j)
 //
 //  Input:   j = link index
@@ -2283,6 +2326,8 @@ double weir_getInflow(int j)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
                   double* q1, double* q2)
 //
@@ -2298,7 +2343,6 @@ void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
 {
     double length;
     double h;
-    double y;
     double hLoss;
     double area;
     double veloc;
@@ -2356,8 +2400,7 @@ void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
         break;
 
       case TRAPEZOIDAL_WEIR:
-        y = (1.0 - Link[j].setting) * Link[j].xsect.yFull;
-        length = xsect_getWofY(&Link[j].xsect, y) * UCF(LENGTH);
+        length = Weir[k].wOffset * UCF(LENGTH);                                //(5.1.015)
         *q1 = cDisch1 * length * pow(h, 1.5);                                 //(5.1.013)
         *q2 = Weir[k].cDisch2 * Weir[k].slope * pow(h, 2.5);
     }
@@ -2429,6 +2472,8 @@ double weir_getOrificeFlow(int j, double head, double y, double cOrif)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double weir_getOpenArea(int j, double y)
 //
 //  Input:   j = link index
@@ -2449,7 +2494,7 @@ double weir_getOpenArea(int j, double y)
     // --- return difference between area of offset + water depth
     //     and area of just the offset
     return xsect_getAofY(&Link[j].xsect, zy) -
-           xsect_getAofY(&Link[j].xsect, z);
+           Weir[Link[j].subIndex].aOffset;                                     //(5.1.015)
 }
 
 //=============================================================================
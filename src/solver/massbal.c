@@ -10,6 +10,7 @@
 //             08/01/16  (Build 5.1.011)
 //             03/14/17  (Build 5.1.012)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -37,6 +38,15 @@
 //
 //   Build 5.1.013:
 //   - Volume from MinSurfArea no longer included in initial & final storage.
+//
+//   Build 5.1.015:
+//   - Runoff, groundwater, loading and routing time step totals are
+//     accumulated separately by each parallel thread and merged in thread
+//     order when used.
+//   - Cumulative totals use compensated (Neumaier) summation, with any
+//     number of threads, so that they depend little on how additions are
+//     split between threads. Totals (and the continuity errors reported)
+//     can differ in their last digits from earlier releases.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -45,6 +55,12 @@
 #include <math.h>
 #include "headers.h"
 #include "swmm5.h"
+#if defined(_OPENMP)                                                           //(5.1.015)
+#include <omp.h>
+#define THREAD_NUM omp_get_thread_num()
+#else
+#define THREAD_NUM 0
+#endif
 
 //-----------------------------------------------------------------------------
 //  Constants   
@@ -52,6 +68,30 @@
 static const double MAX_RUNOFF_BALANCE_ERR = 10.0;
 static const double MAX_FLOW_BALANCE_ERR   = 10.0;
 
+// Positions of runoff, groundwater & loading totals in a thread's sums        //(5.1.015)
+enum GwaterTotalType {GW_INFIL, GW_UPPER_EVAP, GW_LOWER_EVAP, GW_LOWER_PERC,
+                      GW_FLOW};
+#define NUM_RUNOFF_TOTALS  (RUNOFF_RUNON + 1)
+#define NUM_GWATER_TOTALS  (GW_FLOW + 1)
+#define NUM_LOADING_TOTALS (FINAL_LOAD + 1)
+#define RUNOFF_SUM(k)      (k)
+#define GWATER_SUM(k)      (NUM_RUNOFF_TOTALS + (k))
+#define LOADING_SUM(p, k)  (NUM_RUNOFF_TOTALS + NUM_GWATER_TOTALS + \
+                            (p) * NUM_LOADING_TOTALS + (k))
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+// Totals accumulated by a single thread                                       //(5.1.015)
+typedef struct
+{
+    double*         sum;          // runoff, groundwater & loading sums
+    double*         comp;         // compensation terms of the sums
+    TRoutingTotals  stepFlow;     // routed flow totals over time step
+    TRoutingTotals* stepQual;     // routed WQ totals over time step
+    char            pad[64];      // keeps threads off each other's cache line
+}  TThreadTotals;
+
 //-----------------------------------------------------------------------------
 //  Shared variables   
 //-----------------------------------------------------------------------------
@@ -64,6 +104,13 @@ TRoutingTotals   StepFlowTotals;  // routed flow totals over time step
 TRoutingTotals   OldStepFlowTotals;
 TRoutingTotals*  StepQualTotals;  // routed WQ totals over time step
 
+static TThreadTotals*  ThreadTotals;   // totals accumulated by each thread    //(5.1.015)
+static int             NumSums;        // number of sums kept by a thread      //(5.1.015)
+static TRoutingTotals  FlowComp;       // compensation terms of FlowTotals     //(5.1.015)
+static TRoutingTotals* QualComp;       // compensation terms of QualTotals     //(5.1.015)
+static double*         NodeInflowComp; // compensation terms of NodeInflow     //(5.1.015)
+static double*         NodeOutflowComp;// compensation terms of NodeOutflow    //(5.1.015)
+
 //-----------------------------------------------------------------------------
 //  Exportable variables
 //-----------------------------------------------------------------------------
@@ -104,9 +151,21 @@ double massbal_getLoadingError(void);
 double massbal_getGwaterError(void);
 double massbal_getQualError(void);
 
+static int    openThreadTotals(void);                                          //(5.1.015)
+static void   closeThreadTotals(void);                                         //(5.1.015)
+static TThreadTotals* getThreadTotals(void);                                   //(5.1.015)
+static double getThreadSum(int i);                                             //(5.1.015)
+static void   sumRunoffTotals(void);                                           //(5.1.015)
+static void   sumStepTotals(void);                                             //(5.1.015)
+static void   foldRoutingTotals(void);                                         //(5.1.015)
+static void   foldTotal(double* total, double* comp);                          //(5.1.015)
+static void   addCompensated(double* sum, double* comp, double x);             //(5.1.015)
+
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int massbal_open()
 //
 //  Input:   none
@@ -177,6 +236,10 @@ int massbal_open()
     StepQualTotals = NULL;
     NodeInflow = NULL;
     NodeOutflow = NULL;
+    QualComp = NULL;                                                           //(5.1.015)
+    NodeInflowComp = NULL;                                                     //(5.1.015)
+    NodeOutflowComp = NULL;                                                    //(5.1.015)
+    memset(&FlowComp, 0, sizeof(TRoutingTotals));                              //(5.1.015)
 
     // --- allocate memory for WQ washoff continuity totals
     n = Nobjects[POLLUT];
@@ -206,7 +269,9 @@ int massbal_open()
     {
          QualTotals = (TRoutingTotals *) calloc(n, sizeof(TRoutingTotals));
          StepQualTotals = (TRoutingTotals *) calloc(n, sizeof(TRoutingTotals));
-         if ( QualTotals == NULL || StepQualTotals == NULL )
+         QualComp = (TRoutingTotals *) calloc(n, sizeof(TRoutingTotals));      //(5.1.015)
+         if ( QualTotals == NULL || StepQualTotals == NULL ||
+              QualComp == NULL )                                               //(5.1.015)
          {
              report_writeErrorMsg(ERR_MEMORY, "");
              return ErrorCode;
@@ -228,6 +293,13 @@ int massbal_open()
         QualTotals[j].initStorage = massbal_getStoredMass(j);
     }
 
+    // --- allocate memory for totals accumulated by each thread               //(5.1.015)
+    if ( openThreadTotals() )                                                  //(5.1.015)
+    {                                                                          //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+        return ErrorCode;                                                      //(5.1.015)
+    }                                                                          //(5.1.015)
+
     // --- initialize totals used over a single time step
     massbal_initTimeStepTotals();
 
@@ -246,6 +318,13 @@ int massbal_open()
              report_writeErrorMsg(ERR_MEMORY, "");
              return ErrorCode;
         }
+        NodeInflowComp = (double *) calloc(Nobjects[NODE], sizeof(double));    //(5.1.015)
+        NodeOutflowComp = (double *) calloc(Nobjects[NODE], sizeof(double));   //(5.1.015)
+        if ( NodeInflowComp == NULL || NodeOutflowComp == NULL )               //(5.1.015)
+        {                                                                      //(5.1.015)
+             report_writeErrorMsg(ERR_MEMORY, "");                             //(5.1.015)
+             return ErrorCode;                                                 //(5.1.015)
+        }                                                                      //(5.1.015)
         for (j = 0; j < Nobjects[NODE]; j++) NodeInflow[j] = Node[j].newVolume;
     }
     return ErrorCode;
@@ -253,6 +332,8 @@ int massbal_open()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_close()
 //
 //  Input:   none
@@ -265,10 +346,16 @@ void massbal_close()
     FREE(StepQualTotals);
     FREE(NodeInflow);
     FREE(NodeOutflow);
+    FREE(QualComp);                                                            //(5.1.015)
+    FREE(NodeInflowComp);                                                      //(5.1.015)
+    FREE(NodeOutflowComp);                                                     //(5.1.015)
+    closeThreadTotals();                                                       //(5.1.015)
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_report()
 //
 //  Input:   none
@@ -279,6 +366,9 @@ void massbal_report()
     int    j;
     double gwArea = 0.0;
 
+    // --- add compensation terms into cumulative routing totals               //(5.1.015)
+    foldRoutingTotals();                                                       //(5.1.015)
+
     if ( Nobjects[SUBCATCH] > 0 )
     {
         if ( massbal_getRunoffError() > MAX_RUNOFF_BALANCE_ERR ||
@@ -346,6 +436,8 @@ double massbal_getBuildup(int p)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_updateRunoffTotals(int flowType, double v)
 //
 //  Input:   flowType = type of flow
@@ -354,19 +446,17 @@ void massbal_updateRunoffTotals(int flowType, double v)
 //  Purpose: updates runoff totals after current time step.
 //
 {
-    switch(flowType)
-    {
-    case RUNOFF_RAINFALL: RunoffTotals.rainfall += v; break;
-    case RUNOFF_EVAP:     RunoffTotals.evap     += v; break;
-    case RUNOFF_INFIL:    RunoffTotals.infil    += v; break;
-    case RUNOFF_RUNOFF:   RunoffTotals.runoff   += v; break;
-    case RUNOFF_DRAINS:   RunoffTotals.drains   += v; break;
-    case RUNOFF_RUNON:    RunoffTotals.runon    += v; break;
-    }
+    TThreadTotals* t = getThreadTotals();
+    int k = RUNOFF_SUM(flowType);
+
+    if ( flowType < 0 || flowType >= NUM_RUNOFF_TOTALS ) return;
+    addCompensated(&t->sum[k], &t->comp[k], v);
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_updateGwaterTotals(double vInfil, double vUpperEvap, double vLowerEvap,
                                 double vLowerPerc, double vGwater)
 //
@@ -379,15 +469,24 @@ void massbal_updateGwaterTotals(double vInfil, double vUpperEvap, double vLowerE
 //  Purpose: updates groundwater totals after current time step.
 //
 {
-    GwaterTotals.infil     += vInfil;
-    GwaterTotals.upperEvap += vUpperEvap;
-    GwaterTotals.lowerEvap += vLowerEvap;
-    GwaterTotals.lowerPerc += vLowerPerc;
-    GwaterTotals.gwater    += vGwater;
+    TThreadTotals* t = getThreadTotals();
+
+    addCompensated(&t->sum[GWATER_SUM(GW_INFIL)],
+                   &t->comp[GWATER_SUM(GW_INFIL)], vInfil);
+    addCompensated(&t->sum[GWATER_SUM(GW_UPPER_EVAP)],
+                   &t->comp[GWATER_SUM(GW_UPPER_EVAP)], vUpperEvap);
+    addCompensated(&t->sum[GWATER_SUM(GW_LOWER_EVAP)],
+                   &t->comp[GWATER_SUM(GW_LOWER_EVAP)], vLowerEvap);
+    addCompensated(&t->sum[GWATER_SUM(GW_LOWER_PERC)],
+                   &t->comp[GWATER_SUM(GW_LOWER_PERC)], vLowerPerc);
+    addCompensated(&t->sum[GWATER_SUM(GW_FLOW)],
+                   &t->comp[GWATER_SUM(GW_FLOW)], vGwater);
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_initTimeStepTotals()
 //
 //  Input:   none
@@ -395,7 +494,7 @@ void massbal_initTimeStepTotals()
 //  Purpose: initializes routing totals for current time step.
 //
 {
-    int j;
+    int j, t;
     OldStepFlowTotals = StepFlowTotals;
     StepFlowTotals.dwInflow  = 0.0;
     StepFlowTotals.wwInflow  = 0.0;
@@ -421,10 +520,20 @@ void massbal_initTimeStepTotals()
         StepQualTotals[j].initStorage = 0.0;
         StepQualTotals[j].finalStorage = 0.0;
     }
+
+    // --- clear each thread's time step totals
+    for (t = 0; t < NumThreads; t++)
+    {
+        memset(&ThreadTotals[t].stepFlow, 0, sizeof(TRoutingTotals));
+        if ( Nobjects[POLLUT] > 0 ) memset(ThreadTotals[t].stepQual, 0,
+            Nobjects[POLLUT] * sizeof(TRoutingTotals));
+    }
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addInflowFlow(int type, double q)
 //
 //  Input:   type = type of inflow
@@ -433,18 +542,22 @@ void massbal_addInflowFlow(int type, double q)
 //  Purpose: adds flow inflow to routing totals for current time step.
 //
 {
+    TRoutingTotals* f = &getThreadTotals()->stepFlow;
+
     switch (type)
     {
-      case DRY_WEATHER_INFLOW: StepFlowTotals.dwInflow += q; break;
-      case WET_WEATHER_INFLOW: StepFlowTotals.wwInflow += q; break;
-      case GROUNDWATER_INFLOW: StepFlowTotals.gwInflow += q; break;
-      case RDII_INFLOW:        StepFlowTotals.iiInflow += q; break;
-      case EXTERNAL_INFLOW:    StepFlowTotals.exInflow += q; break;
+      case DRY_WEATHER_INFLOW: f->dwInflow += q; break;
+      case WET_WEATHER_INFLOW: f->wwInflow += q; break;
+      case GROUNDWATER_INFLOW: f->gwInflow += q; break;
+      case RDII_INFLOW:        f->iiInflow += q; break;
+      case EXTERNAL_INFLOW:    f->exInflow += q; break;
     }
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_updateLoadingTotals(int type, int p, double w)
 //
 //  Input:   type = type of inflow
@@ -454,20 +567,17 @@ void massbal_updateLoadingTotals(int type, int p, double w)
 //  Purpose: adds inflow mass loading to loading totals for current time step.
 //
 {
-    switch (type)
-    {
-      case BUILDUP_LOAD:     LoadingTotals[p].buildup    += w; break;
-      case DEPOSITION_LOAD:  LoadingTotals[p].deposition += w; break;
-      case SWEEPING_LOAD:    LoadingTotals[p].sweeping   += w; break;
-      case INFIL_LOAD:       LoadingTotals[p].infil      += w; break;
-      case BMP_REMOVAL_LOAD: LoadingTotals[p].bmpRemoval += w; break;
-      case RUNOFF_LOAD:      LoadingTotals[p].runoff     += w; break;
-      case FINAL_LOAD:       LoadingTotals[p].finalLoad  += w; break;
-    }
+    TThreadTotals* t = getThreadTotals();
+    int k = LOADING_SUM(p, type);
+
+    if ( type < 0 || type >= NUM_LOADING_TOTALS ) return;
+    addCompensated(&t->sum[k], &t->comp[k], w);
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addInflowQual(int type, int p, double w)
 //
 //  Input:   type = type of inflow
@@ -477,19 +587,24 @@ void massbal_addInflowQual(int type, int p, double w)
 //  Purpose: adds quality inflow to routing totals for current time step.
 //
 {
+    TRoutingTotals* q;
+
     if ( p < 0 || p >= Nobjects[POLLUT] ) return;
+    q = &getThreadTotals()->stepQual[p];
     switch (type)
     {
-      case DRY_WEATHER_INFLOW: StepQualTotals[p].dwInflow += w; break;
-      case WET_WEATHER_INFLOW: StepQualTotals[p].wwInflow += w; break;
-      case GROUNDWATER_INFLOW: StepQualTotals[p].gwInflow += w; break;
-      case EXTERNAL_INFLOW:    StepQualTotals[p].exInflow += w; break;
-      case RDII_INFLOW:        StepQualTotals[p].iiInflow += w; break;
+      case DRY_WEATHER_INFLOW: q->dwInflow += w; break;
+      case WET_WEATHER_INFLOW: q->wwInflow += w; break;
+      case GROUNDWATER_INFLOW: q->gwInflow += w; break;
+      case EXTERNAL_INFLOW:    q->exInflow += w; break;
+      case RDII_INFLOW:        q->iiInflow += w; break;
    }
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addOutflowFlow(double q, int isFlooded)
 //
 //  Input:   q = outflow flow rate (cfs)
@@ -498,12 +613,16 @@ void massbal_addOutflowFlow(double q, int isFlooded)
 //  Purpose: adds flow outflow over current time step to routing totals.
 //
 {
-    if ( isFlooded ) StepFlowTotals.flooding += q;
-    else             StepFlowTotals.outflow += q;
+    TRoutingTotals* f = &getThreadTotals()->stepFlow;
+
+    if ( isFlooded ) f->flooding += q;
+    else             f->outflow += q;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addOutflowQual(int p, double w, int isFlooded)
 //
 //  Input:   p = pollutant index
@@ -513,17 +632,22 @@ void massbal_addOutflowQual(int p, double w, int isFlooded)
 //  Purpose: adds pollutant outflow over current time step to routing totals.
 //
 {
+    TRoutingTotals* q;
+
     if ( p < 0 || p >= Nobjects[POLLUT] ) return;
+    q = &getThreadTotals()->stepQual[p];
     if ( w >= 0.0 )
     {
-        if ( isFlooded ) StepQualTotals[p].flooding += w;
-        else             StepQualTotals[p].outflow += w;
+        if ( isFlooded ) q->flooding += w;
+        else             q->outflow += w;
     }
-    else StepQualTotals[p].exInflow -= w;
+    else q->exInflow -= w;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addReactedMass(int p, double w)
 //
 //  Input:   p = pollutant index
@@ -533,11 +657,13 @@ void massbal_addReactedMass(int p, double w)
 //
 {
     if ( p < 0 || p >= Nobjects[POLLUT] ) return;
-    StepQualTotals[p].reacted += w;
+    getThreadTotals()->stepQual[p].reacted += w;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addSeepageLoss(int p, double w)
 //
 //  Input:   p = pollutant index
@@ -547,11 +673,13 @@ void massbal_addSeepageLoss(int p, double w)
 //
 {
     if ( p < 0 || p >= Nobjects[POLLUT] ) return;
-    StepQualTotals[p].seepLoss += w;
+    getThreadTotals()->stepQual[p].seepLoss += w;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addToFinalStorage(int p, double w)
 //
 //  Input:   p = pollutant index
@@ -561,11 +689,13 @@ void massbal_addToFinalStorage(int p, double w)
 //
 {
     if ( p < 0 || p >= Nobjects[POLLUT] ) return;
-    StepQualTotals[p].finalStorage += w;
+    getThreadTotals()->stepQual[p].finalStorage += w;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addNodeLosses(double evapLoss, double seepLoss)
 //
 //  Input:   evapLoss = evaporation loss from all nodes (ft3/sec)
@@ -574,12 +704,16 @@ void massbal_addNodeLosses(double evapLoss, double seepLoss)
 //  Purpose: adds node losses over current time step to routing totals.
 //
 {
-    StepFlowTotals.evapLoss += evapLoss;
-    StepFlowTotals.seepLoss += seepLoss;
+    TRoutingTotals* f = &getThreadTotals()->stepFlow;
+
+    f->evapLoss += evapLoss;
+    f->seepLoss += seepLoss;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_addLinkLosses(double evapLoss, double seepLoss)
 //
 //  Input:   evapLoss = evaporation loss from all links (ft3/sec)
@@ -588,12 +722,16 @@ void massbal_addLinkLosses(double evapLoss, double seepLoss)
 //  Purpose: adds link losses over current time step to routing totals.
 //
 {
-    StepFlowTotals.evapLoss += evapLoss;
-    StepFlowTotals.seepLoss += seepLoss;
+    TRoutingTotals* f = &getThreadTotals()->stepFlow;
+
+    f->evapLoss += evapLoss;
+    f->seepLoss += seepLoss;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void massbal_updateRoutingTotals(double tStep)
 //
 //  Input:   tStep = time step (sec)
@@ -602,43 +740,57 @@ void massbal_updateRoutingTotals(double tStep)
 //
 {
     int j;
-    FlowTotals.dwInflow += StepFlowTotals.dwInflow * tStep;
-    FlowTotals.wwInflow += StepFlowTotals.wwInflow * tStep;
-    FlowTotals.gwInflow += StepFlowTotals.gwInflow * tStep;
-    FlowTotals.iiInflow += StepFlowTotals.iiInflow * tStep;
-    FlowTotals.exInflow += StepFlowTotals.exInflow * tStep;
-    FlowTotals.flooding += StepFlowTotals.flooding * tStep;
-    FlowTotals.outflow  += StepFlowTotals.outflow * tStep;
-    FlowTotals.evapLoss += StepFlowTotals.evapLoss * tStep;
-    FlowTotals.seepLoss += StepFlowTotals.seepLoss * tStep;
+    TRoutingTotals* f = &FlowTotals;
+    TRoutingTotals* c = &FlowComp;
+    TRoutingTotals* step = &StepFlowTotals;
+
+    // --- merge the time step totals accumulated by each thread
+    sumStepTotals();
+
+    addCompensated(&f->dwInflow, &c->dwInflow, step->dwInflow * tStep);
+    addCompensated(&f->wwInflow, &c->wwInflow, step->wwInflow * tStep);
+    addCompensated(&f->gwInflow, &c->gwInflow, step->gwInflow * tStep);
+    addCompensated(&f->iiInflow, &c->iiInflow, step->iiInflow * tStep);
+    addCompensated(&f->exInflow, &c->exInflow, step->exInflow * tStep);
+    addCompensated(&f->flooding, &c->flooding, step->flooding * tStep);
+    addCompensated(&f->outflow,  &c->outflow,  step->outflow * tStep);
+    addCompensated(&f->evapLoss, &c->evapLoss, step->evapLoss * tStep);
+    addCompensated(&f->seepLoss, &c->seepLoss, step->seepLoss * tStep);
 
     for (j = 0; j < Nobjects[POLLUT]; j++)
     {
-        QualTotals[j].dwInflow += StepQualTotals[j].dwInflow * tStep;
-        QualTotals[j].wwInflow += StepQualTotals[j].wwInflow * tStep;
-        QualTotals[j].gwInflow += StepQualTotals[j].gwInflow * tStep;
-        QualTotals[j].iiInflow += StepQualTotals[j].iiInflow * tStep;
-        QualTotals[j].exInflow += StepQualTotals[j].exInflow * tStep;
-        QualTotals[j].flooding += StepQualTotals[j].flooding * tStep;
-        QualTotals[j].outflow  += StepQualTotals[j].outflow * tStep;
-        QualTotals[j].reacted  += StepQualTotals[j].reacted * tStep;
-        QualTotals[j].seepLoss += StepQualTotals[j].seepLoss * tStep;
-        QualTotals[j].finalStorage += StepQualTotals[j].finalStorage;
+        f = &QualTotals[j];
+        c = &QualComp[j];
+        step = &StepQualTotals[j];
+        addCompensated(&f->dwInflow, &c->dwInflow, step->dwInflow * tStep);
+        addCompensated(&f->wwInflow, &c->wwInflow, step->wwInflow * tStep);
+        addCompensated(&f->gwInflow, &c->gwInflow, step->gwInflow * tStep);
+        addCompensated(&f->iiInflow, &c->iiInflow, step->iiInflow * tStep);
+        addCompensated(&f->exInflow, &c->exInflow, step->exInflow * tStep);
+        addCompensated(&f->flooding, &c->flooding, step->flooding * tStep);
+        addCompensated(&f->outflow,  &c->outflow,  step->outflow * tStep);
+        addCompensated(&f->reacted,  &c->reacted,  step->reacted * tStep);
+        addCompensated(&f->seepLoss, &c->seepLoss, step->seepLoss * tStep);
+        addCompensated(&f->finalStorage, &c->finalStorage, step->finalStorage);
     }
 
     for ( j = 0; j < Nobjects[NODE]; j++)
     {
-        NodeInflow[j] += Node[j].inflow * tStep;
+        addCompensated(&NodeInflow[j], &NodeInflowComp[j],
+                       Node[j].inflow * tStep);
         if ( Node[j].type == OUTFALL || 
             (Node[j].degree == 0 && Node[j].type != STORAGE) )
         {
-            NodeOutflow[j] += Node[j].inflow * tStep;
+            addCompensated(&NodeOutflow[j], &NodeOutflowComp[j],
+                           Node[j].inflow * tStep);
         }
         else
         {
-            NodeOutflow[j] += Node[j].outflow * tStep; 
+            addCompensated(&NodeOutflow[j], &NodeOutflowComp[j],
+                           Node[j].outflow * tStep);
             if ( Node[j].newVolume <= Node[j].fullVolume ) 
-                NodeOutflow[j] += Node[j].overflow * tStep; 
+                addCompensated(&NodeOutflow[j], &NodeOutflowComp[j],
+                               Node[j].overflow * tStep);
         }
     }
 }
@@ -703,6 +855,8 @@ void massbal_getSysFlows(double f, double sysFlows[])
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double massbal_getRunoffError()
 //
 //  Input:   none
@@ -714,6 +868,9 @@ double massbal_getRunoffError()
     double totalInflow;
     double totalOutflow;
 
+    // --- merge runoff totals accumulated by each thread
+    sumRunoffTotals();
+
     // --- find final storage on all subcatchments
     RunoffTotals.finalStorage = 0.0;
     RunoffTotals.finalSnowCover = 0.0;
@@ -757,6 +914,8 @@ double massbal_getRunoffError()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double massbal_getLoadingError()
 //
 //  Input:   none
@@ -771,6 +930,17 @@ double massbal_getLoadingError()
 
     for (j = 0; j < Nobjects[POLLUT]; j++)
     {
+        // --- merge loadings accumulated by each thread
+        LoadingTotals[j].buildup = getThreadSum(LOADING_SUM(j, BUILDUP_LOAD));
+        LoadingTotals[j].deposition =
+            getThreadSum(LOADING_SUM(j, DEPOSITION_LOAD));
+        LoadingTotals[j].sweeping = getThreadSum(LOADING_SUM(j, SWEEPING_LOAD));
+        LoadingTotals[j].infil = getThreadSum(LOADING_SUM(j, INFIL_LOAD));
+        LoadingTotals[j].bmpRemoval =
+            getThreadSum(LOADING_SUM(j, BMP_REMOVAL_LOAD));
+        LoadingTotals[j].runoff = getThreadSum(LOADING_SUM(j, RUNOFF_LOAD));
+        LoadingTotals[j].finalLoad = getThreadSum(LOADING_SUM(j, FINAL_LOAD));
+
         // --- get final pollutant loading remaining on land surface
         LoadingTotals[j].finalLoad += massbal_getBuildup(j); 
 
@@ -820,6 +990,8 @@ double massbal_getLoadingError()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double massbal_getGwaterError()
 //
 //  Input:   none
@@ -831,6 +1003,13 @@ double massbal_getGwaterError()
     double totalInflow;
     double totalOutflow;
 
+    // --- merge groundwater totals accumulated by each thread
+    GwaterTotals.infil     = getThreadSum(GWATER_SUM(GW_INFIL));
+    GwaterTotals.upperEvap = getThreadSum(GWATER_SUM(GW_UPPER_EVAP));
+    GwaterTotals.lowerEvap = getThreadSum(GWATER_SUM(GW_LOWER_EVAP));
+    GwaterTotals.lowerPerc = getThreadSum(GWATER_SUM(GW_LOWER_PERC));
+    GwaterTotals.gwater    = getThreadSum(GWATER_SUM(GW_FLOW));
+
     // --- find final storage in groundwater
     GwaterTotals.finalStorage = 0.0;
     for ( j = 0; j < Nobjects[SUBCATCH]; j++ )
@@ -1062,6 +1241,7 @@ int massbal_getRoutingTotal(TRoutingTotals **routingTotal)
 // Purpose:  Gets the routing total for toolkitAPI
 //
 {
+    foldRoutingTotals();                                                       //(5.1.015)
 	memcpy(*routingTotal, &FlowTotals, sizeof(TRoutingTotals));
 
     // Cumulative Dry Weather Inflow Volume
@@ -1096,6 +1276,7 @@ int massbal_getRunoffTotal(TRunoffTotals **runoffTotal)
 //
 {
 	
+    sumRunoffTotals();                                                         //(5.1.015)
 	memcpy(*runoffTotal, &RunoffTotals, sizeof(TRunoffTotals));
 	
     // Cumulative Rainfall Depth
@@ -1134,7 +1315,286 @@ int massbal_getNodeTotalInflow(int index, double *value)
 // Return: Error
 // Purpose: Used for ToolkitAPI to pull total Node Inflow.
 {
-	*value = NodeInflow[index] * UCF(VOLUME);
+	*value = (NodeInflow[index] + NodeInflowComp[index]) * UCF(VOLUME);           //(5.1.015)
 
     return 0;
-}
\ No newline at end of file
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int openThreadTotals()
+//
+//  Input:   none
+//  Output:  returns TRUE if memory could not be allocated
+//  Purpose: allocates the totals that each computing thread accumulates.
+//
+{
+    int t;
+    int n = Nobjects[POLLUT];
+
+    NumSums = NUM_RUNOFF_TOTALS + NUM_GWATER_TOTALS + n * NUM_LOADING_TOTALS;
+    ThreadTotals = (TThreadTotals *) calloc(NumThreads, sizeof(TThreadTotals));
+    if ( ThreadTotals == NULL ) return TRUE;
+    for (t = 0; t < NumThreads; t++)
+    {
+        ThreadTotals[t].sum = (double *) calloc(NumSums, sizeof(double));
+        ThreadTotals[t].comp = (double *) calloc(NumSums, sizeof(double));
+        if ( ThreadTotals[t].sum == NULL || ThreadTotals[t].comp == NULL )
+            return TRUE;
+        if ( n > 0 )
+        {
+            ThreadTotals[t].stepQual =
+                (TRoutingTotals *) calloc(n, sizeof(TRoutingTotals));
+            if ( ThreadTotals[t].stepQual == NULL ) return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void closeThreadTotals()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the totals accumulated by each computing thread.
+//
+{
+    int t;
+
+    if ( ThreadTotals == NULL ) return;
+    for (t = 0; t < NumThreads; t++)
+    {
+        FREE(ThreadTotals[t].sum);
+        FREE(ThreadTotals[t].comp);
+        FREE(ThreadTotals[t].stepQual);
+    }
+    FREE(ThreadTotals);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+TThreadTotals* getThreadTotals()
+//
+//  Input:   none
+//  Output:  returns the totals owned by the calling thread
+//  Purpose: finds the set of totals the calling thread adds into, so that
+//           threads updating mass balance totals never share a location.
+//
+{
+    return &ThreadTotals[THREAD_NUM];
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double getThreadSum(int i)
+//
+//  Input:   i = index of a runoff, groundwater or loading total
+//  Output:  returns the total summed over all threads
+//  Purpose: merges the compensated sums kept by each thread for a total.
+//
+//  Note: threads are merged in a fixed order (and the parallel loops that
+//        add to these sums split their work statically) so that a run's
+//        totals repeat for a given number of threads.
+//
+{
+    int    t;
+    double sum = 0.0;
+    double comp = 0.0;
+
+    for (t = 0; t < NumThreads; t++)
+    {
+        addCompensated(&sum, &comp, ThreadTotals[t].sum[i]);
+        comp += ThreadTotals[t].comp[i];
+    }
+    return sum + comp;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void sumRunoffTotals()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: merges the runoff totals kept by each thread into RunoffTotals.
+//
+{
+    RunoffTotals.rainfall = getThreadSum(RUNOFF_SUM(RUNOFF_RAINFALL));
+    RunoffTotals.evap     = getThreadSum(RUNOFF_SUM(RUNOFF_EVAP));
+    RunoffTotals.infil    = getThreadSum(RUNOFF_SUM(RUNOFF_INFIL));
+    RunoffTotals.runoff   = getThreadSum(RUNOFF_SUM(RUNOFF_RUNOFF));
+    RunoffTotals.drains   = getThreadSum(RUNOFF_SUM(RUNOFF_DRAINS));
+    RunoffTotals.runon    = getThreadSum(RUNOFF_SUM(RUNOFF_RUNON));
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void sumStepTotals()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: merges the routing totals each thread accumulated over the
+//           current time step into StepFlowTotals and StepQualTotals.
+//
+{
+    int t, p;
+    TRoutingTotals* f;
+    TRoutingTotals* q;
+
+    // --- threads are summed in a fixed order so results are repeatable
+    //     (the finalStorage flow total is not accumulated and is left as is)
+    StepFlowTotals.dwInflow = 0.0;
+    StepFlowTotals.wwInflow = 0.0;
+    StepFlowTotals.gwInflow = 0.0;
+    StepFlowTotals.iiInflow = 0.0;
+    StepFlowTotals.exInflow = 0.0;
+    StepFlowTotals.flooding = 0.0;
+    StepFlowTotals.outflow  = 0.0;
+    StepFlowTotals.evapLoss = 0.0;
+    StepFlowTotals.seepLoss = 0.0;
+    StepFlowTotals.reacted  = 0.0;
+    for (t = 0; t < NumThreads; t++)
+    {
+        f = &ThreadTotals[t].stepFlow;
+        StepFlowTotals.dwInflow += f->dwInflow;
+        StepFlowTotals.wwInflow += f->wwInflow;
+        StepFlowTotals.gwInflow += f->gwInflow;
+        StepFlowTotals.iiInflow += f->iiInflow;
+        StepFlowTotals.exInflow += f->exInflow;
+        StepFlowTotals.flooding += f->flooding;
+        StepFlowTotals.outflow  += f->outflow;
+        StepFlowTotals.evapLoss += f->evapLoss;
+        StepFlowTotals.seepLoss += f->seepLoss;
+        StepFlowTotals.reacted  += f->reacted;
+    }
+
+    for (p = 0; p < Nobjects[POLLUT]; p++)
+    {
+        q = &StepQualTotals[p];
+        q->dwInflow = 0.0;
+        q->wwInflow = 0.0;
+        q->gwInflow = 0.0;
+        q->iiInflow = 0.0;
+        q->exInflow = 0.0;
+        q->flooding = 0.0;
+        q->outflow  = 0.0;
+        q->reacted  = 0.0;
+        q->seepLoss = 0.0;
+        q->finalStorage = 0.0;
+        for (t = 0; t < NumThreads; t++)
+        {
+            f = &ThreadTotals[t].stepQual[p];
+            q->dwInflow += f->dwInflow;
+            q->wwInflow += f->wwInflow;
+            q->gwInflow += f->gwInflow;
+            q->iiInflow += f->iiInflow;
+            q->exInflow += f->exInflow;
+            q->flooding += f->flooding;
+            q->outflow  += f->outflow;
+            q->reacted  += f->reacted;
+            q->seepLoss += f->seepLoss;
+            q->finalStorage += f->finalStorage;
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void foldRoutingTotals()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: adds the compensation terms of the cumulative routing totals
+//           into the totals themselves before they are reported.
+//
+{
+    int j;
+    TRoutingTotals* f = &FlowTotals;
+    TRoutingTotals* c = &FlowComp;
+
+    foldTotal(&f->dwInflow, &c->dwInflow);
+    foldTotal(&f->wwInflow, &c->wwInflow);
+    foldTotal(&f->gwInflow, &c->gwInflow);
+    foldTotal(&f->iiInflow, &c->iiInflow);
+    foldTotal(&f->exInflow, &c->exInflow);
+    foldTotal(&f->flooding, &c->flooding);
+    foldTotal(&f->outflow,  &c->outflow);
+    foldTotal(&f->evapLoss, &c->evapLoss);
+    foldTotal(&f->seepLoss, &c->seepLoss);
+
+    if ( QualTotals && QualComp ) for (j = 0; j < Nobjects[POLLUT]; j++)
+    {
+        f = &QualTotals[j];
+        c = &QualComp[j];
+        foldTotal(&f->dwInflow, &c->dwInflow);
+        foldTotal(&f->wwInflow, &c->wwInflow);
+        foldTotal(&f->gwInflow, &c->gwInflow);
+        foldTotal(&f->iiInflow, &c->iiInflow);
+        foldTotal(&f->exInflow, &c->exInflow);
+        foldTotal(&f->flooding, &c->flooding);
+        foldTotal(&f->outflow,  &c->outflow);
+        foldTotal(&f->reacted,  &c->reacted);
+        foldTotal(&f->seepLoss, &c->seepLoss);
+        foldTotal(&f->finalStorage, &c->finalStorage);
+    }
+
+    if ( NodeInflowComp && NodeOutflowComp )
+    {
+        for (j = 0; j < Nobjects[NODE]; j++)
+        {
+            foldTotal(&NodeInflow[j], &NodeInflowComp[j]);
+            foldTotal(&NodeOutflow[j], &NodeOutflowComp[j]);
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void foldTotal(double* total, double* comp)
+//
+//  Input:   total = a compensated running total
+//           comp = its accumulated compensation term
+//  Output:  none
+//  Purpose: adds a compensation term into its total and clears it.
+//
+{
+    *total += *comp;
+    *comp = 0.0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void addCompensated(double* sum, double* comp, double x)
+//
+//  Input:   sum = a running total
+//           comp = running compensation term of the total
+//           x = amount added to the total
+//  Output:  none
+//  Purpose: adds to a running total using Neumaier's compensated summation,
+//           which keeps the rounding error lost by each addition in comp.
+//
+{
+    double t = *sum + x;
+
+    if ( fabs(*sum) >= fabs(x) ) *comp += (*sum - t) + x;
+    else                         *comp += (x - t) + *sum;
+    *sum = t;
+}
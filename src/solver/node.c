@@ -9,6 +9,7 @@
 //             08/05/15   (Build 5.1.010)
 //             05/10/18   (Build 5.1.013)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Conveyance system node functions.
@@ -31,6 +32,10 @@
 //
 //   Build 5.1.014:
 //   - Fixed bug in storage_losses() that affected storage exfiltration.
+//
+//   Build 5.1.015:
+//   - Storage unit volume and depth found from precomputed volume tables.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -79,6 +84,11 @@ static int    outfall_readParams(int j, int k, char* tok[], int ntoks);
 static void   outfall_setOutletDepth(int j, double yNorm, double yCrit, double z);
 
 static int    storage_readParams(int j, int k, char* tok[], int ntoks);
+static void   storage_validate(int j);                                         //(5.1.015)
+static int    storage_findEntry(double x[], int n, double x0);                 //(5.1.015)
+static double storage_getTblVolume(TStorageTbl* tbl, double d);                //(5.1.015)
+static double storage_getTblDepth(TStorageTbl* tbl, double v);                 //(5.1.015)
+static double storage_getTblArea(TStorageTbl* tbl, double d);                  //(5.1.015)
 static double storage_getDepth(int j, double v);
 static double storage_getVolume(int j, double d);
 static double storage_getSurfArea(int j, double d);
@@ -192,6 +202,8 @@ void  node_setParams(int j, int type, int k, double x[])
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void  node_validate(int j)
 //
 //  Input:   j = node index
@@ -212,6 +224,7 @@ void  node_validate(int j)
         report_writeErrorMsg(ERR_NODE_DEPTH, Node[j].ID);
 
     if ( Node[j].type == DIVIDER ) divider_validate(j);
+    if ( Node[j].type == STORAGE ) storage_validate(j);                        //(5.1.015)
 
     // --- initialize dry weather inflows
     inflow = Node[j].dwfInflow;
@@ -731,6 +744,270 @@ int storage_readParams(int j, int k, char* tok[], int ntoks)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void storage_validate(int j)
+//
+//  Input:   j = node index
+//  Output:  none
+//  Purpose: builds a storage unit's volume v. depth table.
+//
+//  A tabular area curve is copied along with the volume below each of its
+//  points. A functional curve whose depth can only be found by iteration
+//  is tabulated at equally spaced depths up to the node's full depth. The
+//  remaining functional curves are evaluated directly.
+//
+{
+    int    k = Node[j].subIndex;
+    int    i = Storage[k].aCurve;
+    int    m, n = 0;
+    double x, y, x1, y1, e, dMax;
+    TStorageTbl* tbl = &Storage[k].vTbl;
+
+    FREE(tbl->depth);
+    FREE(tbl->area);
+    FREE(tbl->volume);
+    tbl->nItems = 0;
+
+    // --- count table entries
+    if ( i >= 0 )
+    {
+        if ( table_getFirstEntry(&Curve[i], &x, &y) ) n = 1;
+        while ( table_getNextEntry(&Curve[i], &x, &y) ) n++;
+    }
+    else if ( Storage[k].aExpon != 0.0 && Storage[k].aConst != 0.0
+    &&        Node[j].fullDepth > 0.0 ) n = N_STORAGE_TBL;
+    if ( n == 0 ) return;
+
+    tbl->depth = (double *) calloc(n, sizeof(double));
+    tbl->area = (double *) calloc(n, sizeof(double));
+    tbl->volume = (double *) calloc(n, sizeof(double));
+    if ( !tbl->depth || !tbl->area || !tbl->volume )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    tbl->nItems = n;
+
+    // --- copy the area curve and accumulate the (trapezoidal) volume
+    //     in the same order as table_getArea does
+    if ( i >= 0 )
+    {
+        table_getFirstEntry(&Curve[i], &x1, &y1);
+        tbl->depth[0] = x1;
+        tbl->area[0] = y1;
+        tbl->volume[0] = y1*x1/2.0;
+        for ( m = 1; m < n; m++ )
+        {
+            table_getNextEntry(&Curve[i], &x, &y);
+            tbl->depth[m] = x;
+            tbl->area[m] = y;
+            tbl->volume[m] = tbl->volume[m-1] + (y1 + y) * (x - x1) / 2.0;
+            x1 = x;
+            y1 = y;
+        }
+    }
+
+    // --- evaluate the functional curve at equally spaced depths
+    else
+    {
+        dMax = Node[j].fullDepth * UCF(LENGTH);
+        e = Storage[k].aExpon + 1.0;
+        for ( m = 0; m < n; m++ )
+        {
+            x = dMax * m / (n - 1);
+            tbl->depth[m] = x;
+            tbl->area[m] = Storage[k].aConst + Storage[k].aCoeff *
+                           pow(x, Storage[k].aExpon);
+            tbl->volume[m] = Storage[k].aConst * x +
+                             Storage[k].aCoeff / e * pow(x, e);
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int storage_findEntry(double x[], int n, double x0)
+//
+//  Input:   x = array of n non-decreasing values
+//           n = number of values
+//           x0 = value being located
+//  Output:  returns index of first x[i] >= x0 for i >= 1 (or n if none)
+//  Purpose: locates the interval of a volume table holding a given value.
+//
+{
+    int lo = 1, hi = n, mid;
+
+    while ( lo < hi )
+    {
+        mid = (lo + hi) / 2;
+        if ( x[mid] < x0 ) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double storage_getTblVolume(TStorageTbl* tbl, double d)
+//
+//  Input:   tbl = storage unit's volume table for a tabular area curve
+//           d = depth (user units)
+//  Output:  returns volume below depth d (user units)
+//  Purpose: finds volume from depth the same way as table_getArea does.
+//
+{
+    int    i, n = tbl->nItems;
+    double x1, y1, y2, dx, s = 0.0;
+
+    if ( n == 0 ) return 0.0;
+    x1 = tbl->depth[0];
+    y1 = tbl->area[0];
+    if ( d <= x1 )
+    {
+        if ( x1 > 0.0 ) s = y1/x1;
+        return s*d*d/2.0;
+    }
+
+    // --- within the table
+    i = storage_findEntry(tbl->depth, n, d);
+    if ( i < n )
+    {
+        x1 = tbl->depth[i-1];
+        y1 = tbl->area[i-1];
+        y2 = y1 + (d - x1) * (tbl->area[i] - y1) / (tbl->depth[i] - x1);
+        return tbl->volume[i-1] + (d - x1) * (y1 + y2) / 2.0;
+    }
+
+    // --- extrapolate beyond the table's last entry
+    x1 = tbl->depth[n-1];
+    y1 = tbl->area[n-1];
+    if ( n > 1 ) s = (y1 - tbl->area[n-2]) / (x1 - tbl->depth[n-2]);
+    dx = d - x1;
+    return tbl->volume[n-1] + y1*dx + s*dx*dx/2.0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double storage_getTblDepth(TStorageTbl* tbl, double v)
+//
+//  Input:   tbl = storage unit's volume table for a tabular area curve
+//           v = volume (user units)
+//  Output:  returns depth (user units)
+//  Purpose: finds depth from volume the same way as table_getInverseArea
+//           does.
+//
+{
+    int    i, n = tbl->nItems;
+    double x1, y1, v1, dx = 0.0, dy = 0.0, s;
+
+    if ( n == 0 ) return 0.0;
+    x1 = tbl->depth[0];
+    y1 = tbl->area[0];
+    v1 = tbl->volume[0];
+    if ( v <= v1 )
+    {
+        if ( y1 > 0.0 ) return sqrt(2.0*v*x1/y1);
+        else return 0.0;
+    }
+
+    // --- within the table
+    i = storage_findEntry(tbl->volume, n, v);
+    if ( i < n )
+    {
+        x1 = tbl->depth[i-1];
+        y1 = tbl->area[i-1];
+        v1 = tbl->volume[i-1];
+        dx = tbl->depth[i] - x1;
+        dy = tbl->area[i] - y1;
+        if ( dy == 0.0 )
+        {
+            if ( tbl->volume[i] == v1 ) return x1;
+            else return x1 + dx * (v - v1) / (tbl->volume[i] - v1);
+        }
+
+        // --- if area decreases with depth then start from the upper point
+        if ( dy < 0.0 )
+        {
+            x1 = tbl->depth[i];
+            y1 = tbl->area[i];
+            v1 = tbl->volume[i];
+        }
+        s = dy/dx;
+        return x1 + (sqrt(y1*y1 + 2.0*s*(v-v1)) - y1) / s;
+    }
+
+    // --- extrapolate beyond the table's last entry
+    x1 = tbl->depth[n-1];
+    y1 = tbl->area[n-1];
+    v1 = tbl->volume[n-1];
+    if ( n > 1 )
+    {
+        dx = x1 - tbl->depth[n-2];
+        dy = y1 - tbl->area[n-2];
+    }
+    if ( dx == 0.0 || dy == 0.0 )
+    {
+        if ( y1 > 0.0 ) dx = (v - v1) / y1;
+        else dx = 0.0;
+    }
+    else
+    {
+        s = dy/dx;
+        dx = (sqrt(y1*y1 + 2.0*s*(v-v1)) - y1) / s;
+        if ( dx < 0.0 ) dx = 0.0;
+    }
+    return x1 + dx;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double storage_getTblArea(TStorageTbl* tbl, double d)
+//
+//  Input:   tbl = storage unit's volume table for a tabular area curve
+//           d = depth (user units)
+//  Output:  returns surface area (user units)
+//  Purpose: finds surface area from depth the same way as table_lookupEx
+//           does.
+//
+{
+    int    i, n = tbl->nItems;
+    double x1, y1, s = 0.0;
+
+    if ( n == 0 ) return 0.0;
+    x1 = tbl->depth[0];
+    y1 = tbl->area[0];
+    if ( d <= x1 )
+    {
+        if ( x1 > 0.0 ) return d/x1*y1;
+        else return y1;
+    }
+    i = storage_findEntry(tbl->depth, n, d);
+    if ( i < n )
+    {
+        x1 = tbl->depth[i-1];
+        y1 = tbl->area[i-1];
+        return y1 + (d - x1) * (tbl->area[i] - y1) / (tbl->depth[i] - x1);
+    }
+    x1 = tbl->depth[n-1];
+    y1 = tbl->area[n-1];
+    if ( n > 1 ) s = (y1 - tbl->area[n-2]) / (x1 - tbl->depth[n-2]);
+    if ( s < 0.0 ) s = 0.0;
+    return y1 + s*(d - x1);
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double storage_getDepth(int j, double v)
 //
 //  Input:   j = node index
@@ -741,7 +1018,9 @@ double storage_getDepth(int j, double v)
 {
     int    k = Node[j].subIndex;
     int    i = Storage[k].aCurve;
-    double d, e;
+    int    m, n;                                                               //(5.1.015)
+    double d, e, dLo, dHi;                                                     //(5.1.015)
+    TStorageTbl* tbl = &Storage[k].vTbl;                                       //(5.1.015)
 	TStorageVol storageVol;
 
     // --- return max depth if a max. volume has been computed
@@ -752,7 +1031,7 @@ double storage_getDepth(int j, double v)
 
     // --- use tabular area v. depth curve
     if ( i >= 0 )
-        return table_getInverseArea(&Curve[i], v*UCF(VOLUME)) / UCF(LENGTH);
+        return storage_getTblDepth(tbl, v*UCF(VOLUME)) / UCF(LENGTH);          //(5.1.015)
 
     // --- use functional area v. depth relation
     else
@@ -772,8 +1051,21 @@ double storage_getDepth(int j, double v)
             storageVol.k = k;
             storageVol.v = v;
             d = v / (Storage[k].aConst + Storage[k].aCoeff);
-            findroot_Newton(0.0, Node[j].fullDepth*UCF(LENGTH), &d,
-                            0.001, storage_getVolDiff, &storageVol);            
+            dLo = 0.0;                                                         //(5.1.015)
+            dHi = Node[j].fullDepth*UCF(LENGTH);                               //(5.1.015)
+
+            // --- start from the volume table's bracket on the depth          //(5.1.015)
+            n = tbl->nItems;                                                   //(5.1.015)
+            m = n > 1 ? storage_findEntry(tbl->volume, n, v) : n;              //(5.1.015)
+            if ( m < n && tbl->depth[n-1] <= dHi )                             //(5.1.015)
+            {                                                                  //(5.1.015)
+                dLo = tbl->depth[m-1];                                         //(5.1.015)
+                dHi = tbl->depth[m];                                           //(5.1.015)
+                d = dLo + (dHi - dLo) * (v - tbl->volume[m-1]) /               //(5.1.015)
+                    (tbl->volume[m] - tbl->volume[m-1]);                       //(5.1.015)
+            }                                                                  //(5.1.015)
+            findroot_Newton(dLo, dHi, &d, 0.001, storage_getVolDiff,           //(5.1.015)
+                            &storageVol);                                      //(5.1.015)
         }
         d /= UCF(LENGTH);
         if ( d > Node[j].fullDepth ) d = Node[j].fullDepth;
@@ -812,6 +1104,8 @@ void  storage_getVolDiff(double y, double* f, double* df, void* p)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double storage_getVolume(int j, double d)
 //
 //  Input:   j = node index
@@ -830,8 +1124,9 @@ double storage_getVolume(int j, double d)
     &&   Node[j].fullVolume > 0.0 ) return Node[j].fullVolume;
 
     // --- use table integration if area v. depth table exists
-    if ( i >= 0 )
-        return table_getArea(&Curve[i], d*UCF(LENGTH)) / UCF(VOLUME);
+    if ( i >= 0 )                                                              //(5.1.015)
+        return storage_getTblVolume(&Storage[k].vTbl, d*UCF(LENGTH)) /         //(5.1.015)
+               UCF(VOLUME);                                                    //(5.1.015)
 
     // --- otherwise use functional area v. depth relation
     else
@@ -846,6 +1141,8 @@ double storage_getVolume(int j, double d)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 double storage_getSurfArea(int j, double d)
 //
 //  Input:   j = node index
@@ -857,8 +1154,8 @@ double storage_getSurfArea(int j, double d)
     double area;
     int k = Node[j].subIndex;
     int i = Storage[k].aCurve;
-    if ( i >= 0 )
-        area = table_lookupEx(&Curve[i], d*UCF(LENGTH));
+    if ( i >= 0 )                                                              //(5.1.015)
+        area = storage_getTblArea(&Storage[k].vTbl, d*UCF(LENGTH));            //(5.1.015)
     else
     {
         if ( Storage[k].aCoeff <= 0.0 ) area = Storage[k].aConst;
@@ -9,6 +9,7 @@
 //            08/05/15  (Build 5.1.010)
 //            08/01/16  (Build 5.1.011)
 //            05/10/18  (Build 5.1.013)
+//            10/17/26  (Build 5.1.015)
 //
 //   Author:  L. Rossman (EPA)
 //            M. Tryby (EPA)
@@ -54,6 +55,16 @@
 //   - Adjustment patterns added to TSubcatch structure.
 //   - Members impervRunoff and pervRunoff added to TSubcatchStats structure.
 //   - Member cdCurve (weir coeff. curve) added to TWeir structure.
+//
+//   Build 5.1.015:
+//   - Inverse geometry tables added to cross section object.
+//   - Adaptive geometry tables added to transects and custom shapes.
+//   - Link-node incidence graph added.
+//   - Binary output storage format of a result variable added.
+//   - Volume v. depth table added to storage unit object.
+//   - Orifice and weir opening geometry at the current setting added to the
+//     TOrifice and TWeir structures.
+//
 //-----------------------------------------------------------------------------
 
 #include "mathexpr.h"
@@ -531,6 +542,21 @@ typedef struct
    double*    wRouted;            // pollutant load routed (mass)
 }  TOutfall;
 
+//-----------------------------------
+// STORAGE UNIT VOLUME v. DEPTH TABLE
+//-----------------------------------
+//  Entries lie at the points of a tabular area curve or at equally spaced
+//  depths up to full depth for a functional one. Volumes are integrated
+//  exactly from the area relation between entries.
+#define  N_STORAGE_TBL  51        // size of functional area curve tables
+typedef struct
+{
+   int         nItems;            // number of table entries
+   double*     depth;             // depth (user units)
+   double*     area;              // surface area (user units)
+   double*     volume;            // volume below depth (user units)
+}  TStorageTbl;
+
 //--------------------
 // STORAGE UNIT OBJECT
 //--------------------
@@ -542,6 +568,7 @@ typedef struct
    double      aExpon;            // exponent of area v. height curve
    int         aCurve;            // index of tabulated area v. height curve
    TExfil*     exfil;             // ptr. to exfiltration object
+   TStorageTbl vTbl;              // volume v. depth table                     //(5.1.015)
    //-----------------------------
    double      hrt;               // hydraulic residence time (sec)
    double      evapLoss;          // evaporation loss (ft3) 
@@ -562,6 +589,19 @@ typedef struct
    int         flowCurve;         // index of inflow v. diverted flow curve
 }  TDivider;
 
+//-------------------------------------
+// CROSS SECTION INVERSE GEOMETRY TABLE
+//-------------------------------------
+#define  N_XSECT_TBL  51          // size of inverse geometry tables
+typedef struct
+{
+   double        u[N_XSECT_TBL];  // normalized independent variable
+   double        v[N_XSECT_TBL];  // normalized dependent variable
+   double        d[N_XSECT_TBL];  // interpolating slope dv/du at each entry
+   double        xMax;            // scale of independent variable
+   double        p0;              // power law exponent of first interval
+}  TXsectTbl;
+
 //-----------------------------
 // CROSS SECTION DATA STRUCTURE
 //-----------------------------
@@ -583,8 +623,32 @@ typedef struct
    double        aBot;            // area of bottom section
    double        sBot;            // slope of bottom section
    double        rBot;            // radius of bottom section
+
+   TXsectTbl*    aOfS;            // area v. section factor table         //(5.1.015)
+   TXsectTbl*    yCrit;           // critical depth v. flow table         //(5.1.015)
 }  TXsect;
 
+//----------------------------------------
+// IRREGULAR/CUSTOM SHAPE GEOMETRY TABLES
+//----------------------------------------
+//  Entries lie at non-uniform normalized depths that include every break
+//  in the shape's width profile, with extra entries added where linear
+//  interpolation is not accurate enough. Buckets of equal depth and equal
+//  area index the entries for direct access.
+typedef struct
+{
+    int          nItems;                    // number of table entries
+    int          nBuckets;                  // number of index buckets
+    double*      y;                         // depth / full depth
+    double*      area;                      // area / full area
+    double*      hrad;                      // hyd. radius / full hyd. radius
+    double*      width;                     // top width / max. width
+    int*         yIndex;                    // first entry in each depth bucket
+    int*         aIndex;                    // first entry in each area bucket
+    double       aScale;                    // max. width * full depth / full area
+    double       wMin;                      // min. top width / max. width
+}   TGeomTbl;
+
 //--------------------------------------
 // CROSS SECTION TRANSECT DATA STRUCTURE
 //--------------------------------------
@@ -606,6 +670,7 @@ typedef struct
     double       hradTbl[N_TRANSECT_TBL];   // table of hyd. radius v. depth
     double       widthTbl[N_TRANSECT_TBL];  // table of top width v. depth
     int          nTbl;                      // size of geometry tables
+    TGeomTbl     geom;                      // adaptive geometry tables    //(5.1.015)
 }   TTransect;
 
 //-------------------------------------
@@ -624,6 +689,7 @@ typedef struct
     double       areaTbl[N_SHAPE_TBL];      // table of area v. depth
     double       hradTbl[N_SHAPE_TBL];      // table of hyd. radius v. depth
     double       widthTbl[N_SHAPE_TBL];     // table of top width v. depth
+    TGeomTbl     geom;                      // adaptive geometry tables    //(5.1.015)
 }   TShape;
 
 //------------
@@ -727,6 +793,7 @@ typedef struct
    double        cWeir;           // coeff. for weir flow (cfs)
    double        length;          // equivalent length (ft)
    double        surfArea;        // equivalent surface area (ft2)
+   double        aOpen;           // area of opening at current setting (ft2)  //(5.1.015)
 }  TOrifice;
 
 //------------
@@ -747,6 +814,8 @@ typedef struct
    double        length;          // equivalent length (ft)
    double        slope;           // slope for Vnotch & Trapezoidal weirs
    double        surfArea;        // equivalent surface area (ft2)
+   double        aOffset;         // area below crest raised by setting (ft2)  //(5.1.015)
+   double        wOffset;         // width at crest raised by setting (ft)     //(5.1.015)
 }  TWeir;
 
 //---------------------
@@ -833,6 +902,15 @@ typedef struct
    int           linesPerPage;    // number of lines printed per page
 }  TRptFlags;
 
+//---------------------------------------
+// BINARY OUTPUT STORAGE OF A RESULT TYPE                                      //(5.1.015)
+//---------------------------------------
+typedef struct
+{
+   char          format;          // FLOAT, HALF or INT16 storage
+   double        scale;           // result value of one INT16 storage unit
+}  TOutStorage;
+
 //-------------------------------
 // CUMULATIVE RUNOFF TOTALS
 //-------------------------------
@@ -1054,6 +1132,18 @@ typedef struct
    double        value;           // value of node or link statistic
 }  TMaxStats; 
 
+//-------------------------------------
+// LINK-NODE INCIDENCE GRAPH (5.1.015)
+//-------------------------------------
+//  The links incident on node i are links[k] for start[i] <= k < start[i+1].
+typedef struct
+{
+   int           nNodes;          // number of nodes
+   int           nLinks;          // number of entries in links
+   int*          start;           // start of each node's entries in links
+   int*          links;           // indexes of links incident on each node
+}  TGraph;
+
 //------------------
 // REPORT FIELD INFO
 //------------------
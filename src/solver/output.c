@@ -8,6 +8,7 @@
 //             08/05/15  (Build 5.1.010)
 //             05/10/18  (Build 5.1.013)
 //             03/01/20  (Build 5.1.014)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //
 //   Binary output file access functions.
@@ -28,6 +29,16 @@
 //   Build 5.1.014:
 //   - Incorrect loop limit fixed in function output_saveAvgResults.
 //
+//   Build 5.1.015:
+//   - Binary output file positions use 8-byte offsets so results can extend
+//     past 2 GB; only the positions of the file's sections saved in its
+//     closing records are limited to 4-byte integers.
+//   - Results for a block of objects over all reporting periods can be read in
+//     large blocks of periods for writing the report's time series tables.
+//   - Chosen result variables can be saved as half-precision reals or as
+//     scaled 16-bit integers (set with the QUANTIZE report option); their
+//     storage formats and scales are saved in the file's header.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -41,6 +52,27 @@
 #define INT4  int
 #define REAL4 float
 #define REAL8 double
+#define INT2  short                                                            //(5.1.015)
+
+// Definition of 8-byte file offset type for large file support               //(5.1.015)
+#ifdef _WIN32
+  #define F_OFF __int64
+#else
+  #define F_OFF off_t
+#endif
+#ifdef _MSC_VER
+  #define FSEEK64 _fseeki64
+  #define FTELL64 _ftelli64
+#else
+  #define FSEEK64 fseeko
+  #define FTELL64 ftello
+#endif
+
+// Bytes of results read from the binary file at a time when reporting         //(5.1.015)
+#define READ_BLOCK_SIZE 4194304
+
+// Bytes of results held in memory while transposing them to object order      //(5.1.015)
+#define TRANSPOSE_BLOCK_SIZE 67108864
 
 enum InputDataType {INPUT_TYPE_CODE, INPUT_AREA, INPUT_INVERT, INPUT_MAX_DEPTH,
                     INPUT_OFFSET, INPUT_LENGTH};
@@ -50,13 +82,20 @@ typedef struct                                                                 /
     REAL4* xAvg;                                                               //
 }   TAvgResults;                                                               //
 
+typedef struct                                                                 //(5.1.015)
+{
+    INT4*  format;             // storage format of each result variable
+    REAL4* scale;              // scale of each INT16 result variable
+    INT4   bytes;              // bytes of results saved per object
+}   TResultLayout;
+
 //-----------------------------------------------------------------------------
 //  Shared variables    
 //-----------------------------------------------------------------------------
-static INT4      IDStartPos;           // starting file position of ID names
-static INT4      InputStartPos;        // starting file position of input data
-static INT4      OutputStartPos;       // starting file position of output data
-static INT4      BytesPerPeriod;       // bytes saved per simulation time period
+static F_OFF     IDStartPos;           // starting file position of ID names  //(5.1.015)
+static F_OFF     InputStartPos;        // starting file position of input data//(5.1.015)
+static F_OFF     OutputStartPos;       // starting file position of output    //(5.1.015)
+static F_OFF     BytesPerPeriod;       // bytes saved per time period          //(5.1.015)
 static INT4      NumSubcatchVars;      // number of subcatchment output variables
 static INT4      NumNodeVars;          // number of node output variables
 static INT4      NumLinkVars;          // number of link output variables
@@ -66,6 +105,16 @@ static INT4      NumLinks;             // number of links reported on
 static INT4      NumPolluts;           // number of pollutants reported on
 static REAL4     SysResults[MAX_SYS_RESULTS];    // values of system output vars.
 
+static int           Quantized;     // TRUE if any results are quantized       //(5.1.015)
+static TResultLayout SubcatchLayout;// storage of subcatchment results         //(5.1.015)
+static TResultLayout NodeLayout;    // storage of node results                 //(5.1.015)
+static TResultLayout LinkLayout;    // storage of link results                 //(5.1.015)
+static char*         PackedResults; // an object's results as stored           //(5.1.015)
+static FILE*         TransFile;     // results of one object type in object    //(5.1.015)
+                                    // by object order
+static int           TransType;     // object type whose results are in it     //(5.1.015)
+static char          TransName[MAXFNAME+1]; // name of TransFile               //(5.1.015)
+
 static TAvgResults* AvgLinkResults;                                            //(5.1.013)
 static TAvgResults* AvgNodeResults;                                            //
 static int          Nsteps;                                                    //
@@ -92,6 +141,22 @@ static void output_closeAvgResults(void);                                      /
 static void output_initAvgResults(void);                                       //
 static void output_saveAvgResults(FILE* file);                                 //
 
+static int  output_openLayout(TResultLayout* layout, int nVars,                //(5.1.015)
+            TOutStorage* storage, int maxResults);
+static void output_closeLayout(TResultLayout* layout);
+static void output_saveLayout(TResultLayout* layout, int nVars, FILE* file);
+static TResultLayout* output_getLayout(int objType);
+static void output_saveObjResults(TResultLayout* layout, int nVars, REAL4* x,
+            FILE* file);
+static void output_readObjResults(TResultLayout* layout, int nVars, REAL4* x,
+            FILE* file);
+static void output_unpackResults(TResultLayout* layout, int nVars, char* buf,
+            REAL4* x);
+static int  output_transposeResults(int objType);
+static void output_closeTransposed(void);
+static unsigned short output_floatToHalf(REAL4 x);
+static REAL4 output_halfToFloat(unsigned short h);
+
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -106,10 +171,14 @@ static void output_saveAvgResults(FILE* file);                                 /
 //  output_readSubcatchResults    (called by report_Subcatchments)
 //  output_readNodeResults        (called by report_Nodes)
 //  output_readLinkResults        (called by report_Links)
+//  output_getNumVars             (called by report_Results)                   //(5.1.015)
+//  output_readResultsBlock       (called by report_Results)                   //(5.1.015)
 
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int output_open()
 //
 //  Input:   none
@@ -151,20 +220,39 @@ int output_open()
     for (j=0; j<Nobjects[NODE]; j++) if (Node[j].rptFlag) NumNodes++;
     for (j=0; j<Nobjects[LINK]; j++) if (Link[j].rptFlag) NumLinks++;
 
-    BytesPerPeriod = sizeof(REAL8)
-        + NumSubcatch * NumSubcatchVars * sizeof(REAL4)
-        + NumNodes * NumNodeVars * sizeof(REAL4)
-        + NumLinks * NumLinkVars * sizeof(REAL4)
+    // --- find how each result variable is stored                             //(5.1.015)
+    Quantized = FALSE;                                                         //(5.1.015)
+    PackedResults = NULL;                                                      //(5.1.015)
+    if ( !output_openLayout(&SubcatchLayout, NumSubcatchVars,                  //(5.1.015)
+              SubcatchOutStorage, MAX_SUBCATCH_RESULTS) ||                     //(5.1.015)
+         !output_openLayout(&NodeLayout, NumNodeVars, NodeOutStorage,          //(5.1.015)
+              MAX_NODE_RESULTS) ||                                             //(5.1.015)
+         !output_openLayout(&LinkLayout, NumLinkVars, LinkOutStorage,          //(5.1.015)
+              MAX_LINK_RESULTS) )                                              //(5.1.015)
+    {                                                                          //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+        return ErrorCode;                                                      //(5.1.015)
+    }                                                                          //(5.1.015)
+
+    BytesPerPeriod = sizeof(REAL8)                                             //(5.1.015)
+        + (F_OFF)NumSubcatch * SubcatchLayout.bytes                            //(5.1.015)
+        + (F_OFF)NumNodes * NodeLayout.bytes                                   //(5.1.015)
+        + (F_OFF)NumLinks * LinkLayout.bytes                                   //(5.1.015)
         + MAX_SYS_RESULTS * sizeof(REAL4);
     Nperiods = 0;
 
     SubcatchResults = NULL;
     NodeResults = NULL;
     LinkResults = NULL;
+    TransFile = NULL;                                                          //(5.1.015)
+    TransType = -1;                                                            //(5.1.015)
     SubcatchResults = (REAL4 *) calloc(NumSubcatchVars, sizeof(REAL4));
     NodeResults = (REAL4 *) calloc(NumNodeVars, sizeof(REAL4));
     LinkResults = (REAL4 *) calloc(NumLinkVars, sizeof(REAL4));
-    if ( !SubcatchResults || !NodeResults || !LinkResults )
+    j = MAX(NumSubcatchVars, MAX(NumNodeVars, NumLinkVars));                   //(5.1.015)
+    PackedResults = (char *) calloc(j, sizeof(REAL4));                         //(5.1.015)
+    if ( !SubcatchResults || !NodeResults || !LinkResults ||
+         !PackedResults )                                                      //(5.1.015)
     {
         report_writeErrorMsg(ERR_MEMORY, "");
         return ErrorCode;
@@ -179,8 +267,8 @@ int output_open()
         return ErrorCode;                                                      //
     }                                                                          //
 
-    fseek(Fout.file, 0, SEEK_SET);
-    k = MAGICNUMBER;
+    FSEEK64(Fout.file, 0, SEEK_SET);                                           //(5.1.015)
+    k = Quantized ? QUANT_MAGICNUMBER : MAGICNUMBER;                           //(5.1.015)
     fwrite(&k, sizeof(INT4), 1, Fout.file);   // Magic number
     k = VERSION;
     fwrite(&k, sizeof(INT4), 1, Fout.file);   // Version number
@@ -196,7 +284,7 @@ int output_open()
     fwrite(&k, sizeof(INT4), 1, Fout.file);   // # pollutants
 
     // --- save ID names of subcatchments, nodes, links, & pollutants 
-    IDStartPos = ftell(Fout.file);
+    IDStartPos = FTELL64(Fout.file);                                           //(5.1.015)
     for (j=0; j<Nobjects[SUBCATCH]; j++)
     {
         if ( Subcatch[j].rptFlag ) output_saveID(Subcatch[j].ID, Fout.file);
@@ -218,7 +306,7 @@ int output_open()
         fwrite(&k, sizeof(INT4), 1, Fout.file);
     }
 
-    InputStartPos = ftell(Fout.file);
+    InputStartPos = FTELL64(Fout.file);                                        //(5.1.015)
 
     // --- save subcatchment area
     k = 1;
@@ -367,6 +455,15 @@ int output_open()
     fwrite(&k, sizeof(INT4), 1, Fout.file);
     for (k=0; k<MAX_SYS_RESULTS; k++) fwrite(&k, sizeof(INT4), 1, Fout.file);
 
+    // --- save storage format & scale of each result variable if              //(5.1.015)
+    //     any results are quantized
+    if ( Quantized )                                                           //(5.1.015)
+    {                                                                          //(5.1.015)
+        output_saveLayout(&SubcatchLayout, NumSubcatchVars, Fout.file);        //(5.1.015)
+        output_saveLayout(&NodeLayout, NumNodeVars, Fout.file);                //(5.1.015)
+        output_saveLayout(&LinkLayout, NumLinkVars, Fout.file);                //(5.1.015)
+    }                                                                          //(5.1.015)
+
     // --- save starting report date & report step
     //     (if reporting start date > simulation start date then
     //      make saved starting report date one reporting period
@@ -385,8 +482,8 @@ int output_open()
         report_writeErrorMsg(ERR_OUT_WRITE, "");
         return ErrorCode;
     }
-    OutputStartPos = ftell(Fout.file);
-    if ( Fout.mode == SCRATCH_FILE ) output_checkFileSize();
+    OutputStartPos = FTELL64(Fout.file);                                       //(5.1.015)
+    output_checkFileSize();                                                    //(5.1.015)
     return ErrorCode;
 }
 
@@ -396,20 +493,15 @@ void  output_checkFileSize()
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: checks if the size of the binary output file will be too big
-//           to access using an integer file pointer variable.
+//  Purpose: checks if the starting positions of the sections of the binary
+//           output file are too big to save as 4-byte integers.
+//
+//  Note: results are accessed using 8-byte file offsets so they can extend
+//        past 2 GB; only the section positions saved at the end of the file
+//        must fit in 4-byte integers.
 //
 {
-    if ( RptFlags.subcatchments != NONE ||
-         RptFlags.nodes != NONE ||
-         RptFlags.links != NONE )
-    {
-        if ( (double)OutputStartPos + (double)BytesPerPeriod * TotalDuration
-             / 1000.0 / (double)ReportStep >= (double)MAXFILESIZE )
-        {
-            report_writeErrorMsg(ERR_FILE_SIZE, "");
-        }
-    }
+    if ( OutputStartPos > MAXFILESIZE ) report_writeErrorMsg(ERR_FILE_SIZE, "");  //(5.1.015)
 }
 
 
@@ -503,6 +595,8 @@ void output_saveResults(double reportTime)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_end()
 //
 //  Input:   none
@@ -511,14 +605,17 @@ void output_end()
 //
 {
     INT4 k;
-    fwrite(&IDStartPos, sizeof(INT4), 1, Fout.file);
-    fwrite(&InputStartPos, sizeof(INT4), 1, Fout.file);
-    fwrite(&OutputStartPos, sizeof(INT4), 1, Fout.file);
+    k = (INT4)IDStartPos;                                                      //(5.1.015)
+    fwrite(&k, sizeof(INT4), 1, Fout.file);                                    //(5.1.015)
+    k = (INT4)InputStartPos;                                                   //(5.1.015)
+    fwrite(&k, sizeof(INT4), 1, Fout.file);                                    //(5.1.015)
+    k = (INT4)OutputStartPos;                                                  //(5.1.015)
+    fwrite(&k, sizeof(INT4), 1, Fout.file);                                    //(5.1.015)
     k = Nperiods;
     fwrite(&k, sizeof(INT4), 1, Fout.file);
     k = (INT4)error_getCode(ErrorCode);
     fwrite(&k, sizeof(INT4), 1, Fout.file);
-    k = MAGICNUMBER;
+    k = Quantized ? QUANT_MAGICNUMBER : MAGICNUMBER;                           //(5.1.015)
     if (fwrite(&k, sizeof(INT4), 1, Fout.file) < 1)
     {
         report_writeErrorMsg(ERR_OUT_WRITE, "");
@@ -527,6 +624,8 @@ void output_end()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_close()
 //
 //  Input:   none
@@ -537,7 +636,12 @@ void output_close()
     FREE(SubcatchResults);
     FREE(NodeResults);
     FREE(LinkResults);
+    FREE(PackedResults);                                                       //(5.1.015)
+    output_closeLayout(&SubcatchLayout);                                       //(5.1.015)
+    output_closeLayout(&NodeLayout);                                           //(5.1.015)
+    output_closeLayout(&LinkLayout);                                           //(5.1.015)
     output_closeAvgResults();                                                  //(5.1.013)
+    output_closeTransposed();                                                  //(5.1.015)
 }
 
 //=============================================================================
@@ -557,6 +661,8 @@ void output_saveID(char* id, FILE* file)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_saveSubcatchResults(double reportTime, FILE* file)
 //
 //  Input:   reportTime = elapsed simulation time (millisec)
@@ -586,7 +692,8 @@ void output_saveSubcatchResults(double reportTime, FILE* file)
         // --- retrieve interpolated results for reporting time & write to file
         subcatch_getResults(j, f, SubcatchResults);
         if ( Subcatch[j].rptFlag )
-            fwrite(SubcatchResults, sizeof(REAL4), NumSubcatchVars, file);
+            output_saveObjResults(&SubcatchLayout, NumSubcatchVars,            //(5.1.015)
+                                  SubcatchResults, file);                      //(5.1.015)
 
         // --- update system-wide results
         area = Subcatch[j].area * UCF(LANDAREA);
@@ -625,6 +732,7 @@ void output_saveSubcatchResults(double reportTime, FILE* file)
 //=============================================================================
 
 ////  This function was re-written for release 5.1.013.  ////                  //(5.1.013)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
 
 void output_saveNodeResults(double reportTime, FILE* file)
 //
@@ -646,7 +754,7 @@ void output_saveNodeResults(double reportTime, FILE* file)
         // --- retrieve interpolated results for reporting time & write to file
         node_getResults(j, f, NodeResults);
         if ( Node[j].rptFlag )
-            fwrite(NodeResults, sizeof(REAL4), NumNodeVars, file);
+            output_saveObjResults(&NodeLayout, NumNodeVars, NodeResults, file);//(5.1.015)
         stats_updateMaxNodeDepth(j, NodeResults[NODE_DEPTH]);
 
         // --- update system-wide storage volume 
@@ -656,6 +764,8 @@ void output_saveNodeResults(double reportTime, FILE* file)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_saveLinkResults(double reportTime, FILE* file)
 //
 //  Input:   reportTime = elapsed simulation time (millisec)
@@ -678,7 +788,7 @@ void output_saveLinkResults(double reportTime, FILE* file)
         if (Link[j].rptFlag)
         {
             link_getResults(j, f, LinkResults);
-            fwrite(LinkResults, sizeof(REAL4), NumLinkVars, file);
+            output_saveObjResults(&LinkLayout, NumLinkVars, LinkResults, file);//(5.1.015)
         }
 
         // --- update system-wide results
@@ -697,14 +807,16 @@ void output_readDateTime(int period, DateTime* days)
 //           from the binary output file.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    fseek(Fout.file, bytePos, SEEK_SET);
+    F_OFF bytePos = OutputStartPos + (period-1)*BytesPerPeriod;                //(5.1.015)
+    FSEEK64(Fout.file, bytePos, SEEK_SET);                                     //(5.1.015)
     *days = NO_DATE;
     fread(days, sizeof(REAL8), 1, Fout.file);
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_readSubcatchResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
@@ -714,14 +826,17 @@ void output_readSubcatchResults(int period, int index)
 //           period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    bytePos += sizeof(REAL8) + index*NumSubcatchVars*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(SubcatchResults, sizeof(REAL4), NumSubcatchVars, Fout.file);
+    F_OFF bytePos = OutputStartPos + (period-1)*BytesPerPeriod;                //(5.1.015)
+    bytePos += sizeof(REAL8) + (F_OFF)index*SubcatchLayout.bytes;              //(5.1.015)
+    FSEEK64(Fout.file, bytePos, SEEK_SET);                                     //(5.1.015)
+    output_readObjResults(&SubcatchLayout, NumSubcatchVars, SubcatchResults,   //(5.1.015)
+                          Fout.file);                                          //(5.1.015)
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_readNodeResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
@@ -730,15 +845,17 @@ void output_readNodeResults(int period, int index)
 //  Purpose: reads computed results for a node at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    bytePos += sizeof(REAL8) + NumSubcatch*NumSubcatchVars*sizeof(REAL4);
-    bytePos += index*NumNodeVars*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(NodeResults, sizeof(REAL4), NumNodeVars, Fout.file);
+    F_OFF bytePos = OutputStartPos + (period-1)*BytesPerPeriod;                //(5.1.015)
+    bytePos += sizeof(REAL8) + (F_OFF)NumSubcatch*SubcatchLayout.bytes;        //(5.1.015)
+    bytePos += (F_OFF)index*NodeLayout.bytes;                                  //(5.1.015)
+    FSEEK64(Fout.file, bytePos, SEEK_SET);                                     //(5.1.015)
+    output_readObjResults(&NodeLayout, NumNodeVars, NodeResults, Fout.file);   //(5.1.015)
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void output_readLinkResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
@@ -747,15 +864,247 @@ void output_readLinkResults(int period, int index)
 //  Purpose: reads computed results for a link at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    bytePos += sizeof(REAL8) + NumSubcatch*NumSubcatchVars*sizeof(REAL4);
-    bytePos += NumNodes*NumNodeVars*sizeof(REAL4);
-    bytePos += index*NumLinkVars*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(LinkResults, sizeof(REAL4), NumLinkVars, Fout.file);
+    F_OFF bytePos = OutputStartPos + (period-1)*BytesPerPeriod;                //(5.1.015)
+    bytePos += sizeof(REAL8) + (F_OFF)NumSubcatch*SubcatchLayout.bytes;        //(5.1.015)
+    bytePos += (F_OFF)NumNodes*NodeLayout.bytes;                               //(5.1.015)
+    bytePos += (F_OFF)index*LinkLayout.bytes;                                  //(5.1.015)
+    FSEEK64(Fout.file, bytePos, SEEK_SET);                                     //(5.1.015)
+    output_readObjResults(&LinkLayout, NumLinkVars, LinkResults, Fout.file);   //(5.1.015)
     fread(SysResults, sizeof(REAL4), MAX_SYS_RESULTS, Fout.file);
 }
 
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int output_getNumVars(int objType)
+//
+//  Input:   objType = type of object (SUBCATCH, NODE or LINK)
+//  Output:  returns number of results saved per object in each period
+//  Purpose: retrieves the number of output variables for a type of object.
+//
+{
+    switch ( objType )
+    {
+      case SUBCATCH: return NumSubcatchVars;
+      case NODE:     return NumNodeVars;
+      case LINK:     return NumLinkVars;
+      default:       return 0;
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int output_readResultsBlock(int objType, int index, int n, REAL4* x)
+//
+//  Input:   objType = type of object (SUBCATCH, NODE or LINK)
+//           index = position of first object among those reported on
+//           n = number of consecutive reported objects to read
+//  Output:  x = results for each object in each reporting period, stored
+//               object by object; returns 0 if successful, ERR_MEMORY if
+//               out of memory or ERR_OUT_READ if the results could not
+//               be read
+//  Purpose: reads the results of a block of objects for all reporting
+//           periods from the binary output file.
+//
+//  Note: results are saved period by period. When a block holds all of
+//        the objects reported on, the file is read in blocks of whole
+//        periods (or of just the block's objects when a period is large)
+//        and transposed to object by object order. Otherwise the results
+//        of all objects of the given type are first transposed in a single
+//        pass to a scratch file from which each block is read directly.
+//
+{
+    int    nVars = output_getNumVars(objType);
+    int    nObjects, period, nPeriods, blockSize, i, p;
+    TResultLayout* layout = output_getLayout(objType);
+    size_t objBytes = layout->bytes;
+    size_t readBytes;
+    F_OFF  objPos, readPos;
+    char*  buf;
+    char*  src;
+
+    // --- read a block of a larger set of objects from the transposed file
+    //     (transposing it only once, and reading the binary file directly
+    //     if that fails)
+    switch ( objType )
+    {
+      case SUBCATCH: nObjects = NumSubcatch; break;
+      case NODE:     nObjects = NumNodes;    break;
+      default:       nObjects = NumLinks;
+    }
+    if ( n < nObjects )
+    {
+        if ( TransType != objType ) output_transposeResults(objType);
+        if ( TransFile != NULL )
+        {
+            readBytes = (size_t)Nperiods * nVars * sizeof(REAL4);
+            FSEEK64(TransFile, (F_OFF)index * readBytes, SEEK_SET);
+            if ( fread(x, readBytes, n, TransFile) < (size_t)n )
+                return ERR_OUT_READ;
+            return 0;
+        }
+    }
+
+    // --- position of the block's first object within a period
+    objPos = sizeof(REAL8);
+    if ( objType != SUBCATCH )
+        objPos += (F_OFF)NumSubcatch * SubcatchLayout.bytes;
+    if ( objType == LINK )
+        objPos += (F_OFF)NumNodes * NodeLayout.bytes;
+    objPos += (F_OFF)index * objBytes;
+
+    // --- read whole periods when several fit in a block, otherwise
+    //     read just the block's objects from each period
+    blockSize = (int)(READ_BLOCK_SIZE / BytesPerPeriod);
+    if ( blockSize > Nperiods ) blockSize = Nperiods;
+    if ( blockSize > 1 )
+    {
+        readBytes = (size_t)BytesPerPeriod;
+        readPos = 0;
+    }
+    else
+    {
+        blockSize = 1;
+        readBytes = n * objBytes;
+        readPos = objPos;
+        objPos = 0;
+    }
+    buf = (char *) malloc(blockSize * readBytes);
+    if ( buf == NULL ) return ERR_MEMORY;
+
+    // --- read each block of periods & copy each object's results to x
+    for ( period = 1; period <= Nperiods; period += blockSize )
+    {
+        nPeriods = MIN(blockSize, Nperiods - period + 1);
+        FSEEK64(Fout.file, OutputStartPos + (period-1)*BytesPerPeriod +
+                readPos, SEEK_SET);
+        if ( fread(buf, readBytes, nPeriods, Fout.file) < (size_t)nPeriods )
+        {
+            free(buf);
+            return ERR_OUT_READ;
+        }
+        for ( p = 0; p < nPeriods; p++ )
+        {
+            src = buf + p*readBytes + objPos;
+            for ( i = 0; i < n; i++ )
+            {
+                output_unpackResults(layout, nVars, src + i*objBytes,
+                    x + ((size_t)i*Nperiods + period - 1 + p) * nVars);
+            }
+        }
+    }
+    free(buf);
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int output_transposeResults(int objType)
+//
+//  Input:   objType = type of object (SUBCATCH, NODE or LINK)
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: writes the results of all reported objects of a given type to
+//           a scratch file in object by object order.
+//
+//  Note: the binary output file is read once, one period at a time. The
+//        results of as many periods as fit in memory are transposed there
+//        and each object's part of them written to its place in the
+//        scratch file.
+//
+{
+    int    nVars = output_getNumVars(objType);
+    int    nObjects, period, nPeriods, blockSize, i, p;
+    TResultLayout* layout = output_getLayout(objType);
+    size_t objBytes = layout->bytes;
+    size_t rowBytes = nVars * sizeof(REAL4);
+    F_OFF  objPos;
+    char*  buf;
+    REAL4* x;
+    int    result = TRUE;
+
+    // --- position and number of the objects' results within a period
+    objPos = sizeof(REAL8);
+    nObjects = NumSubcatch;
+    if ( objType != SUBCATCH )
+    {
+        objPos += (F_OFF)NumSubcatch * SubcatchLayout.bytes;
+        nObjects = NumNodes;
+    }
+    if ( objType == LINK )
+    {
+        objPos += (F_OFF)NumNodes * NodeLayout.bytes;
+        nObjects = NumLinks;
+    }
+
+    // --- open a new scratch file
+    output_closeTransposed();
+    TransType = objType;
+    if ( getTempFileName(TransName) == NULL ) return FALSE;
+    TransFile = fopen(TransName, "w+b");
+    if ( TransFile == NULL ) return FALSE;
+
+    // --- allocate memory for one period's results as saved and for the
+    //     transposed results of a block of periods
+    blockSize = (int)(TRANSPOSE_BLOCK_SIZE / ((double)nObjects * rowBytes));
+    if ( blockSize < 1 ) blockSize = 1;
+    if ( blockSize > Nperiods ) blockSize = Nperiods;
+    buf = (char *) malloc(nObjects * objBytes);
+    x = (REAL4 *) malloc((size_t)blockSize * nObjects * rowBytes);
+
+    // --- transpose each block of periods and append each object's
+    //     results for them to its place in the scratch file
+    if ( buf == NULL || x == NULL ) result = FALSE;
+    for ( period = 1; result && period <= Nperiods; period += blockSize )
+    {
+        nPeriods = MIN(blockSize, Nperiods - period + 1);
+        for ( p = 0; p < nPeriods; p++ )
+        {
+            FSEEK64(Fout.file, OutputStartPos +
+                    (period-1+p)*BytesPerPeriod + objPos, SEEK_SET);
+            if ( fread(buf, objBytes, nObjects, Fout.file) < (size_t)nObjects )
+                result = FALSE;
+            for ( i = 0; i < nObjects; i++ )
+            {
+                output_unpackResults(layout, nVars, buf + i*objBytes,
+                    x + ((size_t)i*blockSize + p) * nVars);
+            }
+        }
+        for ( i = 0; result && i < nObjects; i++ )
+        {
+            FSEEK64(TransFile, ((F_OFF)i*Nperiods + period - 1) * rowBytes,
+                    SEEK_SET);
+            if ( fwrite(x + (size_t)i*blockSize*nVars, rowBytes, nPeriods,
+                        TransFile) < (size_t)nPeriods ) result = FALSE;
+        }
+    }
+    FREE(buf);
+    FREE(x);
+    if ( !result ) output_closeTransposed();
+    return result;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_closeTransposed()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: closes and deletes the scratch file of transposed results.
+//
+{
+    if ( TransFile == NULL ) return;
+    fclose(TransFile);
+    remove(TransName);
+    TransFile = NULL;
+}
+
 ////  The following functions were added for release 5.1.013.  ////            //(5.1.013)
 
 //=============================================================================
@@ -916,7 +1265,7 @@ void output_saveAvgResults(FILE* file)
         }
 
         // --- save average results to file
-        fwrite(NodeResults, sizeof(REAL4), NumNodeVars, file);
+        output_saveObjResults(&NodeLayout, NumNodeVars, NodeResults, file);    //(5.1.015)
     }
 
     // --- update each node's max depth and contribution to system storage
@@ -936,7 +1285,7 @@ void output_saveAvgResults(FILE* file)
         }
 
         // --- save average results to file
-        fwrite(LinkResults, sizeof(REAL4), NumLinkVars, file);
+        output_saveObjResults(&LinkLayout, NumLinkVars, LinkResults, file);    //(5.1.015)
     }
  
     // --- add each link's volume to total system storage
@@ -948,3 +1297,304 @@ void output_saveAvgResults(FILE* file)
     // --- re-initialize average results for all nodes and links
     output_initAvgResults();
 }
+
+//=============================================================================
+//  Functions for saving results with reduced precision.                       //(5.1.015)
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int output_openLayout(TResultLayout* layout, int nVars, TOutStorage* storage,
+                      int maxResults)
+//
+//  Input:   layout = storage of an object type's results
+//           nVars = number of result variables saved per object
+//           storage = storage format of each type of result variable
+//           maxResults = number of types of result variables (the last
+//                        type covers each pollutant)
+//  Output:  returns FALSE if memory could not be allocated
+//  Purpose: finds the storage format and scale of each result variable
+//           saved for a type of object.
+//
+{
+    int j, k;
+
+    layout->format = (INT4 *) calloc(nVars, sizeof(INT4));
+    layout->scale = (REAL4 *) calloc(nVars, sizeof(REAL4));
+    layout->bytes = 0;
+    if ( layout->format == NULL || layout->scale == NULL ) return FALSE;
+    for (j = 0; j < nVars; j++)
+    {
+        k = MIN(j, maxResults - 1);
+        layout->format[j] = storage[k].format;
+        layout->scale[j] = (REAL4)storage[k].scale;
+        if ( layout->format[j] == FLOAT_STORAGE )
+            layout->bytes += sizeof(REAL4);
+        else
+        {
+            layout->bytes += sizeof(INT2);
+            Quantized = TRUE;
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_closeLayout(TResultLayout* layout)
+//
+//  Input:   layout = storage of an object type's results
+//  Output:  none
+//  Purpose: frees memory used to describe how results are stored.
+//
+{
+    FREE(layout->format);
+    FREE(layout->scale);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_saveLayout(TResultLayout* layout, int nVars, FILE* file)
+//
+//  Input:   layout = storage of an object type's results
+//           nVars = number of result variables saved per object
+//           file = ptr. to binary output file
+//  Output:  none
+//  Purpose: writes the storage format & scale of each result variable to
+//           the binary output file.
+//
+{
+    int j;
+    for (j = 0; j < nVars; j++)
+    {
+        fwrite(&layout->format[j], sizeof(INT4), 1, file);
+        fwrite(&layout->scale[j], sizeof(REAL4), 1, file);
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+TResultLayout* output_getLayout(int objType)
+//
+//  Input:   objType = type of object (SUBCATCH, NODE or LINK)
+//  Output:  returns how the object type's results are stored
+//  Purpose: retrieves the storage of a type of object's results.
+//
+{
+    switch ( objType )
+    {
+      case SUBCATCH: return &SubcatchLayout;
+      case NODE:     return &NodeLayout;
+      default:       return &LinkLayout;
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_saveObjResults(TResultLayout* layout, int nVars, REAL4* x,
+                           FILE* file)
+//
+//  Input:   layout = storage of an object type's results
+//           nVars = number of result variables saved per object
+//           x = an object's results
+//           file = ptr. to binary output file
+//  Output:  none
+//  Purpose: writes an object's results to the binary output file in the
+//           storage format of each result variable.
+//
+{
+    int            j;
+    char*          buf = PackedResults;
+    unsigned short h;
+    double         v;
+    INT2           k;
+
+    if ( !Quantized )
+    {
+        fwrite(x, sizeof(REAL4), nVars, file);
+        return;
+    }
+    for (j = 0; j < nVars; j++)
+    {
+        switch ( layout->format[j] )
+        {
+          case HALF_STORAGE:
+            h = output_floatToHalf(x[j]);
+            memcpy(buf, &h, sizeof(INT2));
+            buf += sizeof(INT2);
+            break;
+
+          case INT16_STORAGE:
+            // --- round to nearest unit of scale, limiting to 16-bit range
+            v = floor(x[j] / layout->scale[j] + 0.5);
+            if ( v != v ) v = 0.0;
+            k = (INT2)MAX(-32767.0, MIN(32767.0, v));
+            memcpy(buf, &k, sizeof(INT2));
+            buf += sizeof(INT2);
+            break;
+
+          default:
+            memcpy(buf, &x[j], sizeof(REAL4));
+            buf += sizeof(REAL4);
+        }
+    }
+    fwrite(PackedResults, 1, layout->bytes, file);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_readObjResults(TResultLayout* layout, int nVars, REAL4* x,
+                           FILE* file)
+//
+//  Input:   layout = storage of an object type's results
+//           nVars = number of result variables saved per object
+//           file = ptr. to binary output file
+//  Output:  x = an object's results
+//  Purpose: reads an object's results from the current position of the
+//           binary output file.
+//
+{
+    if ( !Quantized )
+    {
+        fread(x, sizeof(REAL4), nVars, file);
+        return;
+    }
+    fread(PackedResults, 1, layout->bytes, file);
+    output_unpackResults(layout, nVars, PackedResults, x);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void output_unpackResults(TResultLayout* layout, int nVars, char* buf,
+                          REAL4* x)
+//
+//  Input:   layout = storage of an object type's results
+//           nVars = number of result variables saved per object
+//           buf = an object's results as stored in the binary output file
+//  Output:  x = an object's results
+//  Purpose: converts an object's stored results back to 4-byte reals.
+//
+{
+    int            j;
+    unsigned short h;
+    INT2           k;
+
+    if ( !Quantized )
+    {
+        memcpy(x, buf, nVars * sizeof(REAL4));
+        return;
+    }
+    for (j = 0; j < nVars; j++)
+    {
+        switch ( layout->format[j] )
+        {
+          case HALF_STORAGE:
+            memcpy(&h, buf, sizeof(INT2));
+            x[j] = output_halfToFloat(h);
+            buf += sizeof(INT2);
+            break;
+
+          case INT16_STORAGE:
+            memcpy(&k, buf, sizeof(INT2));
+            x[j] = (REAL4)(k * layout->scale[j]);
+            buf += sizeof(INT2);
+            break;
+
+          default:
+            memcpy(&x[j], buf, sizeof(REAL4));
+            buf += sizeof(REAL4);
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+unsigned short output_floatToHalf(REAL4 x)
+//
+//  Input:   x = a 4-byte real
+//  Output:  returns x as an IEEE 754 half-precision (2-byte) real
+//  Purpose: rounds a 4-byte real to the nearest half-precision value.
+//
+{
+    unsigned int f, sign, m, rem, half;
+    int          e, shift;
+    unsigned int h;
+
+    memcpy(&f, &x, sizeof(REAL4));
+    sign = (f >> 16) & 0x8000;
+    e = (int)((f >> 23) & 0xFF);
+    m = f & 0x7FFFFF;
+
+    // --- infinity & NaN keep their kind
+    if ( e == 0xFF ) return (unsigned short)(sign | 0x7C00 | (m ? 0x200 : 0));
+
+    // --- values too large for a half become infinite
+    e = e - 127 + 15;
+    if ( e >= 31 ) return (unsigned short)(sign | 0x7C00);
+
+    // --- values too small for a normal half become subnormal or zero
+    if ( e <= 0 )
+    {
+        if ( e < -10 ) return (unsigned short)sign;
+        m |= 0x800000;
+        shift = 14 - e;
+        h = m >> shift;
+        rem = m & ((1u << shift) - 1);
+        half = 1u << (shift - 1);
+    }
+
+    // --- otherwise keep the top 10 bits of the mantissa
+    else
+    {
+        h = ((unsigned int)e << 10) | (m >> 13);
+        rem = m & 0x1FFF;
+        half = 0x1000;
+    }
+
+    // --- round to nearest, ties to even (a carry correctly moves
+    //     into the exponent)
+    if ( rem > half || (rem == half && (h & 1)) ) h++;
+    return (unsigned short)(sign | h);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+REAL4 output_halfToFloat(unsigned short h)
+//
+//  Input:   h = an IEEE 754 half-precision (2-byte) real
+//  Output:  returns h as a 4-byte real
+//  Purpose: converts a half-precision real to a 4-byte real.
+//
+{
+    unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+    unsigned int e = (h >> 10) & 0x1F;
+    unsigned int m = h & 0x3FF;
+    unsigned int f;
+    REAL4        x;
+
+    if ( e == 0 )
+    {
+        x = (REAL4)ldexp((double)m, -24);
+        return sign ? -x : x;
+    }
+    if ( e == 31 ) f = sign | 0x7F800000 | (m << 13);
+    else           f = sign | ((e - 15 + 127) << 23) | (m << 13);
+    memcpy(&x, &f, sizeof(REAL4));
+    return x;
+}
@@ -11,6 +11,7 @@
 //             08/01/16  (Build 5.1.011)
 //             03/14/17  (Build 5.1.012)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Project management functions.
@@ -55,6 +56,18 @@
 //   - More robust parsing of MinSurfarea option provided.
 //   - Support added for new RuleStep analysis option.
 //
+//   Build 5.1.015:
+//   - Runoff and routing calendars are reset in project_init.
+//   - Cross section inverse geometry tables freed when project is closed.
+//   - GEOMETRY_TBL_SIZE option added and custom shape geometry tables freed.
+//   - Lists of links entering and leaving each node built at validation.
+//   - STATISTICS_STRIDE and STATISTICS_TOP_N options added.
+//   - LID_REPORT_FORMAT option added.
+//   - Binary output storage formats of result variables reset to FLOAT by
+//     default.
+//   - Storage unit volume tables freed when project is closed.
+//   - FORCE_MAIN_TABLE option added.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -238,6 +251,11 @@ void project_validate()
     for ( i=0; i<Nobjects[LINK]; i++) link_validate(i);
     for ( i=0; i<Nobjects[NODE]; i++) node_validate(i);
 
+    // --- list the links entering and leaving each node                     //(5.1.015)
+    if ( !toposort_createGraph(&InLinks, INLINK_GRAPH, NULL) ||                //(5.1.015)
+         !toposort_createGraph(&OutLinks, OUTLINK_GRAPH, NULL) )               //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+
     // --- adjust time steps if necessary
     if ( DryStep < WetStep )
     {
@@ -294,6 +312,8 @@ int  project_init(void)
 //
 {
     int j;
+    datetime_initCalendar(&RunoffCalendar);                                    //(5.1.015)
+    datetime_initCalendar(&RoutingCalendar);                                   //(5.1.015)
     climate_initState();
     lid_initState();
     for (j=0; j<Nobjects[TSERIES]; j++)  table_tseriesInit(&Tseries[j]);
@@ -579,6 +599,7 @@ int project_readOption(char* s1, char* s2)
       case IGNORE_ROUTING:
       case IGNORE_QUALITY:
       case IGNORE_RDII:
+      case FORCE_MAIN_TBL:                                                     //(5.1.015)
         m = findmatch(s2, NoYesWords);
         if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
         switch ( k )
@@ -592,6 +613,7 @@ int project_readOption(char* s1, char* s2)
           case IGNORE_ROUTING:    IgnoreRouting   = m;  break;
           case IGNORE_QUALITY:    IgnoreQuality   = m;  break;
           case IGNORE_RDII:       IgnoreRDII      = m;  break;
+          case FORCE_MAIN_TBL:    ForceMainTbl    = m;  break;                 //(5.1.015)
         }
         break;
 
@@ -662,6 +684,37 @@ int project_readOption(char* s1, char* s2)
         NumThreads = m;
         break;
 
+      // --- number of equally spaced entries that irregular & custom       //(5.1.015)
+      //     cross section geometry tables start from before refinement
+      case GEOM_TBL_SIZE:                                                      //(5.1.015)
+        m = atoi(s2);                                                          //(5.1.015)
+        if ( m < 11 || m > 1001 ) return error_setInpError(ERR_NUMBER, s2);    //(5.1.015)
+        GeomTblSize = m;                                                       //(5.1.015)
+        break;                                                                 //(5.1.015)
+
+      // --- number of routing steps between updates of duration and        //(5.1.015)
+      //     frequency statistics (peak values are updated every step)
+      case STATS_STRIDE:                                                       //(5.1.015)
+        m = atoi(s2);                                                          //(5.1.015)
+        if ( m < 1 ) return error_setInpError(ERR_NUMBER, s2);                 //(5.1.015)
+        StatsStride = m;                                                       //(5.1.015)
+        break;                                                                 //(5.1.015)
+
+      // --- number of elements listed in ranked summary tables             //(5.1.015)
+      //     (0 lists all elements in the order they were defined)
+      case STATS_TOP_N:                                                        //(5.1.015)
+        m = atoi(s2);                                                          //(5.1.015)
+        if ( m < 0 ) return error_setInpError(ERR_NUMBER, s2);                 //(5.1.015)
+        StatsTopN = m;                                                         //(5.1.015)
+        break;                                                                 //(5.1.015)
+
+      // --- format of detailed LID report files                               //(5.1.015)
+      case LID_RPT_FORMAT:                                                     //(5.1.015)
+        m = findmatch(s2, LidRptFormatWords);                                  //(5.1.015)
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);                //(5.1.015)
+        LidRptFormat = m;                                                      //(5.1.015)
+        break;                                                                 //(5.1.015)
+
       // --- safety factor applied to variable time step estimates under
       //     dynamic wave flow routing (value of 0 indicates that variable
       //     time step option not used)
@@ -819,6 +872,7 @@ void setDefaults()
    InertDamping    = SOME;             // Partial inertial damping
    NormalFlowLtd   = BOTH;             // Default normal flow limitation
    ForceMainEqn    = H_W;              // Hazen-Williams eqn. for force mains
+   ForceMainTbl    = FALSE;            // Exact D-W friction factors           //(5.1.015)
    LinkOffsets     = DEPTH_OFFSET;     // Use depth for link offsets
    LengtheningStep = 0;                // No lengthening of conduits
    CourantFactor   = 0.0;              // No variable time step
@@ -843,6 +897,10 @@ void setDefaults()
    SysFlowTol      = 0.05;             // System flow tolerance for steady state
    LatFlowTol      = 0.05;             // Lateral flow tolerance for steady state
    NumThreads      = 0;                // Number of parallel threads to use
+   GeomTblSize     = N_TRANSECT_TBL;   // Base size of xsect geometry tables   //(5.1.015)
+   StatsStride     = 1;                // Steps between duration stat updates  //(5.1.015)
+   StatsTopN       = 0;                // Elements listed in ranked tables     //(5.1.015)
+   LidRptFormat    = TEXT_LID_RPT;     // Format of LID report files           //(5.1.015)
    NumEvents       = 0;                // Number of detailed routing events
 
    // Deprecated options
@@ -871,6 +929,23 @@ void setDefaults()
    RptFlags.nodeStats     = FALSE;
    RptFlags.averages      = FALSE;
 
+   // Binary output storage of result variables                                //(5.1.015)
+   for (i = 0; i < MAX_SUBCATCH_RESULTS; i++)                                  //(5.1.015)
+   {                                                                           //(5.1.015)
+       SubcatchOutStorage[i].format = FLOAT_STORAGE;                           //(5.1.015)
+       SubcatchOutStorage[i].scale = 1.0;                                      //(5.1.015)
+   }                                                                           //(5.1.015)
+   for (i = 0; i < MAX_NODE_RESULTS; i++)                                      //(5.1.015)
+   {                                                                           //(5.1.015)
+       NodeOutStorage[i].format = FLOAT_STORAGE;                               //(5.1.015)
+       NodeOutStorage[i].scale = 1.0;                                          //(5.1.015)
+   }                                                                           //(5.1.015)
+   for (i = 0; i < MAX_LINK_RESULTS; i++)                                      //(5.1.015)
+   {                                                                           //(5.1.015)
+       LinkOutStorage[i].format = FLOAT_STORAGE;                               //(5.1.015)
+       LinkOutStorage[i].scale = 1.0;                                          //(5.1.015)
+   }                                                                           //(5.1.015)
+
    // Temperature data
    Temp.dataSource  = NO_TEMP;
    Temp.tSeries     = -1;
@@ -1195,7 +1270,7 @@ void deleteObjects()
     // --- free memory used for rainfall infiltration
     infil_delete();
 
-    // --- free memory used for storage exfiltration
+    // --- free memory used for storage exfiltration & volume tables
     if ( Node ) for (j = 0; j < Nnodes[STORAGE]; j++)
     {
         if ( Storage[j].exfil )
@@ -1204,6 +1279,9 @@ void deleteObjects()
             FREE(Storage[j].exfil->bankExfil);
             FREE(Storage[j].exfil);
         }
+        FREE(Storage[j].vTbl.depth);                                           //(5.1.015)
+        FREE(Storage[j].vTbl.area);                                            //(5.1.015)
+        FREE(Storage[j].vTbl.volume);                                          //(5.1.015)
     }
 
     // --- free memory used for outfall pollutants loads
@@ -1228,6 +1306,17 @@ void deleteObjects()
     // --- delete cross section transects
     transect_delete();
 
+    // --- delete custom cross section shape tables                          //(5.1.015)
+    if ( Shape ) for (j = 0; j < Nobjects[SHAPE]; j++)                         //(5.1.015)
+        shape_delete(&Shape[j]);                                               //(5.1.015)
+
+    // --- delete cross section inverse geometry tables                       //(5.1.015)
+    xsect_deleteTables();                                                      //(5.1.015)
+
+    // --- delete lists of links incident on each node                       //(5.1.015)
+    toposort_deleteGraph(&InLinks);                                            //(5.1.015)
+    toposort_deleteGraph(&OutLinks);                                           //(5.1.015)
+
     // --- delete control rules
     controls_delete();
 
@@ -7,6 +7,7 @@
 //             04/02/15   (Build 5.1.008)
 //             04/30/15   (Build 5.1.009)
 //             08/05/15   (Build 5.1.010)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Water quality routing functions.
@@ -22,6 +23,12 @@
 //   - Entire module re-written to be more compact and easier to follow.
 //   - Neglible depth limit replaced with a negligible volume limit.
 //
+//   Build 5.1.015:
+//   - Link mass flows gathered at each node in parallel by findNodeMassFlow()
+//     using the node's lists of incident links.
+//   - New link quality found in parallel now that mass balance totals are
+//     accumulated separately by each thread.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -45,6 +52,7 @@ static const double ZeroVolume = 0.0353147; // 1 liter in ft3
 //  Function declarations
 //-----------------------------------------------------------------------------
 static void  findLinkMassFlow(int i, double tStep);
+static void  findNodeMassFlow(int j);                                          //(5.1.015)
 static void  findNodeQual(int j);
 static void  findLinkQual(int i, double tStep);
 static void  findSFLinkQual(int i, double qSeep, double fEvap, double tStep);
@@ -104,7 +112,13 @@ void qualrout_execute(double tStep)
     double qIn, vAvg;
 
     // --- find mass flow each link contributes to its downstream node
+#pragma omp parallel num_threads(NumThreads)                                   //(5.1.015)
+{
+    #pragma omp for
     for ( i = 0; i < Nobjects[LINK]; i++ ) findLinkMassFlow(i, tStep);
+    #pragma omp for
+    for ( j = 0; j < Nobjects[NODE]; j++ ) findNodeMassFlow(j);               //(5.1.015)
+}
 
     // --- find new water quality concentration at each node  
     for (j = 0; j < Nobjects[NODE]; j++)
@@ -132,6 +146,8 @@ void qualrout_execute(double tStep)
     }
 
     // --- find new water quality in each link
+    //     (each thread adds its mass balance terms to totals of its own)      //(5.1.015)
+#pragma omp parallel for num_threads(NumThreads) schedule(static)              //(5.1.015)
     for ( i = 0; i < Nobjects[LINK]; i++ ) findLinkQual(i, tStep);
 }
 
@@ -176,37 +192,75 @@ void findLinkMassFlow(int i, double tStep)
 //           tStep = time step (sec)
 //  Output:  none
 //  Purpose: adds constituent mass flow out of link to the total
-//           accumulation at the link's downstream node.
+//           load transported by the link.
 //
-//  Note:    Node[].newQual[], the accumulator variable, already contains
-//           contributions from runoff and other external inflows from
-//           calculations made in routing_execute().
 {
-    int    j, p;
+    int    p;                                                                  //(5.1.015)
     double qLink, w;
 
     // --- find inflow to downstream node
-    qLink = Link[i].newFlow;
-
-    // --- identify index of downstream node
-    j = Link[i].node2;
-    if ( qLink < 0.0 ) j = Link[i].node1;
-    qLink = fabs(qLink);
+    qLink = fabs(Link[i].newFlow);                                             //(5.1.015)
 
     // --- examine each pollutant
     for (p = 0; p < Nobjects[POLLUT]; p++)
     {
-        // --- temporarily accumulate inflow load in Node[j].newQual
-        w = qLink * Link[i].oldQual[p];
-        Node[j].newQual[p] += w;
-
         // --- update total load transported by link
+        w = qLink * Link[i].oldQual[p];
         Link[i].totalLoad[p] += w * tStep;
     }
 }
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void findNodeMassFlow(int j)
+//
+//  Input:   j = node index
+//  Output:  none
+//  Purpose: adds the constituent mass flow out of each link that flows
+//           into a node to the total accumulation at the node.
+//
+//  Note:    Node[].newQual[], the accumulator variable, already contains
+//           contributions from runoff and other external inflows from
+//           calculations made in routing_execute(). A node's outlinks and
+//           inlinks are merged in order of link index so loads are summed
+//           in the same order for any number of threads.
+{
+    int    i, k1, k2, end1, end2, p;
+    double qLink;
+
+    k1 = OutLinks.start[j];
+    end1 = OutLinks.start[j+1];
+    k2 = InLinks.start[j];
+    end2 = InLinks.start[j+1];
+    while ( k1 < end1 || k2 < end2 )
+    {
+        // --- pick the next link attached to the node, skipping those
+        //     whose flow leaves the node
+        if ( k2 >= end2 ||
+             (k1 < end1 && OutLinks.links[k1] <= InLinks.links[k2]) )
+        {
+            i = OutLinks.links[k1++];
+            if ( Link[i].newFlow >= 0.0 ) continue;
+        }
+        else
+        {
+            i = InLinks.links[k2++];
+            if ( Link[i].newFlow < 0.0 ) continue;
+        }
+
+        // --- accumulate the link's inflow load in Node[j].newQual
+        qLink = fabs(Link[i].newFlow);
+        for (p = 0; p < Nobjects[POLLUT]; p++)
+        {
+            Node[j].newQual[p] += qLink * Link[i].oldQual[p];
+        }
+    }
+}
+
+//=============================================================================
+
 void findNodeQual(int j)
 //
 //  Input:   j = node index
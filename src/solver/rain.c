@@ -8,6 +8,7 @@
 //            08/22/16  (Build 5.1.011)
 //            05/10/18  (Build 5.1.013)
 //            03/01/20  (Build 5.1.014)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Places rainfall data from external files into a SWMM rainfall
@@ -52,11 +53,19 @@
 //
 //   Release 5.1.014:
 //   - Fixed indexing bug in rainFileConflict() function.
+//
+//   Release 5.1.015:
+//   - Rain gage data files are read concurrently in groups, each by a reader
+//     of its own, with their records and errors written in gage order.
+//   - Fields of data lines are read with rain_scanLine() in place of sscanf().
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>                                                             //(5.1.015)
+#include <limits.h>                                                            //(5.1.015)
+#include <stdarg.h>                                                            //(5.1.015)
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -67,24 +76,37 @@ enum RainFileFormat {UNKNOWN_FORMAT, NWS_TAPE, NWS_SPACE_DELIMITED,
                      AES_HLY, CMC_HLY, CMC_FIF, STD_SPACE_DELIMITED};
 enum ConditionCodes {NO_CONDITION, ACCUMULATED_PERIOD, DELETED_PERIOD,
                      MISSING_PERIOD};
+#define GAGES_PER_THREAD 4     // gage files read per thread in a group        //(5.1.015)
+#define RAIN_RECD_SIZE   (sizeof(DateTime) + sizeof(float))                    //(5.1.015)
 
 //-----------------------------------------------------------------------------
-//  Shared variables
+//  Data Structures                                                            //(5.1.015)
 //-----------------------------------------------------------------------------
-TRainStats RainStats;                  // see objects.h for definition
-int        Condition;                  // rainfall condition code
-int        TimeOffset;                 // time offset of rainfall reading (sec)
-int        DataOffset;                 // start of data on line of input
-int        ValueOffset;                // start of rain value on input line
-int        RainType;                   // rain measurement type code
-int        Interval;                   // rain measurement interval (sec)
-double     UnitsFactor;                // units conversion factor
-float      RainAccum;                  // rainfall depth accumulation
-char       *StationID;                 // station ID appearing in rain file
-DateTime   AccumStartDate;             // date when accumulation begins
-DateTime   PreviousDate;               // date of previous rainfall record
-int        GageIndex;                  // index of rain gage analyzed
-int        hasStationName;             // true if data contains station name
+//  State of the reader of one gage's rainfall data file. Gage files are read
+//  concurrently, so each gets a reader of its own and the records and any
+//  error it finds are held until the gage is added to the interface file.
+typedef struct                                                                 //(5.1.015)
+{
+    int        gage;                   // index of rain gage analyzed
+    TRainStats stats;                  // see objects.h for definition
+    int        condition;              // rainfall condition code
+    int        timeOffset;             // time offset of rainfall reading (sec)
+    int        dataOffset;             // start of data on line of input
+    int        valueOffset;            // start of rain value on input line
+    int        rainType;               // rain measurement type code
+    int        interval;               // rain measurement interval (sec)
+    double     unitsFactor;            // units conversion factor
+    float      rainAccum;              // rainfall depth accumulation
+    char*      stationID;              // station ID appearing in rain file
+    DateTime   accumStartDate;         // date when accumulation begins
+    DateTime   previousDate;           // date of previous rainfall record
+    int        hasStationName;         // true if data contains station name
+    char*      recds;                  // rainfall records for interface file
+    long       nRecds;                 // number of records saved
+    long       maxRecds;               // number of records allocated
+    int        errCode;                // error code found reading file
+    char*      errLine;                // line of data file in error
+}  TRainReader;                                                                //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -99,24 +121,28 @@ static void createRainFile(int count);
 static int  rainFileConflict(int i);
 static void initRainFile(void);
 static int  findGageInFile(int i, int kount);
-static int  addGageToRainFile(int i);
-static int  findFileFormat(FILE *f, int i, int *hdrLines);
-static int  findNWSOnlineFormat(FILE *f, char *line);
-static void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-            DateTime day2);
-static int  readNWSLine(char *line, int fileFormat, DateTime day1,
-            DateTime day2);
+static void readGageFile(TRainReader* r, int i);                               //(5.1.015)
+static int  addGageToRainFile(TRainReader* r);                                 //(5.1.015)
+static int  findFileFormat(TRainReader* r, FILE *f, int i, int *hdrLines);     //(5.1.015)
+static int  findNWSOnlineFormat(TRainReader* r, FILE *f, char *line);          //(5.1.015)
+static void readFile(TRainReader* r, FILE *f, int fileFormat, int hdrLines,    //(5.1.015)
+            DateTime day1, DateTime day2);                                     //(5.1.015)
+static int  readNWSLine(TRainReader* r, char *line, int fileFormat,            //(5.1.015)
+            DateTime day1, DateTime day2);                                     //(5.1.015)
 static int  readNwsOnlineValue(char* s, long* v, char* flag);
-static int  readCMCLine(char *line, int fileFormat, DateTime day1,
-            DateTime day2);
-static int  readStdLine(char *line, DateTime day1, DateTime day2);
-static void saveAccumRainfall(DateTime date1, int hour, int minute, long v);
-static void saveRainfall(DateTime date1, int hour, int minute, float x,
-            char isMissing);
-static void setCondition(char flag);
+static int  readCMCLine(TRainReader* r, char *line, int fileFormat,            //(5.1.015)
+            DateTime day1, DateTime day2);                                     //(5.1.015)
+static int  readStdLine(TRainReader* r, char *line, DateTime day1,             //(5.1.015)
+            DateTime day2);                                                    //(5.1.015)
+static void saveAccumRainfall(TRainReader* r, DateTime date1, int hour,        //(5.1.015)
+            int minute, long v);                                               //(5.1.015)
+static void saveRainfall(TRainReader* r, DateTime date1, int hour, int minute, //(5.1.015)
+            float x, char isMissing);                                          //(5.1.015)
+static void saveRecord(TRainReader* r, DateTime date, float x);                //(5.1.015)
+static void setCondition(TRainReader* r, char flag);                           //(5.1.015)
 static int  getNWSInterval(char *elemType);
-static int  parseStdLine(char *line, int *year, int *month, int *day,
-            int *hour, int *minute, float *value);
+static int  parseStdLine(TRainReader* r, char *line, int *year, int *month,    //(5.1.015)
+            int *day, int *hour, int *minute, float *value);                   //(5.1.015)
 
 //=============================================================================
 
@@ -204,6 +230,8 @@ void rain_close(void)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void createRainFile(int count)
 //
 //  Input:   count = number of files to include in rain interface file
@@ -211,19 +239,32 @@ void createRainFile(int count)
 //  Purpose: adds rain data from all rain gage files to the interface file.
 //
 {
-    int   i, k;
+    int   i, j, k, m, n;                                                       //(5.1.015)
     int   kount = count;               // number of gages in data file
     int   filePos1;                    // starting byte of gage's header data
     int   filePos2;                    // starting byte of gage's rain data
     int   filePos3;                    // starting byte of next gage's data
     int   interval;                    // recording interval (sec)
     int   dummy = -1;
+    int   groupSize;                   // # gage files read concurrently       //(5.1.015)
+    int*  gages;                       // indexes of gages using rain files    //(5.1.015)
+    TRainReader* readers;              // readers of a group of gage files     //(5.1.015)
     char  staID[MAXMSG+1];             // gage's ID name
     char  fileStamp[] = "SWMM5-RAIN";
 
     // --- make sure interface file is open and no error condition
     if ( ErrorCode || !Frain.file ) return;
 
+    // --- allocate a reader for each gage file in a group                     //(5.1.015)
+    groupSize = MIN(count, GAGES_PER_THREAD * MAX(NumThreads, 1));             //(5.1.015)
+    gages = (int *) calloc(count, sizeof(int));                                //(5.1.015)
+    readers = (TRainReader *) calloc(groupSize, sizeof(TRainReader));          //(5.1.015)
+    if ( gages == NULL || readers == NULL )                                    //(5.1.015)
+    {                                                                          //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+        count = 0;                                                             //(5.1.015)
+    }                                                                          //(5.1.015)
+
     // --- write file stamp & # gages to file
     fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frain.file);
     fwrite(&kount, sizeof(int), 1, Frain.file);
@@ -231,7 +272,7 @@ void createRainFile(int count)
 
     // --- write default fill-in header records to file for each gage
     //     (will be replaced later with actual records)
-    if ( count > 0 ) report_writeRainStats(-1, &RainStats);
+    if ( count > 0 ) report_writeRainStats(-1, &readers[0].stats);             //(5.1.015)
     for ( i = 0;  i < count; i++ )
     {
         fwrite(staID, sizeof(char), MAXMSG+1, Frain.file);
@@ -240,33 +281,56 @@ void createRainFile(int count)
     }
     filePos2 = ftell(Frain.file);
 
-    // --- loop through project's  rain gages,
-    //     looking for ones using rain files
-    for ( i = 0; i < Nobjects[GAGE]; i++ )
-    {
-        if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
-        if ( rainFileConflict(i) ) break;
-
-        // --- position rain file to where data for gage will begin
-        fseek(Frain.file, filePos2, SEEK_SET);
-
-        // --- add gage's data to rain file
-        if ( addGageToRainFile(i) )
-        {
-            // --- write header records for gage to beginning of rain file
-            filePos3 = ftell(Frain.file);
-            fseek(Frain.file, filePos1, SEEK_SET);
-            sstrncpy(staID, Gage[i].staID, MAXMSG);
-            interval = Interval;
-            fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
-            fwrite(&interval,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos2,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos3,  sizeof(int), 1, Frain.file);
-            filePos1 = ftell(Frain.file);
-            filePos2 = filePos3;
-            report_writeRainStats(i, &RainStats);
-        }
-    }
+    // --- list the project's rain gages that use rain files                   //(5.1.015)
+    n = 0;                                                                     //(5.1.015)
+    for ( i = 0; i < Nobjects[GAGE] && count > 0; i++ )                        //(5.1.015)
+    {                                                                          //(5.1.015)
+        if ( Gage[i].dataSource == RAIN_FILE ) gages[n++] = i;                 //(5.1.015)
+    }                                                                          //(5.1.015)
+
+    // --- process gages in groups, reading a group's data files               //(5.1.015)
+    //     concurrently and then adding them to the rain file in order         //(5.1.015)
+    for ( j = 0; j < n && !ErrorCode; j += groupSize )                         //(5.1.015)
+    {                                                                          //(5.1.015)
+        m = MIN(groupSize, n - j);                                             //(5.1.015)
+#pragma omp parallel for num_threads(NumThreads) schedule(dynamic)             //(5.1.015)
+        for ( k = 0; k < m; k++ ) readGageFile(&readers[k], gages[j+k]);       //(5.1.015)
+
+        for ( k = 0; k < m; k++ )                                              //(5.1.015)
+        {                                                                      //(5.1.015)
+            i = gages[j+k];                                                    //(5.1.015)
+            if ( ErrorCode || rainFileConflict(i) ) break;                     //(5.1.015)
+
+            // --- position rain file to where data for gage will begin
+            fseek(Frain.file, filePos2, SEEK_SET);
+
+            // --- add gage's data to rain file
+            if ( addGageToRainFile(&readers[k]) )                              //(5.1.015)
+            {
+                // --- write header records for gage to beginning of rain file
+                filePos3 = ftell(Frain.file);
+                fseek(Frain.file, filePos1, SEEK_SET);
+                sstrncpy(staID, Gage[i].staID, MAXMSG);
+                interval = readers[k].interval;                                //(5.1.015)
+                fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
+                fwrite(&interval,  sizeof(int), 1, Frain.file);
+                fwrite(&filePos2,  sizeof(int), 1, Frain.file);
+                fwrite(&filePos3,  sizeof(int), 1, Frain.file);
+                filePos1 = ftell(Frain.file);
+                filePos2 = filePos3;
+                report_writeRainStats(i, &readers[k].stats);                   //(5.1.015)
+            }
+        }                                                                      //(5.1.015)
+
+        // --- free the group's rainfall records                               //(5.1.015)
+        for ( k = 0; k < m; k++ )                                              //(5.1.015)
+        {                                                                      //(5.1.015)
+            free(readers[k].recds);                                            //(5.1.015)
+            free(readers[k].errLine);                                          //(5.1.015)
+        }                                                                      //(5.1.015)
+    }                                                                          //(5.1.015)
+    free(gages);                                                               //(5.1.015)
+    free(readers);                                                             //(5.1.015)
 
     // --- if there was an error condition, then delete newly created file
     if ( ErrorCode )
@@ -303,38 +367,67 @@ int rainFileConflict(int i)
 
 //=============================================================================
 
-int addGageToRainFile(int i)
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void readGageFile(TRainReader* r, int i)
 //
-//  Input:   i = rain gage index
-//  Output:  returns 1 if successful, 0 if not
-//  Purpose: adds a gage's rainfall record to rain interface file
+//  Input:   r = reader of the gage's rainfall data file
+//           i = rain gage index
+//  Output:  none
+//  Purpose: reads a gage's rainfall record into memory.
 //
+//  Note: gage files are read concurrently, so any error found is saved
+//        with the reader rather than reported here.
 {
     FILE* f;                           // pointer to rain file
     int   fileFormat;                  // file format code
     int   hdrLines;                    // number of header lines skipped
 
-    // --- let StationID point to NULL
-    StationID = NULL;
+    // --- start with an empty reader whose station ID points to NULL
+    memset(r, 0, sizeof(TRainReader));
+    r->gage = i;
+    r->stationID = NULL;
 
     // --- check that rain file exists
     if ( (f = fopen(Gage[i].fname, "rt")) == NULL )
-        report_writeErrorMsg(ERR_RAIN_FILE_DATA, Gage[i].fname);
+        r->errCode = ERR_RAIN_FILE_DATA;
     else
     {
-        fileFormat = findFileFormat(f, i, &hdrLines);
+        fileFormat = findFileFormat(r, f, i, &hdrLines);
         if ( fileFormat == UNKNOWN_FORMAT )
         {
-            report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, Gage[i].fname);
+            r->errCode = ERR_RAIN_FILE_FORMAT;
         }
         else
         {
-            GageIndex = i;
-            readFile(f, fileFormat, hdrLines, Gage[i].startFileDate,
+            readFile(r, f, fileFormat, hdrLines, Gage[i].startFileDate,
                      Gage[i].endFileDate);
         }
         fclose(f);
     }
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int addGageToRainFile(TRainReader* r)                                          //(5.1.015)
+//
+//  Input:   r = reader holding a gage's rainfall record                       //(5.1.015)
+//  Output:  returns 1 if successful, 0 if not
+//  Purpose: adds a gage's rainfall record to rain interface file
+//
+{
+    // --- report any error found reading the gage's data file                 //(5.1.015)
+    if ( r->errCode == ERR_MEMORY )                                            //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+    else if ( r->errCode )                                                     //(5.1.015)
+        report_writeErrorMsg(r->errCode, Gage[r->gage].fname);                 //(5.1.015)
+    if ( r->errLine ) report_writeLine(r->errLine);                            //(5.1.015)
+
+    // --- write the gage's records to the rain file                           //(5.1.015)
+    if ( r->nRecds > 0 )                                                       //(5.1.015)
+        fwrite(r->recds, RAIN_RECD_SIZE, r->nRecds, Frain.file);               //(5.1.015)
     if ( ErrorCode ) return 0;
     else
     return 1;
@@ -421,9 +514,12 @@ int findGageInFile(int i, int kount)
 
 //=============================================================================
 
-int findFileFormat(FILE *f, int i, int *hdrLines)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int findFileFormat(TRainReader* r, FILE *f, int i, int *hdrLines)              //(5.1.015)
 //
-//  Input:   f = ptr. to rain gage's rainfall data file
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           f = ptr. to rain gage's rainfall data file
 //           i = rain gage index
 //  Output:  hdrLines  = number of header lines found in data file;
 //           returns type of format used in a rainfall data file
@@ -446,9 +542,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
 
     // --- check first few lines for known formats
     fileFormat = UNKNOWN_FORMAT;
-    hasStationName = FALSE;
-    UnitsFactor = 1.0;
-    Interval = 0;
+    r->hasStationName = FALSE;                                                 //(5.1.015)
+    r->unitsFactor = 1.0;                                                      //(5.1.015)
+    r->interval = 0;                                                           //(5.1.015)
     *hdrLines = 0;
     for (lineCount = 1; lineCount <= maxCount; lineCount++)
     {
@@ -458,9 +554,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6ld %2d %4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);                            //(5.1.015)
+            r->timeOffset = r->interval;                                       //(5.1.015)
+            if ( r->interval > 0 )                                             //(5.1.015)
             {
                 fileFormat = NWS_SPACE_DELIMITED;
                 break;
@@ -471,12 +567,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d %4s %2s %4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);                            //(5.1.015)
+            r->timeOffset = r->interval;                                       //(5.1.015)
+            if ( r->interval > 0 )                                             //(5.1.015)
             {
                 fileFormat = NWS_SPACE_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;                                      //(5.1.015)
                 break;
             }
         }
@@ -485,9 +581,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6ld,%2d,%4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);                            //(5.1.015)
+            r->timeOffset = r->interval;                                       //(5.1.015)
+            if ( r->interval > 0 )                                             //(5.1.015)
             {
                 fileFormat = NWS_COMMA_DELIMITED;
                 break;
@@ -498,12 +594,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d,%4s,%2s,%4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);                            //(5.1.015)
+            r->timeOffset = r->interval;                                       //(5.1.015)
+            if ( r->interval > 0 )                                             //(5.1.015)
             {
                 fileFormat = NWS_COMMA_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;                                      //(5.1.015)
                 break;
             }
         }
@@ -512,9 +608,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%3s%6ld%2d%4s", recdType, &sn2, &div, elemType);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);                            //(5.1.015)
+            r->timeOffset = r->interval;                                       //(5.1.015)
+            if ( r->interval > 0 )                                             //(5.1.015)
             {
                 fileFormat = NWS_TAPE;
                 break;
@@ -525,7 +621,7 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%5s%6ld", coopID, &sn2);
         if ( n == 2 && strcmp(coopID, "COOP:") == 0 )
         {
-            fileFormat = findNWSOnlineFormat(f, line);
+            fileFormat = findNWSOnlineFormat(r, f, line);                      //(5.1.015)
             break;
         }
 
@@ -536,9 +632,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 123 && strlen(line) >= 185 )
             {
                 fileFormat = AES_HLY;
-                Interval = 3600;
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->interval = 3600;                                            //(5.1.015)
+                r->timeOffset = r->interval;                                   //(5.1.015)
+                r->unitsFactor = 1.0/MMperINCH;                                //(5.1.015)
                 break;
             }
         }
@@ -550,44 +646,47 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 159 && strlen(line) >= 691 )
             {
                 fileFormat = CMC_FIF;
-                Interval = 900;
+                r->interval = 900;                                             //(5.1.015)
             }
             else if ( elem == 123 && strlen(line) >= 186 )
             {
                 fileFormat = CMC_HLY;
-                Interval = 3600;
+                r->interval = 3600;                                            //(5.1.015)
             }
             if ( fileFormat == CMC_FIF || fileFormat == CMC_HLY )
             {
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->timeOffset = r->interval;                                   //(5.1.015)
+                r->unitsFactor = 1.0/MMperINCH;                                //(5.1.015)
                 break;
             }
         }
 
         // --- check for standard format
-        if ( parseStdLine(line, &year, &month, &day, &hour, &minute, &x) )
+        if ( parseStdLine(r, line, &year, &month, &day, &hour, &minute, &x) )  //(5.1.015)
         {
             fileFormat = STD_SPACE_DELIMITED;
-            RainType = Gage[i].rainType;
-            Interval = Gage[i].rainInterval;
-            if ( Gage[i].rainUnits == SI ) UnitsFactor = 1.0/MMperINCH;
-            TimeOffset = 0;
-            StationID = Gage[i].staID;
+            r->rainType = Gage[i].rainType;                                    //(5.1.015)
+            r->interval = Gage[i].rainInterval;                                //(5.1.015)
+            if ( Gage[i].rainUnits == SI ) r->unitsFactor = 1.0/MMperINCH;     //(5.1.015)
+            r->timeOffset = 0;                                                 //(5.1.015)
+            r->stationID = Gage[i].staID;                                      //(5.1.015)
             break;
         }
         (*hdrLines)++;
 
     }
-    if ( fileFormat != UNKNOWN_FORMAT ) Gage[i].rainInterval = Interval;
+    if ( fileFormat != UNKNOWN_FORMAT ) Gage[i].rainInterval = r->interval;    //(5.1.015)
     return fileFormat;
 }
 
 //=============================================================================
 
-int findNWSOnlineFormat(FILE *f, char *line)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int findNWSOnlineFormat(TRainReader* r, FILE *f, char *line)                   //(5.1.015)
 //
-//  Input:   f = pointer to rainfall data file
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           f = pointer to rainfall data file
 //           line = line read from rainfall data file
 //  Output:
 //  Purpose: determines the file format for an NWS Online Retrieval data file.
@@ -604,18 +703,18 @@ int findNWSOnlineFormat(FILE *f, char *line)
     // --- if 'HPCP' appears then file is for hourly data
     if ( (str = strstr(line, "HPCP")) != NULL )
     {
-        Interval = 3600;
-        TimeOffset = Interval;
-        ValueOffset = str - line;
+        r->interval = 3600;                                                    //(5.1.015)
+        r->timeOffset = r->interval;                                           //(5.1.015)
+        r->valueOffset = str - line;                                           //(5.1.015)
         fileFormat = NWS_ONLINE_60;
     }
 
     // --- if 'QPCP" appears then file is for 15 minute data
     else if ( (str = strstr(line, "QPCP")) != NULL )
     {
-        Interval = 900;
-        TimeOffset = Interval;
-        ValueOffset = str - line;
+        r->interval = 900;                                                     //(5.1.015)
+        r->timeOffset = r->interval;                                           //(5.1.015)
+        r->valueOffset = str - line;                                           //(5.1.015)
         fileFormat = NWS_ONLINE_15;
     }
     else return UNKNOWN_FORMAT;
@@ -634,7 +733,7 @@ int findNWSOnlineFormat(FILE *f, char *line)
 
         // --- use pointer arithmetic to convert pointer to character position
         n = str - line;
-        DataOffset = n - 11;
+        r->dataOffset = n - 11;                                                //(5.1.015)
         return fileFormat;
     }
     return UNKNOWN_FORMAT;
@@ -657,30 +756,33 @@ int getNWSInterval(char *elemType)
 
 //=============================================================================
 
-void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-              DateTime day2)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void readFile(TRainReader* r, FILE *f, int fileFormat, int hdrLines,           //(5.1.015)
+              DateTime day1, DateTime day2)                                    //(5.1.015)
 //
-//  Input:   f          = ptr. to gage's rainfall data file
+//  Input:   r          = reader of the data file                              //(5.1.015)
+//           f          = ptr. to gage's rainfall data file
 //           fileFormat = code of data file's format
 //           hdrLines   = number of header lines in data file
 //           day1       = starting day of record of interest
 //           day2       = ending day of record of interest
 //  Output:  none
-//  Purpose: reads rainfall records from gage's data file to interface file.
+//  Purpose: reads rainfall records from gage's data file into memory.         //(5.1.015)
 //
 {
     char line[MAXLINE];
     int  i, n;
 
     rewind(f);
-    RainStats.startDate  = NO_DATE;
-    RainStats.endDate    = NO_DATE;
-    RainStats.periodsRain = 0;
-    RainStats.periodsMissing = 0;
-    RainStats.periodsMalfunc = 0;
-    RainAccum = 0.0;
-    AccumStartDate = NO_DATE;
-    PreviousDate = NO_DATE;
+    r->stats.startDate  = NO_DATE;                                             //(5.1.015)
+    r->stats.endDate    = NO_DATE;                                             //(5.1.015)
+    r->stats.periodsRain = 0;                                                  //(5.1.015)
+    r->stats.periodsMissing = 0;                                               //(5.1.015)
+    r->stats.periodsMalfunc = 0;                                               //(5.1.015)
+    r->rainAccum = 0.0;                                                        //(5.1.015)
+    r->accumStartDate = NO_DATE;                                               //(5.1.015)
+    r->previousDate = NO_DATE;                                                 //(5.1.015)
 
     for (i = 1; i <= hdrLines; i++)
     {
@@ -691,7 +793,7 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
        switch (fileFormat)
        {
          case STD_SPACE_DELIMITED:
-          n = readStdLine(line, day1, day2);
+          n = readStdLine(r, line, day1, day2);                                //(5.1.015)
           break;
 
          case NWS_TAPE:
@@ -699,35 +801,39 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
          case NWS_COMMA_DELIMITED:
          case NWS_ONLINE_60:
          case NWS_ONLINE_15:
-           n = readNWSLine(line, fileFormat, day1, day2);
+           n = readNWSLine(r, line, fileFormat, day1, day2);                   //(5.1.015)
            break;
 
          case AES_HLY:
          case CMC_FIF:
          case CMC_HLY:
-           n = readCMCLine(line, fileFormat, day1, day2);
+           n = readCMCLine(r, line, fileFormat, day1, day2);                   //(5.1.015)
            break;
 
          default:
            n = -1;
            break;
        }
-       if ( n < 0 ) break;
+       if ( n < 0 || r->errCode ) break;                                       //(5.1.015)
     }
 }
 
 //=============================================================================
 
-int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int readNWSLine(TRainReader* r, char *line, int fileFormat, DateTime day1,     //(5.1.015)
+                DateTime day2)                                                 //(5.1.015)
 //
-//  Input:   line       = line of data from rainfall data file
+//  Input:   r          = reader of the data file                              //(5.1.015)
+//           line       = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1       = starting day of record of interest
 //           day2       = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
-//  Purpose: reads a line of data from a rainfall data file and writes its
-//           data to the rain interface file.
+//  Purpose: reads a line of data from a rainfall data file and saves its
+//           data for the rain interface file.                                 //(5.1.015)
 //
 {
     char     flag1, flag2, isMissing;
@@ -745,29 +851,34 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     {
       case NWS_TAPE:
         if ( lineLength <= 30 ) return 0;
-        if (sscanf(&line[17], "%4d%2d%4d%3d", &y, &m, &d, &n) < 4) return 0;
+        if ( rain_scanLine(&line[17], "%4d%2d%4d%3d", &y, &m, &d, &n) < 4 )    //(5.1.015)
+            return 0;                                                          //(5.1.015)
         k = 30;
         break;
 
       case NWS_SPACE_DELIMITED:
-        if ( hasStationName ) nameLength = 31;
+        if ( r->hasStationName ) nameLength = 31;                              //(5.1.015)
         if ( lineLength <= 28 + nameLength ) return 0;
         k = 18 + nameLength;
-        if (sscanf(&line[k], "%4d %2d %2d", &y, &m, &d) < 3) return 0;
+        if ( rain_scanLine(&line[k], "%4d %2d %2d", &y, &m, &d) < 3 )          //(5.1.015)
+            return 0;                                                          //(5.1.015)
         k = k + 10;
         break;
 
       case NWS_COMMA_DELIMITED:
         if ( lineLength <= 28 ) return 0;
-        if ( sscanf(&line[18], "%4d,%2d,%2d", &y, &m, &d) < 3 ) return 0;
+        if ( rain_scanLine(&line[18], "%4d,%2d,%2d", &y, &m, &d) < 3 )         //(5.1.015)
+            return 0;                                                          //(5.1.015)
         k = 28;
         break;
 
       case NWS_ONLINE_60:
       case NWS_ONLINE_15:
-        if ( lineLength <= DataOffset + 23 ) return 0;
-        if ( sscanf(&line[DataOffset], "%4d%2d%2d", &y, &m, &d) < 3 ) return 0;
-        k = DataOffset + 8;
+        if ( lineLength <= r->dataOffset + 23 ) return 0;                      //(5.1.015)
+        if ( rain_scanLine(&line[r->dataOffset], "%4d%2d%2d", &y, &m, &d)      //(5.1.015)
+             < 3 )                                                             //(5.1.015)
+            return 0;                                                          //(5.1.015)
+        k = r->dataOffset + 8;                                                 //(5.1.015)
         break;
 
       default: return 0;
@@ -789,27 +900,27 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         switch ( fileFormat )
         {
           case NWS_TAPE:
-            n = sscanf(&line[k], "%2d%2d%6ld%c%c",
+            n = rain_scanLine(&line[k], "%2d%2d%6ld%c%c",                      //(5.1.015)
                        &hour, &minute, &v, &flag1, &flag2);
             k += 12;
             break;
 
           case NWS_SPACE_DELIMITED:
-            n = sscanf(&line[k], " %2d%2d %6ld %c %c",
+            n = rain_scanLine(&line[k], " %2d%2d %6ld %c %c",                  //(5.1.015)
                        &hour, &minute, &v, &flag1, &flag2);
             k += 16;
             break;
 
           case NWS_COMMA_DELIMITED:
-            n = sscanf(&line[k], ",%2d%2d,%6ld,%c,%c",
+            n = rain_scanLine(&line[k], ",%2d%2d,%6ld,%c,%c",                  //(5.1.015)
                        &hour, &minute, &v, &flag1, &flag2);
             k += 16;
             break;
 
           case NWS_ONLINE_60:
           case NWS_ONLINE_15:
-              n = sscanf(&line[k], " %2d:%2d", &hour, &minute);
-              n += readNwsOnlineValue(&line[ValueOffset], &v, &flag1);
+              n = rain_scanLine(&line[k], " %2d:%2d", &hour, &minute);         //(5.1.015)
+              n += readNwsOnlineValue(&line[r->valueOffset], &v, &flag1);      //(5.1.015)
 
               // --- ending hour 0 is really hour 24 of previous day
               if ( hour == 0 )
@@ -829,9 +940,9 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
         // --- set special condition code & update daily & hourly counts
 
-        setCondition(flag1);
-        if ( Condition == DELETED_PERIOD ||
-             Condition == MISSING_PERIOD ||
+        setCondition(r, flag1);                                                //(5.1.015)
+        if ( r->condition == DELETED_PERIOD ||                                 //(5.1.015)
+             r->condition == MISSING_PERIOD ||                                 //(5.1.015)
              flag1 == 'M' ) isMissing = TRUE;
         else if ( v >= 9999 ) isMissing = TRUE;
         else isMissing = FALSE;
@@ -839,11 +950,11 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         // --- handle accumulation codes
         if ( flag1 == 'a' )
         {
-            AccumStartDate = date1 + datetime_encodeTime(hour, minute, 0);
+            r->accumStartDate = date1 + datetime_encodeTime(hour, minute, 0);  //(5.1.015)
         }
         else if ( flag1 == 'A' )
         {
-            saveAccumRainfall(date1, hour, minute, v);
+            saveAccumRainfall(r, date1, hour, minute, v);                      //(5.1.015)
         }
 
         // --- handle all other conditions
@@ -852,17 +963,19 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
             // --- convert rain measurement to inches & save it
             x = (float)v / 100.0f;
             if ( x > 0 || isMissing )
-                saveRainfall(date1, hour, minute, x, isMissing);
+                saveRainfall(r, date1, hour, minute, x, isMissing);            //(5.1.015)
         }
 
         // --- reset condition code if special condition period ended
-        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') Condition = 0;
+        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') r->condition = 0;   //(5.1.015)
     }
     return result;
 }
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int readNwsOnlineValue(char* s, long* v, char* flag)
 //
 //  Input:   s = portion of rainfall record in NWS online format
@@ -879,52 +992,58 @@ int readNwsOnlineValue(char* s, long* v, char* flag)
     // --- check for newer format of decimal inches
     if ( strchr(s, '.') )
     {
-        n = sscanf(s, "%f %c", &x, flag);
+        n = rain_scanLine(s, "%f %c", &x, flag);                               //(5.1.015)
 
         // --- convert to integer hundreths of an inch
         *v = (long)(100.0f * x + 0.5f);
     }
 
     // --- older format of hundreths of an inch
-    else n = sscanf(s, "%ld %c", v, flag);
+    else n = rain_scanLine(s, "%ld %c", v, flag);                              //(5.1.015)
     return n;
 }
 
 //=============================================================================
 
-void  setCondition(char flag)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void  setCondition(TRainReader* r, char flag)                                  //(5.1.015)
 {
     switch ( flag )
     {
       case 'a':
       case 'A':
-        Condition = ACCUMULATED_PERIOD;
+        r->condition = ACCUMULATED_PERIOD;                                     //(5.1.015)
         break;
       case '{':
       case '}':
-        Condition = DELETED_PERIOD;
+        r->condition = DELETED_PERIOD;                                         //(5.1.015)
         break;
       case '[':
       case ']':
-        Condition = MISSING_PERIOD;
+        r->condition = MISSING_PERIOD;                                         //(5.1.015)
         break;
       default:
-        Condition = NO_CONDITION;
+        r->condition = NO_CONDITION;                                           //(5.1.015)
     }
 }
 
 //=============================================================================
 
-int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int readCMCLine(TRainReader* r, char *line, int fileFormat, DateTime day1,     //(5.1.015)
+                DateTime day2)                                                 //(5.1.015)
 //
-//  Input:   line = line of data from rainfall data file
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           line = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from an AES or CMC rainfall data file and
-//           writes its data to the rain interface file.
+//           saves its data for the rain interface file.                       //(5.1.015)
 //
 {
     char     flag, isMissing;
@@ -936,7 +1055,8 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     // --- get year, month, day & element code from line
     if ( fileFormat == AES_HLY )
     {
-        if ( sscanf(line, "%7ld%3d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
+        if ( rain_scanLine(line, "%7ld%3d%2d%2d%3d", &sn, &y, &m, &d, &elem)   //(5.1.015)
+             < 5 )                                                             //(5.1.015)
             return 0;
         if ( y < 100 ) y = y + 2000;
         else           y = y + 1000;
@@ -944,7 +1064,8 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     }
     else
     {
-        if ( sscanf(line, "%7ld%4d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
+        if ( rain_scanLine(line, "%7ld%4d%2d%2d%3d", &sn, &y, &m, &d, &elem)   //(5.1.015)
+             < 5 )                                                             //(5.1.015)
             return 0;
         col = 18;
     }
@@ -966,7 +1087,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     if ( fileFormat == CMC_FIF ) jMax = 96;
     for (j=1; j<=jMax; j++)
     {
-        if ( sscanf(&line[col], "%6ld%c", &v, &flag) < 2 ) return 0;
+        if ( rain_scanLine(&line[col], "%6ld%c", &v, &flag) < 2 ) return 0;    //(5.1.015)
         col += 7;
         if ( v == -99999 ) isMissing = TRUE;
         else               isMissing = FALSE;
@@ -975,7 +1096,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         x = (float)( (double)v / 10.0 / MMperINCH);
         if ( x > 0 || isMissing)
         {
-            saveRainfall(date1, hour, minute, x, isMissing);
+            saveRainfall(r, date1, hour, minute, x, isMissing);                //(5.1.015)
         }
 
         // --- update hour & minute for next interval
@@ -995,15 +1116,18 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
 //=============================================================================
 
-int readStdLine(char *line, DateTime day1, DateTime day2)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int readStdLine(TRainReader* r, char *line, DateTime day1, DateTime day2)      //(5.1.015)
 //
-//  Input:   line = line of data from a standard rainfall data file
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           line = line of data from a standard rainfall data file
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from a standard rainfall data file and
-//           writes its data to the rain interface file.
+//           saves its data for the rain interface file.                       //(5.1.015)
 //
 {
     DateTime date1;
@@ -1012,7 +1136,8 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
     float    x;
 
     // --- parse data from input line
-    if (!parseStdLine(line, &year, &month, &day, &hour, &minute, &x)) return 0;
+    if (!parseStdLine(r, line, &year, &month, &day, &hour, &minute, &x))       //(5.1.015)
+        return 0;                                                              //(5.1.015)
 
     // --- see if date is within period of record requested
     date1 = datetime_encodeDate(year, month, day);
@@ -1021,42 +1146,47 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
 
     // --- see if record is out of sequence
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    if ( date2 <= PreviousDate )
+    if ( date2 <= r->previousDate )                                            //(5.1.015)
     {
-        report_writeErrorMsg(ERR_RAIN_FILE_SEQUENCE, Gage[GageIndex].fname);
-        report_writeLine(line);
+        // --- save error & offending line to report once reading ends         //(5.1.015)
+        r->errCode = ERR_RAIN_FILE_SEQUENCE;                                   //(5.1.015)
+        r->errLine = (char *) malloc(strlen(line) + 1);                        //(5.1.015)
+        if ( r->errLine ) strcpy(r->errLine, line);                            //(5.1.015)
         return -1;
     }
-    PreviousDate = date2;
+    r->previousDate = date2;                                                   //(5.1.015)
 
-    switch (RainType)
+    switch (r->rainType)                                                       //(5.1.015)
     {
       case RAINFALL_INTENSITY:
-        x = x * Interval / 3600.0f;
+        x = x * r->interval / 3600.0f;                                         //(5.1.015)
         break;
 
       case CUMULATIVE_RAINFALL:
-        if ( x >= RainAccum )
+        if ( x >= r->rainAccum )                                               //(5.1.015)
         {
-            x = x - RainAccum;
-            RainAccum += x;
+            x = x - r->rainAccum;                                              //(5.1.015)
+            r->rainAccum += x;                                                 //(5.1.015)
         }
-        else RainAccum = x;
+        else r->rainAccum = x;                                                 //(5.1.015)
         break;
     }
-    x *= (float)UnitsFactor;
+    x *= (float)r->unitsFactor;                                                //(5.1.015)
 
-    // --- save rainfall to binary interface file
-    saveRainfall(date1, hour, minute, x, FALSE);
+    // --- save rainfall for binary interface file                             //(5.1.015)
+    saveRainfall(r, date1, hour, minute, x, FALSE);                            //(5.1.015)
     return 1;
 }
 
 //=============================================================================
 
-int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
-                 int *minute, float *value)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+int parseStdLine(TRainReader* r, char *line, int *year, int *month, int *day,  //(5.1.015)
+                 int *hour, int *minute, float *value)                         //(5.1.015)
 //
-//  Input:   line = line of data from a standard rainfall data file
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           line = line of data from a standard rainfall data file
 //  Output:  *year = year when rainfall occurs
 //           *month = month of year when rainfall occurs
 //           *day = day of month when rainfall occurs
@@ -1071,24 +1201,29 @@ int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
     int n;
     char token[MAXLINE];
 
-    n = sscanf(line, "%s %d %d %d %d %d %f", token, year, month, day, hour, minute, value);
+    n = rain_scanLine(line, "%s %d %d %d %d %d %f", token, year, month, day,   //(5.1.015)
+                      hour, minute, value);                                    //(5.1.015)
     if ( n < 7 ) return 0;
-    if ( StationID != NULL && !strcomp(token, StationID) ) return 0;
+    if ( r->stationID != NULL && !strcomp(token, r->stationID) ) return 0;     //(5.1.015)
     return 1;
 }
 
 //=============================================================================
 
-void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void saveAccumRainfall(TRainReader* r, DateTime date1, int hour, int minute,   //(5.1.015)
+                       long v)                                                 //(5.1.015)
 //
-//  Input:   date1 = date of latest rainfall reading (in DateTime format)
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           date1 = date of latest rainfall reading (in DateTime format)
 //           hour = hour of day of latest rain reading
 //           minute = minute of hour of latest rain reading
 //           v = accumulated rainfall reading in hundreths of inches
 //  Output:  none
 //  Purpose: divides accumulated rainfall evenly into individual recording
-//           periods over the accumulation period and writes each period's
-//           rainfall to the binary rainfall file.
+//           periods over the accumulation period and saves each period's
+//           rainfall for the binary rainfall file.                            //(5.1.015)
 //
 {
     DateTime date2;
@@ -1096,75 +1231,247 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
     float    x;
 
     // --- return if accumulated start date is missing
-    if ( AccumStartDate == NO_DATE ) return;
+    if ( r->accumStartDate == NO_DATE ) return;                                //(5.1.015)
 
     // --- find number of recording intervals over accumulation period
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    n = (datetime_timeDiff(date2, AccumStartDate) / Interval) + 1;
+    n = (datetime_timeDiff(date2, r->accumStartDate) / r->interval) + 1;       //(5.1.015)
 
     // --- update count of rain or missing periods
     if ( v == 99999 )
     {
-        RainStats.periodsMissing += n;
+        r->stats.periodsMissing += n;                                          //(5.1.015)
         return;
     }
-    RainStats.periodsRain += n;
+    r->stats.periodsRain += n;                                                 //(5.1.015)
 
     // --- divide accumulated amount evenly into each period
     x = (float)v / (float)n / 100.0f;
 
-    // --- save this amount to file for each period
+    // --- save this amount for each period                                    //(5.1.015)
     if ( x > 0.0f )
     {
-        date2 = datetime_addSeconds(AccumStartDate, -TimeOffset);
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
+        date2 = datetime_addSeconds(r->accumStartDate, -r->timeOffset);        //(5.1.015)
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;       //(5.1.015)
         for (j = 0; j < n; j++)
         {
-            fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-            fwrite(&x, sizeof(float), 1, Frain.file);
-            date2 = datetime_addSeconds(date2, Interval);
-            RainStats.endDate = date2;
+            saveRecord(r, date2, x);                                           //(5.1.015)
+            date2 = datetime_addSeconds(date2, r->interval);                   //(5.1.015)
+            r->stats.endDate = date2;                                          //(5.1.015)
         }
     }
 
     // --- reset start of accumulation period
-    AccumStartDate = NO_DATE;
+    r->accumStartDate = NO_DATE;                                               //(5.1.015)
 }
 
 
 //=============================================================================
 
-void saveRainfall(DateTime date1, int hour, int minute, float x, char isMissing)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void saveRainfall(TRainReader* r, DateTime date1, int hour, int minute,        //(5.1.015)
+                  float x, char isMissing)                                     //(5.1.015)
 //
-//  Input:   date1 = date of rainfall reading (in DateTime format)
+//  Input:   r = reader of the data file                                       //(5.1.015)
+//           date1 = date of rainfall reading (in DateTime format)
 //           hour = hour of day of current rain reading
 //           minute = minute of hour of current rain reading
 //           x = rainfall reading in inches
 //           isMissing = TRUE if rainfall value is missing
 //  Output:  none
-//  Purpose: writes current rainfall reading from an external rainfall file
-//           to project's binary rainfall file.
+//  Purpose: saves current rainfall reading from an external rainfall file
+//           for project's binary rainfall file.                               //(5.1.015)
 //
 {
     DateTime date2;
     double   seconds;
 
-    if ( isMissing ) RainStats.periodsMissing++;
-    else             RainStats.periodsRain++;
+    if ( isMissing ) r->stats.periodsMissing++;                                //(5.1.015)
+    else             r->stats.periodsRain++;                                   //(5.1.015)
 
-    // --- if rainfall not missing then save it to rainfall interface file
+    // --- if rainfall not missing then save it for rainfall interface file    //(5.1.015)
     if ( !isMissing )
     {
-        seconds = 3600*hour + 60*minute - TimeOffset;
+        seconds = 3600*hour + 60*minute - r->timeOffset;                       //(5.1.015)
         date2 = datetime_addSeconds(date1, seconds);
 
-        // --- write date & value (in inches) to interface file
-        fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-        fwrite(&x, sizeof(float), 1, Frain.file);
+        // --- save date & value (in inches) for interface file                //(5.1.015)
+        saveRecord(r, date2, x);                                               //(5.1.015)
 
         // --- update actual start & end of record dates
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
-        RainStats.endDate = date2;
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;       //(5.1.015)
+        r->stats.endDate = date2;                                              //(5.1.015)
+    }
+}
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void saveRecord(TRainReader* r, DateTime date, float x)
+//
+//  Input:   r = reader of the data file
+//           date = start date of rainfall period
+//           x = rainfall depth (inches)
+//  Output:  none
+//  Purpose: adds a record in the rain interface file's layout to the
+//           records held for a gage.
+//
+{
+    char* recd;
+    long  maxRecds;
+
+    if ( r->errCode ) return;
+
+    // --- enlarge the record array when it is full
+    if ( r->nRecds == r->maxRecds )
+    {
+        maxRecds = MAX(2 * r->maxRecds, 1024);
+        recd = (char *) realloc(r->recds, maxRecds * RAIN_RECD_SIZE);
+        if ( recd == NULL )
+        {
+            r->errCode = ERR_MEMORY;
+            return;
+        }
+        r->recds = recd;
+        r->maxRecds = maxRecds;
+    }
+
+    // --- copy date & value without any padding between them
+    recd = r->recds + r->nRecds * RAIN_RECD_SIZE;
+    memcpy(recd, &date, sizeof(DateTime));
+    memcpy(recd + sizeof(DateTime), &x, sizeof(float));
+    r->nRecds++;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int rain_scanLine(char* s, const char* format, ...)
+//
+//  Input:   s = portion of a line from a rainfall data file
+//           format = sscanf style format of the fields to read
+//  Output:  returns number of fields read or -1 if s ends before the first
+//           field is read
+//  Purpose: reads fields from a line of rainfall data the way sscanf does.
+//
+//  Note: only %c, %s, %f, %d and %ld conversions (with optional widths)
+//        are supported. Unlike sscanf, s is not measured first, which
+//        matters when a long line is read one field at a time.
+{
+    va_list       ap;
+    const char*   f = format;
+    char*         p = s;
+    char*         end;
+    char*         t;
+    int           count = 0;
+    int           width, isLong, sign, digits;
+    long          v;
+    unsigned long u;
+    float         x;
+
+    va_start(ap, format);
+    while ( *f )
+    {
+        // --- white space in format matches any amount of white space
+        if ( isspace((unsigned char)*f) )
+        {
+            while ( isspace((unsigned char)*f) ) f++;
+            while ( isspace((unsigned char)*p) ) p++;
+            continue;
+        }
+
+        // --- any other character but '%' must appear in s
+        if ( *f != '%' )
+        {
+            if ( *p == '\0' ) break;
+            if ( *p != *f ) goto done;
+            p++;
+            f++;
+            continue;
+        }
+
+        // --- read conversion's width & size
+        f++;
+        width = 0;
+        while ( isdigit((unsigned char)*f) ) width = 10 * width + (*f++ - '0');
+        if ( width == 0 ) width = MAXLINE;
+        isLong = ( *f == 'l' );
+        if ( isLong ) f++;
+
+        // --- all conversions but %c skip leading white space
+        if ( *f != 'c' ) while ( isspace((unsigned char)*p) ) p++;
+        if ( *p == '\0' ) break;
+        switch ( *f )
+        {
+          case 'c':
+            *va_arg(ap, char*) = *p++;
+            break;
+
+          case 's':
+            t = va_arg(ap, char*);
+            while ( width > 0 && *p != '\0' && !isspace((unsigned char)*p) )
+            {
+                *t++ = *p++;
+                width--;
+            }
+            *t = '\0';
+            break;
+
+          case 'f':
+            x = strtof(p, &end);
+            if ( end == p ) goto done;
+            *va_arg(ap, float*) = x;
+
+            // --- like sscanf, consume an exponent that has no digits
+            for ( t = p; t < end && *t != 'e' && *t != 'E'; t++ );
+            if ( t == end && (*end == 'e' || *end == 'E') &&
+                 (isdigit((unsigned char)end[-1]) || end[-1] == '.') )
+            {
+                end++;
+                if ( *end == '-' || *end == '+' ) end++;
+            }
+            p = end;
+            break;
+
+          case 'd':
+            sign = 1;
+            if ( *p == '-' || *p == '+' )
+            {
+                if ( *p == '-' ) sign = -1;
+                p++;
+                width--;
+            }
+            u = 0;
+            for ( digits = 0; digits < width && isdigit((unsigned char)*p);
+                  digits++ )
+            {
+                if ( u <= (ULONG_MAX - 9) / 10 ) u = 10 * u + (*p - '0');
+                else u = ULONG_MAX;
+                p++;
+            }
+            if ( digits == 0 ) goto done;
+
+            // --- out of range values are clipped as strtol does
+            if ( sign > 0 ) v = (u > LONG_MAX) ? LONG_MAX : (long)u;
+            else            v = (u > LONG_MAX) ? LONG_MIN : -(long)u;
+            if ( isLong ) *va_arg(ap, long*) = v;
+            else          *va_arg(ap, int*) = (int)v;
+            break;
+
+          default: goto done;
+        }
+        f++;
+        count++;
     }
+
+    // --- s ended before the first field was read
+    if ( *f && count == 0 ) count = -1;
+
+done:
+    va_end(ap);
+    return count;
 }
+
 //=============================================================================
@@ -11,6 +11,7 @@
 //             03/14/17    (Build 5.1.012)
 //             05/10/18    (Build 5.1.013)
 //             03/01/20    (Build 5.1.014)
+//             10/17/26    (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //
 //   Report writing functions.
@@ -43,6 +44,16 @@
 //
 //   Build 5.1.014:
 //   - Fixed bug in confusing keywords with ID names in report_readOptions().
+//
+//   Build 5.1.015:
+//   - Time series tables of reported subcatchments, nodes and links are
+//     written from blocks of results read for many elements at once, with each
+//     period's date & time formatted only once.
+//   - Numbers in time series and summary tables are formatted with a fast
+//     fixed-point formatter that gives the same text as printf.
+//   - QUANTIZE option added to store chosen result variables in the binary
+//     output file as half-precision reals or scaled 16-bit integers.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -59,12 +70,15 @@
 "---------------------------------------------------"
 #define LINE_64 \
 "----------------------------------------------------------------"
+#define PERIOD_TEXT_SIZE   32         // chars. per formatted period date     //(5.1.015)
+#define RESULTS_BLOCK_SIZE 67108864   // max. bytes of results held in memory  //(5.1.015)
 
 
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
 static time_t SysTime;
+static char*  PeriodText;   // formatted date & time of each report period     //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  Imported variables
@@ -86,10 +100,17 @@ static void report_Nodes(void);
 static void report_NodeHeader(char *id);
 static void report_Links(void);
 static void report_LinkHeader(char *id);
+static int  report_openPeriodText(void);                                       //(5.1.015)
+static int  report_fixedToStr(char* s, double x, int width, int prec);         //(5.1.015)
+static int  report_formatValue(char* s, double x);                             //(5.1.015)
+static REAL4* report_allocResults(int objType, int nRpt, int* blockSize);     //(5.1.015)
+static int  report_readQuantize(char* tok[], int ntoks);                       //(5.1.015)
 
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int report_readOptions(char* tok[], int ntoks)
 //
 //  Input:   tok[] = array of string tokens
@@ -151,6 +172,9 @@ int report_readOptions(char* tok[], int ntoks)
         else               return error_setInpError(ERR_KEYWORD, tok[1]);      //
         return 0;                                                              //
 
+      case 9: // Quantize                                                      //(5.1.015)
+        return report_readQuantize(tok, ntoks);                                //(5.1.015)
+
       default: return error_setInpError(ERR_KEYWORD, tok[1]);
     }
     
@@ -184,6 +208,77 @@ int report_readOptions(char* tok[], int ntoks)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int report_readQuantize(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an error code
+//  Purpose: reads how a type of result variable is stored in the binary
+//           output file.
+//
+//  Format of input line is:
+//     QUANTIZE  SUBCATCH/NODE/LINK  variable/ALL  FLOAT/HALF/INT16  (scale)
+//  where scale is the result value (in user's units) of one unit of an
+//  INT16 integer.
+//
+{
+    int    i, n, format;
+    double scale = 1.0;
+    char** varWords;
+    TOutStorage* storage;
+
+    // --- get type of object whose results are stored
+    if ( ntoks < 4 ) return error_setInpError(ERR_ITEMS, "");
+    if ( match(tok[1], w_SUBCATCH) )
+    {
+        storage = SubcatchOutStorage;
+        varWords = SubcatchResultWords;
+        n = MAX_SUBCATCH_RESULTS;
+    }
+    else if ( match(tok[1], w_NODE) )
+    {
+        storage = NodeOutStorage;
+        varWords = NodeResultWords;
+        n = MAX_NODE_RESULTS;
+    }
+    else if ( match(tok[1], w_LINK) )
+    {
+        storage = LinkOutStorage;
+        varWords = LinkResultWords;
+        n = MAX_LINK_RESULTS;
+    }
+    else return error_setInpError(ERR_KEYWORD, tok[1]);
+
+    // --- get storage format and scale of INT16 storage
+    format = findmatch(tok[3], OutStorageWords);
+    if ( format < 0 ) return error_setInpError(ERR_KEYWORD, tok[3]);
+    if ( format == INT16_STORAGE )
+    {
+        if ( ntoks < 5 ) return error_setInpError(ERR_ITEMS, "");
+        if ( !getDouble(tok[4], &scale) || scale <= 0.0 )
+            return error_setInpError(ERR_NUMBER, tok[4]);
+    }
+
+    // --- assign storage to one or to all of the object's result variables
+    if ( strcomp(tok[2], w_ALL) ) i = 0;
+    else
+    {
+        i = findmatch(tok[2], varWords);
+        if ( i < 0 ) return error_setInpError(ERR_KEYWORD, tok[2]);
+        n = i + 1;
+    }
+    for ( ; i < n; i++ )
+    {
+        storage[i].format = (char)format;
+        storage[i].scale = scale;
+    }
+    return 0;
+}
+
+//=============================================================================
+
 void report_writeLine(char *line)
 //
 //  Input:   line = line of text
@@ -196,6 +291,124 @@ void report_writeLine(char *line)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int report_formatFixed(char* s, double x, int width, int prec)
+//
+//  Input:   x = number to format
+//           width = minimum field width
+//           prec = number of decimal places
+//  Output:  s = formatted number; returns number of characters in s
+//  Purpose: formats a number the same way as sprintf(s, "%*.*f", ...) but
+//           without the overhead of parsing a format string.
+//
+{
+    int n = report_fixedToStr(s, x, width, prec);
+    if ( n < 0 ) n = sprintf(s, "%*.*f", width, prec, x);
+    return n;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void report_writeFixed(char* prefix, double x, int width, int prec)
+//
+//  Input:   prefix = text written in front of the number
+//           x = number to format
+//           width = minimum field width
+//           prec = number of decimal places
+//  Output:  none
+//  Purpose: writes a number to the report file the same way as
+//           fprintf(Frpt.file, "%s%*.*f", prefix, ...).
+//
+{
+    char s[32];
+    fputs(prefix, Frpt.file);
+    if ( report_fixedToStr(s, x, width, prec) >= 0 ) fputs(s, Frpt.file);
+    else fprintf(Frpt.file, "%*.*f", width, prec, x);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int report_formatValue(char* s, double x)
+//
+//  Input:   x = a time series result
+//  Output:  s = formatted result; returns number of characters in s
+//  Purpose: formats a node or link result the same way as
+//           sprintf(s, " %9.3f", x).
+//
+{
+    s[0] = ' ';
+    return 1 + report_formatFixed(s + 1, x, 9, 3);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int report_fixedToStr(char* s, double x, int width, int prec)
+//
+//  Input:   x = number to format
+//           width = minimum field width (at most 30)
+//           prec = number of decimal places (0 to 9)
+//  Output:  s = formatted number; returns number of characters in s or
+//           -1 if x must be formatted with sprintf instead
+//  Purpose: converts a number to a fixed-point string using integer
+//           arithmetic.
+//
+//  Note: x is scaled by 10^prec and rounded to an integer. Cases where the
+//        scaled value is too large or lies too close to a rounding tie to
+//        decide the rounding exactly are left to sprintf, so the result is
+//        always identical to that of sprintf.
+//
+{
+    static const double pow10[] = {1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4,
+                                   1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9};
+    char          buf[24];
+    char*         p = buf + sizeof(buf);
+    double        y, f;
+    unsigned long n;
+    int           k, len, negative;
+
+    if ( prec < 0 || prec > 9 || width > 30 ) return -1;
+
+    // --- scale x & check that it can be rounded exactly
+    //     (x == 0.0 && 1.0/x < 0.0 identifies a negative zero)
+    negative = ( x < 0.0 || (x == 0.0 && 1.0/x < 0.0) );
+    y = fabs(x) * pow10[prec];
+    if ( !(y < 4.0e9) ) return -1;
+    f = floor(y);
+    if ( fabs(y - f - 0.5) < 1.0e-6 ) return -1;
+    n = (unsigned long)f;
+    if ( y - f > 0.5 ) n++;
+
+    // --- write digits from right to left
+    *--p = '\0';
+    for ( k = 0; k < prec; k++ )
+    {
+        *--p = (char)('0' + n % 10);
+        n /= 10;
+    }
+    if ( prec > 0 ) *--p = '.';
+    do
+    {
+        *--p = (char)('0' + n % 10);
+        n /= 10;
+    } while ( n > 0 );
+    if ( negative ) *--p = '-';
+
+    // --- pad with leading blanks to field width
+    len = (int)(buf + sizeof(buf) - 1 - p);
+    for ( k = 0; len + k < width; k++ ) s[k] = ' ';
+    memcpy(s + k, p, len + 1);
+    return len + k;
+}
+
+//=============================================================================
+
 void report_writeSysTime(void)
 //
 //  Input:   none
@@ -1080,19 +1293,84 @@ void report_writeReport()
 {
     if ( ErrorCode ) return;
     if ( Nperiods == 0 ) return;
+    if ( !report_openPeriodText() ) return;                                    //(5.1.015)
     if ( RptFlags.subcatchments != NONE
          && ( IgnoreRainfall == FALSE ||
               IgnoreSnowmelt == FALSE ||
               IgnoreGwater == FALSE)
        ) report_Subcatchments();
 
-    if ( IgnoreRouting == TRUE && IgnoreQuality == TRUE ) return;
-    if ( RptFlags.nodes != NONE ) report_Nodes();
-    if ( RptFlags.links != NONE ) report_Links();
+    if ( IgnoreRouting == FALSE || IgnoreQuality == FALSE )                    //(5.1.015)
+    {
+        if ( RptFlags.nodes != NONE ) report_Nodes();
+        if ( RptFlags.links != NONE ) report_Links();
+    }
+    FREE(PeriodText);                                                          //(5.1.015)
 }
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int report_openPeriodText()
+//
+//  Input:   none
+//  Output:  returns FALSE if out of memory
+//  Purpose: formats the date & time of each reporting period once for use
+//           in every element's time series table.
+//
+{
+    int      period;
+    DateTime days;
+    char     theDate[20];
+    char     theTime[20];
+
+    PeriodText = (char *) malloc((size_t)Nperiods * PERIOD_TEXT_SIZE);
+    if ( PeriodText == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+    for ( period = 1; period <= Nperiods; period++ )
+    {
+        output_readDateTime(period, &days);
+        datetime_dateToStr(days, theDate);
+        datetime_timeToStr(days, theTime);
+        sprintf(PeriodText + (size_t)(period-1)*PERIOD_TEXT_SIZE,
+                "\n  %11s %8s", theDate, theTime);
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+REAL4* report_allocResults(int objType, int nRpt, int* blockSize)
+//
+//  Input:   objType = type of object (SUBCATCH, NODE or LINK)
+//           nRpt = number of objects reported on
+//  Output:  blockSize = number of objects whose results are held at once;
+//           returns pointer to memory for the results (or NULL)
+//  Purpose: allocates memory to hold the results of a block of reported
+//           objects over all reporting periods.
+//
+{
+    int    nVars = output_getNumVars(objType);
+    double bytes = (double)Nperiods * nVars * sizeof(REAL4);
+    double n = RESULTS_BLOCK_SIZE / bytes;
+
+    if ( n > nRpt ) n = nRpt;
+    if ( n < 1.0 ) n = 1.0;
+    *blockSize = (int)n;
+    return (REAL4 *) malloc((size_t)(*blockSize) * Nperiods * nVars *
+                            sizeof(REAL4));
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void report_Subcatchments()
 //
 //  Input:   none
@@ -1100,11 +1378,11 @@ void report_Subcatchments()
 //  Purpose: writes results for selected subcatchments to report file.
 //
 {
-    int      j, p, k;
-    int      period;
-    DateTime days;
-    char     theDate[12];
-    char     theTime[9];
+    int      i, j, p, k, n;
+    int      period, nRpt, nVars, blockSize, len, errCode;
+    REAL4*   x;
+    REAL4*   r;
+    char*    row;
     int      hasSnowmelt = (Nobjects[SNOWMELT] > 0 && !IgnoreSnowmelt);
     int      hasGwater   = (Nobjects[AQUIFER] > 0  && !IgnoreGwater);
     int      hasQuality  = (Nobjects[POLLUT] > 0 && !IgnoreQuality);
@@ -1114,39 +1392,70 @@ void report_Subcatchments()
     WRITE("********************");
     WRITE("Subcatchment Results");
     WRITE("********************");
-    k = 0;
-    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+
+    // --- allocate memory for results of a block of subcatchments over
+    //     all periods and for a formatted row of results
+    nRpt = 0;
+    for (j = 0; j < Nobjects[SUBCATCH]; j++) if ( Subcatch[j].rptFlag ) nRpt++;
+    nVars = output_getNumVars(SUBCATCH);
+    x = report_allocResults(SUBCATCH, nRpt, &blockSize);
+    row = (char *) malloc(PERIOD_TEXT_SIZE + 50 * (nVars + 4));
+    if ( x == NULL || row == NULL )
     {
-        if ( Subcatch[j].rptFlag == TRUE )
+        FREE(x);
+        FREE(row);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
+    // --- read the results of each block of reported subcatchments
+    j = 0;
+    for (k = 0; k < nRpt; k += n)
+    {
+        n = MIN(blockSize, nRpt - k);
+        errCode = output_readResultsBlock(SUBCATCH, k, n, x);
+        if ( errCode )
         {
+            report_writeErrorMsg(errCode, "");
+            break;
+        }
+
+        // --- write the time series table of each subcatchment in block
+        for (i = 0; i < n; i++, j++)
+        {
+            while ( Subcatch[j].rptFlag == FALSE ) j++;
             report_SubcatchHeader(Subcatch[j].ID);
-            for ( period = 1; period <= Nperiods; period++ )
+            r = x + (size_t)i * Nperiods * nVars;
+            for ( period = 1; period <= Nperiods; period++, r += nVars )
             {
-                output_readDateTime(period, &days);
-                datetime_dateToStr(days, theDate);
-                datetime_timeToStr(days, theTime);
-                output_readSubcatchResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s %10.3f%10.3f%10.4f",
-                    theDate, theTime, SubcatchResults[SUBCATCH_RAINFALL],
-                    SubcatchResults[SUBCATCH_EVAP]/24.0 +
-                    SubcatchResults[SUBCATCH_INFIL],
-                    SubcatchResults[SUBCATCH_RUNOFF]);
+                len = sprintf(row, "%s ",
+                    PeriodText + (size_t)(period-1)*PERIOD_TEXT_SIZE);
+                len += report_formatFixed(row+len, r[SUBCATCH_RAINFALL], 10, 3);
+                len += report_formatFixed(row+len,
+                    r[SUBCATCH_EVAP]/24.0 + r[SUBCATCH_INFIL], 10, 3);
+                len += report_formatFixed(row+len, r[SUBCATCH_RUNOFF], 10, 4);
                 if ( hasSnowmelt )
-                    fprintf(Frpt.file, "  %10.3f",
-                        SubcatchResults[SUBCATCH_SNOWDEPTH]);
+                {
+                    len += sprintf(row+len, "  ");
+                    len += report_formatFixed(row+len, r[SUBCATCH_SNOWDEPTH],
+                                              10, 3);
+                }
                 if ( hasGwater )
-                    fprintf(Frpt.file, "%10.3f%10.4f",
-                        SubcatchResults[SUBCATCH_GW_ELEV],
-                        SubcatchResults[SUBCATCH_GW_FLOW]);
+                {
+                    len += report_formatFixed(row+len, r[SUBCATCH_GW_ELEV], 10, 3);
+                    len += report_formatFixed(row+len, r[SUBCATCH_GW_FLOW], 10, 4);
+                }
                 if ( hasQuality )
                     for (p = 0; p < Nobjects[POLLUT]; p++)
-                        fprintf(Frpt.file, "%10.3f",
-                            SubcatchResults[SUBCATCH_WASHOFF+p]);
+                        len += report_formatFixed(row+len,
+                                   r[SUBCATCH_WASHOFF+p], 10, 3);
+                fwrite(row, sizeof(char), len, Frpt.file);
             }
             WRITE("");
-            k++;
         }
     }
+    free(x);
+    free(row);
 }
 
 //=============================================================================
@@ -1220,6 +1529,8 @@ void  report_SubcatchHeader(char *id)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void report_Nodes()
 //
 //  Input:   none
@@ -1227,40 +1538,68 @@ void report_Nodes()
 //  Purpose: writes results for selected nodes to report file.
 //
 {
-    int      j, p, k;
-    int      period;
-    DateTime days;
-    char     theDate[20];
-    char     theTime[20];
+    int      i, j, p, k, n;
+    int      period, nRpt, nVars, blockSize, len, errCode;
+    REAL4*   x;
+    REAL4*   r;
+    char*    row;
 
     if ( Nobjects[NODE] == 0 ) return;
     WRITE("");
     WRITE("************");
     WRITE("Node Results");
     WRITE("************");
-    k = 0;
-    for (j = 0; j < Nobjects[NODE]; j++)
+
+    // --- allocate memory for results of a block of nodes over all
+    //     periods and for a formatted row of results
+    nRpt = 0;
+    for (j = 0; j < Nobjects[NODE]; j++) if ( Node[j].rptFlag ) nRpt++;
+    nVars = output_getNumVars(NODE);
+    x = report_allocResults(NODE, nRpt, &blockSize);
+    row = (char *) malloc(PERIOD_TEXT_SIZE + 50 * (nVars + 4));
+    if ( x == NULL || row == NULL )
+    {
+        FREE(x);
+        FREE(row);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
+    // --- read the results of each block of reported nodes
+    j = 0;
+    for (k = 0; k < nRpt; k += n)
     {
-        if ( Node[j].rptFlag == TRUE )
+        n = MIN(blockSize, nRpt - k);
+        errCode = output_readResultsBlock(NODE, k, n, x);
+        if ( errCode )
         {
+            report_writeErrorMsg(errCode, "");
+            break;
+        }
+
+        // --- write the time series table of each node in block
+        for (i = 0; i < n; i++, j++)
+        {
+            while ( Node[j].rptFlag == FALSE ) j++;
             report_NodeHeader(Node[j].ID);
-            for ( period = 1; period <= Nperiods; period++ )
+            r = x + (size_t)i * Nperiods * nVars;
+            for ( period = 1; period <= Nperiods; period++, r += nVars )
             {
-                output_readDateTime(period, &days);
-                datetime_dateToStr(days, theDate);
-                datetime_timeToStr(days, theTime);
-                output_readNodeResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s  %9.3f %9.3f %9.3f %9.3f",
-                    theDate, theTime, NodeResults[NODE_INFLOW],
-                    NodeResults[NODE_OVERFLOW], NodeResults[NODE_DEPTH],
-                    NodeResults[NODE_HEAD]);
+                len = sprintf(row, "%s ",
+                    PeriodText + (size_t)(period-1)*PERIOD_TEXT_SIZE);
+                len += report_formatValue(row+len, r[NODE_INFLOW]);
+                len += report_formatValue(row+len, r[NODE_OVERFLOW]);
+                len += report_formatValue(row+len, r[NODE_DEPTH]);
+                len += report_formatValue(row+len, r[NODE_HEAD]);
                 if ( !IgnoreQuality ) for (p = 0; p < Nobjects[POLLUT]; p++)
-                    fprintf(Frpt.file, " %9.3f", NodeResults[NODE_QUAL + p]);
+                    len += report_formatValue(row+len, r[NODE_QUAL + p]);
+                fwrite(row, sizeof(char), len, Frpt.file);
             }
             WRITE("");
-            k++;
         }
     }
+    free(x);
+    free(row);
 }
 
 //=============================================================================
@@ -1299,6 +1638,8 @@ void  report_NodeHeader(char *id)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void report_Links()
 //
 //  Input:   none
@@ -1306,40 +1647,68 @@ void report_Links()
 //  Purpose: writes results for selected links to report file.
 //
 {
-    int      j, p, k;
-    int      period;
-    DateTime days;
-    char     theDate[12];
-    char     theTime[9];
+    int      i, j, p, k, n;
+    int      period, nRpt, nVars, blockSize, len, errCode;
+    REAL4*   x;
+    REAL4*   r;
+    char*    row;
 
     if ( Nobjects[LINK] == 0 ) return;
     WRITE("");
     WRITE("************");
     WRITE("Link Results");
     WRITE("************");
-    k = 0;
-    for (j = 0; j < Nobjects[LINK]; j++)
+
+    // --- allocate memory for results of a block of links over all
+    //     periods and for a formatted row of results
+    nRpt = 0;
+    for (j = 0; j < Nobjects[LINK]; j++) if ( Link[j].rptFlag ) nRpt++;
+    nVars = output_getNumVars(LINK);
+    x = report_allocResults(LINK, nRpt, &blockSize);
+    row = (char *) malloc(PERIOD_TEXT_SIZE + 50 * (nVars + 4));
+    if ( x == NULL || row == NULL )
+    {
+        FREE(x);
+        FREE(row);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
+    // --- read the results of each block of reported links
+    j = 0;
+    for (k = 0; k < nRpt; k += n)
     {
-        if ( Link[j].rptFlag == TRUE )
+        n = MIN(blockSize, nRpt - k);
+        errCode = output_readResultsBlock(LINK, k, n, x);
+        if ( errCode )
+        {
+            report_writeErrorMsg(errCode, "");
+            break;
+        }
+
+        // --- write the time series table of each link in block
+        for (i = 0; i < n; i++, j++)
         {
+            while ( Link[j].rptFlag == FALSE ) j++;
             report_LinkHeader(Link[j].ID);
-            for ( period = 1; period <= Nperiods; period++ )
+            r = x + (size_t)i * Nperiods * nVars;
+            for ( period = 1; period <= Nperiods; period++, r += nVars )
             {
-                output_readDateTime(period, &days);
-                datetime_dateToStr(days, theDate);
-                datetime_timeToStr(days, theTime);
-                output_readLinkResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s  %9.3f %9.3f %9.3f %9.3f",
-                    theDate, theTime, LinkResults[LINK_FLOW],
-                    LinkResults[LINK_VELOCITY], LinkResults[LINK_DEPTH],
-                    LinkResults[LINK_CAPACITY]);
+                len = sprintf(row, "%s ",
+                    PeriodText + (size_t)(period-1)*PERIOD_TEXT_SIZE);
+                len += report_formatValue(row+len, r[LINK_FLOW]);
+                len += report_formatValue(row+len, r[LINK_VELOCITY]);
+                len += report_formatValue(row+len, r[LINK_DEPTH]);
+                len += report_formatValue(row+len, r[LINK_CAPACITY]);
                 if ( !IgnoreQuality ) for (p = 0; p < Nobjects[POLLUT]; p++)
-                    fprintf(Frpt.file, " %9.3f", LinkResults[LINK_QUAL + p]);
+                    len += report_formatValue(row+len, r[LINK_QUAL + p]);
+                fwrite(row, sizeof(char), len, Frpt.file);
             }
             WRITE("");
-            k++;
         }
     }
+    free(x);
+    free(row);
 }
 
 //=============================================================================
@@ -10,6 +10,7 @@
 //             08/01/16  (Build 5.1.011)
 //             03/14/17  (Build 5.1.012)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -44,6 +45,13 @@
 //     mass balance purposes.
 //   - Global infiltration factor for storage seepage set in routing_execute.
 //
+//   Build 5.1.015:
+//   - External and dry weather inflows are added from a compiled inflow
+//     schedule (see inflow.c) rather than by scanning every node's
+//     inflow lists each time step.
+//   - Calendar components of the routing date are updated once per step
+//     in RoutingCalendar for use by other modules.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -72,8 +80,6 @@ static double NewRuleTime;                                                     /
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
-static void addExternalInflows(DateTime currentDate);
-static void addDryWeatherInflows(DateTime currentDate);
 static void addWetWeatherInflows(double routingTime);
 static void addGroundwaterInflows(double routingTime);
 static void addRdiiInflows(DateTime currentDate);
@@ -111,11 +117,14 @@ int routing_open()
         if ( ErrorCode ) return ErrorCode;
     }
 
+    // --- compile the schedule of external & dry weather inflows
+    if ( inflow_openSchedule() ) return ErrorCode;                             //(5.1.015)
+
     // --- open any routing interface files
     iface_openRoutingFiles();
 
     // --- initialize flow and quality routing systems
-    flowrout_init(RouteModel);
+    flowrout_init(RouteModel, SortedLinks);                                    //(5.1.015)
     if ( Fhotstart1.mode == NO_FILE ) qualrout_init();
 
     // --- initialize routing events
@@ -141,6 +150,7 @@ void routing_close(int routingModel)
     // --- free allocated memory
     flowrout_close(routingModel);
     treatmnt_close();
+    inflow_closeSchedule();                                                    //(5.1.015)
     FREE(SortedLinks);
 }
 
@@ -225,6 +235,7 @@ void routing_execute(int routingModel, double routingStep)
 
     // --- find date of start of current time period                           //(5.1.013)
     currentDate = getDateTime(NewRoutingTime);                                 //
+    datetime_setCalendar(&RoutingCalendar, currentDate);                       //(5.1.015)
                                                                                //
     // --- evaluate control rules if next evluation time reached               //
     if (RuleStep == 0 || fabs(NewRoutingTime - NewRuleTime) < 1.0)             //
@@ -302,8 +313,7 @@ void routing_execute(int routingModel, double routingStep)
         }
 
         // --- add lateral inflows and evap/seepage losses at nodes
-        addExternalInflows(currentDate);
-        addDryWeatherInflows(currentDate);
+        inflow_addScheduledInflows(currentDate);                               //(5.1.015)
         addWetWeatherInflows(OldRoutingTime);
         addGroundwaterInflows(OldRoutingTime);
         addLidDrainInflows(OldRoutingTime);
@@ -365,146 +375,6 @@ void routing_execute(int routingModel, double routingStep)
 
 //=============================================================================
 
-void addExternalInflows(DateTime currentDate)
-//
-//  Input:   currentDate = current date/time
-//  Output:  none
-//  Purpose: adds direct external inflows to nodes at current date.
-//
-{
-    int     j, p;
-    double  q, w;
-    TExtInflow* inflow;
-
-    // --- for each node with a defined external inflow
-    for (j = 0; j < Nobjects[NODE]; j++)
-    {
-        inflow = Node[j].extInflow;
-        if ( !inflow ) continue;
-
-        // --- get flow inflow
-        q = 0.0;
-        while ( inflow )
-        {
-            if ( inflow->type == FLOW_INFLOW )
-            {
-                q = inflow_getExtInflow(inflow, currentDate);
-                break;
-            }
-            else inflow = inflow->next;
-        }
-        if ( fabs(q) < FLOW_TOL ) q = 0.0;
-
-        // --- add flow inflow to node's lateral inflow
-        Node[j].newLatFlow += q;
-        massbal_addInflowFlow(EXTERNAL_INFLOW, q);
-
-        // --- add on any inflow (i.e., reverse flow) through an outfall
-        if ( Node[j].type == OUTFALL && Node[j].oldNetInflow < 0.0 ) 
-        {
-            q = q - Node[j].oldNetInflow;
-        }
-
-        // --- get pollutant mass inflows
-        inflow = Node[j].extInflow;
-        while ( inflow )
-        {
-            if ( inflow->type != FLOW_INFLOW )
-            {
-                p = inflow->param;
-                w = inflow_getExtInflow(inflow, currentDate);
-                if ( inflow->type == CONCEN_INFLOW ) w *= q;
-                Node[j].newQual[p] += w;
-                massbal_addInflowQual(EXTERNAL_INFLOW, p, w);
-            }
-            inflow = inflow->next;
-        }
-    }
-}
-
-//=============================================================================
-
-void addDryWeatherInflows(DateTime currentDate)
-//
-//  Input:   currentDate = current date/time
-//  Output:  none
-//  Purpose: adds dry weather inflows to nodes at current date.
-//
-{
-    int      j, p;
-    int      month, day, hour;
-    double   q, w;
-    TDwfInflow* inflow;
-
-    // --- get month (zero-based), day-of-week (zero-based),
-    //     & hour-of-day for routing date/time
-    month = datetime_monthOfYear(currentDate) - 1;
-    day   = datetime_dayOfWeek(currentDate) - 1;
-    hour  = datetime_hourOfDay(currentDate);
-
-    // --- for each node with a defined dry weather inflow
-    for (j = 0; j < Nobjects[NODE]; j++)
-    {
-        inflow = Node[j].dwfInflow;
-        if ( !inflow ) continue;
-
-        // --- get flow inflow (i.e., the inflow whose param code is -1)
-        q = 0.0;
-        while ( inflow )
-        {
-            if ( inflow->param < 0 )
-            {
-                q = inflow_getDwfInflow(inflow, month, day, hour);
-                break;
-            }
-            inflow = inflow->next;
-        }
-        if ( fabs(q) < FLOW_TOL ) q = 0.0;
-
-        // --- add flow inflow to node's lateral inflow
-        Node[j].newLatFlow += q;
-        massbal_addInflowFlow(DRY_WEATHER_INFLOW, q);
-
-        // --- stop if inflow is non-positive
-        if ( q <= 0.0 ) continue;
-
-        // --- add default DWF pollutant inflows
-        for ( p = 0; p < Nobjects[POLLUT]; p++)
-        {
-            if ( Pollut[p].dwfConcen > 0.0 )
-            {
-                w = q * Pollut[p].dwfConcen;
-                Node[j].newQual[p] += w;
-                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
-            }
-        }
-
-        // --- get pollutant mass inflows
-        inflow = Node[j].dwfInflow;
-        while ( inflow )
-        {
-            if ( inflow->param >= 0 )
-            {
-                p = inflow->param;
-                w = q * inflow_getDwfInflow(inflow, month, day, hour);
-                Node[j].newQual[p] += w;
-                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
-
-                // --- subtract off any default inflow
-                if ( Pollut[p].dwfConcen > 0.0 )
-                {
-                    w = q * Pollut[p].dwfConcen;
-                    Node[j].newQual[p] -= w;
-                    massbal_addInflowQual(DRY_WEATHER_INFLOW, p, -w);
-                }
-            }
-            inflow = inflow->next;
-        }
-    }
-}
-
-//=============================================================================
-
 void addWetWeatherInflows(double routingTime)
 //
 //  Input:   routingTime = elasped time (millisec)
@@ -9,6 +9,7 @@
 //             08/01/16   (Build 5.1.011)
 //             03/14/17   (Build 5.1.012)
 //             03/01/20   (Build 5.1.014)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //             M. Tryby
 //
@@ -33,6 +34,12 @@
 //
 //   Build 5.1.014:
 //   - Fixed street sweeping bug.
+//
+//   Build 5.1.015:
+//   - Calendar components of the runoff date are updated once per step in
+//     RunoffCalendar.
+//   - Buffered LID report file results are written when runoff is closed.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -124,6 +131,8 @@ int runoff_open()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void runoff_close()
 //
 //  Input:   none
@@ -151,6 +160,9 @@ void runoff_close()
 
     // --- close climate file if in use
     if ( Fclimate.file ) fclose(Fclimate.file);
+
+    // --- write results buffered for LID report files                         //(5.1.015)
+    lid_flushRptFiles();                                                       //(5.1.015)
 }
 
 //=============================================================================
@@ -177,6 +189,7 @@ void runoff_execute()
 
     // --- convert elapsed runoff time in milliseconds to a calendar date
     currentDate = getDateTime(NewRunoffTime);
+    datetime_setCalendar(&RunoffCalendar, currentDate);                        //(5.1.015)
 
     // --- update climatological conditions
     climate_setState(currentDate);
@@ -208,7 +221,7 @@ void runoff_execute()
     }
 
     // --- see if street sweeping can occur on current date
-    day = datetime_dayOfYear(currentDate);
+    day = RunoffCalendar.dayOfYear;                                            //(5.1.015)
     if ( SweepStart <= SweepEnd )
     {
         if ( day >= SweepStart && day <= SweepEnd ) canSweep = TRUE;
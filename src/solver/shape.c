@@ -4,12 +4,19 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Geometry functions for custom cross-section shapes.
+//
+//   Build 5.1.015:
+//   - Adaptive geometry tables with entries at each height on the shape curve
+//     added.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>                                                            //(5.1.015)
 #include <math.h>
 #include "headers.h"
 
@@ -18,16 +25,23 @@
 //-----------------------------------------------------------------------------
 static double Atotal;
 static double Ptotal;
+static TTable* ShapeCurve;             // curve of shape being validated      //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //  shape_validate                (called from project_validate in project.c)
+//  shape_delete                  (called from deleteObjects in project.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static int computeShapeTables(TShape *shape, TTable *curve);
+static int createGeomTbl(TShape *shape, TTable *curve);                       //(5.1.015)
+static int getGeomTbl(int n, double y[], double a[], double r[], double w[],  //(5.1.015)
+                      void* p);
+static int getFirstInterval(TTable *curve, double *y1, double *y2,           //(5.1.015)
+                            double *w1, double *w2, double *wMax);
 static void getSmax(TShape *shape);
 static int normalizeShapeTables(TShape *shape);
 static int getNextInterval(TTable *curve, double y, double yLast, double wLast,
@@ -56,11 +70,30 @@ int shape_validate(TShape *shape, TTable *curve)
         return FALSE;
     }
 
+    if (!createGeomTbl(shape, curve)) {                                        //(5.1.015)
+        return FALSE;
+    }
+    getSmax(shape);                                                            //(5.1.015)
+
     return TRUE;
 }
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void shape_delete(TShape *shape)
+//
+//  Input:   shape = pointer to a custom x-section TShape object
+//  Output:  none
+//  Purpose: frees memory used by a custom x-section shape's geometry tables.
+//
+{
+    xsect_deleteGeomTbl(&shape->geom);
+}
+
+//=============================================================================
+
 int computeShapeTables(TShape *shape, TTable *curve)
 //
 //  Input:   shape = pointer to a TShape object
@@ -77,43 +110,11 @@ int computeShapeTables(TShape *shape, TTable *curve)
     double dy, y, y1, y2, w, w1, w2;
     double yLast, wLast, wMax;
 
-    // --- get first entry of user's shape curve
-    if (!table_getFirstEntry(curve, &y1, &w1)) {
+    // --- get first interval of user's shape curve
+    if (!getFirstInterval(curve, &y1, &y2, &w1, &w2, &wMax)) {                 //(5.1.015)
         return FALSE;
     }
 
-    if (y1 < 0.0 || y1 >= 1.0 || w1 < 0.0) {
-        return FALSE;
-    }
-
-    wMax = w1;
-
-    // --- if first entry not at zero ht. then add an initial entry
-    if (y1 != 0.0) {
-        y2 = y1;
-        w2 = w1;
-        y1 = 0.0;
-        w1 = 0.0;
-    }
-    // --- otherwise get next entry in the user's shape curve
-    else {
-        if (!table_getNextEntry(curve, &y2, &w2)) {
-            return FALSE;
-        }
-
-        if (y2 < y1 || w2 < 0.0) {
-            return FALSE;
-        }
-
-        if (y2 > 1.0) {
-            y2 = 1.0;
-        }
-
-        if (w2 > wMax) {
-            wMax = w2;
-        }
-    }
-
     // --- determine number of entries & interval size in geom. tables
     shape->nTbl = N_SHAPE_TBL;
     n           = shape->nTbl - 1;
@@ -177,38 +178,200 @@ int computeShapeTables(TShape *shape, TTable *curve)
     shape->aFull = shape->areaTbl[n];
     shape->rFull = shape->hradTbl[n];
 
-    // --- assign values to shape's max. width and section factor
+    // --- assign value to shape's max. width                                  //(5.1.015)
     shape->wMax = wMax;
-    getSmax(shape);
 
     return TRUE;
 }
 
 //=============================================================================
 
-void getSmax(TShape *shape)
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int getFirstInterval(TTable *curve, double *y1, double *y2, double *w1,
+                     double *w2, double *wMax)
+//
+//  Input:   curve = pointer to a user-supplied shape curve table
+//  Output:  y1 = height at start of first curve interval
+//           y2 = height at end of first curve interval
+//           w1 = width at start of first curve interval
+//           w2 = width at end of first curve interval
+//           wMax = maximum width of first curve interval;
+//           returns TRUE if successful, FALSE if not.
+//  Purpose: retrieves the first height interval of a shape's curve.
+//
+{
+    // --- get first entry of user's shape curve
+    if (!table_getFirstEntry(curve, y1, w1)) {
+        return FALSE;
+    }
+
+    if (*y1 < 0.0 || *y1 >= 1.0 || *w1 < 0.0) {
+        return FALSE;
+    }
+
+    *wMax = *w1;
+
+    // --- if first entry not at zero ht. then add an initial entry
+    if (*y1 != 0.0) {
+        *y2 = *y1;
+        *w2 = *w1;
+        *y1 = 0.0;
+        *w1 = 0.0;
+    }
+    // --- otherwise get next entry in the user's shape curve
+    else {
+        if (!table_getNextEntry(curve, y2, w2)) {
+            return FALSE;
+        }
+
+        if (*y2 < *y1 || *w2 < 0.0) {
+            return FALSE;
+        }
+
+        if (*y2 > 1.0) {
+            *y2 = 1.0;
+        }
+
+        if (*w2 > *wMax) {
+            *wMax = *w2;
+        }
+    }
+
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int createGeomTbl(TShape *shape, TTable *curve)
 //
 //  Input:   shape = pointer to a TShape object
-//  Output:  none
-//  Purpose: computes the max. section factor and corresponding area
-//           for a shape of unit height.
+//           curve = pointer to shape's table of width v. height
+//  Output:  returns TRUE if successful. FALSE if not
+//  Purpose: builds the adaptive geometry tables used to compute a custom
+//           shape's geometry, with entries at each height on its curve.
 //
 {
-    int    i;
-    int    n = shape->nTbl - 1;
-    double sf;
+    int    n = 0;
+    int    result;
+    double y, w;
+    double *yBreaks;
+
+    // --- count the curve heights that lie inside the shape
+    if (table_getFirstEntry(curve, &y, &w)) {
+        do {
+            n++;
+        } while (table_getNextEntry(curve, &y, &w));
+    }
 
-    shape->sMax = 0.0;
-    shape->aMax = 0.0;
+    // --- save them as the breaks in the shape's width profile
+    yBreaks = (double *) calloc(n + 1, sizeof(double));
+    if (yBreaks == NULL) {
+        return FALSE;
+    }
+    n = 0;
+    if (table_getFirstEntry(curve, &y, &w)) {
+        do {
+            if (y > 0.0 && y < 1.0) {
+                yBreaks[n++] = y;
+            }
+        } while (table_getNextEntry(curve, &y, &w));
+    }
 
-    for (i = 1; i <= n; i++) {
-        sf = shape->areaTbl[i] * pow(shape->hradTbl[i], 2. / 3.);
+    // --- build the tables (shape has unit height)
+    ShapeCurve = curve;
+    result = xsect_createGeomTbl(&shape->geom, n, yBreaks,
+                                 shape->wMax / shape->aFull, getGeomTbl,
+                                 shape);
+    free(yBreaks);
+    return result;
+}
 
-        if (sf > shape->sMax) {
-            shape->sMax = sf;
-            shape->aMax = shape->areaTbl[i];
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int getGeomTbl(int n, double y[], double a[], double r[], double w[], void* p)
+//
+//  Input:   n = number of heights
+//           y = increasing heights for a shape of unit height
+//           p = pointer to the TShape object being validated
+//  Output:  a = normalized area at each height
+//           r = normalized hyd. radius at each height
+//           w = normalized top width at each height;
+//           returns TRUE if successful, FALSE if not.
+//  Purpose: evaluates the geometry of the shape being validated when
+//           building its adaptive geometry tables.
+//
+{
+    int     i;
+    double  y1, y2, w1, w2, wMax, yLast, wLast, wTop, pTotal;
+    TShape* shape = (TShape *)p;
+
+    // --- start at the bottom of the shape curve
+    if (!getFirstInterval(ShapeCurve, &y1, &y2, &w1, &w2, &wMax)) {
+        return FALSE;
+    }
+    Ptotal = w1;
+    Atotal = 0.0;
+    yLast  = 0.0;
+    wLast  = w1;
+
+    for (i = 0; i < n; i++) {
+        // --- move to the curve interval containing the current height
+        if (y[i] > y2) {
+            if (!getNextInterval(ShapeCurve, y[i], yLast, wLast, &y1, &y2,
+                                 &w1, &w2, &wMax)) {
+                return FALSE;
+            }
+
+            yLast = y1;
+            wLast = w1;
+        }
+
+        // --- add area & perimeter of the curve up to the current height
+        wTop = getWidth(y[i], y1, y2, w1, w2);
+        Atotal += getArea(y[i], wTop, yLast, wLast);
+        Ptotal += getPerim(y[i], wTop, yLast, wLast);
+        yLast = y[i];
+        wLast = wTop;
+
+        // --- top width closes the shape when full
+        pTotal = Ptotal;
+        if (y[i] >= 1.0) {
+            pTotal += w2;
+        }
+
+        a[i] = Atotal / shape->aFull;
+        r[i] = 0.0;
+        if (pTotal > 0.0) {
+            r[i] = Atotal / pTotal / shape->rFull;
         }
+        w[i] = wTop / shape->wMax;
     }
+
+    return TRUE;
+}
+
+//=============================================================================
+
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void getSmax(TShape *shape)
+//
+//  Input:   shape = pointer to a TShape object
+//  Output:  none
+//  Purpose: computes the max. section factor and corresponding area
+//           for a shape of unit height from its adaptive geometry tables.
+//
+{
+    double a;
+
+    shape->sMax = xsect_getGeomTblSmax(&shape->geom, &a) * shape->aFull *
+                  pow(shape->rFull, 2. / 3.);
+    shape->aMax = a * shape->aFull;
 }
 
 //=============================================================================
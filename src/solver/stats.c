@@ -9,6 +9,7 @@
 //             08/01/16   (Build 5.1.011)
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             R. Dickinson (CDM)
 //
@@ -36,6 +37,16 @@
 //   - Statistics on impervious and pervious runoff totals added.
 //   - Storage nodes with a non-zero surcharge depth (e.g. enclosed tanks)
 //     can now be classified as being surcharged.
+//
+//   Build 5.1.015:
+//   - System outfall flow summed outside the parallel node loop so results no
+//     longer depend on thread timing. Duration & frequency statistics updated
+//     every STATISTICS_STRIDE routing steps, with peak values still updated
+//     every step.
+//   - Lists of highest continuity errors, Courant critical elements and flow
+//     instability indexes kept as top-K heaps whose size is set by the
+//     STATISTICS_TOP_N option.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -53,10 +64,13 @@
 //-----------------------------------------------------------------------------
 #define MAX_STATS 5
 static TSysStats       SysStats;
-static TMaxStats       MaxMassBalErrs[MAX_STATS];
-static TMaxStats       MaxCourantCrit[MAX_STATS];
-static TMaxStats       MaxFlowTurns[MAX_STATS];
+static int             MaxStatsSize;   // entries in each max. stats list     //(5.1.015)
+static TMaxStats*      MaxMassBalErrs;                                         //(5.1.015)
+static TMaxStats*      MaxCourantCrit;                                         //(5.1.015)
+static TMaxStats*      MaxFlowTurns;                                           //(5.1.015)
 static double          SysOutfallFlow;
+static int             StrideSteps;    // steps since durations updated        //(5.1.015)
+static double          StrideTime;     // time since durations updated (sec)   //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  Exportable variables (shared with statsrpt.c)
@@ -93,8 +107,15 @@ extern double*         NodeOutflow;    // defined in massbal.c
 //-----------------------------------------------------------------------------
 static void stats_updateNodeStats(int node, double tStep, DateTime aDate);
 static void stats_updateLinkStats(int link, double tStep, DateTime aDate);
+static void stats_updateDurations(void);                                       //(5.1.015)
+static void stats_updateNodeDurations(int node, int nSteps, double tSum);      //(5.1.015)
+static void stats_updateLinkDurations(int link, int nSteps, double tSum);      //(5.1.015)
 static void stats_findMaxStats(void);
-static void stats_updateMaxStats(TMaxStats maxStats[], int i, int j, double x);
+static void stats_updateMaxStats(TMaxStats maxStats[], int* n, int i, int j,  //(5.1.015)
+            double x);
+static void stats_sortMaxStats(TMaxStats maxStats[], int n);                   //(5.1.015)
+static int  stats_isLowerRank(TMaxStats* a, TMaxStats* b);                     //(5.1.015)
+static void stats_siftDown(TMaxStats maxStats[], int n, int k);                //(5.1.015)
 
 //=============================================================================
 
@@ -107,6 +128,18 @@ int  stats_open()
 {
     int j, k;
 
+    // --- allocate memory for lists of most critical nodes & links        //(5.1.015)
+    MaxStatsSize = MAX_STATS;                                                  //(5.1.015)
+    if ( StatsTopN > 0 ) MaxStatsSize = StatsTopN;                             //(5.1.015)
+    MaxMassBalErrs = (TMaxStats *) calloc(MaxStatsSize, sizeof(TMaxStats));    //(5.1.015)
+    MaxCourantCrit = (TMaxStats *) calloc(MaxStatsSize, sizeof(TMaxStats));    //(5.1.015)
+    MaxFlowTurns   = (TMaxStats *) calloc(MaxStatsSize, sizeof(TMaxStats));    //(5.1.015)
+    if ( !MaxMassBalErrs || !MaxCourantCrit || !MaxFlowTurns )                 //(5.1.015)
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return ErrorCode;
+    }
+
     // --- set all pointers to NULL
     NodeStats = NULL;
     LinkStats = NULL;
@@ -286,6 +319,8 @@ int  stats_open()
     SysStats.avgTimeStep = 0.0;
     SysStats.avgStepCount = 0.0;
     SysStats.steadyStateCount = 0.0;
+    StrideSteps = 0;                                                           //(5.1.015)
+    StrideTime = 0.0;                                                          //(5.1.015)
     return 0;
 }
 
@@ -311,6 +346,9 @@ void  stats_close()
         FREE(OutfallStats);
     }
     FREE(PumpStats);
+    FREE(MaxMassBalErrs);                                                      //(5.1.015)
+    FREE(MaxCourantCrit);                                                      //(5.1.015)
+    FREE(MaxFlowTurns);                                                        //(5.1.015)
 }
 
 //=============================================================================
@@ -322,12 +360,15 @@ void  stats_report()
 //  Purpose: reports simulation statistics.
 //
 {
+    // --- add steps not yet included in duration statistics                 //(5.1.015)
+    if ( StrideSteps > 0 && NodeStats ) stats_updateDurations();               //(5.1.015)
+
     // --- report flow routing accuracy statistics
     if ( Nobjects[LINK] > 0 && RouteModel != NO_ROUTING )
     {
         stats_findMaxStats();
-        report_writeMaxStats(MaxMassBalErrs, MaxCourantCrit, MAX_STATS);
-        report_writeMaxFlowTurns(MaxFlowTurns, MAX_STATS);
+        report_writeMaxStats(MaxMassBalErrs, MaxCourantCrit, MaxStatsSize);    //(5.1.015)
+        report_writeMaxFlowTurns(MaxFlowTurns, MaxStatsSize);                  //(5.1.015)
         report_writeSysStats(&SysStats);
     }
 
@@ -432,7 +473,6 @@ void   stats_updateFlowStats(double tStep, DateTime aDate, int stepCount,
 
     // --- update stats only after reporting period begins
     if ( aDate < ReportStart ) return;
-    SysOutfallFlow = 0.0;
 
     // --- update node & link stats
 #pragma omp parallel num_threads(NumThreads)
@@ -445,6 +485,20 @@ void   stats_updateFlowStats(double tStep, DateTime aDate, int stepCount,
         stats_updateLinkStats(j, tStep, aDate);
 }
 
+    // --- update duration & frequency stats every StatsStride steps         //(5.1.015)
+    StrideSteps++;                                                             //(5.1.015)
+    StrideTime += tStep;                                                       //(5.1.015)
+    if ( StrideSteps >= StatsStride ) stats_updateDurations();                 //(5.1.015)
+
+    // --- find system outfall flow                                          //(5.1.015)
+    //     (summed here rather than within the parallel node loop
+    //      so that the result does not depend on thread timing)
+    SysOutfallFlow = 0.0;                                                      //(5.1.015)
+    for ( j=0; j<Nobjects[NODE]; j++ )                                         //(5.1.015)
+    {                                                                          //(5.1.015)
+        if ( Node[j].type == OUTFALL ) SysOutfallFlow += Node[j].inflow;       //(5.1.015)
+    }                                                                          //(5.1.015)
+
     // --- update count of times in steady state
     SysStats.steadyStateCount += steadyState;
 
@@ -499,7 +553,6 @@ void stats_updateNodeStats(int j, double tStep, DateTime aDate)
     int    canPond = (AllowPonding && Node[j].pondedArea > 0.0);
 
     // --- update depth statistics
-    NodeStats[j].avgDepth += newDepth;
     if ( newDepth > NodeStats[j].maxDepth )
     {
         NodeStats[j].maxDepth = newDepth;
@@ -511,30 +564,17 @@ void stats_updateNodeStats(int j, double tStep, DateTime aDate)
     {
         if ( newVolume > Node[j].fullVolume || Node[j].overflow > 0.0 )
         {
-            NodeStats[j].timeFlooded += tStep;
             NodeStats[j].volFlooded += Node[j].overflow * tStep;
             if ( canPond ) NodeStats[j].maxPondedVol =
                 MAX(NodeStats[j].maxPondedVol,
                     (newVolume - Node[j].fullVolume));
         }
-
-        // --- for dynamic wave routing, classify a node as                    //(5.1.013)
-        //     surcharged if its water level exceeds its crown elev.
-        if (RouteModel == DW)                                                  //(5.1.013)
-        {
-            if ((Node[j].type != STORAGE || Node[j].surDepth > 0.0) &&         //(5.1.013)
-                newDepth + Node[j].invertElev + FUDGE >= Node[j].crownElev)
-            {
-                NodeStats[j].timeSurcharged += tStep;
-            }
-        }
     }
 
     // --- update storage statistics
     if ( Node[j].type == STORAGE )
     {
         k = Node[j].subIndex;
-        StorageStats[k].avgVol += newVolume;
         StorageStats[k].evapLosses +=
             Storage[Node[j].subIndex].evapLoss;
         StorageStats[k].exfilLosses +=
@@ -555,16 +595,13 @@ void stats_updateNodeStats(int j, double tStep, DateTime aDate)
         k = Node[j].subIndex;
         if ( Node[j].inflow >= MIN_RUNOFF_FLOW )
         {
-            OutfallStats[k].avgFlow += Node[j].inflow;
             OutfallStats[k].maxFlow = MAX(OutfallStats[k].maxFlow, Node[j].inflow);
-            OutfallStats[k].totalPeriods++;
         }
         for (p=0; p<Nobjects[POLLUT]; p++)
         {
             OutfallStats[k].totalLoad[p] += Node[j].inflow *
             Node[j].newQual[p] * tStep;
         }
-        SysOutfallFlow += Node[j].inflow;
     }
 
     // --- update inflow statistics
@@ -625,70 +662,185 @@ void  stats_updateLinkStats(int j, double tStep, DateTime aDate)
 
     if ( Link[j].type == PUMP )
     {
-        if ( q >= Link[j].qFull )
-            LinkStats[j].timeFullFlow += tStep;
         if ( q > MIN_RUNOFF_FLOW )
         {
             k = Link[j].subIndex;
             PumpStats[k].minFlow = MIN(PumpStats[k].minFlow, q);
             PumpStats[k].maxFlow = LinkStats[j].maxFlow;
-            PumpStats[k].avgFlow += q;
             PumpStats[k].volume += q*tStep;
-            PumpStats[k].utilized += tStep;
             PumpStats[k].energy += link_getPower(j)*tStep/3600.0;
-            if ( Link[j].flowClass == DN_DRY )
-                PumpStats[k].offCurveLow += tStep;
-            if ( Link[j].flowClass == UP_DRY )
-                PumpStats[k].offCurveHigh += tStep;
             if ( Link[j].oldFlow < MIN_RUNOFF_FLOW )
                 PumpStats[k].startUps++;
-            PumpStats[k].totalPeriods++;
-            LinkStats[j].timeSurcharged += tStep;
-            LinkStats[j].timeFullUpstream += tStep;
-            LinkStats[j].timeFullDnstream += tStep;
+        }
+    }
+
+    // --- update flow turn count
+    k = LinkStats[j].flowTurnSign;
+    LinkStats[j].flowTurnSign = SGN(dq);
+    if ( fabs(dq) > 0.001 &&  k * LinkStats[j].flowTurnSign < 0 )
+            LinkStats[j].flowTurns++;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  stats_updateDurations()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: updates the duration & frequency statistics of all nodes and
+//           links over the routing steps taken since they were last updated.
+//
+{
+    int j;
+    int    nSteps = StrideSteps;
+    double tSum = StrideTime;
+
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for
+    for ( j=0; j<Nobjects[NODE]; j++ )
+        stats_updateNodeDurations(j, nSteps, tSum);
+    #pragma omp for
+    for ( j=0; j<Nobjects[LINK]; j++ )
+        stats_updateLinkDurations(j, nSteps, tSum);
+}
+    StrideSteps = 0;
+    StrideTime = 0.0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void stats_updateNodeDurations(int j, int nSteps, double tSum)
+//
+//  Input:   j = node index
+//           nSteps = number of routing steps since last update
+//           tSum = total time of these routing steps (sec)
+//  Output:  none
+//  Purpose: updates a node's duration & frequency statistics, applying
+//           its current state to each routing step since the last update.
+//
+{
+    int    k;
+    double newVolume = Node[j].newVolume;
+    double newDepth = Node[j].newDepth;
+
+    // --- update depth statistics
+    NodeStats[j].avgDepth += newDepth * nSteps;
+
+    // --- update flooding and surcharge statistics
+    if ( Node[j].type != OUTFALL )
+    {
+        if ( newVolume > Node[j].fullVolume || Node[j].overflow > 0.0 )
+        {
+            NodeStats[j].timeFlooded += tSum;
+        }
+
+        // --- for dynamic wave routing, classify a node as
+        //     surcharged if its water level exceeds its crown elev.
+        if (RouteModel == DW)
+        {
+            if ((Node[j].type != STORAGE || Node[j].surDepth > 0.0) &&
+                newDepth + Node[j].invertElev + FUDGE >= Node[j].crownElev)
+            {
+                NodeStats[j].timeSurcharged += tSum;
+            }
+        }
+    }
+
+    // --- update storage statistics
+    if ( Node[j].type == STORAGE )
+    {
+        k = Node[j].subIndex;
+        StorageStats[k].avgVol += newVolume * nSteps;
+    }
+
+    // --- update outfall statistics
+    if ( Node[j].type == OUTFALL )
+    {
+        k = Node[j].subIndex;
+        if ( Node[j].inflow >= MIN_RUNOFF_FLOW )
+        {
+            OutfallStats[k].avgFlow += Node[j].inflow * nSteps;
+            OutfallStats[k].totalPeriods += nSteps;
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  stats_updateLinkDurations(int j, int nSteps, double tSum)
+//
+//  Input:   j = link index
+//           nSteps = number of routing steps since last update
+//           tSum = total time of these routing steps (sec)
+//  Output:  none
+//  Purpose: updates a link's duration & frequency statistics, applying
+//           its current state to each routing step since the last update.
+//
+{
+    int    k;
+    double q = fabs(Link[j].newFlow);
+
+    if ( Link[j].type == PUMP )
+    {
+        if ( q >= Link[j].qFull )
+            LinkStats[j].timeFullFlow += tSum;
+        if ( q > MIN_RUNOFF_FLOW )
+        {
+            k = Link[j].subIndex;
+            PumpStats[k].avgFlow += q * nSteps;
+            PumpStats[k].utilized += tSum;
+            if ( Link[j].flowClass == DN_DRY )
+                PumpStats[k].offCurveLow += tSum;
+            if ( Link[j].flowClass == UP_DRY )
+                PumpStats[k].offCurveHigh += tSum;
+            PumpStats[k].totalPeriods += nSteps;
+            LinkStats[j].timeSurcharged += tSum;
+            LinkStats[j].timeFullUpstream += tSum;
+            LinkStats[j].timeFullDnstream += tSum;
         }
     }
     else if ( Link[j].type == CONDUIT )
     {
 
         // --- update time under normal flow & inlet control
-        if ( Link[j].normalFlow ) LinkStats[j].timeNormalFlow += tStep;
-        if ( Link[j].inletControl ) LinkStats[j].timeInletControl += tStep;
+        if ( Link[j].normalFlow ) LinkStats[j].timeNormalFlow += tSum;
+        if ( Link[j].inletControl ) LinkStats[j].timeInletControl += tSum;
 
         // --- update flow classification distribution
         k = Link[j].flowClass;
         if ( k >= 0 && k < MAX_FLOW_CLASSES )
         {
-            ++LinkStats[j].timeInFlowClass[k];
+            LinkStats[j].timeInFlowClass[k] += nSteps;
         }
 
         // --- update time conduit is full
         k = Link[j].subIndex;
         if ( q >= Link[j].qFull * (double)Conduit[k].barrels )
-            LinkStats[j].timeFullFlow += tStep;
+            LinkStats[j].timeFullFlow += tSum;
         if ( Conduit[k].capacityLimited )
-            LinkStats[j].timeCapacityLimited += tStep;
+            LinkStats[j].timeCapacityLimited += tSum;
 
         switch (Conduit[k].fullState)
         {
         case ALL_FULL:
-            LinkStats[j].timeSurcharged += tStep;
-            LinkStats[j].timeFullUpstream += tStep;
-            LinkStats[j].timeFullDnstream += tStep;
+            LinkStats[j].timeSurcharged += tSum;
+            LinkStats[j].timeFullUpstream += tSum;
+            LinkStats[j].timeFullDnstream += tSum;
             break;
         case UP_FULL:
-            LinkStats[j].timeFullUpstream += tStep;
+            LinkStats[j].timeFullUpstream += tSum;
             break;
         case DN_FULL:
-            LinkStats[j].timeFullDnstream += tStep;
+            LinkStats[j].timeFullDnstream += tSum;
         }
     }
-
-    // --- update flow turn count
-    k = LinkStats[j].flowTurnSign;
-    LinkStats[j].flowTurnSign = SGN(dq);
-    if ( fabs(dq) > 0.001 &&  k * LinkStats[j].flowTurnSign < 0 )
-            LinkStats[j].flowTurns++;
 }
 
 //=============================================================================
@@ -700,12 +852,17 @@ void  stats_findMaxStats()
 //  Purpose: finds nodes & links with highest mass balance errors
 //           & highest times Courant time-step critical.
 //
+//  Note: each list is kept as a min-heap of its MaxStatsSize highest ranked
+//        entries while elements are scanned and is then sorted from highest
+//        to lowest rank, which takes O(n log MaxStatsSize) time.
+//
 {
     int    j;
+    int    nMassBalErrs = 0, nCourantCrit = 0, nFlowTurns = 0;                //(5.1.015)
     double x;
 
     // --- initialize max. stats arrays
-    for (j=0; j<MAX_STATS; j++)
+    for (j=0; j<MaxStatsSize; j++)                                             //(5.1.015)
     {
         MaxMassBalErrs[j].objType = NODE;
         MaxMassBalErrs[j].index   = -1;
@@ -722,8 +879,9 @@ void  stats_findMaxStats()
         for (j=0; j<Nobjects[LINK]; j++)
         {
             x = 100.0 * LinkStats[j].flowTurns / (2./3.*(StepCount-2));
-            stats_updateMaxStats(MaxFlowTurns, LINK, j, x);
+            stats_updateMaxStats(MaxFlowTurns, &nFlowTurns, LINK, j, x);       //(5.1.015)
         }
+        stats_sortMaxStats(MaxFlowTurns, nFlowTurns);                          //(5.1.015)
     }
 
     // --- find nodes with largest mass balance errors
@@ -740,8 +898,9 @@ void  stats_findMaxStats()
             x = 1.0 - NodeOutflow[j] / NodeInflow[j];
         else if ( NodeOutflow[j] > 0.0 ) x = -1.0;
         else                             x = 0.0;
-        stats_updateMaxStats(MaxMassBalErrs, NODE, j, 100.0*x);
+        stats_updateMaxStats(MaxMassBalErrs, &nMassBalErrs, NODE, j, 100.0*x); //(5.1.015)
     }
+    stats_sortMaxStats(MaxMassBalErrs, nMassBalErrs);                          //(5.1.015)
 
     // --- stop if not using a variable time step
     if ( RouteModel != DW || CourantFactor == 0.0 ) return;
@@ -751,22 +910,27 @@ void  stats_findMaxStats()
     for (j=0; j<Nobjects[NODE]; j++)
     {
         x = NodeStats[j].timeCourantCritical / StepCount;
-        stats_updateMaxStats(MaxCourantCrit, NODE, j, 100.0*x);
+        stats_updateMaxStats(MaxCourantCrit, &nCourantCrit, NODE, j, 100.0*x); //(5.1.015)
     }
 
     // --- find links most frequently Courant critical
     for (j=0; j<Nobjects[LINK]; j++)
     {
         x = LinkStats[j].timeCourantCritical / StepCount;
-        stats_updateMaxStats(MaxCourantCrit, LINK, j, 100.0*x);
+        stats_updateMaxStats(MaxCourantCrit, &nCourantCrit, LINK, j, 100.0*x); //(5.1.015)
     }
+    stats_sortMaxStats(MaxCourantCrit, nCourantCrit);                          //(5.1.015)
 }
 
 //=============================================================================
 
-void  stats_updateMaxStats(TMaxStats maxStats[], int i, int j, double x)
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
+void  stats_updateMaxStats(TMaxStats maxStats[], int* n, int i, int j,         //(5.1.015)
+                           double x)
 //
-//  Input:   maxStats[] = array of critical statistics values
+//  Input:   maxStats[] = heap of critical statistics values
+//           n = number of entries in the heap
 //           i = object category (NODE or LINK)
 //           j = object index
 //           x = value of statistic for the object
@@ -774,22 +938,111 @@ void  stats_updateMaxStats(TMaxStats maxStats[], int i, int j, double x)
 //  Purpose: updates the collection of most critical statistics
 //
 {
-    int   k;
-    TMaxStats maxStats1, maxStats2;
+    int   k, parent;                                                           //(5.1.015)
+    TMaxStats maxStats1;
     maxStats1.objType = i;
     maxStats1.index   = j;
     maxStats1.value   = x;
-    for (k=0; k<MAX_STATS; k++)
+
+    // --- only values above 1 percent are ranked
+    if ( fabs(x) <= 1.0 ) return;
+
+    // --- heap not yet full: add new entry and sift it up
+    if ( *n < MaxStatsSize )
     {
-        if ( fabs(maxStats1.value) > fabs(maxStats[k].value) )
+        k = *n;
+        while ( k > 0 )
         {
-            maxStats2 = maxStats[k];
-            maxStats[k] = maxStats1;
-            maxStats1 = maxStats2;
+            parent = (k - 1) / 2;
+            if ( !stats_isLowerRank(&maxStats1, &maxStats[parent]) ) break;
+            maxStats[k] = maxStats[parent];
+            k = parent;
         }
+        maxStats[k] = maxStats1;
+        (*n)++;
+    }
+
+    // --- otherwise new entry replaces lowest ranked one at top of heap
+    else if ( stats_isLowerRank(&maxStats[0], &maxStats1) )
+    {
+        maxStats[0] = maxStats1;
+        stats_siftDown(maxStats, *n, 0);
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  stats_sortMaxStats(TMaxStats maxStats[], int n)
+//
+//  Input:   maxStats[] = heap of critical statistics values
+//           n = number of entries in the heap
+//  Output:  none
+//  Purpose: sorts a heap of critical statistics from highest to lowest rank.
+//
+{
+    int       k;
+    TMaxStats maxStats1;
+
+    // --- repeatedly move the lowest ranked entry to the end of the heap
+    for (k = n-1; k > 0; k--)
+    {
+        maxStats1 = maxStats[0];
+        maxStats[0] = maxStats[k];
+        maxStats[k] = maxStats1;
+        stats_siftDown(maxStats, k, 0);
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void  stats_siftDown(TMaxStats maxStats[], int n, int k)
+//
+//  Input:   maxStats[] = heap of critical statistics values
+//           n = number of entries in the heap
+//           k = position of entry to sift down
+//  Output:  none
+//  Purpose: restores heap order below position k.
+//
+{
+    int       child;
+    TMaxStats maxStats1 = maxStats[k];
+
+    for (;;)
+    {
+        child = 2*k + 1;
+        if ( child >= n ) break;
+        if ( child + 1 < n &&
+             stats_isLowerRank(&maxStats[child+1], &maxStats[child]) ) child++;
+        if ( !stats_isLowerRank(&maxStats[child], &maxStats1) ) break;
+        maxStats[k] = maxStats[child];
+        k = child;
     }
+    maxStats[k] = maxStats1;
 }
 
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int  stats_isLowerRank(TMaxStats* a, TMaxStats* b)
+//
+//  Input:   a, b = pointers to two critical statistics entries
+//  Output:  returns TRUE if entry a ranks below entry b
+//  Purpose: orders critical statistics by decreasing magnitude, with ties
+//           going to nodes before links and then to lower object indexes.
+//
+{
+    if ( fabs(a->value) != fabs(b->value) )
+        return ( fabs(a->value) < fabs(b->value) );
+    if ( a->objType != b->objType ) return ( a->objType > b->objType );
+    return ( a->index > b->index );
+}
+
+//=============================================================================
 
 int stats_getNodeStat(int index, TNodeStats **nodeStats)
 //
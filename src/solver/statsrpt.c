@@ -9,6 +9,7 @@
 //             04/30/15 (Build 5.1.009)
 //             08/01/16 (Build 5.1.011)
 //             05/10/18 (Build 5.1.013)
+//             10/17/26 (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Report writing functions for summary statistics.
@@ -26,6 +27,13 @@
 //
 //   Build 5.1.013:
 //   - Pervious and impervious runoff added to Subcatchment Runoff Summary.
+//
+//   Build 5.1.015:
+//   - Setting the STATISTICS_TOP_N option limits the Subcatchment Runoff, Node
+//     Depth, Node Inflow, Node Surcharge, Node Flooding, Link Flow and Conduit
+//     Surcharge tables to their highest ranked elements, selected with a heap.
+//   - Table values are written with report_writeFixed instead of fprintf.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -67,11 +75,18 @@ void    writeFlowClass(void);
 void    writeLinkSurcharge(void);
 void    writePumpFlows(void);
 void    writeLinkLoads(void);
+static int  rankElements(int n);                                               //(5.1.015)
+static int  isLowerRank(int j, int k);                                         //(5.1.015)
+static void siftDown(int n, int k);                                            //(5.1.015)
+static void writeRankNote(char* elements, char* rankedBy);                     //(5.1.015)
 
 #define WRITE(x) (report_writeLine((x)))
 
-static char   FlowFmt[6];
+static int    FlowPrec;                                                        //(5.1.015)
 static double Vcf;
+static double* RankKey;      // value each element is ranked by (< 0 if     //(5.1.015)
+                             // the element is left out of a table)
+static int*    RankList;     // elements listed in a table, in rank order    //(5.1.015)
 
 //=============================================================================
 
@@ -82,9 +97,23 @@ void statsrpt_writeReport()
 //  Purpose: reports simulation summary statistics.
 //
 {
+    int n;
+
+    // --- allocate work arrays used to rank elements listed in tables      //(5.1.015)
+    n = MAX(Nobjects[SUBCATCH], MAX(Nobjects[NODE], Nobjects[LINK]));          //(5.1.015)
+    RankKey = (double *) calloc(n+1, sizeof(double));                          //(5.1.015)
+    RankList = (int *) calloc(n+1, sizeof(int));                               //(5.1.015)
+    if ( !RankKey || !RankList )                                               //(5.1.015)
+    {
+        FREE(RankKey);
+        FREE(RankList);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
     // --- set number of decimal places for reporting flow values
-    if ( FlowUnits == MGD || FlowUnits == CMS ) strcpy(FlowFmt, "%9.3f");
-    else strcpy(FlowFmt, "%9.2f");
+    if ( FlowUnits == MGD || FlowUnits == CMS ) FlowPrec = 3;                  //(5.1.015)
+    else FlowPrec = 2;                                                         //(5.1.015)
 
     // --- volume conversion factor from ft3 to Mgal or Mliters
     if (UnitSystem == US) Vcf = 7.48 / 1.0e6;
@@ -119,13 +148,15 @@ void statsrpt_writeReport()
         writePumpFlows();
         if ( Nobjects[POLLUT] > 0 && !IgnoreQuality) writeLinkLoads();
     }
+    FREE(RankKey);                                                             //(5.1.015)
+    FREE(RankList);                                                            //(5.1.015)
 }
 
 //=============================================================================
 
 void writeSubcatchRunoff()
 {
-    int    j;
+    int    i, j, n;                                                            //(5.1.015)
     double a, x, r;
 
     if ( Nobjects[SUBCATCH] == 0 ) return;
@@ -134,6 +165,7 @@ void writeSubcatchRunoff()
     WRITE("Subcatchment Runoff Summary");
     WRITE("***************************");
     WRITE("");
+    writeRankNote("subcatchments", "total runoff volume");                     //(5.1.015)
     fprintf(Frpt.file,
 
 ////////  Segment below modified for release 5.1.013.  /////////
@@ -152,32 +184,40 @@ void writeSubcatchRunoff()
 
 /////////////////////////////////////////////////////////////////
 
-    for ( j = 0; j < Nobjects[SUBCATCH]; j++ )
+    // --- rank subcatchments by runoff volume                               //(5.1.015)
+    for ( j = 0; j < Nobjects[SUBCATCH]; j++ )                                 //(5.1.015)
     {
+        if ( Subcatch[j].area == 0.0 ) RankKey[j] = -1.0;
+        else RankKey[j] = SubcatchStats[j].runoff;
+    }
+    n = rankElements(Nobjects[SUBCATCH]);                                      //(5.1.015)
+
+    for ( i = 0; i < n; i++ )                                                  //(5.1.015)
+    {
+        j = RankList[i];                                                       //(5.1.015)
         a = Subcatch[j].area;
-        if ( a == 0.0 ) continue;
         fprintf(Frpt.file, "\n  %-20s", Subcatch[j].ID);
         x = SubcatchStats[j].precip * UCF(RAINDEPTH);
-        fprintf(Frpt.file, " %10.2f", x/a);
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].runon * UCF(RAINDEPTH); 
-        fprintf(Frpt.file, " %10.2f", x/a);
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].evap * UCF(RAINDEPTH);
-        fprintf(Frpt.file, " %10.2f", x/a);
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].infil * UCF(RAINDEPTH); 
-        fprintf(Frpt.file, " %10.2f", x/a);
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].impervRunoff * UCF(RAINDEPTH);                    //(5.1.013)
-        fprintf(Frpt.file, " %10.2f", x/a);                                    //
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].pervRunoff * UCF(RAINDEPTH);                      //
-        fprintf(Frpt.file, " %10.2f", x/a);                                    //
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].runoff * UCF(RAINDEPTH);
-        fprintf(Frpt.file, " %10.2f", x/a);
+        report_writeFixed(" ", x/a, 10, 2);                                    //(5.1.015)
         x = SubcatchStats[j].runoff * Vcf;
-        fprintf(Frpt.file, "%12.2f", x);
+        report_writeFixed("", x, 12, 2);                                       //(5.1.015)
         x = SubcatchStats[j].maxFlow * UCF(FLOW);
-        fprintf(Frpt.file, " %8.2f", x);
+        report_writeFixed(" ", x, 8, 2);                                       //(5.1.015)
         r = SubcatchStats[j].precip + SubcatchStats[j].runon;
         if ( r > 0.0 ) r = SubcatchStats[j].runoff / r;
-        fprintf(Frpt.file, "%8.3f", r);
+        report_writeFixed("", r, 8, 3);                                        //(5.1.015)
     }
     WRITE("");
 }
@@ -232,7 +272,7 @@ void    writeGroundwater(void)
                totalSeconds;
         x[7] = Subcatch[j].groundwater->stats.finalUpperMoist;
         x[8] = Subcatch[j].groundwater->stats.finalWaterTable * UCF(LENGTH);
-        for (i = 0; i < 9; i++) fprintf(Frpt.file, " %8.2f", x[i]);
+        for (i = 0; i < 9; i++) report_writeFixed(" ", x[i], 8, 2);            //(5.1.015)
     }
     WRITE("");
 }
@@ -283,7 +323,7 @@ void writeSubcatchLoads()
                 x = Subcatch[j].totalLoad[p];
                 totals[p] += x;
                 if ( Pollut[p].units == COUNT ) x = LOG10(x);
-                fprintf(Frpt.file, "%14.3f", x); 
+                report_writeFixed("", x, 14, 3);                               //(5.1.015)
             }
         }
 
@@ -295,7 +335,7 @@ void writeSubcatchLoads()
         {
             x = totals[p];
             if ( Pollut[p].units == COUNT ) x = LOG10(x);
-            fprintf(Frpt.file, "%14.3f", x); 
+            report_writeFixed("", x, 14, 3);                                   //(5.1.015)
         }
         free(totals);
         WRITE("");
@@ -311,7 +351,7 @@ void writeNodeDepths()
 //  Purpose: writes simulation statistics for nodes to report file.
 //
 {
-    int j, days, hrs, mins;
+    int i, j, n, days, hrs, mins;                                              //(5.1.015)
     if ( Nobjects[LINK] == 0 ) return;
 
     WRITE("");
@@ -319,6 +359,7 @@ void writeNodeDepths()
     WRITE("Node Depth Summary");
     WRITE("******************");
     WRITE("");
+    writeRankNote("nodes", "maximum depth");                                   //(5.1.015)
 
     fprintf(Frpt.file,
 "\n  ---------------------------------------------------------------------------------"
@@ -331,8 +372,13 @@ void writeNodeDepths()
     fprintf(Frpt.file,
 "\n  ---------------------------------------------------------------------------------");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( j = 0; j < Nobjects[NODE]; j++ )                                     //(5.1.015)
+        RankKey[j] = NodeStats[j].maxDepth;
+    n = rankElements(Nobjects[NODE]);                                          //(5.1.015)
+
+    for ( i = 0; i < n; i++ )                                                  //(5.1.015)
     {
+        j = RankList[i];                                                       //(5.1.015)
         fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
         fprintf(Frpt.file, " %-9s ", NodeTypeWords[Node[j].type]);
         getElapsedTime(NodeStats[j].maxDepthDate, &days, &hrs, &mins);
@@ -354,7 +400,7 @@ void writeNodeFlows()
 //  Purpose: writes flow statistics for nodes to report file.
 //
 {
-    int j;
+    int i, j, n;                                                               //(5.1.015)
     int days1, hrs1, mins1;
 
     WRITE("");
@@ -362,6 +408,7 @@ void writeNodeFlows()
     WRITE("Node Inflow Summary");
     WRITE("*******************");
     WRITE("");
+    writeRankNote("nodes", "maximum total inflow");                            //(5.1.015)
 
     fprintf(Frpt.file,
 "\n  -------------------------------------------------------------------------------------------------"
@@ -374,13 +421,20 @@ void writeNodeFlows()
     fprintf(Frpt.file,
 "\n  -------------------------------------------------------------------------------------------------");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( j = 0; j < Nobjects[NODE]; j++ )                                     //(5.1.015)
+        RankKey[j] = NodeStats[j].maxInflow;
+    n = rankElements(Nobjects[NODE]);                                          //(5.1.015)
+
+    for ( i = 0; i < n; i++ )                                                  //(5.1.015)
     {
+        j = RankList[i];                                                       //(5.1.015)
         fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
         fprintf(Frpt.file, " %-9s", NodeTypeWords[Node[j].type]);
         getElapsedTime(NodeStats[j].maxInflowDate, &days1, &hrs1, &mins1);
-        fprintf(Frpt.file, FlowFmt, NodeStats[j].maxLatFlow * UCF(FLOW));
-        fprintf(Frpt.file, FlowFmt, NodeStats[j].maxInflow * UCF(FLOW));
+        report_writeFixed("", NodeStats[j].maxLatFlow * UCF(FLOW),             //(5.1.015)
+            9, FlowPrec);
+        report_writeFixed("", NodeStats[j].maxInflow * UCF(FLOW),              //(5.1.015)
+            9, FlowPrec);
         fprintf(Frpt.file, "  %4d  %02d:%02d", days1, hrs1, mins1);
         fprintf(Frpt.file, "%12.3g", NodeStats[j].totLatFlow * Vcf);
         fprintf(Frpt.file, "%12.3g", NodeInflow[j] * Vcf);
@@ -399,7 +453,7 @@ void writeNodeFlows()
 
 void writeNodeSurcharge()
 {
-    int    j, n = 0;
+    int    i, j, m, n = 0;                                                     //(5.1.015)
     double t, d1, d2;
 
     WRITE("");
@@ -407,11 +461,19 @@ void writeNodeSurcharge()
     WRITE("Node Surcharge Summary");
     WRITE("**********************");
     WRITE("");
+    writeRankNote("nodes", "hours surcharged");                                //(5.1.015)
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    // --- rank surcharged nodes by time surcharged                         //(5.1.015)
+    for ( j = 0; j < Nobjects[NODE]; j++ )                                     //(5.1.015)
     {
-        if ( Node[j].type == OUTFALL ) continue;
-        if ( NodeStats[j].timeSurcharged == 0.0 ) continue;
+        RankKey[j] = NodeStats[j].timeSurcharged;
+        if ( Node[j].type == OUTFALL || RankKey[j] == 0.0 ) RankKey[j] = -1.0;
+    }
+    m = rankElements(Nobjects[NODE]);                                          //(5.1.015)
+
+    for ( i = 0; i < m; i++ )                                                  //(5.1.015)
+    {
+        j = RankList[i];                                                       //(5.1.015)
         t = MAX(0.01, (NodeStats[j].timeSurcharged / 3600.0));
         if ( n == 0 )
         {
@@ -445,7 +507,7 @@ void writeNodeSurcharge()
 
 void writeNodeFlooding()
 {
-    int    j, n = 0;
+    int    i, j, m, n = 0;                                                     //(5.1.015)
     int    days, hrs, mins;
     double t;
 
@@ -454,11 +516,20 @@ void writeNodeFlooding()
     WRITE("Node Flooding Summary");
     WRITE("*********************");
     WRITE("");
+    writeRankNote("nodes", "total flood volume");                              //(5.1.015)
+
+    // --- rank flooded nodes by flood volume                               //(5.1.015)
+    for ( j = 0; j < Nobjects[NODE]; j++ )                                     //(5.1.015)
+    {
+        RankKey[j] = NodeStats[j].volFlooded;
+        if ( Node[j].type == OUTFALL ||
+             NodeStats[j].timeFlooded == 0.0 ) RankKey[j] = -1.0;
+    }
+    m = rankElements(Nobjects[NODE]);                                          //(5.1.015)
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( i = 0; i < m; i++ )                                                  //(5.1.015)
     {
-        if ( Node[j].type == OUTFALL ) continue;
-        if ( NodeStats[j].timeFlooded == 0.0 ) continue;
+        j = RankList[i];                                                       //(5.1.015)
         t = MAX(0.01, (NodeStats[j].timeFlooded / 3600.0));
 
         if ( n == 0 )
@@ -484,10 +555,11 @@ void writeNodeFlooding()
         }
         fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
         fprintf(Frpt.file, " %7.2f ", t);
-        fprintf(Frpt.file, FlowFmt, NodeStats[j].maxOverflow * UCF(FLOW));
+        report_writeFixed("", NodeStats[j].maxOverflow * UCF(FLOW),            //(5.1.015)
+            9, FlowPrec);
         getElapsedTime(NodeStats[j].maxOverflowDate, &days, &hrs, &mins);
         fprintf(Frpt.file, "   %4d  %02d:%02d", days, hrs, mins);
-        fprintf(Frpt.file, "%12.3f", NodeStats[j].volFlooded * Vcf);
+        report_writeFixed("", NodeStats[j].volFlooded * Vcf, 12, 3);           //(5.1.015)
         if ( RouteModel == DW )
             fprintf(Frpt.file, " %9.3f",
                 (NodeStats[j].maxDepth - Node[j].fullDepth) * UCF(LENGTH));
@@ -562,7 +634,8 @@ void writeStorageVolumes()
 
             getElapsedTime(StorageStats[k].maxVolDate, &days, &hrs, &mins);
             fprintf(Frpt.file, "    %4d  %02d:%02d  ", days, hrs, mins);
-            fprintf(Frpt.file, FlowFmt, StorageStats[k].maxFlow*UCF(FLOW));
+            report_writeFixed("", StorageStats[k].maxFlow*UCF(FLOW),           //(5.1.015)
+                9, FlowPrec);
         }
         WRITE("");
     }
@@ -635,7 +708,7 @@ void writeOutfallLoads()
             // --- print node ID, flow freq., avg. flow, max. flow & flow vol.
             fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
             x = 100.*flowCount/(double)StepCount;
-            fprintf(Frpt.file, "%7.2f", x);
+            report_writeFixed("", x, 7, 2);                                    //(5.1.015)
             freqSum += x;
             if ( flowCount > 0 )
                 x = OutfallStats[k].avgFlow*UCF(FLOW)/flowCount;
@@ -644,10 +717,12 @@ void writeOutfallLoads()
             flowSum += x;
 
             fprintf(Frpt.file, " ");
-            fprintf(Frpt.file, FlowFmt, x);
+            report_writeFixed("", x,                                           //(5.1.015)
+                9, FlowPrec);
             fprintf(Frpt.file, " ");
-            fprintf(Frpt.file, FlowFmt, OutfallStats[k].maxFlow*UCF(FLOW));
-            fprintf(Frpt.file, "%12.3f", NodeInflow[j] * Vcf);
+            report_writeFixed("", OutfallStats[k].maxFlow*UCF(FLOW),           //(5.1.015)
+                9, FlowPrec);
+            report_writeFixed("", NodeInflow[j] * Vcf, 12, 3);                 //(5.1.015)
             volSum += NodeInflow[j];
 
             // --- print load of each pollutant for outfall
@@ -656,7 +731,7 @@ void writeOutfallLoads()
                 x = OutfallStats[k].totalLoad[p] * LperFT3 * Pollut[p].mcf;
                 totals[p] += x;
                 if ( Pollut[p].units == COUNT ) x = LOG10(x);
-                fprintf(Frpt.file, "%14.3f", x); 
+                report_writeFixed("", x, 14, 3);                               //(5.1.015)
             }
         }
 
@@ -668,16 +743,18 @@ void writeOutfallLoads()
 
         fprintf(Frpt.file, "\n  System              %7.2f ",
             freqSum/outfallCount);
-        fprintf(Frpt.file, FlowFmt, flowSum);
+        report_writeFixed("", flowSum,                                         //(5.1.015)
+            9, FlowPrec);
         fprintf(Frpt.file, " ");
-        fprintf(Frpt.file, FlowFmt, MaxOutfallFlow*UCF(FLOW));
-        fprintf(Frpt.file, "%12.3f", volSum * Vcf);
+        report_writeFixed("", MaxOutfallFlow*UCF(FLOW),                        //(5.1.015)
+            9, FlowPrec);
+        report_writeFixed("", volSum * Vcf, 12, 3);                            //(5.1.015)
 
         for (p = 0; p < Nobjects[POLLUT]; p++)
         {
             x = totals[p];
             if ( Pollut[p].units == COUNT ) x = LOG10(x);
-            fprintf(Frpt.file, "%14.3f", x); 
+            report_writeFixed("", x, 14, 3);                                   //(5.1.015)
         }
         WRITE("");
         free(totals);
@@ -693,7 +770,7 @@ void writeLinkFlows()
 //  Purpose: writes simulation statistics for links to report file.
 //
 {
-    int    j, k, days, hrs, mins;
+    int    i, j, k, n, days, hrs, mins;                                        //(5.1.015)
     double v, fullDepth;
 
     if (Nobjects[LINK] == 0) return;
@@ -702,6 +779,7 @@ void writeLinkFlows()
     WRITE("Link Flow Summary");
     WRITE("********************");
     WRITE("");
+    writeRankNote("links", "maximum |flow|");                                  //(5.1.015)
 
     fprintf(Frpt.file,
         "\n  -----------------------------------------------------------------------------"
@@ -716,9 +794,14 @@ void writeLinkFlows()
     fprintf(Frpt.file,
         "\n  -----------------------------------------------------------------------------");
 
-    for (j = 0; j < Nobjects[LINK]; j++)
+    for (j = 0; j < Nobjects[LINK]; j++)                                       //(5.1.015)
+        RankKey[j] = fabs(LinkStats[j].maxFlow);
+    n = rankElements(Nobjects[LINK]);                                          //(5.1.015)
+
+    for (i = 0; i < n; i++)                                                    //(5.1.015)
     {
         // --- print link ID
+        j = RankList[i];                                                       //(5.1.015)
         k = Link[j].subIndex;
         fprintf(Frpt.file, "\n  %-20s", Link[j].ID);
 
@@ -729,7 +812,8 @@ void writeLinkFlows()
 
         // --- print max. flow & time of occurrence
         getElapsedTime(LinkStats[j].maxFlowDate, &days, &hrs, &mins);
-        fprintf(Frpt.file, FlowFmt, LinkStats[j].maxFlow*UCF(FLOW));
+        report_writeFixed("", LinkStats[j].maxFlow*UCF(FLOW),                  //(5.1.015)
+            9, FlowPrec);
         fprintf(Frpt.file, "  %4d  %02d:%02d", days, hrs, mins);
 
         // --- print max flow / flow capacity for pumps
@@ -752,7 +836,7 @@ void writeLinkFlows()
         {
             v = LinkStats[j].maxVeloc*UCF(LENGTH);
             if (v > 50.0) fprintf(Frpt.file, "    >50.00");
-            else fprintf(Frpt.file, "   %7.2f", v);
+            else report_writeFixed("   ", v, 7, 2);                            //(5.1.015)
             fprintf(Frpt.file, "  %6.2f", LinkStats[j].maxFlow / Link[j].qFull /
                 (double)Conduit[k].barrels);
         }
@@ -764,7 +848,7 @@ void writeLinkFlows()
             Orifice[k].type == BOTTOM_ORIFICE) fullDepth = 0.0;
         if (fullDepth > 0.0)
         {
-            fprintf(Frpt.file, "  %6.2f", LinkStats[j].maxDepth / fullDepth);
+            report_writeFixed("  ", LinkStats[j].maxDepth / fullDepth, 6, 2);  //(5.1.015)
         }
         else fprintf(Frpt.file, "        ");
     }
@@ -818,7 +902,7 @@ void writeFlowClass()
 
 void writeLinkSurcharge()
 {
-    int    i, j, n = 0;
+    int    i, j, k, m, n = 0;                                                  //(5.1.015)
     double t[5];
 
     WRITE("");
@@ -826,8 +910,12 @@ void writeLinkSurcharge()
     WRITE("Conduit Surcharge Summary");
     WRITE("*************************");
     WRITE("");
-    for ( j = 0; j < Nobjects[LINK]; j++ )
+    writeRankNote("conduits", "hours full at both ends");                      //(5.1.015)
+
+    // --- rank surcharged conduits by time full at both ends               //(5.1.015)
+    for ( j = 0; j < Nobjects[LINK]; j++ )                                     //(5.1.015)
     {
+        RankKey[j] = -1.0;
         if ( Link[j].type != CONDUIT ||
              Link[j].xsect.type == DUMMY ) continue; 
         t[0] = LinkStats[j].timeSurcharged / 3600.0;
@@ -835,8 +923,19 @@ void writeLinkSurcharge()
         t[2] = LinkStats[j].timeFullDnstream / 3600.0;
         t[3] = LinkStats[j].timeFullFlow / 3600.0;
         if ( t[0] + t[1] + t[2] + t[3] == 0.0 ) continue;
+        RankKey[j] = LinkStats[j].timeSurcharged;
+    }
+    m = rankElements(Nobjects[LINK]);                                          //(5.1.015)
+
+    for ( i = 0; i < m; i++ )                                                  //(5.1.015)
+    {
+        j = RankList[i];                                                       //(5.1.015)
+        t[0] = LinkStats[j].timeSurcharged / 3600.0;
+        t[1] = LinkStats[j].timeFullUpstream / 3600.0;
+        t[2] = LinkStats[j].timeFullDnstream / 3600.0;
+        t[3] = LinkStats[j].timeFullFlow / 3600.0;
         t[4] = LinkStats[j].timeCapacityLimited / 3600.0;
-        for (i=0; i<5; i++) t[i] = MAX(0.01, t[i]);
+        for (k=0; k<5; k++) t[k] = MAX(0.01, t[k]);                            //(5.1.015)
         if (n == 0)
         {
             fprintf(Frpt.file, 
@@ -948,9 +1047,134 @@ void writeLinkLoads()
         {
             x = Link[j].totalLoad[p] * LperFT3 * Pollut[p].mcf;
             if ( Pollut[p].units == COUNT ) x = LOG10(x);
-            if ( x < 10000. ) fprintf(Frpt.file, "%14.3f", x);
+            if ( x < 10000. ) report_writeFixed("", x, 14, 3);                 //(5.1.015)
             else fprintf(Frpt.file, "%14.3e", x);
         }
     }
     WRITE("");
 }
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int rankElements(int n)
+//
+//  Input:   n = number of elements
+//  Output:  returns number of elements placed in RankList
+//  Purpose: fills RankList with the elements to list in a summary table.
+//
+//  Elements with a negative RankKey value are left out. When StatsTopN is
+//  0 all other elements are listed in index order. Otherwise the StatsTopN
+//  elements with largest RankKey values are selected with a min-heap and
+//  then listed from largest to smallest, which takes O(n log StatsTopN)
+//  time rather than sorting all n elements.
+//
+{
+    int i, j, k, m = 0;
+
+    // --- list all elements in index order
+    if ( StatsTopN <= 0 )
+    {
+        for (j = 0; j < n; j++) if ( RankKey[j] >= 0.0 ) RankList[m++] = j;
+        return m;
+    }
+
+    // --- keep the StatsTopN highest ranked elements in a min-heap
+    for (j = 0; j < n; j++)
+    {
+        if ( RankKey[j] < 0.0 ) continue;
+        if ( m < StatsTopN )
+        {
+            k = m++;
+            while ( k > 0 )
+            {
+                i = (k - 1) / 2;
+                if ( !isLowerRank(j, RankList[i]) ) break;
+                RankList[k] = RankList[i];
+                k = i;
+            }
+            RankList[k] = j;
+        }
+        else if ( isLowerRank(RankList[0], j) )
+        {
+            RankList[0] = j;
+            siftDown(m, 0);
+        }
+    }
+
+    // --- sort the heap from highest to lowest rank
+    for (k = m-1; k > 0; k--)
+    {
+        j = RankList[0];
+        RankList[0] = RankList[k];
+        RankList[k] = j;
+        siftDown(k, 0);
+    }
+    return m;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int isLowerRank(int j, int k)
+//
+//  Input:   j, k = element indexes
+//  Output:  returns TRUE if element j ranks below element k
+//  Purpose: orders elements by decreasing RankKey value, with ties going
+//           to the element defined first.
+//
+{
+    if ( RankKey[j] != RankKey[k] ) return ( RankKey[j] < RankKey[k] );
+    return ( j > k );
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void siftDown(int n, int k)
+//
+//  Input:   n = number of elements in the heap stored in RankList
+//           k = heap position to sift down
+//  Output:  none
+//  Purpose: restores min-heap order of RankList below position k.
+//
+{
+    int child;
+    int j = RankList[k];
+
+    for (;;)
+    {
+        child = 2*k + 1;
+        if ( child >= n ) break;
+        if ( child + 1 < n &&
+             isLowerRank(RankList[child+1], RankList[child]) ) child++;
+        if ( !isLowerRank(RankList[child], j) ) break;
+        RankList[k] = RankList[child];
+        k = child;
+    }
+    RankList[k] = j;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void writeRankNote(char* elements, char* rankedBy)
+//
+//  Input:   elements = name of the type of element listed in a table
+//           rankedBy = name of the value elements are ranked by
+//  Output:  none
+//  Purpose: notes that only the highest ranked elements are listed in a
+//           summary table.
+//
+{
+    char msg[MAXMSG+1];
+
+    if ( StatsTopN <= 0 ) return;
+    sprintf(msg, "Only the %d %s with highest %s are listed.",
+            StatsTopN, elements, rankedBy);
+    WRITE(msg);
+}
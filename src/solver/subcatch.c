@@ -11,6 +11,7 @@
 //             08/01/16  (Build 5.1.011)
 //             03/14/17  (Build 5.1.012)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Subcatchment runoff functions.
@@ -45,6 +46,9 @@
 //   - Support added for monthly adjustment of subcatchment's depression
 //     storage, pervious N, and infiltration.
 //
+//   Build 5.1.015:
+//   - Monthly subarea adjustments use the month held in RunoffCalendar.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -1173,7 +1177,7 @@ void adjustSubareaParams(int i, int j)
      p = Subcatch[j].dStorePattern;
      if (p >= 0 && Pattern[p].type == MONTHLY_PATTERN)
      {
-         m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
+         m = RunoffCalendar.month - 1;                                         //(5.1.015)
          f = Pattern[p].factor[m];
          if (f >= 0.0) Dstore *= f;
      }
@@ -1182,7 +1186,7 @@ void adjustSubareaParams(int i, int j)
     p = Subcatch[j].nPervPattern;
     if (i == PERV && p >= 0 && Pattern[p].type == MONTHLY_PATTERN)
     {
-         m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
+         m = RunoffCalendar.month - 1;                                         //(5.1.015)
          f = Pattern[p].factor[m];
          if (f <= 0.0) Alpha = 0.0;
          else          Alpha /= f;
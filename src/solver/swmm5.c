@@ -8,6 +8,7 @@
 //             08/01/16  (Build 5.1.011)
 //             03/14/17  (Build 5.1.012)
 //             05/10/18  (Build 5.1.013)
+//             10/17/26  (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   This is the main module of the computational engine for Version 5 of
@@ -39,6 +40,10 @@
 //   - Support added for saving average results within a reporting period.
 //   - SWMM engine now always compiled to a shared object library.
 //
+//   Build 5.1.015:
+//   - A project's saved in-memory state is discarded when the project is
+//     closed.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -553,6 +558,8 @@ int DLLEXPORT swmm_report()
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 int DLLEXPORT swmm_close()
 //
 //  Input:   none
@@ -561,6 +568,7 @@ int DLLEXPORT swmm_close()
 //
 {
     if ( Fout.file ) output_close();
+    hotstart_deleteState();                                                    //(5.1.015)
     if ( IsOpenFlag ) project_close();
     report_writeSysTime();
     if ( Finp.file != NULL ) fclose(Finp.file);
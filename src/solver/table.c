@@ -6,6 +6,7 @@
 //   Date:     03/20/14   (Build 5.1.001)
 //             09/15/14   (Build 5.1.007)
 //             03/19/15   (Build 5.1.008)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Table (curve and time series) functions.
@@ -22,6 +23,12 @@
 //     table_getArea, and table_getInverseArea) were made thread-safe (thanks to
 //     suggestions by CHI).
 //
+//   Build 5.1.015:
+//   - Entries can be appended to a time series while a simulation runs, and a
+//     time series lookup past the end of a series continues from its last
+//     entry instead of re-scanning the series.
+//   - A time series' entries can be replaced between runs.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -217,6 +224,73 @@ int table_addEntry(TTable* table, double x, double y)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int table_appendEntries(TTable* table, int n, double* x, double* y)
+//
+//  Input:   table = pointer to a TTable structure
+//           n = number of entries to append
+//           x = x values (dates for a time series) in ascending order
+//           y = y values
+//  Output:  returns an error code
+//  Purpose: adds a block of x/y entries to the end of an in-memory table
+//           while a simulation is underway.
+//
+//  NOTE: entries are linked on after the table's last entry so its current
+//        position (thisEntry) and time series bracket remain valid.
+//
+{
+    int    i;
+    double dx, dxMin = table->dxMin;
+
+    // --- x values must continue the table's ascending sequence
+    for (i = 0; i < n; i++)
+    {
+        if ( i > 0 ) dx = x[i] - x[i-1];
+        else if ( table->lastEntry ) dx = x[0] - table->lastEntry->x;
+        else continue;
+        if ( dx <= 0.0 ) return ERR_TIMESERIES_SEQUENCE;
+        if ( dxMin == 0.0 || dx < dxMin ) dxMin = dx;
+    }
+
+    // --- link on the new entries
+    for (i = 0; i < n; i++)
+    {
+        if ( !table_addEntry(table, x[i], y[i]) ) return ERR_MEMORY;
+        if ( table->thisEntry == NULL ) table_tseriesInit(table);
+    }
+    table->dxMin = dxMin;
+    return 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int table_replaceEntries(TTable* table, int n, double* x, double* y)
+//
+//  Input:   table = pointer to a TTable structure
+//           n = number of new entries
+//           x = new x values in ascending order
+//           y = new y values
+//  Output:  returns an error code
+//  Purpose: replaces all of an in-memory table's entries between runs.
+//
+{
+    int i;
+
+    for (i = 1; i < n; i++)
+    {
+        if ( x[i] <= x[i-1] ) return ERR_TIMESERIES_SEQUENCE;
+    }
+    table_deleteEntries(table);
+    table->thisEntry = NULL;
+    table->dxMin = 0.0;
+    return table_appendEntries(table, n, x, y);
+}
+
+//=============================================================================
+
 void   table_deleteEntries(TTable *table)
 //
 //  Input:   table = pointer to a TTable structure
@@ -752,7 +826,13 @@ double table_tseriesLookup(TTable *table, double x, char extend)
 
     // --- x lies before current time bracket:
     //     move to start of time series
-    if ( table->x1 == table->x2 || x < table->x1 )
+    //     (a bracket collapsed onto the last entry read, as at the end of     //(5.1.015)
+    //     the series, is continued from that entry instead since entries
+    //     may have been appended after it)
+    if ( x < table->x1
+    ||   (table->x1 == table->x2
+          && (table->file.mode == USE_FILE || table->thisEntry == NULL
+              || table->thisEntry->x != table->x2)) )                          //(5.1.015)
     {
         table_getFirstEntry(table, &(table->x1), &(table->y1));
         if ( x < table->x1 )
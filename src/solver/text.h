@@ -15,9 +15,19 @@
 //            08/01/16  (Build 5.1.011)
 //            03/14/17  (Build 5.1.012)
 //            05/10/18  (Build 5.1.013)
+//            10/17/26  (Build 5.1.015)
 //   Author:  L. Rossman
 //
 //   Text strings
+//
+//   Build 5.1.015:
+//   - GEOMETRY_TBL_SIZE, STATISTICS_STRIDE and STATISTICS_TOP_N option
+//     keywords added.
+//   - LID_REPORT_FORMAT option keyword and its TEXT and BINARY values added.
+//   - PIPE interface file format keyword added.
+//   - QUANTIZE report keyword, its storage formats and result variables added.
+//   - FORCE_MAIN_TABLE option keyword added.
+//
 //-----------------------------------------------------------------------------
 
 #include "consts.h"
@@ -108,6 +118,11 @@
 #define  w_MIN_ROUTE_STEP    "MINIMUM_STEP"
 #define  w_NUM_THREADS       "THREADS"
 #define  w_SURCHARGE_METHOD  "SURCHARGE_METHOD"                                //(5.1.013)
+#define  w_GEOM_TBL_SIZE     "GEOMETRY_TBL_SIZE"                               //(5.1.015)
+#define  w_STATS_STRIDE      "STATISTICS_STRIDE"                               //(5.1.015)
+#define  w_STATS_TOP_N       "STATISTICS_TOP_N"                                //(5.1.015)
+#define  w_LID_RPT_FORMAT    "LID_REPORT_FORMAT"                               //(5.1.015)
+#define  w_FORCE_MAIN_TBL    "FORCE_MAIN_TABLE"                                //(5.1.015)
 
 // Flow Units
 #define  w_CFS               "CFS"
@@ -132,6 +147,29 @@
 #define  w_EXTRAN            "EXTRAN"
 #define  w_SLOT              "SLOT"
 
+// LID Report File Formats                                                     //(5.1.015)
+#define  w_TEXT              "TEXT"
+#define  w_BINARY            "BINARY"
+
+// Binary Output Storage Formats & Result Variables                            //(5.1.015)
+#define  w_QUANTIZE          "QUANTIZE"
+#define  w_FLOAT             "FLOAT"
+#define  w_HALF              "HALF"
+#define  w_INT16             "INT16"
+#define  w_SNOW_DEPTH        "SNOW_DEPTH"
+#define  w_EVAPORATION       "EVAPORATION"
+#define  w_INFILTRATION      "INFILTRATION"
+#define  w_GW_FLOW           "GW_FLOW"
+#define  w_GW_ELEV           "GW_ELEV"
+#define  w_SOIL_MOISTURE     "SOIL_MOISTURE"
+#define  w_WASHOFF           "WASHOFF"
+#define  w_LATERAL_INFLOW    "LATERAL_INFLOW"
+#define  w_TOTAL_INFLOW      "TOTAL_INFLOW"
+#define  w_FLOODING          "FLOODING"
+#define  w_QUALITY           "QUALITY"
+#define  w_VELOCITY          "VELOCITY"
+#define  w_CAPACITY          "CAPACITY"
+
 // Infiltration Methods
 #define  w_HORTON            "HORTON"
 #define  w_MOD_HORTON        "MODIFIED_HORTON"
@@ -330,6 +368,9 @@
 #define  w_INFLOWS           "INFLOWS"
 #define  w_OUTFLOWS          "OUTFLOWS"
 
+// Interface File Formats (besides TEXT & BINARY)                              //(5.1.015)
+#define  w_PIPE              "PIPE"
+
 // Miscellaneous Keywords
 #define  w_OFF               "OFF"
 #define  w_ON                "ON"
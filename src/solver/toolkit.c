@@ -148,6 +148,34 @@ int DLLEXPORT swmm_getAPIError(int errorCode, char **errorMsg)
 }
 
 
+int DLLEXPORT swmm_convertIfaceFile(const char* inFile, const char* outFile)
+///
+/// Input:   inFile = name of existing routing interface file
+///          outFile = name of routing interface file to create
+/// Return:  API Error
+/// Purpose: Converts a text routing interface file to binary or vice versa
+{
+    char f1[MAXFNAME+1];
+    char f2[MAXFNAME+1];
+
+    sstrncpy(f1, inFile, MAXFNAME);
+    sstrncpy(f2, outFile, MAXFNAME);
+    return error_getCode(iface_convertFile(f1, f2));
+}
+
+
+int DLLEXPORT swmm_deleteIfacePipes(void)
+///
+/// Input:   none
+/// Return:  API Error
+/// Purpose: Frees in-memory routing interface files (PIPE format) that
+///          no project run has read as its inflows file
+{
+    iface_deletePipes();
+    return 0;
+}
+
+
 int DLLEXPORT swmm_project_findObject(SM_ObjectType type, char *id, int *index)
 {
     int error_code_index = 0;
@@ -2837,6 +2865,174 @@ int DLLEXPORT swmm_setGagePrecip(int index, double total_precip)
     return error_getCode(error_code_index);
 }
 
+int DLLEXPORT swmm_appendTimeseries(int index, int n, double* dates,
+    double* values)
+///
+/// Input:   index = Index of desired time series
+///          n = number of data points to append
+///          dates = dates of data points (decimal days), in ascending order
+///          values = values of data points (in the series' input units)
+/// Return:  API Error
+/// Purpose: Appends data points to the end of a time series, before or
+///          during a simulation
+{
+    int error_code_index = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        error_code_index = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if object index is within bounds
+    else if (index < 0 || index >= Nobjects[TSERIES])
+    {
+        error_code_index = ERR_API_TSERIES_INDEX;
+    }
+    else if (n < 0 || (n > 0 && (dates == NULL || values == NULL)))
+    {
+        error_code_index = ERR_API_OUTBOUNDS;
+    }
+    // Series read from an external file cannot be extended
+    else if (Tseries[index].file.mode == USE_FILE)
+    {
+        error_code_index = ERR_API_WRONG_TYPE;
+    }
+    else
+    {
+        error_code_index = table_appendEntries(&Tseries[index], n, dates,
+            values);
+    }
+    return error_getCode(error_code_index);
+}
+
+int DLLEXPORT swmm_appendGageData(int index, int n, double* dates,
+    double* values)
+///
+/// Input:   index = Index of desired rain gage
+///          n = number of rainfall readings to append
+///          dates = dates of readings (decimal days), in ascending order
+///          values = rainfall readings (in the gage's rain format & units)
+/// Return:  API Error
+/// Purpose: Appends rainfall readings to the time series used by a rain gage
+{
+    int error_code_index = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        error_code_index = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if object index is within bounds
+    else if (index < 0 || index >= Nobjects[GAGE])
+    {
+        error_code_index = ERR_API_OBJECT_INDEX;
+    }
+    // Gage must get its rainfall from a time series
+    else if (Gage[index].dataSource != RAIN_TSERIES || Gage[index].tSeries < 0)
+    {
+        error_code_index = ERR_API_WRONG_TYPE;
+    }
+    else
+    {
+        return swmm_appendTimeseries(Gage[index].tSeries, n, dates, values);
+    }
+    return error_getCode(error_code_index);
+}
+
+int DLLEXPORT swmm_replaceTimeseries(int index, int n, double* dates,
+    double* values)
+///
+/// Input:   index = Index of desired time series
+///          n = number of data points
+///          dates = dates of data points (decimal days), in ascending order
+///          values = values of data points (in the series' input units)
+/// Return:  API Error
+/// Purpose: Replaces all of a time series' data points between runs
+{
+    int error_code_index = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        error_code_index = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if Simulation is Running
+    else if (swmm_IsStartedFlag() == TRUE)
+    {
+        error_code_index = ERR_API_SIM_NRUNNING;
+    }
+    // Check if object index is within bounds
+    else if (index < 0 || index >= Nobjects[TSERIES])
+    {
+        error_code_index = ERR_API_TSERIES_INDEX;
+    }
+    else if (n < 1 || dates == NULL || values == NULL)
+    {
+        error_code_index = ERR_API_OUTBOUNDS;
+    }
+    // Series read from an external file cannot be replaced
+    else if (Tseries[index].file.mode == USE_FILE)
+    {
+        error_code_index = ERR_API_WRONG_TYPE;
+    }
+    else
+    {
+        error_code_index = table_replaceEntries(&Tseries[index], n, dates,
+            values);
+    }
+    return error_getCode(error_code_index);
+}
+
+int DLLEXPORT swmm_saveState(void)
+///
+/// Return:  API Error
+/// Purpose: Saves the current state of a running simulation in memory so
+///          that a later run of the open project can start from it
+{
+    int error_code_index = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        error_code_index = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if Simulation is Running
+    else if (swmm_IsStartedFlag() == FALSE)
+    {
+        error_code_index = ERR_API_SIM_NRUNNING;
+    }
+    else
+    {
+        error_code_index = hotstart_saveState();
+    }
+    return error_getCode(error_code_index);
+}
+
+int DLLEXPORT swmm_restoreState(void)
+///
+/// Return:  API Error
+/// Purpose: Has the next simulation start from the state last saved with
+///          swmm_saveState (in place of any hot start file)
+{
+    int error_code_index = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        error_code_index = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if Simulation is Running
+    else if (swmm_IsStartedFlag() == TRUE)
+    {
+        error_code_index = ERR_API_SIM_NRUNNING;
+    }
+    else
+    {
+        error_code_index = hotstart_useState();
+    }
+    return error_getCode(error_code_index);
+}
+
 //-------------------------------
 // Utility Functions
 //-------------------------------
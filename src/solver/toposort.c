@@ -4,53 +4,55 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Topological sorting of conveyance network links
+//
+//   Build 5.1.015:
+//   - Links incident on each node listed in a reusable CSR graph, and cycles
+//     found with an iterative version of Tarjan's strongly connected
+//     components algorithm.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdlib.h>
 #include "headers.h"
 
-//-----------------------------------------------------------------------------
-//  Constants
-//-----------------------------------------------------------------------------
-enum AdjListType {UNDIRECTED, DIRECTED};    // type of nodal adjacency list
-
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
 static int* InDegree;                  // number of incoming links to each node
-static int* StartPos;                  // start of a node's outlinks in AdjList
-static int* AdjList;                   // list of outlink indexes for each node
 static int* Stack;                     // array of nodes "reached" during sorting
 static int  First;                     // position of first node in stack
 static int  Last;                      // position of last node added to stack
 
-static char* Examined;                 // TRUE if node included in spanning tree
-static char* InTree;                   // state of each link in spanning tree:
-                                       // 0 = unexamined,
-                                       // 1 = in spanning tree,
-                                       // 2 = chord of spanning tree
-static int*  LoopLinks;                // list of links which forms a loop
-static int   LoopLinksLast;            // number of links in a loop
+static int* Index;                     // order in which node was visited      //(5.1.015)
+static int* LowLink;                   // lowest Index reachable from node     //(5.1.015)
+static int* Component;                 // root node of node's strong component //(5.1.015)
+static int* CallNode;                  // nodes on depth-first search path     //(5.1.015)
+static int* CallPos;                   // next outlink to search from node     //(5.1.015)
+static int* PredLink;                  // link used to reach node in a cycle   //(5.1.015)
+static int* Queue;                     // nodes reached while tracing a cycle  //(5.1.015)
+static int* LoopLinks;                 // list of links which forms a loop
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
 //-----------------------------------------------------------------------------
-//  toposort_sortLinks (called by routing_open)
+//  toposort_sortLinks    (called by routing_open)
+//  toposort_createGraph  (called by toposort_sortLinks & createLevels)
+//  toposort_deleteGraph
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
-static void createAdjList(int listType);
-static void adjustAdjList(void);
-static int  topoSort(int sortedLinks[]);
-static void findCycles(void);
-static void findSpanningTree(int startNode);
-static void evalLoop(int startLink);
-static int  traceLoop(int i1, int i2, int k);
+static void adjustGraph(TGraph* graph);                                        //(5.1.015)
+static int  topoSort(TGraph* graph, int sortedLinks[]);                        //(5.1.015)
+static void findCycles(TGraph* graph);                                         //(5.1.015)
+static void findComponent(TGraph* graph, int startNode, int* count);           //(5.1.015)
+static int  findCycle(TGraph* graph, int root);                                //(5.1.015)
+static void reportCycle(int n);                                                //(5.1.015)
 static void checkDummyLinks(void);
 //=============================================================================
 
@@ -62,6 +64,7 @@ void toposort_sortLinks(int sortedLinks[])
 //
 {
     int i, n = 0;
+    TGraph graph = {0};                                                        //(5.1.015)
 
     // --- no need to sort links for Dyn. Wave routing
     for ( i=0; i<Nobjects[LINK]; i++) sortedLinks[i] = i;
@@ -96,100 +99,133 @@ void toposort_sortLinks(int sortedLinks[])
     // --- allocate arrays used for topo sorting
     if ( ErrorCode ) return;
     InDegree = (int *) calloc(Nobjects[NODE], sizeof(int));
-    StartPos = (int *) calloc(Nobjects[NODE], sizeof(int));
-    AdjList  = (int *) calloc(Nobjects[LINK], sizeof(int));
     Stack    = (int *) calloc(Nobjects[NODE], sizeof(int));
-    if ( InDegree == NULL || StartPos == NULL ||
-         AdjList == NULL || Stack == NULL )
+    if ( InDegree == NULL || Stack == NULL ||
+         !toposort_createGraph(&graph, OUTLINK_GRAPH, NULL) )                  //(5.1.015)
     {
         report_writeErrorMsg(ERR_MEMORY, "");
     }
     else
     {
-        // --- create a directed adjacency list of links leaving each node
-        createAdjList(DIRECTED);
+        // --- record number of links leaving each node                        //(5.1.015)
+        for (i = 0; i < Nobjects[NODE]; i++)                                   //(5.1.015)
+            Node[i].degree = graph.start[i+1] - graph.start[i];                //(5.1.015)
 
         // --- adjust adjacency list for DIVIDER nodes
-        adjustAdjList();
+        adjustGraph(&graph);                                                   //(5.1.015)
 
         // --- find number of links entering each node
         for (i = 0; i < Nobjects[NODE]; i++) InDegree[i] = 0;
         for (i = 0; i < Nobjects[LINK]; i++) InDegree[ Link[i].node2 ]++;
 
         // --- topo sort the links
-        n = topoSort(sortedLinks);
+        n = topoSort(&graph, sortedLinks);                                     //(5.1.015)
     }   
 
     // --- free allocated memory
     FREE(InDegree);
-    FREE(StartPos);
-    FREE(AdjList);
     FREE(Stack);
 
     // --- check that all links are included in SortedLinks
     if ( !ErrorCode &&  n != Nobjects[LINK] )
     {
         report_writeErrorMsg(ERR_LOOP, "");
-        findCycles();
+        findCycles(&graph);                                                    //(5.1.015)
     }
+    toposort_deleteGraph(&graph);                                              //(5.1.015)
 }
 
 //=============================================================================
 
-void createAdjList(int listType)
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int toposort_createGraph(TGraph* graph, int graphType, int links[])
 //
-//  Input:   lsitType = DIRECTED or UNDIRECTED
-//  Output:  none
-//  Purpose: creates listing of links incident on each node.
+//  Input:   graph = ptr. to a link-node graph
+//           graphType = OUTLINK_GRAPH, INLINK_GRAPH or UNDIRECTED_GRAPH
+//           links = order in which links are listed (NULL for index order)
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: creates a listing of the links incident on each node.
+//
+//  Notes:   The listing is one long vector containing the individual node
+//           lists one after the other, so the links incident on node i are
+//           graph->links[k] for graph->start[i] <= k < graph->start[i+1].
+//           An OUTLINK_GRAPH lists each link at its upstream node, an
+//           INLINK_GRAPH at its downstream node and an UNDIRECTED_GRAPH at
+//           both of its end nodes.
 //
 {
-    int i, j, k;
+    int  i, j, k;
+    int  nNodes = Nobjects[NODE];
+    int  nLinks = Nobjects[LINK];
+    int* pos;
+
+    // --- allocate memory
+    toposort_deleteGraph(graph);
+    if ( graphType == UNDIRECTED_GRAPH ) nLinks *= 2;
+    graph->start = (int *) calloc(nNodes+1, sizeof(int));
+    graph->links = (int *) calloc(MAX(nLinks, 1), sizeof(int));
+    pos = (int *) calloc(MAX(nNodes, 1), sizeof(int));
+    if ( graph->start == NULL || graph->links == NULL || pos == NULL )
+    {
+        FREE(pos);
+        toposort_deleteGraph(graph);
+        return FALSE;
+    }
+    graph->nNodes = nNodes;
+    graph->nLinks = nLinks;
 
-    // --- determine degree of each node
-    //     (for DIRECTED list only count link at its upstream node;
-    //      for UNDIRECTED list count link at both end nodes)
-    for (i = 0; i < Nobjects[NODE]; i++) Node[i].degree = 0;
+    // --- count the links incident on each node
     for (j = 0; j < Nobjects[LINK]; j++)
     {
-        Node[ Link[j].node1 ].degree++;
-        if ( listType == UNDIRECTED ) Node[ Link[j].node2 ].degree++;
+        if ( graphType != INLINK_GRAPH ) graph->start[Link[j].node1+1]++;
+        if ( graphType != OUTLINK_GRAPH ) graph->start[Link[j].node2+1]++;
     }
 
-    // --- determine start position of each node in the adjacency list
-    //     (the adjacency list, AdjList, is one long vector containing
-    //      the individual node lists one after the other)
-    StartPos[0] = 0;
-    for (i = 0; i < Nobjects[NODE]-1; i++)
+    // --- determine start position of each node's links
+    for (i = 0; i < nNodes; i++)
     {
-        StartPos[i+1] = StartPos[i] + Node[i].degree;
-        Node[i].degree = 0;
+        graph->start[i+1] += graph->start[i];
+        pos[i] = graph->start[i];
     }
-    Node[Nobjects[NODE]-1].degree = 0;
 
-    // --- traverse the list of links once more,
-    //     adding each link's index to the proper 
-    //     position in the adjacency list
-    for (j = 0; j < Nobjects[LINK]; j++)
+    // --- traverse the list of links once more, adding each link's
+    //     index to the proper position in the listing
+    for (k = 0; k < Nobjects[LINK]; k++)
     {
-        i = Link[j].node1;
-        k = StartPos[i] + Node[i].degree;
-        AdjList[k] = j;
-        Node[i].degree++;
-        if ( listType == UNDIRECTED )
-        {
-            i = Link[j].node2;
-            k = StartPos[i] + Node[i].degree;
-            AdjList[k] = j;
-            Node[i].degree++;
-        }
+        j = k;
+        if ( links ) j = links[k];
+        if ( graphType != INLINK_GRAPH )
+            graph->links[pos[Link[j].node1]++] = j;
+        if ( graphType != OUTLINK_GRAPH )
+            graph->links[pos[Link[j].node2]++] = j;
     }
+    FREE(pos);
+    return TRUE;
 }
 
 //=============================================================================
 
-void adjustAdjList()
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void toposort_deleteGraph(TGraph* graph)
 //
-//  Input:   none
+//  Input:   graph = ptr. to a link-node graph
+//  Output:  none
+//  Purpose: frees memory used by a link-node graph.
+//
+{
+    FREE(graph->start);
+    FREE(graph->links);
+    graph->nNodes = 0;
+    graph->nLinks = 0;
+}
+
+//=============================================================================
+
+void adjustGraph(TGraph* graph)
+//
+//  Input:   graph = ptr. to graph of links leaving each node
 //  Output:  none
 //  Purpose: adjusts adjacency list for Divider nodes so that non-
 //           diversion link appears before diversion link.
@@ -202,33 +238,33 @@ void adjustAdjList()
     {
         // --- skip nodes that are not Dividers
         if ( Node[i].type != DIVIDER ) continue;
-        if ( Node[i].degree != 2 ) continue;
+        if ( graph->start[i+1] - graph->start[i] != 2 ) continue;
 
         // --- switch position of outgoing links at the node if the
         //     diversion link appears first in the adjacency list
         k = Node[i].subIndex;
-        m = StartPos[i];
-        j = AdjList[m];
+        m = graph->start[i];
+        j = graph->links[m];
         if ( j == Divider[k].link )
         {
-            AdjList[m] = AdjList[m+1];
-            AdjList[m+1] = j;
+            graph->links[m] = graph->links[m+1];
+            graph->links[m+1] = j;
         }
     }
 }
 
 //=============================================================================
 
-int topoSort(int sortedLinks[])
+int topoSort(TGraph* graph, int sortedLinks[])
 //
-//  Input:   none
+//  Input:   graph = ptr. to graph of links leaving each node
 //  Output:  sortedLinks = array of sorted link indexes,
 //           returns number of links successfully sorted
 //  Purpose: performs a stack-based topo sort of the drainage network's links.
 //
 {
     int i, j, k, n;
-    int i1, i2, k1, k2;
+    int i1, i2;
 
     // --- initialize a stack which contains nodes with zero in-degree
     First = 0;
@@ -247,17 +283,12 @@ int topoSort(int sortedLinks[])
     n = 0;
     while ( First <= Last )
     {
-        // --- determine range of adjacency list indexes belonging to 
-        //     first node remaining on the stack
-        i1 = Stack[First];
-        k1 = StartPos[i1];
-        k2 = k1 + Node[i1].degree;
-
         // --- for each outgoing link from first node on stack
-        for (k = k1; k < k2; k++)
+        i1 = Stack[First];
+        for (k = graph->start[i1]; k < graph->start[i1+1]; k++)
         {
             // --- add link index to current position in SortedLinks
-            j = AdjList[k];
+            j = graph->links[k];
             sortedLinks[n] = j;
             n++;
 
@@ -279,200 +310,215 @@ int topoSort(int sortedLinks[])
 
 //=============================================================================
 
-void  findCycles()
+void  findCycles(TGraph* graph)
 //
-//  Input:   none
+//  Input:   graph = ptr. to graph of links leaving each node
 //  Output:  none
-//  Purpose: finds all cycles in the drainage network (i.e., closed loops that
-//           start and end at the same node).
+//  Purpose: finds and reports a cycle (i.e., a closed loop that starts
+//           and ends at the same node) in each strongly connected
+//           component of the drainage network.
+//
+//  Notes:   Components are found with an iterative version of Tarjan's
+//           algorithm, so both the search and the cycle tracing take
+//           time proportional to the size of the network.
 //
 {
-    int i;
+    int i, count;
+    int n = Nobjects[NODE];
 
     // --- allocate arrays
-    AdjList  = (int *) calloc(2*Nobjects[LINK], sizeof(int));
-    StartPos = (int *) calloc(Nobjects[NODE], sizeof(int));
-    Stack    = (int *) calloc(Nobjects[NODE], sizeof(int));
-    Examined = (char *) calloc(Nobjects[NODE], sizeof(char));
-    InTree   = (char *) calloc(Nobjects[LINK], sizeof(char));
+    Index     = (int *) calloc(n, sizeof(int));
+    LowLink   = (int *) calloc(n, sizeof(int));
+    Component = (int *) calloc(n, sizeof(int));
+    CallNode  = (int *) calloc(n, sizeof(int));
+    CallPos   = (int *) calloc(n, sizeof(int));
+    PredLink  = (int *) calloc(n, sizeof(int));
+    Queue     = (int *) calloc(n, sizeof(int));
+    Stack     = (int *) calloc(n, sizeof(int));
     LoopLinks = (int *) calloc(Nobjects[LINK], sizeof(int));
-    if ( StartPos && AdjList && Stack && Examined && InTree && LoopLinks )
+    if ( Index && LowLink && Component && CallNode && CallPos && PredLink &&
+         Queue && Stack && LoopLinks )
     {
-        // --- create an undirected adjacency list for the nodes
-        createAdjList(UNDIRECTED);
-
-        // --- set to empty the list of nodes examined and the list
-        //     of links in the spanning tree
-        for ( i=0; i<Nobjects[NODE]; i++) Examined[i] = 0;
-        for ( i=0; i<Nobjects[LINK]; i++) InTree[i] = 0;
+        // --- mark all nodes as unvisited
+        for ( i=0; i<n; i++)
+        {
+            Index[i] = -1;
+            Component[i] = -1;
+            PredLink[i] = -1;
+        }
 
-        // --- find a spanning tree for each unexamined node
-        //     (cycles are identified as tree is constructed)
-        for ( i=0; i<Nobjects[NODE]; i++)
+        // --- search for components from each unvisited node
+        count = 0;
+        Last = -1;
+        for ( i=0; i<n; i++)
         {
-            if ( Examined[i] ) continue;
-            Last = -1;
-            findSpanningTree(i);
+            if ( Index[i] < 0 ) findComponent(graph, i, &count);
         }
     }
-    FREE(StartPos);
-    FREE(AdjList);
+    FREE(Index);
+    FREE(LowLink);
+    FREE(Component);
+    FREE(CallNode);
+    FREE(CallPos);
+    FREE(PredLink);
+    FREE(Queue);
     FREE(Stack);
-    FREE(Examined);
-    FREE(InTree);
     FREE(LoopLinks);
 }
 
 //=============================================================================
 
-void  findSpanningTree(int startNode)
+void  findComponent(TGraph* graph, int startNode, int* count)
 //
-//  Input:   i = index of starting node of tree
-//  Output:  none
-//  Purpose: finds continuation of network's spanning tree of links.
+//  Input:   graph = ptr. to graph of links leaving each node
+//           startNode = index of an unvisited node
+//           count = number of nodes visited so far
+//  Output:  count = updated number of nodes visited
+//  Purpose: finds the strongly connected components reachable from a node
+//           and reports a cycle within each one.
 //
 {
-    int nextNode, j, k, m;
+    int top, v, w, n;
 
-    // --- examine each link connected to node i
-    for ( m = StartPos[startNode];
-          m < StartPos[startNode]+Node[startNode].degree; m++ )
-    {
-        // --- find which node (j) connects link k from start node
-        k = AdjList[m];
-        if ( Link[k].node1 == startNode ) j = Link[k].node2;
-        else j = Link[k].node1;
+    // --- start a depth-first search path at the start node
+    top = 0;
+    CallNode[0] = startNode;
+    CallPos[0] = graph->start[startNode];
+    Index[startNode] = LowLink[startNode] = (*count)++;
+    Stack[++Last] = startNode;
 
-        // --- if link k is not in the tree
-        if ( InTree[k] == 0 )
+    while ( top >= 0 )
+    {
+        // --- follow the next link leaving the node at the end of the path
+        v = CallNode[top];
+        if ( CallPos[top] < graph->start[v+1] )
         {
-            // --- if connecting node already examined,
-            //     then link k forms a loop; mark it as a chord
-            //     and check if loop forms a cycle
-            if ( Examined[j] )
+            w = Link[graph->links[CallPos[top]]].node2;
+            CallPos[top]++;
+
+            // --- extend the path to the link's downstream node if
+            //     it has not been visited yet
+            if ( Index[w] < 0 )
             {
-                InTree[k] = 2;
-                evalLoop(k);
+                Index[w] = LowLink[w] = (*count)++;
+                Stack[++Last] = w;
+                top++;
+                CallNode[top] = w;
+                CallPos[top] = graph->start[w];
             }
 
-            // --- otherwise mark connected node as being examined,
-            //     add it to the node stack, and mark the connecting
-            //     link as being in the spanning tree
-            else
+            // --- otherwise if the node is still on the stack it belongs
+            //     to the same component as the current node
+            else if ( Component[w] < 0 )
             {
-                Examined[j] = 1;
-                Last++;
-                Stack[Last] = j;
-                InTree[k] = 1;
+                LowLink[v] = MIN(LowLink[v], Index[w]);
             }
         }
-    }
 
-    // --- continue to grow the spanning tree from
-    //     the last node added to the stack
-    if ( Last >= 0 )
-    {
-        nextNode = Stack[Last];
-        Last--;
-        findSpanningTree(nextNode);
+        // --- all links leaving the node have been searched
+        else
+        {
+            top--;
+            if ( top >= 0 )
+            {
+                w = CallNode[top];
+                LowLink[w] = MIN(LowLink[w], LowLink[v]);
+            }
+
+            // --- node is the root of a component: pop the component's
+            //     nodes off the stack and report a cycle through them
+            if ( LowLink[v] == Index[v] )
+            {
+                do
+                {
+                    w = Stack[Last--];
+                    Component[w] = v;
+                } while ( w != v );
+                n = findCycle(graph, v);
+                if ( n > 0 ) reportCycle(n);
+            }
+        }
     }
 }
 
 //=============================================================================
 
-void evalLoop(int startLink)
+int  findCycle(TGraph* graph, int root)
 //
-//  Input:   startLink = index of starting link of a loop
-//  Output:  none
-//  Purpose: checks if loop starting with a given link forms a closed cycle.
+//  Input:   graph = ptr. to graph of links leaving each node
+//           root = root node of a strongly connected component
+//  Output:  returns number of links in the cycle saved to LoopLinks
+//           (0 if the component has no cycle)
+//  Purpose: finds the shortest cycle that starts and ends at the root node
+//           of a strongly connected component.
 //
 {
-    int i;                             // loop list index
-    int i1, i2;                        // start & end node indexes
-    int j;                             // index of link in loop
-    int kount;                         // items per line counter
-    int isCycle;                       // TRUE if loop forms a cycle
-
-    // --- make startLink the first link in the loop
-    LoopLinksLast = 0;
-    LoopLinks[0] = startLink;
-
-    // --- trace a path on the spanning tree that starts at the
-    //     tail node of startLink and ends at its head node
-    i1 = Link[startLink].node1;
-    i2 = Link[startLink].node2;
-    if ( !traceLoop(i1, i2, startLink) ) return;
-
-    // --- check if all links on the path are oriented head-to-tail
-    isCycle = TRUE;
-    j = LoopLinks[0];
-    i2 = Link[j].node2;
-    for (i=1; i<=LoopLinksLast; i++)
-    {
-        j = LoopLinks[i];
-        i1 = Link[j].node1;
-        if ( i1 == i2 ) i2 = Link[j].node2;
-        else
-        {
-            isCycle = FALSE;
-            break;
-        }
-    }
+    int i, j, k, n, v, w;
+    int first = 0;
+    int last = 0;
 
-    // --- print cycle to report file
-    if ( isCycle )
+    // --- search outward from the root through the component's nodes
+    Queue[0] = root;
+    while ( first <= last )
     {
-        kount = 0;
-        for (i = 0; i <= LoopLinksLast; i++)
+        v = Queue[first++];
+        for (k = graph->start[v]; k < graph->start[v+1]; k++)
         {
-            if ( kount % 5 == 0 ) fprintf(Frpt.file, "\n");
-            kount++;
-            fprintf(Frpt.file, "  %s", Link[LoopLinks[i]].ID);
-            if ( i < LoopLinksLast ) fprintf(Frpt.file, "  -->");
+            j = graph->links[k];
+            w = Link[j].node2;
+            if ( Component[w] != root ) continue;
+
+            // --- link returns to the root: list the cycle's links
+            //     from the root back to itself
+            if ( w == root )
+            {
+                n = 0;
+                LoopLinks[n++] = j;
+                while ( v != root )
+                {
+                    j = PredLink[v];
+                    LoopLinks[n++] = j;
+                    v = Link[j].node1;
+                }
+                for (i = 0; i < n/2; i++)
+                {
+                    j = LoopLinks[i];
+                    LoopLinks[i] = LoopLinks[n-1-i];
+                    LoopLinks[n-1-i] = j;
+                }
+                return n;
+            }
+
+            // --- otherwise add newly reached node to the queue
+            if ( PredLink[w] < 0 )
+            {
+                PredLink[w] = j;
+                Queue[++last] = w;
+            }
         }
     }
+    return 0;
 }
 
 //=============================================================================
 
-int traceLoop(int i1, int i2, int k1)
+void reportCycle(int n)
 //
-//  Input:   i1 = index of current node reached while tracing a loop
-//           i2 = index of final node on the loop
-//           k1 = index of link which extends loop to node i1
-//  Output:  returns TRUE if loop can be extended through node i1
-//  Purpose: tries to extend closed loop through current node.
+//  Input:   n = number of links in the cycle saved to LoopLinks
+//  Output:  none
+//  Purpose: prints the links that form a cycle to the report file.
 //
 {
-    int j, k, m;
-
-    // --- if current node equals final node then return with loop found
-    if ( i1 == i2 ) return TRUE;
+    int i;
+    int kount = 0;                     // items per line counter
 
-    // --- examine each link connected to current node
-    for (m = StartPos[i1]; m < StartPos[i1] + Node[i1].degree; m++)
+    for (i = 0; i < n; i++)
     {
-        // --- ignore link if it comes from predecessor node or if
-        //     it is not on the spanning tree
-        k = AdjList[m];
-        if ( k == k1 || InTree[k] != 1 ) continue;
-
-        // --- identify other node that link is connected to
-        if ( Link[k].node1 == i1 ) j = Link[k].node2;
-        else                       j = Link[k].node1;
-
-        // --- try to continue tracing the loop from this node;
-        //     if successful, then add link to loop and return
-        if ( traceLoop(j, i2, k) )
-        {
-            LoopLinksLast++;
-            LoopLinks[LoopLinksLast] = k;
-            return TRUE;
-        }
+        if ( kount % 5 == 0 ) fprintf(Frpt.file, "\n");
+        kount++;
+        fprintf(Frpt.file, "  %s", Link[LoopLinks[i]].ID);
+        if ( i < n-1 ) fprintf(Frpt.file, "  -->");
     }
-
-    // --- return false if loop cannot be continued from current node
-    return FALSE;
 }
 
 //=============================================================================
@@ -4,9 +4,16 @@
 //   Project:  EPA SWMM5
 //   Version:  5.1
 //   Date:     03/20/14   (Build 5.1.001)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman
 //
 //   Geometry processing for irregular cross-section transects.
+//
+//   Build 5.1.015:
+//   - Geometry at a given elevation computed separately from table building
+//     and adaptive geometry tables with entries at each station elevation
+//     added.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -35,6 +42,8 @@ static double  Xrightbank;             // station where right overbank begins
 static double  Xfactor;                // multiplier for station spacing
 static double  Yfactor;                // factor added to station elevations
 static double  Lfactor;                // main channel/flood plain length
+static double  Ybottom;                // elevation of transect bottom        //(5.1.015)
+static double  Ybreaks[MAXSTATION+1];  // normalized depths of station elevs. //(5.1.015)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
@@ -51,7 +60,10 @@ static int    setParams(int transect, char* id, double x[]);
 static int    setManning(double n[]);
 static int    addStation(double x, double y);
 static double getFlow(int k, double a, double wp, int findFlow);
-static void   getGeometry(int i, int j, double y);
+static void   getGeometry(double y, double *a, double *r, double *w);       //(5.1.015)
+static int    getGeomTbl(int n, double y[], double a[], double r[],          //(5.1.015)
+              double w[], void* p);
+static int    compareDepths(const void* p1, const void* p2);                  //(5.1.015)
 static void   getSliceGeom(int k, double y, double yu, double yd, double *w,
               double *a, double *wp);
 static void   setMaxSectionFactor(int transect);
@@ -85,7 +97,11 @@ void transect_delete(void)
 //  Purpose: deletes memory allocated for all transects.
 //
 {
+    int j;
+
     if ( Ntransects == 0 ) return;
+    for (j = 0; j < Ntransects; j++)                                           //(5.1.015)
+        xsect_deleteGeomTbl(&Transect[j].geom);                                //(5.1.015)
     FREE(Transect);
     Ntransects = 0;
 }
@@ -191,6 +207,7 @@ void  transect_validate(int j)
 {
     int    i, nLast;
     double dy, y, ymin, ymax;
+    double a, r, w;                                                            //(5.1.015)
     double oldNchannel = Nchannel;
 
     // --- check for valid transect data
@@ -258,15 +275,13 @@ void  transect_validate(int j)
     for (i = 1; i < Transect[j].nTbl; i++)
     {
         y += dy;
-        Transect[j].areaTbl[i] = 0.0;
-        Transect[j].hradTbl[i] = 0.0;
-        Transect[j].widthTbl[i] = 0.0;
-        getGeometry(i, j, y);
+        getGeometry(y, &a, &r, &w);                                            //(5.1.015)
+        Transect[j].areaTbl[i] = a;                                            //(5.1.015)
+        Transect[j].widthTbl[i] = w;                                           //(5.1.015)
+        if ( a == 0.0 ) Transect[j].hradTbl[i] = Transect[j].hradTbl[i-1];     //(5.1.015)
+        else Transect[j].hradTbl[i] = r;                                       //(5.1.015)
     }
 
-    // --- determine max. section factor 
-    setMaxSectionFactor(j);
-
     // --- normalize geometry table entries
     //     (full cross-section values are last table entries)
     nLast = Transect[j].nTbl - 1;
@@ -284,6 +299,24 @@ void  transect_validate(int j)
     // --- set width at 0 height equal to width at 4% of max. height
     Transect[j].widthTbl[0] = Transect[j].widthTbl[1];
 
+    // --- build the adaptive geometry tables used in computations, with     //(5.1.015)
+    //     entries at each station elevation where the width profile breaks
+    Ybottom = ymin;                                                            //(5.1.015)
+    for (i = 1; i < Nstations; i++)                                            //(5.1.015)
+        Ybreaks[i-1] = (Elev[i] - ymin) / Transect[j].yFull;                   //(5.1.015)
+    qsort(Ybreaks, Nstations-1, sizeof(double), compareDepths);                //(5.1.015)
+    if ( !xsect_createGeomTbl(&Transect[j].geom, Nstations-1, Ybreaks,         //(5.1.015)
+        Transect[j].wMax * Transect[j].yFull / Transect[j].aFull,
+        getGeomTbl, &Transect[j]) )
+    {                                                                          //(5.1.015)
+        report_writeErrorMsg(ERR_MEMORY, "");                                  //(5.1.015)
+        return;                                                                //(5.1.015)
+    }                                                                          //(5.1.015)
+    Transect[j].geom.wMin = Transect[j].widthTbl[0];                           //(5.1.015)
+
+    // --- determine max. section factor from the adaptive tables              //(5.1.015)
+    setMaxSectionFactor(j);                                                    //(5.1.015)
+
     // --- save unadjusted main channel roughness 
     Transect[j].roughness = oldNchannel;
 }
@@ -366,13 +399,13 @@ int  addStation(double y, double x)
 
 //=============================================================================
 
-void  getGeometry(int i, int j, double y)
+void  getGeometry(double y, double *aTotal, double *rTotal, double *wTotal)
 //
-//  Input:   i = index of current entry in geometry tables
-//           j = transect index
-//           y = depth of current entry in geometry tables
-//  Output:  none
-//  Purpose: computes entries in a transect's geometry tables at a given depth. 
+//  Input:   y = water surface elevation
+//  Output:  aTotal = flow area (ft2)
+//           rTotal = hydraulic radius (ft)
+//           wTotal = top width (ft)
+//  Purpose: computes a transect's geometry at a given water elevation.
 //
 {
     int    k;                // station index
@@ -391,6 +424,9 @@ void  getGeometry(int i, int j, double y)
     wpSum = 0.0;
     aSum = 0.0;
     qSum = 0.0;
+    *aTotal = 0.0;
+    *rTotal = 0.0;
+    *wTotal = 0.0;
 
     // --- examine each horizontal station from left to right
     for (k = 1; k <= Nstations; k++)
@@ -417,8 +453,8 @@ void  getGeometry(int i, int j, double y)
         // --- update total transect values
         wpSum += wp;
         aSum += a;
-        Transect[j].areaTbl[i] += a;
-        Transect[j].widthTbl[i] += w;
+        *aTotal += a;
+        *wTotal += w;
 
         // --- must update flow if station elevation is above water level
         if ( Elev[k] >= y ) findFlow = TRUE;
@@ -435,11 +471,59 @@ void  getGeometry(int i, int j, double y)
 
     }   // next station k 
 
-    // --- find hyd. radius table entry solving Manning eq. with
-    //     total flow, total area, and main channel n
-    aSum = Transect[j].areaTbl[i];
-    if ( aSum == 0.0 ) Transect[j].hradTbl[i] = Transect[j].hradTbl[i-1];
-    else Transect[j].hradTbl[i] = pow(qSum * Nchannel / 1.49 / aSum, 1.5);
+    // --- find hyd. radius solving Manning eq. with total flow,
+    //     total area, and main channel n
+    if ( *aTotal > 0.0 )
+        *rTotal = pow(qSum * Nchannel / 1.49 / *aTotal, 1.5);
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int  getGeomTbl(int n, double y[], double a[], double r[], double w[], void* p)
+//
+//  Input:   n = number of depths
+//           y = increasing depths normalized by full depth
+//           p = pointer to the transect being validated
+//  Output:  a = normalized area at each depth
+//           r = normalized hydraulic radius at each depth
+//           w = normalized top width at each depth
+//           returns TRUE
+//  Purpose: evaluates the geometry of the transect being validated when
+//           building its adaptive geometry tables.
+//
+{
+    int        i;
+    TTransect* transect = (TTransect *)p;
+
+    for (i = 0; i < n; i++)
+    {
+        getGeometry(Ybottom + y[i] * transect->yFull, &a[i], &r[i], &w[i]);
+        a[i] /= transect->aFull;
+        r[i] /= transect->rFull;
+        w[i] /= transect->wMax;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int  compareDepths(const void* p1, const void* p2)
+//
+//  Input:   p1, p2 = pointers to two depths
+//  Output:  returns -1, 0 or 1 if first depth is below, at or above second
+//  Purpose: comparison function used to sort station depths.
+//
+{
+    double y1 = *(const double *)p1;
+    double y2 = *(const double *)p2;
+
+    if ( y1 < y2 ) return -1;
+    if ( y1 > y2 ) return 1;
+    return 0;
 }
 
 //=============================================================================
@@ -545,6 +629,8 @@ double getFlow(int k, double a, double wp, int findFlow)
 
 //=============================================================================
 
+////  This function was modified for release 5.1.015.  ////                    //(5.1.015)
+
 void setMaxSectionFactor(int j)
 //
 //  Input:   j = transect index
@@ -553,20 +639,11 @@ void setMaxSectionFactor(int j)
 //           area where this maxumum occurs.
 //
 {
-    int    i;
-    double sf;
+    double a;                                                                  //(5.1.015)
 
-    Transect[j].aMax = 0.0;
-    Transect[j].sMax = 0.0;
-    for (i=1; i<Transect[j].nTbl; i++)
-    {
-        sf = Transect[j].areaTbl[i] * pow(Transect[j].hradTbl[i], 2./3.);
-        if ( sf > Transect[j].sMax )
-        {
-            Transect[j].sMax = sf;
-            Transect[j].aMax = Transect[j].areaTbl[i];
-        }
-    }
+    Transect[j].sMax = xsect_getGeomTblSmax(&Transect[j].geom, &a) *           //(5.1.015)
+                       Transect[j].aFull * pow(Transect[j].rFull, 2./3.);      //(5.1.015)
+    Transect[j].aMax = a * Transect[j].aFull;                                  //(5.1.015)
 }
 
 //=============================================================================
@@ -6,6 +6,7 @@
 //   Date:     03/20/14   (Build 5.1.001)
 //             03/14/17   (Build 5.1.012)
 //             05/10/18   (Build 5.1.013)
+//             10/17/26   (Build 5.1.015)
 //   Author:   L. Rossman (EPA)
 //             M. Tryby (EPA)
 //
@@ -31,16 +32,31 @@
 //
 //   Build 5.1.013:
 //   - Width at full height set to 0 for closed rectangular shape.
+//
+//   Build 5.1.015:
+//   - Inverse geometry tables replace root finding in getAofS and getYcrit for
+//     shapes lacking a closed form or tabulated inverse.
+//   - Adaptive geometry tables with an indexed lookup used for irregular and
+//     custom shapes.
+//   - Batched evaluation of area and hyd. radius for sections of a common
+//     shape added (xsect_getAandRofY).
+//   - Batched evaluation of section factor and its derivative for sections
+//     of a common shape added (xsect_getSanddSdA).
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <math.h>
+#include <stdlib.h>                                                            //(5.1.015)
+#include <string.h>                                                            //(5.1.015)
 #include "headers.h"
 #include "findroot.h"
 
 #define  RECT_ALFMAX        0.97
 #define  RECT_TRIANG_ALFMAX 0.98
 #define  RECT_ROUND_ALFMAX  0.98
+#define  GEOM_TBL_TOL       0.001    // accuracy of geometry table entries      //(5.1.015)
+#define  GEOM_TBL_PASSES    8        // max. refinements of geometry tables     //(5.1.015)
 
 #include "xsect.dat"    // File containing geometry tables for rounded shapes
 
@@ -86,6 +102,21 @@ typedef struct
     TXsect* xsect;            // pointer to a cross section object
 } TXsectStar;
 
+// Inverse geometry tables built for a particular cross section geometry
+// (cross sections of identical shape & size share the same tables)
+typedef struct XsectTblNode
+{
+    TXsect     xsect;         // geometry the tables were built for
+    TXsectTbl  aOfS;          // area v. section factor table
+    TXsectTbl  yCrit;         // critical depth v. critical flow table
+    int        hasAofS;       // TRUE if aOfS table is valid
+    int        hasYcrit;      // TRUE if yCrit table is valid
+    struct XsectTblNode* next;
+} TXsectTblNode;
+
+#define  XSECT_HASH_SIZE 1021 // number of buckets in table hash
+static TXsectTblNode* XsectTblHash[XSECT_HASH_SIZE];
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -103,15 +134,43 @@ typedef struct
 //  xsect_getRofY
 //  xsect_getWofY
 //  xsect_getYcrit
+//  xsect_deleteTables
+//  xsect_createGeomTbl
+//  xsect_deleteGeomTbl
+//  xsect_getGeomTblSmax
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static double generic_getAofS(TXsect* xsect, double s);
+static void   setTables(TXsect* xsect);
+static int    sameGeometry(TXsect* x1, TXsect* x2);
+static unsigned int hashGeometry(TXsect* xsect);
+static int    buildAofSTable(TXsect* xsect, TXsectTbl* tbl);
+static int    buildYcritTable(TXsect* xsect, TXsectTbl* tbl);
+static void   setTableSlopes(TXsectTbl* tbl);
+static double endSlope(double h1, double h2, double s1, double s2);
+static double tableLookup(TXsectTbl* tbl, double u);
+static int    refineGeomTbl(int* n, int nMax, int canRefine, double y[],
+              double yNew[], double a[], double r[], double w[],
+              double aScale, int (*getGeom)(int n, double y[], double a[],
+              double r[], double w[], void* p), void* p);
+static int    saveGeomTbl(TGeomTbl* tbl, int n, double y[], double a[],
+              double r[], double w[]);
+static void   setGeomTblIndex(int n, int nBuckets, double x[], int index[]);
+static int    geomLocate(TGeomTbl* tbl, double x, double table[],
+              int index[]);
+static double geomGetAofY(TGeomTbl* tbl, double y);
+static double geomGetYofA(TGeomTbl* tbl, double a);
+static double geomLookup(TGeomTbl* tbl, double y, double* table);
 static void   evalSofA(double a, double* f, double* df, void* p);
 static double tabular_getdSdA(TXsect* xsect, double a, double *table, int nItems);
 static double generic_getdSdA(TXsect* xsect, double a);
+static void   tabular_getSanddSdA(TXsect* xsect, double a, double *table,      //(5.1.015)
+              int nItems, double* s, double* dsda);                            //(5.1.015)
 static double lookup(double x, double *table, int nItems);
+static void   lookupPair(double x, double *table1, double *table2,             //(5.1.015)
+              int nItems, double* y1, double* y2);                             //(5.1.015)
 static double invLookup(double y, double *table, int nItems);
 static int    locate(double y, double *table, int nItems);
 
@@ -221,6 +280,8 @@ int xsect_setParams(TXsect *xsect, int type, double p[], double ucf)
 
     if ( type != DUMMY && p[0] <= 0.0 ) return FALSE;
     xsect->type  = type;
+    xsect->aOfS  = NULL;                                                       //(5.1.015)
+    xsect->yCrit = NULL;                                                       //(5.1.015)
     switch ( xsect->type )
     {
     case DUMMY:
@@ -621,6 +682,10 @@ int xsect_setParams(TXsect *xsect, int type, double p[], double ucf)
         xsect->ywMax = 0.28 * xsect->yFull;
         break;
     }
+
+    // --- build inverse geometry tables (for irregular and custom shapes   //(5.1.015)
+    //     this is done once their transect or shape curve is assigned)
+    if ( type != IRREGULAR && type != CUSTOM ) setTables(xsect);               //(5.1.015)
     return TRUE;
 }
 
@@ -658,6 +723,9 @@ void xsect_setIrregXsectParams(TXsect *xsect)
 
     // Determine height at lowest widest point
     xsect->ywMax = xsect->yFull * (double)iMax / (double)(N_TRANSECT_TBL-1);
+
+    // Build inverse geometry tables                                           //(5.1.015)
+    setTables(xsect);                                                          //(5.1.015)
 }
 
 //=============================================================================
@@ -694,6 +762,9 @@ void xsect_setCustomXsectParams(TXsect *xsect)
 
     // Determine height at lowest widest point
     xsect->ywMax = yFull * (double)iMax / (double)(N_SHAPE_TBL-1);
+
+    // Build inverse geometry tables                                           //(5.1.015)
+    setTables(xsect);                                                          //(5.1.015)
 }
 
 //=============================================================================
@@ -816,12 +887,12 @@ double xsect_getYofA(TXsect *xsect, double a)
         return xsect->yFull * invLookup(alpha, A_VertEllipse, N_A_VertEllipse);
 
       case IRREGULAR:
-        return xsect->yFull * invLookup(alpha,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+        return xsect->yFull * geomGetYofA(                                    //(5.1.015)
+            &Transect[xsect->transect].geom, alpha);                           //(5.1.015)
 
       case CUSTOM:
-        return xsect->yFull * invLookup(alpha,
-            Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
+        return xsect->yFull * geomGetYofA(                                    //(5.1.015)
+            &Shape[Curve[xsect->transect].refersTo].geom, alpha);              //(5.1.015)
 
       case ARCH:
         return xsect->yFull * invLookup(alpha, A_Arch, N_A_Arch);
@@ -900,12 +971,12 @@ double xsect_getAofY(TXsect *xsect, double y)
         return xsect->aFull * lookup(yNorm, A_Arch, N_A_Arch);
 
       case IRREGULAR:
-        return xsect->aFull * lookup(yNorm,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+        return xsect->aFull * geomGetAofY(                                    //(5.1.015)
+            &Transect[xsect->transect].geom, yNorm);                           //(5.1.015)
 
       case CUSTOM:
-        return xsect->aFull * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
+        return xsect->aFull * geomGetAofY(                                    //(5.1.015)
+            &Shape[Curve[xsect->transect].refersTo].geom, yNorm);              //(5.1.015)
 
      case RECT_CLOSED:  return y * xsect->wMax;
 
@@ -940,6 +1011,7 @@ double xsect_getWofY(TXsect *xsect, double y)
 //
 {
     double yNorm = y / xsect->yFull;
+    TGeomTbl* tbl;                                                             //(5.1.015)
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -981,12 +1053,14 @@ double xsect_getWofY(TXsect *xsect, double y)
         return xsect->wMax * lookup(yNorm, W_Arch, N_W_Arch);
 
       case IRREGULAR:
-        return xsect->wMax * lookup(yNorm,
-            Transect[xsect->transect].widthTbl, N_TRANSECT_TBL);
+        tbl = &Transect[xsect->transect].geom;                                 //(5.1.015)
+        return xsect->wMax * MAX(geomLookup(tbl, yNorm, tbl->width),          //(5.1.015)
+                                 tbl->wMin);                                   //(5.1.015)
 
       case CUSTOM:
-        return xsect->wMax * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].widthTbl, N_SHAPE_TBL);
+        tbl = &Shape[Curve[xsect->transect].refersTo].geom;                    //(5.1.015)
+        return xsect->wMax * MAX(geomLookup(tbl, yNorm, tbl->width),          //(5.1.015)
+                                 tbl->wMin);                                   //(5.1.015)
 
       case RECT_CLOSED: 
           if (yNorm == 1.0) return 0.0;                                        //(5.1.013)
@@ -1023,6 +1097,7 @@ double xsect_getRofY(TXsect *xsect, double y)
 //
 {
     double yNorm = y / xsect->yFull;
+    TGeomTbl* tbl;                                                             //(5.1.015)
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -1053,12 +1128,12 @@ double xsect_getRofY(TXsect *xsect, double y)
         return xsect->rFull * lookup(yNorm, R_Arch, N_R_Arch);
 
       case IRREGULAR:
-        return xsect->rFull * lookup(yNorm,
-            Transect[xsect->transect].hradTbl, N_TRANSECT_TBL);
+        tbl = &Transect[xsect->transect].geom;                                 //(5.1.015)
+        return xsect->rFull * geomLookup(tbl, yNorm, tbl->hrad);               //(5.1.015)
 
       case CUSTOM:
-        return xsect->rFull * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].hradTbl, N_SHAPE_TBL);
+        tbl = &Shape[Curve[xsect->transect].refersTo].geom;                    //(5.1.015)
+        return xsect->rFull * geomLookup(tbl, yNorm, tbl->hrad);               //(5.1.015)
 
       case RECT_TRIANG:  return rect_triang_getRofY(xsect, y);
 
@@ -1078,6 +1153,92 @@ double xsect_getRofY(TXsect *xsect, double y)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int xsect_getAandRofY(int type, TXsect* xsect[], int n, double y[],
+                      double a[], double r[])
+//
+//  Input:   type = shape type shared by all of the cross sections
+//           xsect = array of n ptrs. to cross section data structures
+//           n = number of cross sections
+//           y = depth in each cross section (ft)
+//  Output:  a = area of each cross section (ft2)
+//           r = hyd. radius of each cross section (ft);
+//           returns FALSE if the shape has no batched form
+//  Purpose: computes the same areas and hyd. radii as xsect_getAofY and
+//           xsect_getRofY for a batch of cross sections of a given shape.
+//
+//  Note:    the shape is resolved once for the whole batch and the closed
+//           form shapes are evaluated in loops without branches that the
+//           compiler can vectorize.
+//
+{
+    int    i;
+    double aa, p, yNorm;
+
+    switch ( type )
+    {
+      case FORCE_MAIN:
+      case CIRCULAR:
+        for (i = 0; i < n; i++)
+        {
+            yNorm = y[i] / xsect[i]->yFull;
+            lookupPair(yNorm, A_Circ, R_Circ, N_A_Circ, &aa, &p);
+            a[i] = (y[i] <= 0.0) ? 0.0 : xsect[i]->aFull * aa;
+            r[i] = xsect[i]->rFull * p;
+        }
+        return TRUE;
+
+      case RECT_CLOSED:
+        #pragma omp simd private(aa, p)
+        for (i = 0; i < n; i++)
+        {
+            aa = (y[i] <= 0.0) ? 0.0 : y[i] * xsect[i]->wMax;
+            p = xsect[i]->wMax + 2.*aa/xsect[i]->wMax;
+            p += (aa/xsect[i]->aFull > RECT_ALFMAX) ?
+                 (aa/xsect[i]->aFull - RECT_ALFMAX) / (1.0 - RECT_ALFMAX) *
+                 xsect[i]->wMax : 0.0;
+            a[i] = aa;
+            r[i] = (aa <= 0.0) ? 0.0 : aa / p;
+        }
+        return TRUE;
+
+      case RECT_OPEN:
+        #pragma omp simd private(aa)
+        for (i = 0; i < n; i++)
+        {
+            aa = (y[i] <= 0.0) ? 0.0 : y[i] * xsect[i]->wMax;
+            a[i] = aa;
+            r[i] = (aa <= 0.0) ? 0.0 : aa / (xsect[i]->wMax +
+                   (2. - xsect[i]->sBot) * aa / xsect[i]->wMax);
+        }
+        return TRUE;
+
+      case TRAPEZOIDAL:
+        #pragma omp simd private(aa)
+        for (i = 0; i < n; i++)
+        {
+            aa = ( xsect[i]->yBot + xsect[i]->sBot * y[i] ) * y[i];
+            a[i] = (y[i] <= 0.0) ? 0.0 : aa;
+            r[i] = (y[i] == 0.0) ? 0.0 :
+                   aa / (xsect[i]->yBot + y[i] * xsect[i]->rBot);
+        }
+        return TRUE;
+
+      case TRIANGULAR:
+        #pragma omp simd
+        for (i = 0; i < n; i++)
+        {
+            a[i] = (y[i] <= 0.0) ? 0.0 : y[i] * y[i] * xsect[i]->sBot;
+            r[i] = (y[i] * xsect[i]->sBot) / (2. * xsect[i]->rBot);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
 double xsect_getRofA(TXsect *xsect, double a)
 //
 //  Input:   xsect = ptr. to a cross section data structure
@@ -1165,7 +1326,16 @@ double xsect_getAofS(TXsect* xsect, double s)
       case SEMICIRCULAR:
         return xsect->aFull * invLookup(psi, S_SemiCirc, N_S_SemiCirc);
 
-      default: return generic_getAofS(xsect, s);
+      default:
+        // --- use inverse table on the branch of the section factor        //(5.1.015)
+        //     curve below sFull (where S increases monotonically with A)
+        if ( xsect->aOfS &&                                                    //(5.1.015)
+             (s < xsect->sFull || xsect->sMax == xsect->sFull) )               //(5.1.015)
+        {                                                                      //(5.1.015)
+            psi = pow(s / xsect->aOfS->xMax, 3./5.);                           //(5.1.015)
+            return xsect->aFull * tableLookup(xsect->aOfS, psi);               //(5.1.015)
+        }                                                                      //(5.1.015)
+        return generic_getAofS(xsect, s);
     }
 }
 
@@ -1234,6 +1404,144 @@ double xsect_getdSdA(TXsect* xsect, double a)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int xsect_getSanddSdA(int type, TXsect* xsect[], int n, double a[],
+                      double s[], double dsda[])
+//
+//  Input:   type = shape type shared by all of the cross sections
+//           xsect = array of n ptrs. to cross section data structures
+//           n = number of cross sections
+//           a = area of each cross section (ft2)
+//  Output:  s = section factor of each cross section (ft^(8/3))
+//           dsda = derivative of each section factor w.r.t. area (ft^2/3);
+//           returns FALSE if the shape has no batched form
+//  Purpose: computes the same section factors and derivatives as
+//           xsect_getSofA and xsect_getdSdA for a batch of cross sections
+//           of a given shape.
+//
+//  Note:    the shape (and its geometry table) is resolved once for the
+//           whole batch. Where the section factor and its derivative are
+//           both found from the hyd. radius, the radius and its 2/3 power
+//           are computed only once.
+//
+{
+    int    i, nItems;
+    double alpha, dPdA, r, r23, theta;
+    double *table;
+
+    switch ( type )
+    {
+      case FORCE_MAIN:
+      case CIRCULAR:
+        for (i = 0; i < n; i++)
+        {
+            // --- the angle subtended by the water surface gives both the
+            //     section factor and its derivative for small a/aFull
+            alpha = a[i] / xsect[i]->aFull;
+            if ( alpha > 1.0e-5 && alpha < 0.04 )
+            {
+                theta = getThetaOfAlpha(alpha);
+                s[i] = xsect[i]->sFull * (pow((theta - sin(theta)), 5./3.) /
+                       (2.0 * PI) / pow(theta, 2./3.));
+                r = a[i] / (theta * xsect[i]->yFull / 2.0);
+                dPdA = 4.0 / xsect[i]->yFull / (1. - cos(theta));
+                dsda[i] = (5./3. - (2./3.) * dPdA * r) * pow(r, 2./3.);
+            }
+            else if ( alpha >= 0.04 )
+            {
+                tabular_getSanddSdA(xsect[i], a[i], S_Circ, N_S_Circ,
+                                    &s[i], &dsda[i]);
+            }
+            else
+            {
+                s[i] = circ_getSofA(xsect[i], a[i]);
+                dsda[i] = circ_getdSdA(xsect[i], a[i]);
+            }
+        }
+        return TRUE;
+
+      case EGGSHAPED:
+        table = S_Egg;            nItems = N_S_Egg;            break;
+      case HORSESHOE:
+        table = S_Horseshoe;      nItems = N_S_Horseshoe;      break;
+      case GOTHIC:
+        table = S_Gothic;         nItems = N_S_Gothic;         break;
+      case CATENARY:
+        table = S_Catenary;       nItems = N_S_Catenary;       break;
+      case SEMIELLIPTICAL:
+        table = S_SemiEllip;      nItems = N_S_SemiEllip;      break;
+      case BASKETHANDLE:
+        table = S_BasketHandle;   nItems = N_S_BasketHandle;   break;
+      case SEMICIRCULAR:
+        table = S_SemiCirc;       nItems = N_S_SemiCirc;       break;
+
+      case RECT_CLOSED:
+        for (i = 0; i < n; i++)
+        {
+            alpha = a[i] / xsect[i]->aFull;
+            if ( alpha > RECT_ALFMAX || alpha <= 1.0e-30 )
+            {
+                s[i] = rect_closed_getSofA(xsect[i], a[i]);
+                dsda[i] = rect_closed_getdSdA(xsect[i], a[i]);
+                continue;
+            }
+            r = rect_closed_getRofA(xsect[i], a[i]);
+            r23 = pow(r, 2./3.);
+            s[i] = a[i] * r23;
+            dsda[i] = (5./3. - (2./3.) * (2.0/xsect[i]->wMax) * r) * r23;
+        }
+        return TRUE;
+
+      case RECT_OPEN:
+        for (i = 0; i < n; i++)
+        {
+            s[i] = rect_open_getSofA(xsect[i], a[i]);
+            dsda[i] = rect_open_getdSdA(xsect[i], a[i]);
+        }
+        return TRUE;
+
+      case TRAPEZOIDAL:
+      case TRIANGULAR:
+        for (i = 0; i < n; i++)
+        {
+            if ( a[i] / xsect[i]->aFull <= 1.0e-30 )
+            {
+                s[i] = xsect_getSofA(xsect[i], a[i]);
+                dsda[i] = xsect_getdSdA(xsect[i], a[i]);
+                continue;
+            }
+            if ( type == TRAPEZOIDAL )
+            {
+                r = trapez_getRofA(xsect[i], a[i]);
+                dPdA = xsect[i]->rBot / sqrt( xsect[i]->yBot * xsect[i]->yBot +
+                       4. * xsect[i]->sBot * a[i] );
+            }
+            else
+            {
+                r = triang_getRofA(xsect[i], a[i]);
+                dPdA = xsect[i]->rBot / sqrt(a[i] * xsect[i]->sBot);
+            }
+            r23 = pow(r, 2./3.);
+            s[i] = ( r < TINY ) ? 0.0 : a[i] * r23;
+            dsda[i] = (5./3. - (2./3.) * dPdA * r) * r23;
+        }
+        return TRUE;
+
+      default:
+        return FALSE;
+    }
+
+    // --- shapes with a tabulated section factor
+    for (i = 0; i < n; i++)
+    {
+        tabular_getSanddSdA(xsect[i], a[i], table, nItems, &s[i], &dsda[i]);
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
 double xsect_getYcrit(TXsect* xsect, double q)
 //
 //  Input:   xsect = ptr. to a cross section data structure
@@ -1277,6 +1585,15 @@ double xsect_getYcrit(TXsect* xsect, double q)
         break;
 
       default:
+        // --- use inverse table of critical flow v. depth if available    //(5.1.015)
+        if ( xsect->yCrit )                                                    //(5.1.015)
+        {                                                                      //(5.1.015)
+            if ( q >= xsect->yCrit->xMax ) return xsect->yFull;                //(5.1.015)
+            r = pow(q / xsect->yCrit->xMax, 2./5.);                            //(5.1.015)
+            y = xsect->yFull * tableLookup(xsect->yCrit, r);                   //(5.1.015)
+            break;                                                             //(5.1.015)
+        }                                                                      //(5.1.015)
+
         // --- first estimate yCritical for an equivalent circular conduit
         //     using 1.01 * (q2g / yFull)^(1/4)
         y = 1.01 * pow(q2g / xsect->yFull, 1./4.);
@@ -1300,6 +1617,162 @@ double xsect_getYcrit(TXsect* xsect, double q)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void xsect_deleteTables()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees memory used by all cross sections' inverse geometry tables.
+//
+{
+    int i;
+    TXsectTblNode* node;
+
+    for (i = 0; i < XSECT_HASH_SIZE; i++)
+    {
+        while ( XsectTblHash[i] )
+        {
+            node = XsectTblHash[i];
+            XsectTblHash[i] = node->next;
+            free(node);
+        }
+    }
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+int xsect_createGeomTbl(TGeomTbl* tbl, int nBreaks, double yBreaks[],
+    double aScale, int (*getGeom)(int n, double y[], double a[], double r[],
+    double w[], void* p), void* p)
+//
+//  Input:   tbl = ptr. to a geometry table structure
+//           nBreaks = number of breaks in the shape's width profile
+//           yBreaks = increasing normalized depths of the width profile breaks
+//           aScale = max. width * full depth / full area
+//           getGeom = function that computes normalized area, hyd. radius
+//                     and top width at a set of increasing normalized depths
+//           p = data passed on to getGeom
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: builds the geometry tables of an irregular or custom shaped
+//           cross section.
+//
+//  Notes:   The tables start from GeomTblSize equally spaced depths plus
+//           the width profile's breaks, so width varies linearly and area
+//           quadratically between entries. Intervals where a mid-depth
+//           check shows linear interpolation of hyd. radius (or width or
+//           area) is off by more than GEOM_TBL_TOL are then bisected.
+//
+{
+    int     i, k, n, nMax, pass, status;
+    int     result = FALSE;
+    double  yk;
+    double  *y, *yNew, *a, *r, *w;
+
+    xsect_deleteGeomTbl(tbl);
+    tbl->aScale = aScale;
+    tbl->wMin = 0.0;
+
+    // --- allocate work arrays big enough for the largest table plus
+    //     the mid-depth of each of its intervals
+    nMax = 4 * GeomTblSize + nBreaks;
+    y = (double *) calloc(nMax, sizeof(double));
+    yNew = (double *) calloc(2*nMax, sizeof(double));
+    a = (double *) calloc(2*nMax, sizeof(double));
+    r = (double *) calloc(2*nMax, sizeof(double));
+    w = (double *) calloc(2*nMax, sizeof(double));
+    if ( y && yNew && a && r && w )
+    {
+        // --- merge equally spaced depths with width profile breaks
+        //     (a break replaces an equally spaced depth right next to it)
+        n = 0;
+        k = 0;
+        y[n++] = 0.0;
+        for (i = 1; i < GeomTblSize; i++)
+        {
+            yk = (double)i / (double)(GeomTblSize-1);
+            for ( ; k < nBreaks && yBreaks[k] < yk - 1.0e-6; k++)
+            {
+                if ( yBreaks[k] - y[n-1] > 1.0e-6 ) y[n++] = yBreaks[k];
+            }
+            if ( k < nBreaks && yBreaks[k] <= yk + 1.0e-6 ) yk = yBreaks[k++];
+            if ( yk - y[n-1] > 1.0e-6 ) y[n++] = yk;
+        }
+        y[n-1] = 1.0;
+
+        // --- refine the tables, then save their entries
+        status = 1;
+        for (pass = 0; status > 0; pass++)
+        {
+            status = refineGeomTbl(&n, nMax, pass < GEOM_TBL_PASSES, y, yNew,
+                                   a, r, w, aScale, getGeom, p);
+        }
+        if ( status == 0 ) result = saveGeomTbl(tbl, n, y, a, r, w);
+    }
+    FREE(y);
+    FREE(yNew);
+    FREE(a);
+    FREE(r);
+    FREE(w);
+    if ( !result ) xsect_deleteGeomTbl(tbl);
+    return result;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void xsect_deleteGeomTbl(TGeomTbl* tbl)
+//
+//  Input:   tbl = ptr. to a geometry table structure
+//  Output:  none
+//  Purpose: frees memory used by an irregular or custom shape's geometry
+//           tables.
+//
+{
+    FREE(tbl->y);
+    FREE(tbl->area);
+    FREE(tbl->hrad);
+    FREE(tbl->width);
+    FREE(tbl->yIndex);
+    FREE(tbl->aIndex);
+    tbl->nItems = 0;
+    tbl->nBuckets = 0;
+}
+
+//=============================================================================
+
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+double xsect_getGeomTblSmax(TGeomTbl* tbl, double* aMax)
+//
+//  Input:   tbl = ptr. to a geometry table structure
+//  Output:  aMax = area / full area where the max. section factor occurs;
+//           returns max. section factor / full section factor
+//  Purpose: finds the max. section factor of an irregular or custom shaped
+//           cross section from its geometry tables.
+//
+{
+    int    i;
+    double sf, sMax = 0.0;
+
+    *aMax = 0.0;
+    for (i = 1; i < tbl->nItems; i++)
+    {
+        sf = tbl->area[i] * pow(tbl->hrad[i], 2./3.);
+        if ( sf > sMax )
+        {
+            sMax = sf;
+            *aMax = tbl->area[i];
+        }
+    }
+    return sMax;
+}
+
+//=============================================================================
+
 double generic_getAofS(TXsect* xsect, double s)
 //
 //  Input:   xsect = ptr. to a cross section data structure
@@ -1394,6 +1867,56 @@ double tabular_getdSdA(TXsect* xsect, double a, double *table, int nItems)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void tabular_getSanddSdA(TXsect* xsect, double a, double *table, int nItems,
+                         double* s, double* dsda)
+//
+//  Input:   xsect = ptr. to cross section data structure
+//           a = area (ft2)
+//           table = ptr. to table of section factor v. normalized area
+//           nItems = number of equally spaced items in table
+//  Output:  s = section factor (ft^(8/3))
+//           dsda = derivative of section factor w.r.t. area (ft^2/3)
+//  Purpose: computes the same section factor and derivative as lookup()
+//           and tabular_getdSdA(), locating the table segment only once.
+//
+{
+    int    i;
+    double alpha = a / xsect->aFull;
+    double delta = 1.0 / (nItems-1);
+    double x0, x1, y, y2;
+
+    // --- find which segment of table contains alpha
+    i = (int)(alpha / delta);
+
+    // --- compute slope from this interval of table
+    if ( i >= nItems - 1 )
+    {
+        *s = xsect->sFull * table[nItems-1];
+        i = nItems - 2;
+    }
+    else
+    {
+        // --- linearly interpolate a section factor, using quadratic
+        //     interpolation for low alpha
+        x0 = i * delta;
+        x1 = (i+1) * delta;
+        y = table[i] + (alpha - x0) * (table[i+1] - table[i]) / delta;
+        if ( i < 2 )
+        {
+            y2 = y + (alpha - x0) * (alpha - x1) / (delta*delta) *
+                 (table[i]/2.0 - table[i+1] + table[i+2]/2.0) ;
+            if ( y2 > 0.0 ) y = y2;
+        }
+        if ( y < 0.0 ) y = 0.0;
+        *s = xsect->sFull * y;
+    }
+    *dsda = (table[i+1] - table[i]) / delta * xsect->sFull / xsect->aFull;
+}
+
+//=============================================================================
+
 double generic_getdSdA(TXsect* xsect, double a)
 //
 //  Input:   xsect = ptr. to cross section data structure
@@ -1452,6 +1975,56 @@ double lookup(double x, double *table, int nItems)
 
 //=============================================================================
 
+////  New function added to release 5.1.015.  ////                             //(5.1.015)
+
+void lookupPair(double x, double *table1, double *table2, int nItems,
+                double* y1, double* y2)
+//
+//  Input:   x = value of independent variable in two geometry tables
+//           table1, table2 = ptrs. to geometry tables
+//           nItems = number of equally spaced items in each table
+//  Output:  y1, y2 = values of the dependent variables of each table
+//  Purpose: performs the same lookup as lookup() in two tables that share
+//           the same spacing, locating the table segment only once.
+//
+{
+    double  delta, x0, x1, y, yq, c;
+    double* table;
+    int     i, t;
+
+    // --- find which segment of tables contains x
+    delta = 1.0 / (nItems-1);
+    i = (int)(x / delta);
+    if ( i >= nItems - 1 )
+    {
+        *y1 = table1[nItems-1];
+        *y2 = table2[nItems-1];
+        return;
+    }
+
+    // --- compute x at start and end of segment
+    x0 = i * delta;
+    x1 = (i+1) * delta;
+    c = (x - x0) * (x - x1) / (delta*delta);
+
+    // --- interpolate in each table as lookup() does
+    for (t = 0; t < 2; t++)
+    {
+        table = (t == 0) ? table1 : table2;
+        y = table[i] + (x - x0) * (table[i+1] - table[i]) / delta;
+        if ( i < 2 )
+        {
+            yq = y + c * (table[i]/2.0 - table[i+1] + table[i+2]/2.0) ;
+            if ( yq > 0.0 ) y = yq;
+        }
+        if ( y < 0.0 ) y = 0.0;
+        if ( t == 0 ) *y1 = y;
+        else          *y2 = y;
+    }
+}
+
+//=============================================================================
+
 double invLookup(double y, double *table, int nItems)
 //
 //  Input:   y = value of dependent variable in a geometry table
@@ -1692,6 +2265,516 @@ double getYcritRidder(TXsect* xsect, double q, double y0)
 }
 
 
+//=============================================================================
+//  Inverse geometry table functions                                          //(5.1.015)
+//=============================================================================
+
+void setTables(TXsect* xsect)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//  Output:  none
+//  Purpose: assigns inverse geometry tables to a cross section, re-using
+//           those of a previously processed section with identical geometry.
+//
+//  Notes:   The tables replace the root finding otherwise needed to invert
+//           the section factor and critical flow functions of shapes that
+//           have no closed form or tabulated inverse. They are used with
+//           monotone cubic interpolation and are only built when the
+//           function being inverted is strictly increasing.
+//
+{
+    unsigned int   h;
+    TXsectTblNode* node;
+
+    xsect->aOfS = NULL;
+    xsect->yCrit = NULL;
+    if ( xsect->type == DUMMY || xsect->aFull <= 0.0 ) return;
+
+    // --- look for an existing set of tables for this geometry
+    h = hashGeometry(xsect);
+    for (node = XsectTblHash[h]; node; node = node->next)
+    {
+        if ( sameGeometry(&node->xsect, xsect) ) break;
+    }
+
+    // --- otherwise build a new set of tables
+    if ( node == NULL )
+    {
+        node = (TXsectTblNode *) malloc(sizeof(TXsectTblNode));
+        if ( node == NULL ) return;
+        node->xsect = *xsect;
+        node->hasAofS = buildAofSTable(xsect, &node->aOfS);
+        node->hasYcrit = buildYcritTable(xsect, &node->yCrit);
+        node->next = XsectTblHash[h];
+        XsectTblHash[h] = node;
+    }
+    if ( node->hasAofS ) xsect->aOfS = &node->aOfS;
+    if ( node->hasYcrit ) xsect->yCrit = &node->yCrit;
+}
+
+//=============================================================================
+
+int sameGeometry(TXsect* x1, TXsect* x2)
+//
+//  Input:   x1, x2 = ptrs. to cross section data structures
+//  Output:  returns TRUE if both sections have identical geometry
+//  Purpose: compares the geometric parameters of two cross sections.
+//
+{
+    return x1->type == x2->type && x1->transect == x2->transect &&
+           x1->yFull == x2->yFull && x1->wMax == x2->wMax &&
+           x1->ywMax == x2->ywMax && x1->aFull == x2->aFull &&
+           x1->rFull == x2->rFull && x1->sFull == x2->sFull &&
+           x1->sMax == x2->sMax && x1->yBot == x2->yBot &&
+           x1->aBot == x2->aBot && x1->sBot == x2->sBot &&
+           x1->rBot == x2->rBot;
+}
+
+//=============================================================================
+
+unsigned int hashGeometry(TXsect* xsect)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//  Output:  returns a hash table bucket index
+//  Purpose: hashes the shape type and main dimensions of a cross section.
+//
+{
+    double x[4];
+    unsigned char b[sizeof(x)];
+    unsigned int h = 2166136261u;
+    size_t i;
+
+    x[0] = xsect->yFull;
+    x[1] = xsect->wMax;
+    x[2] = xsect->aFull;
+    x[3] = xsect->sBot;
+    memcpy(b, x, sizeof(x));
+    h = (h ^ (unsigned int)xsect->type) * 16777619u;
+    h = (h ^ (unsigned int)xsect->transect) * 16777619u;
+    for (i = 0; i < sizeof(b); i++) h = (h ^ b[i]) * 16777619u;
+    return h % XSECT_HASH_SIZE;
+}
+
+//=============================================================================
+
+int buildAofSTable(TXsect* xsect, TXsectTbl* tbl)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//           tbl = ptr. to table being built
+//  Output:  returns TRUE if table was built, FALSE if not
+//  Purpose: tabulates area v. section factor between zero and max. area
+//           for shapes whose getAofS() would otherwise use root finding.
+//
+//  Notes:   Entries are u = (S/Smax)^(3/5) and v = A/Afull. This choice of u
+//           makes the relation close to linear for most shapes.
+//
+{
+    int    i;
+    double a, aMax;
+
+    switch ( xsect->type )
+    {
+      case DUMMY:
+      case FORCE_MAIN:
+      case CIRCULAR:
+      case EGGSHAPED:
+      case HORSESHOE:
+      case GOTHIC:
+      case CATENARY:
+      case SEMIELLIPTICAL:
+      case BASKETHANDLE:
+      case SEMICIRCULAR:
+        return FALSE;
+    }
+
+    aMax = xsect_getAmax(xsect);
+    tbl->xMax = xsect_getSofA(xsect, aMax);
+    if ( tbl->xMax <= 0.0 ) return FALSE;
+    for (i = 0; i < N_XSECT_TBL; i++)
+    {
+        a = aMax * pow((double)i / (double)(N_XSECT_TBL-1), 2.0);
+        tbl->u[i] = pow(xsect_getSofA(xsect, a) / tbl->xMax, 3./5.);
+        tbl->v[i] = a / xsect->aFull;
+        if ( i > 0 && tbl->u[i] <= tbl->u[i-1] ) return FALSE;
+    }
+    setTableSlopes(tbl);
+    return TRUE;
+}
+
+//=============================================================================
+
+int buildYcritTable(TXsect* xsect, TXsectTbl* tbl)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//           tbl = ptr. to table being built
+//  Output:  returns TRUE if table was built, FALSE if not
+//  Purpose: tabulates depth v. critical flow for shapes whose getYcrit()
+//           would otherwise use root finding.
+//
+//  Notes:   Entries are u = (Qc/Qmax)^(2/5) and v = Y/Yfull where Qmax is
+//           the critical flow at full depth (open shapes) or at 99% of full
+//           depth (closed shapes). Standard shapes whose area is close to
+//           that of a circle keep using getYcritEnum() so that their
+//           results are unchanged.
+//
+{
+    int    i;
+    double y, yMax, r;
+    TXsectStar xsectStar;
+
+    switch ( xsect->type )
+    {
+      case DUMMY:
+      case RECT_OPEN:
+      case RECT_CLOSED:
+      case TRIANGULAR:
+      case PARABOLIC:
+      case POWERFUNC:
+        return FALSE;
+
+      case IRREGULAR:
+      case CUSTOM:
+        break;
+
+      default:
+        r = xsect->aFull / (PI / 4.0 * SQR(xsect->yFull));
+        if ( r >= 0.5 && r <= 2.0 ) return FALSE;
+    }
+
+    yMax = xsect->yFull;
+    if ( !xsect_isOpen(xsect->type) ) yMax = 0.99 * yMax;
+    xsectStar.xsect = xsect;
+    xsectStar.qc = 0.0;
+    tbl->xMax = getQcritical(yMax, &xsectStar);
+    if ( tbl->xMax <= 0.0 ) return FALSE;
+    for (i = 0; i < N_XSECT_TBL; i++)
+    {
+        y = yMax * (double)i / (double)(N_XSECT_TBL-1);
+        tbl->u[i] = pow(MAX(getQcritical(y, &xsectStar), 0.0) / tbl->xMax,
+                        2./5.);
+        tbl->v[i] = y / xsect->yFull;
+        if ( i > 0 && tbl->u[i] <= tbl->u[i-1] ) return FALSE;
+    }
+    setTableSlopes(tbl);
+    return TRUE;
+}
+
+//=============================================================================
+
+void setTableSlopes(TXsectTbl* tbl)
+//
+//  Input:   tbl = ptr. to an inverse geometry table
+//  Output:  none
+//  Purpose: assigns slopes at each table entry that keep cubic Hermite
+//           interpolation of the table monotone (Fritsch-Butland method).
+//
+{
+    int    i;
+    double h1, h2, s1, s2;
+
+    // --- the first interval, where geometric functions behave like a
+    //     power of depth or area, uses a power law through entries 1 and 2
+    tbl->p0 = 1.0;
+    if ( tbl->v[0] == 0.0 && tbl->u[0] == 0.0 && tbl->v[1] > 0.0 )
+        tbl->p0 = log(tbl->v[2] / tbl->v[1]) / log(tbl->u[2] / tbl->u[1]);
+
+    for (i = 1; i < N_XSECT_TBL-1; i++)
+    {
+        h1 = tbl->u[i] - tbl->u[i-1];
+        h2 = tbl->u[i+1] - tbl->u[i];
+        s1 = (tbl->v[i] - tbl->v[i-1]) / h1;
+        s2 = (tbl->v[i+1] - tbl->v[i]) / h2;
+        if ( s1 * s2 <= 0.0 ) tbl->d[i] = 0.0;
+        else tbl->d[i] = 3.0 * (h1 + h2) /
+                         ((2.0*h2 + h1) / s1 + (h2 + 2.0*h1) / s2);
+    }
+
+    // --- end slopes use one-sided 3-point estimates limited to keep
+    //     the end segments monotone
+    i = N_XSECT_TBL - 1;
+    tbl->d[0] = endSlope(tbl->u[1] - tbl->u[0], tbl->u[2] - tbl->u[1],
+        (tbl->v[1] - tbl->v[0]) / (tbl->u[1] - tbl->u[0]),
+        (tbl->v[2] - tbl->v[1]) / (tbl->u[2] - tbl->u[1]));
+    tbl->d[i] = endSlope(tbl->u[i] - tbl->u[i-1], tbl->u[i-1] - tbl->u[i-2],
+        (tbl->v[i] - tbl->v[i-1]) / (tbl->u[i] - tbl->u[i-1]),
+        (tbl->v[i-1] - tbl->v[i-2]) / (tbl->u[i-1] - tbl->u[i-2]));
+}
+
+//=============================================================================
+
+double endSlope(double h1, double h2, double s1, double s2)
+//
+//  Input:   h1 = width of end interval
+//           h2 = width of adjacent interval
+//           s1 = secant slope of end interval
+//           s2 = secant slope of adjacent interval
+//  Output:  returns slope at end point of a table
+//  Purpose: computes a non-centered, shape-preserving end point slope.
+//
+{
+    double d = ((2.0*h1 + h2) * s1 - h1 * s2) / (h1 + h2);
+    if ( d * s1 <= 0.0 ) return 0.0;
+    if ( s1 * s2 <= 0.0 && fabs(d) > fabs(3.0*s1) ) return 3.0 * s1;
+    return d;
+}
+
+//=============================================================================
+
+double tableLookup(TXsectTbl* tbl, double u)
+//
+//  Input:   tbl = ptr. to an inverse geometry table
+//           u = normalized value of independent variable
+//  Output:  returns normalized value of dependent variable
+//  Purpose: interpolates an inverse geometry table using a cubic Hermite
+//           polynomial within the table interval that contains u.
+//
+{
+    int    i = 0, j = N_XSECT_TBL - 1, k;
+    double h, t, t1;
+
+    // --- locate interval u[i] <= u < u[j] by bisection
+    if ( u <= tbl->u[0] ) return tbl->v[0];
+    if ( u >= tbl->u[j] ) return tbl->v[j];
+    while ( j - i > 1 )
+    {
+        k = (i + j) / 2;
+        if ( tbl->u[k] <= u ) i = k;
+        else j = k;
+    }
+
+    // --- use power law within first interval
+    if ( i == 0 ) return tbl->v[0] +
+        (tbl->v[1] - tbl->v[0]) * pow(u / tbl->u[1], tbl->p0);
+
+    // --- evaluate Hermite basis functions
+    h = tbl->u[j] - tbl->u[i];
+    t = (u - tbl->u[i]) / h;
+    t1 = 1.0 - t;
+    return t1 * t1 * ((1.0 + 2.0*t) * tbl->v[i] + t * h * tbl->d[i]) +
+           t * t * ((3.0 - 2.0*t) * tbl->v[j] - t1 * h * tbl->d[j]);
+}
+
+
+
+//=============================================================================
+//  Irregular & custom shape geometry table functions                        //(5.1.015)
+//=============================================================================
+
+int refineGeomTbl(int* n, int nMax, int canRefine, double y[], double yNew[],
+    double a[], double r[], double w[], double aScale,
+    int (*getGeom)(int n, double y[], double a[], double r[], double w[],
+    void* p), void* p)
+//
+//  Input:   n = number of table entries
+//           nMax = max. number of table entries
+//           canRefine = TRUE if table entries can be added
+//           y = normalized depth of each table entry
+//           yNew = work array for 2*nMax depths
+//           aScale = max. width * full depth / full area
+//           getGeom = function that evaluates the shape's geometry
+//           p = data passed on to getGeom
+//  Output:  a, r, w = normalized area, hyd. radius & top width at each
+//           table entry (even positions) and interval mid-depth (odd
+//           positions); updated n and y if entries were added;
+//           returns 1 if entries were added, 0 if not, -1 if geometry
+//           could not be evaluated.
+//  Purpose: evaluates a shape's geometry at its table entries and bisects
+//           the table intervals that are not accurately interpolated.
+//
+{
+    int    i, k, m, nRefine;
+    double dy, aMid, err;
+
+    // --- evaluate geometry at each entry and each interval mid-depth
+    for (i = 0; i < *n - 1; i++)
+    {
+        yNew[2*i] = y[i];
+        yNew[2*i+1] = 0.5 * (y[i] + y[i+1]);
+    }
+    yNew[2*(*n)-2] = y[*n-1];
+    if ( !getGeom(2*(*n)-1, yNew, a, r, w, p) ) return -1;
+    if ( !canRefine ) return 0;
+
+    // --- compare mid-depth geometry with its interpolated value
+    //     (area uses the linear variation of width across an interval)
+    m = 0;
+    nRefine = 0;
+    for (i = 0; i < *n - 1; i++)
+    {
+        k = 2 * i;
+        dy = y[i+1] - y[i];
+        aMid = a[k] + aScale * 0.5 * dy * (0.75*w[k] + 0.25*w[k+2]);
+        err = fabs(r[k+1] - 0.5*(r[k] + r[k+2]));
+        err = MAX(err, fabs(w[k+1] - 0.5*(w[k] + w[k+2])));
+        err = MAX(err, fabs(a[k+1] - aMid));
+        yNew[m++] = y[i];
+        if ( err > GEOM_TBL_TOL && dy > 1.0e-4 && *n + nRefine < nMax )
+        {
+            yNew[m++] = 0.5 * (y[i] + y[i+1]);
+            nRefine++;
+        }
+    }
+    yNew[m++] = y[*n-1];
+    if ( nRefine == 0 ) return 0;
+
+    // --- replace table depths with refined ones
+    for (i = 0; i < m; i++) y[i] = yNew[i];
+    *n = m;
+    return 1;
+}
+
+//=============================================================================
+
+int saveGeomTbl(TGeomTbl* tbl, int n, double y[], double a[], double r[],
+                double w[])
+//
+//  Input:   tbl = ptr. to a geometry table structure
+//           n = number of table entries
+//           y = normalized depth of each table entry
+//           a, r, w = normalized area, hyd. radius & top width evaluated at
+//                     each table entry and interval mid-depth
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: saves a shape's geometry table entries and indexes them.
+//
+{
+    int i;
+
+    tbl->nItems = n;
+    tbl->nBuckets = n - 1;
+    tbl->y = (double *) calloc(n, sizeof(double));
+    tbl->area = (double *) calloc(n, sizeof(double));
+    tbl->hrad = (double *) calloc(n, sizeof(double));
+    tbl->width = (double *) calloc(n, sizeof(double));
+    tbl->yIndex = (int *) calloc(n, sizeof(int));
+    tbl->aIndex = (int *) calloc(n, sizeof(int));
+    if ( !tbl->y || !tbl->area || !tbl->hrad || !tbl->width ||
+         !tbl->yIndex || !tbl->aIndex ) return FALSE;
+    for (i = 0; i < n; i++)
+    {
+        tbl->y[i] = y[i];
+        tbl->area[i] = a[2*i];
+        tbl->hrad[i] = r[2*i];
+        tbl->width[i] = w[2*i];
+    }
+    setGeomTblIndex(tbl->nItems, tbl->nBuckets, tbl->y, tbl->yIndex);
+    setGeomTblIndex(tbl->nItems, tbl->nBuckets, tbl->area, tbl->aIndex);
+    return TRUE;
+}
+
+//=============================================================================
+
+void setGeomTblIndex(int n, int nBuckets, double x[], int index[])
+//
+//  Input:   n = number of table entries
+//           nBuckets = number of index buckets
+//           x = non-decreasing table values between 0 and 1
+//  Output:  index = entry at start of each bucket
+//  Purpose: indexes a geometry table by dividing the range 0 to 1 into
+//           equal buckets and finding the table interval where each starts.
+//
+{
+    int    i = 0, b;
+    double xb;
+
+    for (b = 0; b < nBuckets; b++)
+    {
+        xb = (double)b / (double)nBuckets;
+        while ( i < n - 2 && x[i+1] <= xb ) i++;
+        index[b] = i;
+    }
+}
+
+//=============================================================================
+
+int geomLocate(TGeomTbl* tbl, double x, double table[], int index[])
+//
+//  Input:   tbl = ptr. to a shape's geometry tables
+//           x = value between 0 and 1
+//           table = non-decreasing table of normalized values
+//           index = bucket index of the table
+//  Output:  returns i such that table[i] <= x < table[i+1]
+//  Purpose: locates the table interval containing a given value.
+//
+{
+    int b = (int)(x * tbl->nBuckets);
+    int i;
+
+    if ( b >= tbl->nBuckets ) b = tbl->nBuckets - 1;
+    if ( b < 0 ) b = 0;
+    i = index[b];
+    while ( i < tbl->nItems - 2 && table[i+1] <= x ) i++;
+    return i;
+}
+
+//=============================================================================
+
+double geomGetAofY(TGeomTbl* tbl, double y)
+//
+//  Input:   tbl = ptr. to a shape's geometry tables
+//           y = depth / full depth
+//  Output:  returns area / full area
+//  Purpose: finds area at a given depth from a shape's geometry tables.
+//
+{
+    int    i;
+    double dy, dw;
+
+    if ( y <= 0.0 ) return 0.0;
+    if ( y >= 1.0 ) return tbl->area[tbl->nItems-1];
+    i = geomLocate(tbl, y, tbl->y, tbl->yIndex);
+    dy = y - tbl->y[i];
+    dw = (tbl->width[i+1] - tbl->width[i]) / (tbl->y[i+1] - tbl->y[i]);
+    return tbl->area[i] + tbl->aScale * dy * (tbl->width[i] + 0.5 * dw * dy);
+}
+
+//=============================================================================
+
+double geomGetYofA(TGeomTbl* tbl, double a)
+//
+//  Input:   tbl = ptr. to a shape's geometry tables
+//           a = area / full area
+//  Output:  returns depth / full depth
+//  Purpose: finds depth at a given area from a shape's geometry tables.
+//
+{
+    int    i;
+    double h, da, dw, d, x;
+
+    if ( a <= 0.0 ) return 0.0;
+    if ( a >= tbl->area[tbl->nItems-1] ) return 1.0;
+    i = geomLocate(tbl, a, tbl->area, tbl->aIndex);
+    h = tbl->y[i+1] - tbl->y[i];
+    da = (a - tbl->area[i]) / tbl->aScale;
+    dw = (tbl->width[i+1] - tbl->width[i]) / h;
+
+    // --- solve da = d * (w + 0.5 * dw * d) for depth increment d
+    x = tbl->width[i] + sqrt(MAX(0.0, SQR(tbl->width[i]) + 2.0 * dw * da));
+    if ( x <= 0.0 ) d = 0.0;
+    else d = MIN(2.0 * da / x, h);
+    return tbl->y[i] + d;
+}
+
+//=============================================================================
+
+double geomLookup(TGeomTbl* tbl, double y, double table[])
+//
+//  Input:   tbl = ptr. to a shape's geometry tables
+//           y = depth / full depth
+//           table = table of normalized width or hyd. radius
+//  Output:  returns interpolated table value
+//  Purpose: linearly interpolates a shape's width or hyd. radius table.
+//
+{
+    int i;
+
+    if ( y <= 0.0 ) return table[0];
+    if ( y >= 1.0 ) return table[tbl->nItems-1];
+    i = geomLocate(tbl, y, tbl->y, tbl->yIndex);
+    return table[i] + (y - tbl->y[i]) * (table[i+1] - table[i]) /
+                      (tbl->y[i+1] - tbl->y[i]);
+}
+
+
 //=============================================================================
 //  RECT_CLOSED fuctions
 //=============================================================================
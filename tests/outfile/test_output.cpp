@@ -1,13 +1,13 @@
 /*
  ******************************************************************************
  Project:      OWA SWMM
- Version:      5.1.14
+ Version:      5.1.15
  Module:       test_output.cpp
  Description:  tests for output library functions
  Authors:      see AUTHORS
  Copyright:    see AUTHORS
  License:      see LICENSE
- Last Updated: 12/21/2020
+ Last Updated: 10/17/2026
  ******************************************************************************
  */
 
@@ -17,13 +17,31 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 #include "swmm_output.h"
 
 // NOTE: Reference data for the unit tests is currently tied to SWMM 5.1.7
 #define DATA_PATH "./test_example1.out"
 
+// Example 1 run with subcatch & node results and link flows saved as half
+// floats and link capacities as integers scaled by 0.0001
+#define DATA_PATH_QUANT "./test_example1_q.out"
+
+// Synthetic output file whose last period starts past the 2 GB boundary
+#define DATA_PATH_LARGE "./test_large.out"
+
+// NOTE: File offsets must be 8 byte / 64 bit integers for large file support
+#ifdef _MSC_VER
+  #define F_OFF __int64
+  #define FSEEK64 _fseeki64
+#else
+  #define F_OFF off_t
+  #define FSEEK64 fseeko
+#endif
+
 using namespace std;
 
 // Checks for minimum number of correct decimal digits
@@ -62,6 +80,18 @@ boost::test_tools::predicate_result check_cdd_float(std::vector<float>& test,
     return floor(min_cdd) >= cdd_tol;
 }
 
+// Checks that each value is within a relative tolerance of its reference
+boost::test_tools::predicate_result check_rel_float(float* test,
+    float* ref, int n, float rel_tol, float abs_tol){
+
+    for (int i = 0; i < n; i++)
+    {
+        if (fabs(test[i] - ref[i]) > rel_tol * fabs(ref[i]) + abs_tol)
+            return false;
+    }
+    return true;
+}
+
 boost::test_tools::predicate_result check_string(std::string test,
     std::string ref) {
 
@@ -341,3 +371,241 @@ BOOST_FIXTURE_TEST_CASE(test_getSystemResult, Fixture) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+
+// Builds a sparse copy of the reference output file once for the whole
+// test suite. Its results are those of the reference file followed by a run
+// of empty periods and then a copy of the reference file's last period,
+// which starts beyond 2^31 bytes. Only the periods actually written occupy
+// disk space (on file systems that support sparse files).
+struct LargeFile {
+    LargeFile() {
+        FILE* file;
+        int   epilogue[6];
+        long  size;
+        F_OFF resultsPos, bytesPerPeriod;
+
+        // read the reference file and its closing records
+        file = fopen(DATA_PATH, "rb");
+        BOOST_REQUIRE(file != NULL);
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        std::vector<char> bytes(size);
+        fseek(file, 0, SEEK_SET);
+        BOOST_REQUIRE(fread(&bytes[0], 1, size, file) == (size_t)size);
+        fclose(file);
+        memcpy(epilogue, &bytes[size - sizeof(epilogue)], sizeof(epilogue));
+
+        // epilogue holds ID, input & results positions, number of periods,
+        // error code and magic number
+        resultsPos = epilogue[2];
+        numPeriods = epilogue[3];
+        bytesPerPeriod = (size - sizeof(epilogue) - resultsPos) / numPeriods;
+        lastPeriod = (int)(((F_OFF)1 << 31) / bytesPerPeriod) + 1;
+
+        // write the reference results, then seek past 2 GB to write a copy
+        // of the last period and new closing records
+        file = fopen(DATA_PATH_LARGE, "wb");
+        BOOST_REQUIRE(file != NULL);
+        fwrite(&bytes[0], 1, size - sizeof(epilogue), file);
+        BOOST_REQUIRE(FSEEK64(file, resultsPos + lastPeriod * bytesPerPeriod,
+            SEEK_SET) == 0);
+        fwrite(&bytes[resultsPos + (numPeriods - 1) * bytesPerPeriod], 1,
+            bytesPerPeriod, file);
+        epilogue[3] = lastPeriod + 1;
+        BOOST_REQUIRE(fwrite(epilogue, sizeof(epilogue), 1, file) == 1);
+        fclose(file);
+    }
+    ~LargeFile() {
+        remove(DATA_PATH_LARGE);
+    }
+
+    static int numPeriods;
+    static int lastPeriod;
+};
+
+int LargeFile::numPeriods = 0;
+int LargeFile::lastPeriod = 0;
+
+struct FixtureLarge {
+    FixtureLarge() {
+        numPeriods = LargeFile::numPeriods;
+        lastPeriod = LargeFile::lastPeriod;
+
+        SMO_init(&p_handle);
+        SMO_init(&p_handle_ref);
+        error = SMO_open(p_handle, DATA_PATH_LARGE);
+        BOOST_REQUIRE(error == 0);
+        error = SMO_open(p_handle_ref, DATA_PATH);
+        BOOST_REQUIRE(error == 0);
+
+        array = NULL;
+        ref_array = NULL;
+    }
+    ~FixtureLarge() {
+        SMO_freeMemory((void*)array);
+        SMO_freeMemory((void*)ref_array);
+        SMO_close(p_handle);
+        SMO_close(p_handle_ref);
+    }
+
+    int        error;
+    int        numPeriods;
+    int        lastPeriod;
+    SMO_Handle p_handle;
+    SMO_Handle p_handle_ref;
+
+    float* array;
+    float* ref_array;
+    int    array_dim;
+    int    ref_dim;
+};
+
+BOOST_AUTO_TEST_SUITE(test_output_large,
+    * boost::unit_test::fixture<LargeFile>())
+
+BOOST_FIXTURE_TEST_CASE(test_getTimes, FixtureLarge) {
+    int time = -1;
+
+    error = SMO_getTimes(p_handle, SMO_numPeriods, &time);
+    BOOST_REQUIRE(error == 0);
+
+    BOOST_CHECK_EQUAL(lastPeriod + 1, time);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getNodeResult, FixtureLarge) {
+    error = SMO_getNodeResult(p_handle, lastPeriod, 2, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getNodeResult(p_handle_ref, numPeriods - 1, 2, &ref_array,
+        &ref_dim);
+    BOOST_REQUIRE(error == 0);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(array, array + array_dim,
+        ref_array, ref_array + ref_dim);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getLinkResult, FixtureLarge) {
+    error = SMO_getLinkResult(p_handle, lastPeriod, 3, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getLinkResult(p_handle_ref, numPeriods - 1, 3, &ref_array,
+        &ref_dim);
+    BOOST_REQUIRE(error == 0);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(array, array + array_dim,
+        ref_array, ref_array + ref_dim);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getSystemResult, FixtureLarge) {
+    error = SMO_getSystemResult(p_handle, lastPeriod, 0, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getSystemResult(p_handle_ref, numPeriods - 1, 0, &ref_array,
+        &ref_dim);
+    BOOST_REQUIRE(error == 0);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(array, array + array_dim,
+        ref_array, ref_array + ref_dim);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+struct FixtureQuant {
+    FixtureQuant() {
+        error = SMO_init(&p_handle);
+        SMO_clearError(p_handle);
+        error = SMO_open(p_handle, DATA_PATH_QUANT);
+
+        array     = NULL;
+        array_dim = 0;
+    }
+    ~FixtureQuant() {
+        SMO_freeMemory((void*)array);
+        error = SMO_close(p_handle);
+    }
+
+    int        error;
+    SMO_Handle p_handle;
+
+    float* array;
+    int    array_dim;
+};
+
+// Reference values are the results of the same run saved as 4-byte reals
+BOOST_AUTO_TEST_SUITE(test_output_quantized)
+
+BOOST_FIXTURE_TEST_CASE(test_open, FixtureQuant) {
+    int time = -1;
+
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getTimes(p_handle, SMO_numPeriods, &time);
+    BOOST_REQUIRE(error == 0);
+
+    BOOST_CHECK_EQUAL(36, time);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getSubcatchSeries, FixtureQuant) {
+    error = SMO_getSubcatchSeries(p_handle, 1, SMO_runoff_rate, 0, 10, &array,
+                                  &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 10);
+
+    float ref_array[10] = {
+        0.0f, 1.2438242f, 2.5639679f, 4.524055f, 2.5115132f, 0.69808137f,
+        0.040894926f, 0.011605669f, 0.0f, 0.0f};
+
+    BOOST_CHECK(check_rel_float(array, ref_array, 10, 1.0e-3f, 0.0f));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getSubcatchResult, FixtureQuant) {
+    error = SMO_getSubcatchResult(p_handle, 1, 1, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 10);
+
+    float ref_array[10] = {
+        0.5f, 0.0f, 0.0f, 0.125f, 1.2438242f,
+        0.0f, 0.0f, 0.0f, 33.481991f, 6.6963983f};
+
+    BOOST_CHECK(check_rel_float(array, ref_array, 10, 1.0e-3f, 0.0f));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getNodeResult, FixtureQuant) {
+    error = SMO_getNodeResult(p_handle, 2, 2, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 8);
+
+    float ref_array[8] = {
+        0.29606342f, 995.29608f, 0.0f, 1.3012083f, 1.3012083f, 0.0f,
+        15.367908f, 3.0735817f};
+
+    BOOST_CHECK(check_rel_float(array, ref_array, 8, 1.0e-3f, 0.0f));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getLinkResult, FixtureQuant) {
+    error = SMO_getLinkResult(p_handle, 3, 3, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 7);
+
+    // --- only the flow & capacity are quantized
+    float ref_array[7] = {
+        4.631762f, 1.0f, 5.8973422f, 314.15927f, 1.0f, 19.091614f,
+        3.8183229f};
+
+    BOOST_CHECK(check_rel_float(array, ref_array, 7, 1.0e-3f, 0.0f));
+    BOOST_CHECK_EQUAL_COLLECTIONS(array + 1, array + 4,
+        ref_array + 1, ref_array + 4);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getLinkSeries, FixtureQuant) {
+    error = SMO_getLinkSeries(p_handle, 3, SMO_capacity, 0, 10, &array,
+                              &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 10);
+
+    float ref_array[10] = {
+        0.0f, 0.52504826f, 1.0f, 1.0f, 1.0f, 0.37290618f,
+        0.075824879f, 0.020547327f, 0.011382443f, 0.0073821400f};
+
+    BOOST_CHECK(check_rel_float(array, ref_array, 10, 0.0f, 0.5e-4f));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_couple.cpp
+ Description:  tests for coupled model runs through named pipes
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <stdio.h>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "couple.h"
+#include "test_solver.hpp"
+
+#define ERR_NONE 0
+
+using namespace std;
+
+
+// Coupled runs require named pipes
+#ifndef _WIN32
+
+// Files of a chain of two copies of the example model whose first model's
+// outflows are the second's inflows
+struct FixtureChain {
+    string channel, upInp, downInp;
+    string files[6];
+
+    FixtureChain(bool saveOutflows) {
+        channel = getTempName();
+        upInp = saveOutflows ?
+            writeExampleModel("SAVE OUTFLOWS " + channel + " BINARY") :
+            writeExampleModel("");
+        downInp = writeExampleModel("USE INFLOWS " + channel);
+        files[0] = upInp;
+        files[3] = downInp;
+        for (int i = 1; i < 6; i++)
+            if (i != 3) files[i] = getTempName();
+    }
+
+    // Runs the chain with its models one after the other, each in a
+    // process of its own as in a coupled run
+    int runSerial() {
+        char* f[6];
+        for (int i = 0; i < 6; i++) f[i] = (char *)files[i].c_str();
+        int n_failed = couple_run(1, f, NULL);
+        if (n_failed) return n_failed;
+        return couple_run(1, f + 3, NULL);
+    }
+
+    // Runs the chain with its models at the same time
+    int runCoupled() {
+        char* f[6];
+        char* c[1] = {(char *)channel.c_str()};
+        for (int i = 0; i < 6; i++) f[i] = (char *)files[i].c_str();
+        return couple_run(2, f, c);
+    }
+
+    ~FixtureChain() {
+        remove(channel.c_str());
+        for (int i = 0; i < 6; i++) remove(files[i].c_str());
+    }
+};
+
+
+BOOST_AUTO_TEST_SUITE(test_couple)
+
+// A model fed by another through a named pipe has the same results as when
+// fed by a binary interface file saved before it runs
+BOOST_AUTO_TEST_CASE(coupled_matches_serial){
+    string serialOut;
+
+    {
+        FixtureChain chain(true);
+        BOOST_REQUIRE(chain.runSerial() == ERR_NONE);
+        serialOut = readFileContents(chain.files[5]);
+    }
+    BOOST_REQUIRE(serialOut.size() > 0);
+
+    FixtureChain chain(true);
+    BOOST_REQUIRE(chain.runCoupled() == 0);
+    BOOST_CHECK(readFileContents(chain.files[5]) == serialOut);
+}
+
+// Models forked after the calling process has run a model of its own (and
+// so created a pool of OpenMP threads when more than one is available)
+// run to completion rather than waiting on the pool's missing threads
+BOOST_AUTO_TEST_CASE(coupled_after_run_in_process){
+    FixtureChain chain(true);
+    BOOST_REQUIRE(swmm_run((char *)chain.files[0].c_str(),
+        (char *)chain.files[1].c_str(), (char *)chain.files[2].c_str())
+        == ERR_NONE);
+    remove(chain.channel.c_str());
+    BOOST_CHECK_EQUAL(chain.runCoupled(), 0);
+}
+
+// A model whose upstream model never writes to the pipe between them sees
+// the pipe end once the upstream model exits (rather than waiting on it
+// for ever) and fails since the pipe holds no interface data
+BOOST_AUTO_TEST_CASE(writer_exits_without_writing){
+    FixtureChain chain(false);
+    BOOST_CHECK_EQUAL(chain.runCoupled(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_findroot.cpp
+ Description:  tests for the root finding methods
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <math.h>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "findroot.h"
+}
+
+// Number of roots solved together
+#define N_LANES 40
+
+
+// f(x) = x^3 - c and its derivative
+static void evalCube(double x, double* f, double* df, void* p)
+{
+    double c = *(double *)p;
+    *f = x*x*x - c;
+    *df = 3.0*x*x;
+}
+
+static void evalCubes(int n, int lanes[], double x[], double f[], double df[],
+                      void* p)
+{
+    double* c = (double *)p;
+    for (int k = 0; k < n; k++)
+    {
+        int i = lanes[k];
+        evalCube(x[i], &f[i], &df[i], &c[i]);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_findroot)
+
+// Each lane of a batched solution takes the same steps as findroot_Newton,
+// whether it converges while the lanes are stepped in lockstep or after
+// being left to finish on its own
+BOOST_AUTO_TEST_CASE(batch_matches_newton){
+    const int nFixed[] = {0, 1, 2, 4, 60};
+    double c[N_LANES], x1[N_LANES], x2[N_LANES], guess[N_LANES];
+    double rts[N_LANES], root;
+    int    evals[N_LANES], n;
+
+    // --- roots spread over the bracket, with initial guesses both near
+    //     and far from them (some outside the bracket's Newton range)
+    for (int i = 0; i < N_LANES; i++)
+    {
+        c[i] = pow(0.05 + 1.9 * (double)i / (double)N_LANES, 3.0);
+        x1[i] = 0.0;
+        x2[i] = 2.0;
+        guess[i] = (i % 3 == 0) ? cbrt(c[i]) : (i % 3 == 1) ? 1.0 : 1.99;
+    }
+
+    for (int k = 0; k < (int)(sizeof(nFixed) / sizeof(nFixed[0])); k++)
+    {
+        for (int i = 0; i < N_LANES; i++) rts[i] = guess[i];
+        findroot_NewtonBatch(N_LANES, x1, x2, rts, 1.0e-6, nFixed[k], evals,
+                             evalCubes, c);
+        for (int i = 0; i < N_LANES; i++)
+        {
+            root = guess[i];
+            n = findroot_Newton(x1[i], x2[i], &root, 1.0e-6, evalCube, &c[i]);
+            BOOST_CHECK_EQUAL(rts[i], root);
+            BOOST_CHECK_EQUAL(evals[i], n);
+            BOOST_CHECK_SMALL(rts[i] - cbrt(c[i]), 1.0e-6);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_forcmain.cpp
+ Description:  tests for the force main friction factor table
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <fstream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+}
+
+#include "test_solver.hpp"
+
+
+#define DATA_PATH_FORCMAIN "test_forcmain.inp"
+
+// Kinematic viscosity of water used by the force main module (sq ft/sec)
+#define VISCOS 1.1E-5
+
+// Largest relative error allowed in a friction factor looked up in the table
+#define FRIC_TOL 0.0005
+
+// Largest difference allowed in the wet well depth (ft) when the table is
+// used: 0.05% of the roughly 25 ft of friction head lost in its force main
+#define WW_DEPTH_TOL 0.0125
+
+
+// Writes a copy of the force main model with the FORCE_MAIN_TABLE option
+// set to a temporary file and returns the file's name
+static std::string writeForceMainModel(bool useTable)
+{
+    std::string name = getTempName();
+    std::ofstream(name.c_str()) << readFileContents(DATA_PATH_FORCMAIN)
+        << "\n[OPTIONS]\nFORCE_MAIN_TABLE " << (useTable ? "YES" : "NO")
+        << "\n";
+    return name;
+}
+
+// Runs the force main model and returns the wet well depth at each step
+static std::vector<double> runForceMainModel(bool useTable)
+{
+    std::vector<double> depths;
+    std::string inp = writeForceMainModel(useTable);
+    double elapsedTime = 0.0;
+    int    error, ww, fm1;
+
+    BOOST_REQUIRE_EQUAL(swmm_open(inp.c_str(), DATA_PATH_RPT, DATA_PATH_OUT),
+                        0);
+    BOOST_CHECK_EQUAL(ForceMainTbl, useTable ? TRUE : FALSE);
+    ww = project_findObject(NODE, (char *)"WW");
+    fm1 = project_findObject(LINK, (char *)"FM1");
+    BOOST_REQUIRE(ww >= 0 && fm1 >= 0);
+    BOOST_REQUIRE_EQUAL(swmm_start(0), 0);
+    do
+    {
+        error = swmm_step(&elapsedTime);
+
+        // --- the force main leaving the wet well stays surcharged
+        BOOST_CHECK(Node[ww].newDepth > Link[fm1].xsect.yFull);
+        depths.push_back(Node[ww].newDepth);
+    } while ( elapsedTime != 0 && !error );
+    BOOST_CHECK_EQUAL(error, 0);
+    swmm_end();
+    swmm_close();
+    remove(inp.c_str());
+    return depths;
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_forcmain)
+
+// Friction slopes of a full force main found from the friction factor
+// table are within 0.05% of the Swamee-Jain ones between table entries
+BOOST_AUTO_TEST_CASE(table_accuracy){
+    std::string inp = writeForceMainModel(true);
+    double maxErr = 0.0;
+    int    j;
+
+    BOOST_REQUIRE_EQUAL(swmm_open(inp.c_str(), DATA_PATH_RPT, DATA_PATH_OUT),
+                        0);
+    BOOST_REQUIRE_EQUAL(swmm_start(0), 0);
+    j = project_findObject(LINK, (char *)"FM1");
+    BOOST_REQUIRE(j >= 0);
+
+    TXsect* xsect = &Link[j].xsect;
+    double  hrad = xsect->rFull;
+    double  d = 4.0 * hrad;
+    for (double logRR = -7.9; logRR < -1.0; logRR += 0.037)
+    {
+        // --- give the pipe a new roughness and find its terms again
+        xsect->rBot = pow(10.0, logRR) * d;
+        forcemain_close();
+        forcemain_init();
+        for (double logRe = 3.61; logRe < 10.0; logRe += 0.013)
+        {
+            double re = pow(10.0, logRe);
+            double v = re * VISCOS / d;
+            double f = log10(xsect->rBot/3.7/d + 5.74/pow(re, 0.9));
+            double slope = 0.25 / f / f * xsect->sBot * v / hrad;
+            double err = forcemain_getFricSlope(j, v, hrad) / slope - 1.0;
+            maxErr = fmax(maxErr, fabs(err));
+        }
+    }
+    BOOST_CHECK(maxErr > 0.0);
+    BOOST_CHECK_SMALL(maxErr, FRIC_TOL);
+
+    swmm_end();
+    swmm_close();
+    remove(inp.c_str());
+}
+
+// A surcharged Darcy-Weisbach force main gives nearly the same results with
+// the friction factor table as without it, and a run without the table that
+// follows one with it does not use the table
+BOOST_AUTO_TEST_CASE(table_option_run){
+    std::vector<double> withTable = runForceMainModel(true);
+    std::vector<double> noTable = runForceMainModel(false);
+    double maxDiff = 0.0;
+
+    BOOST_REQUIRE_EQUAL(withTable.size(), noTable.size());
+    for (size_t i = 0; i < noTable.size(); i++)
+    {
+        maxDiff = fmax(maxDiff, fabs(withTable[i] - noTable[i]));
+    }
+    BOOST_CHECK(maxDiff > 0.0);
+    BOOST_CHECK_SMALL(maxDiff, WW_DEPTH_TOL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,7 +7,7 @@
  Authors:      see AUTHORS
  Copyright:    see AUTHORS
  License:      see LICENSE
- Last Updated: 12/21/2020
+ Last Updated: 10/17/2026
  ******************************************************************************
 */
 
@@ -17,6 +17,8 @@
 
 
 #define ERR_NONE 0
+#define ERR_API_OBJECT_INDEX 505
+#define ERR_TIMESERIES_SEQUENCE 173
 
 BOOST_AUTO_TEST_SUITE(test_toolkitapi_gage)
 
@@ -117,4 +119,87 @@ BOOST_FIXTURE_TEST_CASE(get_set_gage_rate, FixtureBeforeStep){
 }
 
 
+// Testing Rain Gage Data Appended During Simulation
+BOOST_FIXTURE_TEST_CASE(append_gage_data, FixtureBeforeStep){
+    int error;
+    int rg_ind, ts_ind, subc_ind;
+    int appended_early = 0, appended_late = 0;
+    double rainfall, hours;
+    double elapsedTime = 0.0;
+
+    // Simulation starts Jan 1, 1998 (decimal days)
+    double start = 35796.0;
+    double early_dates[] = {start + 31.0/24.0, start + 32.0/24.0};
+    double early_rain[] = {1.0, 0.0};
+    double late_dates[] = {start + 34.0/24.0, start + 35.0/24.0};
+    double late_rain[] = {2.0, 0.0};
+    double bad_dates[] = {start + 29.0/24.0};
+
+    char rgid[] = "RG1";
+    char tsid[] = "TS1";
+    char subid[] = "1";
+
+    error = swmm_getObjectIndex(SM_GAGE, rgid, &rg_ind);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_getObjectIndex(SM_TSERIES, tsid, &ts_ind);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_getObjectIndex(SM_SUBCATCH, subid, &subc_ind);
+    BOOST_REQUIRE(error == ERR_NONE);
+
+    // TS1 ends at 30:00 so data must come after it
+    error = swmm_appendTimeseries(ts_ind, 1, bad_dates, early_rain);
+    BOOST_CHECK_EQUAL(error, ERR_TIMESERIES_SEQUENCE);
+    error = swmm_appendGageData(100, 1, early_dates, early_rain);
+    BOOST_CHECK_EQUAL(error, ERR_API_OBJECT_INDEX);
+
+    do
+    {
+        hours = elapsedTime * 24.0;
+
+        // Append while the gage is still reading TS1
+        if (!appended_early && hours >= 12.0)
+        {
+            error = swmm_appendGageData(rg_ind, 2, early_dates, early_rain);
+            BOOST_REQUIRE(error == ERR_NONE);
+            appended_early = 1;
+        }
+
+        // Append after the gage has reached the end of its record
+        if (!appended_late && hours >= 33.0)
+        {
+            error = swmm_appendTimeseries(ts_ind, 2, late_dates, late_rain);
+            BOOST_REQUIRE(error == ERR_NONE);
+            appended_late = 1;
+        }
+
+        if (hours >= 31.5 && hours < 31.6)
+        {
+            error = swmm_getGagePrecip(rg_ind, SM_RAINFALL, &rainfall);
+            BOOST_REQUIRE(error == ERR_NONE);
+            BOOST_CHECK_SMALL(rainfall - 1.0, 0.0001);
+        }
+        if (hours >= 34.5 && hours < 34.6)
+        {
+            error = swmm_getGagePrecip(rg_ind, SM_RAINFALL, &rainfall);
+            BOOST_REQUIRE(error == ERR_NONE);
+            BOOST_CHECK_SMALL(rainfall - 2.0, 0.0001);
+        }
+
+        // Route Model Forward
+        error = swmm_step(&elapsedTime);
+        BOOST_REQUIRE(error == ERR_NONE);
+    }while (elapsedTime != 0 && !error);
+
+    // Rainfall of TS1 (2.65 in) plus the appended 1.0 and 2.0 inches
+    SM_SubcatchStats __subc_stats;
+    SM_SubcatchStats *_subc_stats = &__subc_stats;
+
+    error = swmm_getSubcatchStats(subc_ind, _subc_stats);
+    BOOST_CHECK_EQUAL(error, ERR_NONE);
+    BOOST_CHECK_SMALL(_subc_stats->precip - 5.65, 0.0001);
+
+    swmm_end();
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,236 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_lid_rpt.cpp
+ Description:  tests for detailed LID report files
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+}
+
+#include "test_solver.hpp"
+
+#define ERR_NONE 0
+
+#define DATA_PATH_INP_LID "lid/revised/test_w_wo_BC_2Subcatchments_revised.inp"
+#define LID_RPT_FILE      "\"feng_r.txt\""
+#define LIDRPT_MAGIC      516114525
+
+// Allowed difference between a binary and a text value: half of the text
+// value's last digit plus the precision of a 4-byte real
+#define RPT_TOL(x) (0.0005 + 1.0e-6 * fabs(x))
+
+using namespace std;
+
+
+// Results of one run saved in an LID report file
+struct LidRptRun {
+    vector<string>          dates;
+    vector< vector<double> > values;   // elapsed hours & reported variables
+};
+
+// Writes a copy of the LID test model that saves its LID report to a
+// temporary file in a given format and returns the copy's name
+static string writeLidModel(const string& rptFile, bool binary)
+{
+    string text = readFileContents(DATA_PATH_INP_LID);
+    size_t pos = text.find(LID_RPT_FILE);
+    BOOST_REQUIRE(pos != string::npos);
+    text.replace(pos, strlen(LID_RPT_FILE), "\"" + rptFile + "\"");
+    if ( binary )
+    {
+        pos = text.find("[OPTIONS]\n");
+        BOOST_REQUIRE(pos != string::npos);
+        text.insert(pos + strlen("[OPTIONS]\n"), "LID_REPORT_FORMAT BINARY\n");
+    }
+    string name = getTempName();
+    ofstream(name.c_str()) << text;
+    return name;
+}
+
+// Returns a string without its leading and trailing blanks
+static string trim(const string& s)
+{
+    size_t first = s.find_first_not_of(' ');
+    if ( first == string::npos ) return "";
+    return s.substr(first, s.find_last_not_of(' ') - first + 1);
+}
+
+// Reads the results of a text LID report file's single run
+static void readTextRpt(const string& data, LidRptRun& run)
+{
+    istringstream in(data);
+    string line, field;
+    bool   started = false;
+
+    while ( getline(in, line) )
+    {
+        if ( !started )
+        {
+            started = (line.compare(0, 11, "-----------") == 0);
+            continue;
+        }
+        istringstream fields(line);
+        getline(fields, field, '\t');
+        run.dates.push_back(trim(field));
+        run.values.push_back(vector<double>());
+        while ( getline(fields, field, '\t') )
+            run.values.back().push_back(atof(field.c_str()));
+    }
+}
+
+// Reads the results of the next run from the binary LID report file
+// contents in data starting at pos
+static void readBinaryRpt(const string& data, size_t& pos, LidRptRun& run)
+{
+    int      k[4], n, periods;
+    double   date;
+    float    x;
+    char     stamp[25];
+
+    // --- header: magic number, version, units, no. of variables, 3 strings
+    BOOST_REQUIRE(pos + sizeof(k) <= data.size());
+    memcpy(k, &data[pos], sizeof(k));
+    pos += sizeof(k);
+    BOOST_REQUIRE_EQUAL(k[0], LIDRPT_MAGIC);
+    for (int i = 0; i < 3; i++)
+    {
+        BOOST_REQUIRE(pos + sizeof(int) <= data.size());
+        memcpy(&n, &data[pos], sizeof(int));
+        pos += sizeof(int) + n;
+    }
+
+    // --- a record of each period until the number of periods & magic number
+    size_t recordSize = sizeof(double) + (1 + k[3]) * sizeof(float);
+    for (;;)
+    {
+        BOOST_REQUIRE(pos + 2 * sizeof(int) <= data.size());
+        memcpy(&periods, &data[pos], sizeof(int));
+        memcpy(&n, &data[pos + sizeof(int)], sizeof(int));
+        if ( n == LIDRPT_MAGIC && periods == (int)run.dates.size() ) break;
+        BOOST_REQUIRE(pos + recordSize <= data.size());
+        memcpy(&date, &data[pos], sizeof(double));
+        pos += sizeof(double);
+        datetime_getTimeStamp(M_D_Y, date, 24, stamp);
+        run.dates.push_back(trim(stamp));
+        run.values.push_back(vector<double>());
+        for (int i = 0; i <= k[3]; i++)
+        {
+            memcpy(&x, &data[pos], sizeof(float));
+            pos += sizeof(float);
+            run.values.back().push_back(x);
+        }
+    }
+    pos += 2 * sizeof(int);
+}
+
+// Runs a model from start to end
+static void runModel()
+{
+    int    error;
+    double elapsedTime = 0.0;
+
+    BOOST_REQUIRE(swmm_start(0) == ERR_NONE);
+    do
+    {
+        error = swmm_step(&elapsedTime);
+    } while (elapsedTime != 0 && !error);
+    BOOST_REQUIRE(error == ERR_NONE);
+    BOOST_REQUIRE(swmm_end() == ERR_NONE);
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_lid_rpt)
+
+// A binary LID report file holds the same results as a text one
+BOOST_AUTO_TEST_CASE(binary_matches_text){
+    string textRpt = getTempName();
+    string binaryRpt = getTempName();
+    string textInp = writeLidModel(textRpt, false);
+    string binaryInp = writeLidModel(binaryRpt, true);
+    string rpt = getTempName();
+    string out = getTempName();
+    LidRptRun text, binary;
+    size_t pos = 0;
+
+    BOOST_REQUIRE(swmm_run((char *)textInp.c_str(), (char *)rpt.c_str(),
+                           (char *)out.c_str()) == ERR_NONE);
+    BOOST_REQUIRE(swmm_run((char *)binaryInp.c_str(), (char *)rpt.c_str(),
+                           (char *)out.c_str()) == ERR_NONE);
+    readTextRpt(readFileContents(textRpt), text);
+    string data = readFileContents(binaryRpt);
+    readBinaryRpt(data, pos, binary);
+    BOOST_CHECK_EQUAL(pos, data.size());
+
+    BOOST_REQUIRE(text.dates.size() > 2);
+    BOOST_REQUIRE_EQUAL(binary.dates.size(), text.dates.size());
+    for (size_t i = 0; i < text.dates.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(binary.dates[i], text.dates[i]);
+        BOOST_REQUIRE_EQUAL(binary.values[i].size(), text.values[i].size());
+        for (size_t j = 0; j < text.values[i].size(); j++)
+            BOOST_CHECK_SMALL(binary.values[i][j] - text.values[i][j],
+                              RPT_TOL(text.values[i][j]));
+    }
+
+    remove(textRpt.c_str());
+    remove(binaryRpt.c_str());
+    remove(textInp.c_str());
+    remove(binaryInp.c_str());
+    remove(rpt.c_str());
+    remove(out.c_str());
+}
+
+// Each run made while a project is open writes all of its results
+BOOST_AUTO_TEST_CASE(results_of_each_run){
+    string binaryRpt = getTempName();
+    string binaryInp = writeLidModel(binaryRpt, true);
+    string rpt = getTempName();
+    string out = getTempName();
+    LidRptRun run1, run2;
+    size_t pos = 0;
+
+    BOOST_REQUIRE(swmm_open((char *)binaryInp.c_str(), (char *)rpt.c_str(),
+                            (char *)out.c_str()) == ERR_NONE);
+    runModel();
+    runModel();
+    swmm_close();
+
+    string data = readFileContents(binaryRpt);
+    readBinaryRpt(data, pos, run1);
+    readBinaryRpt(data, pos, run2);
+    BOOST_CHECK_EQUAL(pos, data.size());
+    BOOST_REQUIRE(run1.dates.size() > 2);
+    BOOST_CHECK(run1.dates == run2.dates);
+    BOOST_CHECK(run1.values == run2.values);
+
+    remove(binaryRpt.c_str());
+    remove(binaryInp.c_str());
+    remove(rpt.c_str());
+    remove(out.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_output.cpp
+ Description:  tests for the solver's binary output file functions
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+
+extern float* NodeResults;             // Results vectors defined in output.c
+extern float* LinkResults;             //  "
+}
+
+#include "test_solver.hpp"
+
+// NOTE: File offsets must be 8 byte / 64 bit integers for large file support
+#ifdef _MSC_VER
+  #define F_OFF __int64
+  #define FSEEK64 _fseeki64
+  #define FTELL64 _ftelli64
+#else
+  #define F_OFF off_t
+  #define FSEEK64 fseeko
+  #define FTELL64 ftello
+#endif
+
+#define ERR_NONE 0
+
+
+// Results of one run of the example model read back from its output file
+struct SavedResults {
+    std::vector<DateTime> dates;
+    std::vector<float>    nodeDepths;
+    std::vector<float>    linkFlows;
+};
+
+// Reads the date, a node's depth and a link's flow at each period saved
+// before the hole (if any) and each period written after it.
+static void readResults(int nSaved, int skip, int node, int link,
+    SavedResults& results)
+{
+    int      period;
+    DateTime date;
+
+    for (int i = 1; i <= nSaved; i++)
+    {
+        period = (i == 1) ? 1 : i + skip;
+        output_readDateTime(period, &date);
+        results.dates.push_back(date);
+        output_readNodeResults(period, node);
+        results.nodeDepths.push_back(NodeResults[NODE_DEPTH]);
+        output_readLinkResults(period, link);
+        results.linkFlows.push_back(LinkResults[LINK_FLOW]);
+    }
+}
+
+// Runs the example model saving its results to a temporary output file.
+// With a hole the file position is moved ahead by enough periods after the
+// first period is saved that later periods are written beyond 2^31 bytes,
+// while only the periods actually written occupy disk space.
+static void runModel(bool hole, SavedResults& results, F_OFF* lastPos)
+{
+    int    error, node, link, nSaved;
+    int    skip = 0;
+    double elapsedTime = 0.0;
+    F_OFF  startPos, bytesPerPeriod = 0;
+    char   outFile[MAXFNAME+1];
+
+    BOOST_REQUIRE(getTempFileName(outFile) != NULL);
+    error = swmm_open((char *)DATA_PATH_INP, (char *)DATA_PATH_RPT, outFile);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_start(1);
+    BOOST_REQUIRE(error == ERR_NONE);
+    startPos = FTELL64(Fout.file);
+
+    do
+    {
+        error = swmm_step(&elapsedTime);
+        if ( Nperiods == 1 && bytesPerPeriod == 0 )
+        {
+            bytesPerPeriod = FTELL64(Fout.file) - startPos;
+            if ( hole )
+            {
+                skip = (int)(((F_OFF)1 << 31) / bytesPerPeriod) + 1;
+                BOOST_REQUIRE(FSEEK64(Fout.file, skip * bytesPerPeriod,
+                              SEEK_CUR) == 0);
+                Nperiods += skip;
+            }
+        }
+    } while (elapsedTime != 0 && !error);
+    BOOST_REQUIRE(error == ERR_NONE);
+    *lastPos = FTELL64(Fout.file);
+
+    // --- results can extend past 2 GB without a file size error
+    output_checkFileSize();
+    BOOST_REQUIRE(ErrorCode == ERR_NONE);
+    BOOST_REQUIRE(swmm_end() == ERR_NONE);
+
+    nSaved = Nperiods - skip;
+    error = swmm_getObjectIndex(SM_NODE, (char *)"18", &node);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_getObjectIndex(SM_LINK, (char *)"15", &link);
+    BOOST_REQUIRE(error == ERR_NONE);
+    readResults(nSaved, skip, node, link, results);
+
+    swmm_close();
+    remove(outFile);
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_output_large)
+
+// Results written and read back beyond 2^31 bytes match those of a file
+// without the hole
+BOOST_AUTO_TEST_CASE(results_past_2GB){
+    SavedResults ref, large;
+    F_OFF refPos, largePos;
+
+    runModel(false, ref, &refPos);
+    BOOST_REQUIRE(ref.dates.size() > 2);
+    BOOST_REQUIRE(*std::max_element(ref.linkFlows.begin(),
+                                    ref.linkFlows.end()) > 0.0f);
+    runModel(true, large, &largePos);
+    BOOST_REQUIRE(largePos > ((F_OFF)1 << 31));
+
+    BOOST_REQUIRE_EQUAL(large.dates.size(), ref.dates.size());
+    for (size_t i = 0; i < ref.dates.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(large.dates[i], ref.dates[i]);
+        BOOST_CHECK_EQUAL(large.nodeDepths[i], ref.nodeDepths[i]);
+        BOOST_CHECK_EQUAL(large.linkFlows[i], ref.linkFlows[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,301 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_rain.cpp
+ Description:  tests for reading rainfall data files
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+}
+
+#include "test_solver.hpp"
+
+
+// Number of days of hourly rainfall in the test rain file
+#define RAIN_DAYS 40
+
+// Hour of the rain file at which the later of two runs starts
+#define MID_HOUR (19 * 24)
+
+// Time between checks of a gage's rainfall (days)
+#define CHECK_STEP (5.0 / 1440.0)
+
+
+// Lines of rainfall data read with each format used by rain.c
+struct ScanCase {
+    const char* format;
+    const char* lines[16];
+};
+
+static const ScanCase ScanCases[] = {
+    {"%4d%2d%4d%3d",
+        {"20200101   1", "  2020 3  15  7", "-123+4567890", "2020", "",
+         "   ", "12345678901234", "20x0", "+-12", "99999999999999999999",
+         NULL}},
+    {"%6ld%c",
+        {"   123A", "123456789", "-12345X", "+", "", "   ", "      ",
+         "12 ", "0000001", "-", "+0", NULL}},
+    {"%f %c",
+        {"1.5 T", "1e5 M", "1e M", "1.e+ A", "2E- B", ".e5 C", "-3.25e-2",
+         "  ", "", "abc", "+.5X", "1.5e5.3 Q", "0.25", "-.75e+1 ]", NULL}},
+    {"%ld %c",
+        {"42 A", "-7", "", " x", NULL}},
+    {" %2d%2d %6ld %c %c",
+        {" 0100    12 A B", "1230 5", " 0930 -000001 ] ", "", NULL}},
+    {",%2d%2d,%6ld,%c,%c",
+        {",0100,000012,A,B", ",0100,", ";0100", "", NULL}},
+    {" %2d:%2d",
+        {" 12:30", "1:5", "12-30", "", NULL}},
+    {"%7ld%3d%2d%2d%3d",
+        {"1234567120 1 1001", "123456", "", NULL}},
+    {"%s %d %d %d %d %d %f",
+        {"STA01 2020 1 1 0 0 0.1", "STA01 2020 1 1", "  ", "",
+         "STA01\t2020\t12\t31\t23\t45\t1e", NULL}},
+};
+
+
+// Checks that rain_scanLine reads a line with a format the same way that
+// sscanf does, in its return value and in every field it assigns
+static void checkScan(const char* format, const char* line)
+{
+    char   s[MAXLINE+1], token1[MAXLINE+1], token2[MAXLINE+1];
+    char   c1[2], c2[2];
+    int    d1[6], d2[6];
+    long   l1, l2;
+    float  x1, x2;
+    int    n1, n2;
+
+    BOOST_TEST_CONTEXT("format \"" << format << "\", line \"" << line << "\"")
+    {
+        strcpy(s, line);
+        memset(c1, '?', sizeof(c1));
+        memset(c2, '?', sizeof(c2));
+        for (int i = 0; i < 6; i++) d1[i] = d2[i] = -999;
+        l1 = l2 = -999;
+        x1 = x2 = -999.0f;
+        strcpy(token1, "?");
+        strcpy(token2, "?");
+
+        if ( strcmp(format, "%4d%2d%4d%3d") == 0 )
+        {
+            n1 = sscanf(s, format, &d1[0], &d1[1], &d1[2], &d1[3]);
+            n2 = rain_scanLine(s, format, &d2[0], &d2[1], &d2[2], &d2[3]);
+        }
+        else if ( strcmp(format, "%6ld%c") == 0 )
+        {
+            n1 = sscanf(s, format, &l1, &c1[0]);
+            n2 = rain_scanLine(s, format, &l2, &c2[0]);
+        }
+        else if ( strcmp(format, "%f %c") == 0 )
+        {
+            n1 = sscanf(s, format, &x1, &c1[0]);
+            n2 = rain_scanLine(s, format, &x2, &c2[0]);
+        }
+        else if ( strcmp(format, "%ld %c") == 0 )
+        {
+            n1 = sscanf(s, format, &l1, &c1[0]);
+            n2 = rain_scanLine(s, format, &l2, &c2[0]);
+        }
+        else if ( strcmp(format, " %2d%2d %6ld %c %c") == 0 ||
+                  strcmp(format, ",%2d%2d,%6ld,%c,%c") == 0 )
+        {
+            n1 = sscanf(s, format, &d1[0], &d1[1], &l1, &c1[0], &c1[1]);
+            n2 = rain_scanLine(s, format, &d2[0], &d2[1], &l2, &c2[0],
+                               &c2[1]);
+        }
+        else if ( strcmp(format, " %2d:%2d") == 0 )
+        {
+            n1 = sscanf(s, format, &d1[0], &d1[1]);
+            n2 = rain_scanLine(s, format, &d2[0], &d2[1]);
+        }
+        else if ( strcmp(format, "%7ld%3d%2d%2d%3d") == 0 )
+        {
+            n1 = sscanf(s, format, &l1, &d1[0], &d1[1], &d1[2], &d1[3]);
+            n2 = rain_scanLine(s, format, &l2, &d2[0], &d2[1], &d2[2],
+                               &d2[3]);
+        }
+        else
+        {
+            n1 = sscanf(s, format, token1, &d1[0], &d1[1], &d1[2], &d1[3],
+                        &d1[4], &x1);
+            n2 = rain_scanLine(s, format, token2, &d2[0], &d2[1], &d2[2],
+                               &d2[3], &d2[4], &x2);
+        }
+
+        BOOST_CHECK_EQUAL(n2, n1);
+        for (int i = 0; i < 6; i++) BOOST_CHECK_EQUAL(d2[i], d1[i]);
+        BOOST_CHECK_EQUAL(l2, l1);
+        BOOST_CHECK_EQUAL(x2, x1);
+        BOOST_CHECK_EQUAL(c2[0], c1[0]);
+        BOOST_CHECK_EQUAL(c2[1], c1[1]);
+        BOOST_CHECK_EQUAL(std::string(token2), std::string(token1));
+    }
+}
+
+
+// Rainfall volume (in) recorded for an hour of the test rain file
+static double getHourlyRain(int h)
+{
+    if ( h == MID_HOUR || (h * 7) % 13 < 3 ) return 0.01 * (h % 5 + 1);
+    return 0.0;
+}
+
+// Writes the test rain file, with a record for every hour with rainfall
+// and for every tenth hour without it, and returns its name
+static std::string writeRainFile()
+{
+    std::string name = getTempName();
+    std::ofstream out(name.c_str());
+    DateTime t0 = datetime_encodeDate(2020, 1, 1);
+    int y, m, d, hr, mn, sec;
+
+    for (int h = 0; h < RAIN_DAYS * 24; h++)
+    {
+        if ( getHourlyRain(h) == 0.0 && h % 10 != 0 ) continue;
+        datetime_decodeDate(t0 + h / 24.0, &y, &m, &d);
+        datetime_decodeTime(t0 + h / 24.0, &hr, &mn, &sec);
+        out << "STA01 " << y << " " << m << " " << d << " " << hr << " "
+            << mn << " " << getHourlyRain(h) << "\n";
+    }
+    return name;
+}
+
+// Writes a model whose only gage reads the test rain file and whose
+// simulation starts at a given time
+static std::string writeRainModel(const std::string& rainFile,
+                                  const char* startDate, const char* startTime)
+{
+    std::string name = getTempName();
+    std::ofstream(name.c_str())
+        << "[OPTIONS]\n"
+        << "FLOW_ROUTING KINWAVE\n"
+        << "START_DATE " << startDate << "\n"
+        << "START_TIME " << startTime << "\n"
+        << "REPORT_START_DATE " << startDate << "\n"
+        << "REPORT_START_TIME " << startTime << "\n"
+        << "END_DATE 02/05/2020\n"
+        << "END_TIME 00:00:00\n"
+        << "WET_STEP 00:05:00\n"
+        << "DRY_STEP 01:00:00\n"
+        << "ROUTING_STEP 0:00:30\n"
+        << "REPORT_STEP 01:00:00\n"
+        << "[RAINGAGES]\n"
+        << "RG1 VOLUME 1:00 1.0 FILE \"" << rainFile << "\" STA01 IN\n"
+        << "[SUBCATCHMENTS]\n"
+        << "S1 RG1 O1 10 50 500 0.5 0\n"
+        << "[SUBAREAS]\n"
+        << "S1 0.01 0.1 0.05 0.05 25 OUTLET\n"
+        << "[INFILTRATION]\n"
+        << "S1 3.0 0.5 4 7 0\n"
+        << "[OUTFALLS]\n"
+        << "O1 0 FREE NO\n";
+    return name;
+}
+
+// Sets the state of the gage of a rain model at regular times from the
+// start to the end of its simulation and returns its rainfall at those
+// times from date t onwards
+static std::vector<double> getGageRainfall(const std::string& inp,
+                                           DateTime t)
+{
+    std::vector<double> rainfall;
+    DateTime t0 = datetime_encodeDate(2020, 1, 1);
+    DateTime tStep;
+    int      j, h;
+
+    BOOST_REQUIRE_EQUAL(swmm_open(inp.c_str(), DATA_PATH_RPT, DATA_PATH_OUT),
+                        0);
+    BOOST_REQUIRE_EQUAL(swmm_start(0), 0);
+    j = project_findObject(GAGE, (char *)"RG1");
+    BOOST_REQUIRE(j >= 0);
+
+    // --- check half way through each step so that the hour of rainfall
+    //     recorded for it is not in doubt
+    for (int k = 0; ; k++)
+    {
+        tStep = StartDateTime + (k + 0.5) * CHECK_STEP;
+        if ( tStep >= EndDateTime ) break;
+        gage_setState(j, tStep);
+        if ( tStep < t ) continue;
+        rainfall.push_back(Gage[j].rainfall);
+
+        // --- rainfall intensity (in/hr) is the hour's volume (in)
+        h = (int)floor((tStep - t0) * 24.0);
+        BOOST_CHECK_SMALL(Gage[j].rainfall - getHourlyRain(h), 1.0e-6);
+    }
+    swmm_end();
+    swmm_close();
+    return rainfall;
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_rain)
+
+// rain_scanLine reads each format used for rainfall data as sscanf does,
+// including fields with widths, signs, empty and blank lines and (with
+// glibc) exponents without digits
+BOOST_AUTO_TEST_CASE(scan_line_matches_sscanf){
+    for (size_t i = 0; i < sizeof(ScanCases) / sizeof(ScanCases[0]); i++)
+    {
+        for (int k = 0; ScanCases[i].lines[k] != NULL; k++)
+        {
+#if !defined(__GLIBC__)
+            // --- C libraries differ in how much of "1e" they consume
+            if ( strchr(ScanCases[i].format, 'f') &&
+                 strpbrk(ScanCases[i].lines[k], "eE") ) continue;
+#endif
+            checkScan(ScanCases[i].format, ScanCases[i].lines[k]);
+        }
+    }
+}
+
+// A gage whose simulation starts part way through its rain file (in an
+// hour with rainfall) has the same rainfall as one that reads the file
+// from its first record
+BOOST_AUTO_TEST_CASE(gage_start_mid_file){
+    std::string rainFile = writeRainFile();
+    std::string inpStart = writeRainModel(rainFile, "01/01/2020", "00:00:00");
+    std::string inpMid = writeRainModel(rainFile, "01/20/2020", "00:30:00");
+    DateTime tMid = datetime_encodeDate(2020, 1, 20) +
+                    datetime_encodeTime(0, 30, 0);
+
+    BOOST_REQUIRE(getHourlyRain(MID_HOUR) > 0.0);
+    std::vector<double> fromStart = getGageRainfall(inpStart, tMid);
+    std::vector<double> fromMid = getGageRainfall(inpMid, tMid);
+
+    BOOST_REQUIRE_EQUAL(fromStart.size(), fromMid.size());
+    BOOST_REQUIRE(fromMid.size() > 0);
+    BOOST_CHECK(fromMid[0] > 0.0);
+    for (size_t i = 0; i < fromStart.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(fromMid[i], fromStart[i]);
+    }
+
+    remove(inpStart.c_str());
+    remove(inpMid.c_str());
+    remove(rainFile.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,9 +15,20 @@
 
 
 #include <math.h>
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
 
 #include <boost/test/included/unit_test.hpp>
 
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+}
+
 #include "test_solver.hpp"
 
 
@@ -64,3 +75,30 @@ boost::test_tools::predicate_result check_string(std::string test, std::string r
     else
         return false;
 }
+
+// Returns a new temporary file name (with no file left behind under it)
+std::string getTempName()
+{
+    char name[MAXFNAME+1];
+    BOOST_REQUIRE(getTempFileName(name) != NULL);
+    remove(name);
+    return name;
+}
+
+// Returns the contents of a file
+std::string readFileContents(const std::string& name)
+{
+    std::ifstream in(name.c_str(), std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// Writes a copy of the example model with a [FILES] section added to it
+// to a temporary file and returns the file's name
+std::string writeExampleModel(const std::string& filesSection)
+{
+    std::string name = getTempName();
+    std::ofstream(name.c_str()) << readFileContents(DATA_PATH_INP)
+                                << "\n[FILES]\n" << filesSection << "\n";
+    return name;
+}
@@ -14,6 +14,8 @@
 #ifndef TEST_SOLVER_HPP
 #define TEST_SOLVER_HPP
 
+#include <string>
+
 #include "swmm5.h"
 #include "toolkit.h"
 
@@ -74,5 +76,10 @@ boost::test_tools::predicate_result check_cdd_double(std::vector<double>& test,
 
 boost::test_tools::predicate_result check_string(std::string test, std::string ref);
 
+// Declare shared helper functions here
+std::string getTempName();
+std::string readFileContents(const std::string& name);
+std::string writeExampleModel(const std::string& filesSection);
+
 
 #endif //TEST_SOLVER_HPP
@@ -1,28 +1,186 @@
 /*
  ******************************************************************************
  Project:      OWA SWMM
- Version:      5.1.13
+ Version:      5.1.15
  Module:       test_stats.cpp
- Description:  tests for SWMM stats access functions
+ Description:  tests for SWMM stats access functions and ranked statistics
  Authors:      see AUTHORS
  Copyright:    see AUTHORS
  License:      see LICENSE
- Last Updated: 12/21/2020
+ Last Updated: 10/17/2026
  ******************************************************************************
 */
 
+#include <stdio.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+
+extern TNodeStats* NodeStats;           // defined in stats.c
+extern TLinkStats* LinkStats;           // defined in stats.c
+}
+
 #include "test_solver.hpp"
 
 #define ERR_NONE 0
 #define ERR_API_MEMORY 512
 #define ERR_API_WRONG_TYPE 504
 
+#define DATA_PATH_DYNWAVE "test_ex1_metric_dynwave.inp"
+
+// Number of elements listed in ranked tables when STATISTICS_TOP_N is used
+#define TOP_N 3
+
 using namespace std;
 
 
+// An element with its ranked statistic
+struct RankedElement {
+    string name;
+    double value;
+};
+
+// Ranks elements from highest to lowest value, keeping elements with
+// equal values in the order they are given
+static vector<string> rankNames(vector<RankedElement> elements, size_t n)
+{
+    vector<string> names;
+
+    stable_sort(elements.begin(), elements.end(),
+        [](const RankedElement& a, const RankedElement& b)
+        { return a.value > b.value; });
+    for (size_t i = 0; i < elements.size() && i < n; i++)
+        names.push_back(elements[i].name);
+    return names;
+}
+
+// Expected contents of the ranked tables of a run
+struct RankedRun {
+    string         report;         // contents of the run's report file
+    vector<string> nodeIds;        // all node IDs in index order
+    vector<string> depthRanks;     // node IDs ranked by maximum depth
+};
+
+// Gives the nodes and links of the dynamic wave model statistics with
+// known ties, in place of those found by its simulation
+static void setRankedStats(RankedRun& run)
+{
+    vector<RankedElement> depths;
+    double pct;
+
+    // --- maximum depths with many ties between nodes
+    for (int j = 0; j < Nobjects[NODE]; j++)
+    {
+        NodeStats[j].maxDepth = 0.25 * ((j * 7) % 5);
+        run.nodeIds.push_back(Node[j].ID);
+        depths.push_back({Node[j].ID, NodeStats[j].maxDepth});
+    }
+
+    // --- percent of time steps Courant critical, with nodes tied with
+    //     a link of lower index and some elements not above 1 percent
+    //     (this ranks them as Link 11, Node 10, Node 17, Link 1)
+    for (int j = 0; j < Nobjects[NODE]; j++)
+    {
+        pct = (j == 1 || j == 6) ? 3.0 : (j == 3 || j == 8) ? 0.9 : 0.0;
+        NodeStats[j].timeCourantCritical = pct / 100.0 * StepCount;
+    }
+    for (int j = 0; j < Nobjects[LINK]; j++)
+    {
+        pct = (j == 7) ? 4.0 : (j == 0) ? 3.0 : (j == 2) ? 0.9 : 0.0;
+        LinkStats[j].timeCourantCritical = pct / 100.0 * StepCount;
+    }
+
+    run.depthRanks = rankNames(depths,
+                               StatsTopN > 0 ? StatsTopN : depths.size());
+}
+
+// Runs the dynamic wave model with a given STATISTICS_TOP_N option, giving
+// its elements known statistics before its report is written
+static RankedRun runRankedModel(int topN)
+{
+    RankedRun run;
+    string inp = getTempName();
+    string rpt = getTempName();
+    double elapsedTime = 0.0;
+    int    error;
+
+    ofstream(inp.c_str()) << readFileContents(DATA_PATH_DYNWAVE)
+        << "\n[OPTIONS]\nSTATISTICS_TOP_N " << topN << "\n";
+    BOOST_REQUIRE_EQUAL(swmm_open(inp.c_str(), rpt.c_str(), DATA_PATH_OUT), 0);
+    BOOST_REQUIRE_EQUAL(swmm_start(0), 0);
+    do
+    {
+        error = swmm_step(&elapsedTime);
+    } while ( elapsedTime != 0 && !error );
+    BOOST_REQUIRE_EQUAL(error, 0);
+    BOOST_REQUIRE(StepCount > 0);
+    BOOST_REQUIRE(Nobjects[LINK] > 7);
+
+    setRankedStats(run);
+    swmm_end();
+    swmm_close();
+    run.report = readFileContents(rpt.c_str());
+    remove(inp.c_str());
+    remove(rpt.c_str());
+    return run;
+}
+
+// Reads the element IDs listed in a summary table of a report and whether
+// the table notes that only its highest ranked elements are listed
+static vector<string> readTableIds(const string& report, const char* title,
+                                   bool* hasRankNote)
+{
+    vector<string> ids;
+    istringstream in(report);
+    string line, id;
+    int    nDashLines = 0;
+
+    *hasRankNote = false;
+    while ( getline(in, line) && line.find(title) == string::npos ) {}
+
+    // --- rows follow the second dashed line of the table's heading
+    while ( getline(in, line) )
+    {
+        if ( line.find("Only the") != string::npos ) *hasRankNote = true;
+        if ( line.find("  ----") == 0 && ++nDashLines == 2 ) break;
+    }
+    while ( getline(in, line) && istringstream(line) >> id )
+        ids.push_back(id);
+    return ids;
+}
+
+// Reads the elements listed as time step critical in a report
+static vector<string> readCriticalElements(const string& report)
+{
+    vector<string> names;
+    istringstream in(report);
+    string line, type, id;
+
+    while ( getline(in, line) &&
+            line.find("Time-Step Critical Elements") == string::npos ) {}
+    getline(in, line);
+    while ( getline(in, line) && istringstream(line) >> type >> id )
+    {
+        if ( type != "Node" && type != "Link" ) break;
+        names.push_back(type + " " + id);
+    }
+    return names;
+}
+
+
 BOOST_AUTO_TEST_SUITE(test_toolkit_stats)
 
 
@@ -195,3 +353,48 @@ BOOST_FIXTURE_TEST_CASE(get_runoff_totals, FixtureBeforeEnd){
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+
+// Summary tables and critical element lists of the top N elements, and of
+// all elements by default, are listed in the expected order
+BOOST_AUTO_TEST_SUITE(test_ranked_stats)
+
+// With STATISTICS_TOP_N a table lists only the N elements with the highest
+// values, from highest to lowest with ties going to the lower index, and the
+// critical elements are the N above 1 percent with ties going to nodes
+BOOST_AUTO_TEST_CASE(top_n_tables){
+    RankedRun run = runRankedModel(TOP_N);
+    bool hasRankNote;
+
+    vector<string> ids = readTableIds(run.report, "Node Depth Summary",
+                                      &hasRankNote);
+    BOOST_CHECK(hasRankNote);
+    BOOST_REQUIRE_EQUAL(run.depthRanks.size(), (size_t)TOP_N);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(),
+        run.depthRanks.begin(), run.depthRanks.end());
+
+    vector<string> names = readCriticalElements(run.report);
+    vector<string> expected = {"Link 11", "Node 10", "Node 17"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(),
+        expected.begin(), expected.end());
+}
+
+// By default a table lists all elements in index order and the critical
+// element lists hold all entries above 1 percent (up to 5)
+BOOST_AUTO_TEST_CASE(default_tables){
+    RankedRun run = runRankedModel(0);
+    bool hasRankNote;
+
+    vector<string> ids = readTableIds(run.report, "Node Depth Summary",
+                                      &hasRankNote);
+    BOOST_CHECK(!hasRankNote);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(),
+        run.nodeIds.begin(), run.nodeIds.end());
+
+    vector<string> names = readCriticalElements(run.report);
+    vector<string> expected = {"Link 11", "Node 10", "Node 17", "Link 1"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(),
+        expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,10 @@
  */
 
 
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
+
 #include <boost/test/unit_test.hpp>
 
 #include "test_solver.hpp"
@@ -22,6 +26,9 @@
 #define ERR_API_SIM_NRUNNING 503
 #define ERR_API_WRONG_TYPE 504
 #define ERR_API_OBJECT_INDEX 505
+#define ERR_API_TSERIES_INDEX 508
+#define ERR_ROUTING_FILE_OPEN 351
+#define ERR_HOTSTART_FILE_READ 335
 
 using namespace std;
 
@@ -103,6 +110,106 @@ BOOST_AUTO_TEST_CASE(model_not_open) {
     BOOST_CHECK_EQUAL(error, ERR_API_INPUTNOTOPEN);
 }
 
+// Test Routing Interface File Conversion
+BOOST_AUTO_TEST_CASE(convert_iface_file) {
+    int error;
+    string text = "SWMM5 Interface File\n"
+        "Example 1\n"
+        "300  - reporting time step in sec\n"
+        "2    - number of constituents as listed below:\n"
+        "FLOW CFS\n"
+        "TSS MG/L\n"
+        "2    - number of nodes as listed below:\n"
+        "18\n"
+        "20\n"
+        "Node             Year Mon Day Hr  Min Sec FLOW       TSS       \n"
+        "18               1998 01  01  00  00  00  0.000000   0.000000  \n"
+        "20               1998 01  01  00  00  00  1.250000   12.500000 \n"
+        "18               1998 01  01  00  05  00  3.141593   0.001000  \n"
+        "20               1998 01  01  00  05  00  2.500000   25.000000 ";
+
+    string textFile = getTempName();
+    string binaryFile = getTempName();
+    string textFile2 = getTempName();
+    ofstream(textFile.c_str()) << text;
+
+    error = swmm_convertIfaceFile(textFile.c_str(), binaryFile.c_str());
+    BOOST_CHECK(error == ERR_NONE);
+    error = swmm_convertIfaceFile(binaryFile.c_str(), textFile2.c_str());
+    BOOST_CHECK(error == ERR_NONE);
+    BOOST_CHECK_EQUAL(readFileContents(textFile2), text);
+
+    remove(textFile.c_str());
+    remove(binaryFile.c_str());
+    remove(textFile2.c_str());
+
+    error = swmm_convertIfaceFile("no_such_file.txt", "iface3.dat");
+    BOOST_CHECK_EQUAL(error, ERR_ROUTING_FILE_OPEN);
+}
+
+// Runs the example model fed by the outflows of another run of it saved to
+// a routing interface file of a given format and returns the error code of
+// the downstream run and the contents of its binary output file
+static int runWithInflows(const string& saveLine, const string& useLine,
+    bool deletePipes, string& output)
+{
+    int    error;
+    string up = writeExampleModel(saveLine);
+    string down = writeExampleModel(useLine);
+    string rpt = getTempName();
+    string out = getTempName();
+
+    error = swmm_run((char *)up.c_str(), (char *)rpt.c_str(),
+                     (char *)out.c_str());
+    if ( !error )
+    {
+        if ( deletePipes ) swmm_deleteIfacePipes();
+        error = swmm_run((char *)down.c_str(), (char *)rpt.c_str(),
+                         (char *)out.c_str());
+        output = readFileContents(out);
+    }
+    remove(up.c_str());
+    remove(down.c_str());
+    remove(rpt.c_str());
+    remove(out.c_str());
+    return error;
+}
+
+// Test Routing Interface Files Saved in Binary and Pipe Formats
+BOOST_AUTO_TEST_CASE(binary_and_pipe_iface_files) {
+    int error;
+    string name = getTempName();
+    string noInflows, binary, pipe, pipe2;
+
+    error = runWithInflows("", "", false, noInflows);
+    BOOST_REQUIRE(error == ERR_NONE);
+
+    // --- a binary file's format is detected when it is used
+    error = runWithInflows("SAVE OUTFLOWS " + name + " BINARY",
+                           "USE INFLOWS " + name, false, binary);
+    BOOST_REQUIRE(error == ERR_NONE);
+    BOOST_CHECK(binary != noInflows);
+    remove(name.c_str());
+
+    // --- a pipe carries the same data as a binary file
+    error = runWithInflows("SAVE OUTFLOWS " + name + " PIPE",
+                           "USE INFLOWS " + name + " PIPE", false, pipe);
+    BOOST_REQUIRE(error == ERR_NONE);
+    BOOST_CHECK(pipe == binary);
+
+    // --- the pipe was freed once read
+    string down = writeExampleModel("USE INFLOWS " + name + " PIPE");
+    error = swmm_run((char *)down.c_str(), (char *)DATA_PATH_RPT,
+                     (char *)DATA_PATH_OUT);
+    BOOST_CHECK_EQUAL(error, ERR_ROUTING_FILE_OPEN);
+    remove(down.c_str());
+
+    // --- a pipe no run has read is freed on request
+    error = runWithInflows("SAVE OUTFLOWS " + name + " PIPE",
+                           "USE INFLOWS " + name + " PIPE", true, pipe2);
+    BOOST_CHECK_EQUAL(error, ERR_ROUTING_FILE_OPEN);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -973,4 +1080,80 @@ BOOST_FIXTURE_TEST_CASE(get_result_during_sim, FixtureBeforeStep){
 //     swmm_freeMemory(subc_stats);
 // }
 
+// Testing a warm restart from a state saved in memory
+BOOST_FIXTURE_TEST_CASE(save_restore_state, FixtureOpenClose) {
+    int error, ts_ind, node_ind;
+    int year, month, day, hour, minute, second;
+    double elapsedTime = 0.0;
+    double depth, saved_depth = 0.0;
+    double dates[] = {35796.0, 35796.5};
+    double values[] = {0.0, 0.0};
+    char ts_id[] = "TS1";
+    char node_id[] = "18";
+
+    error = swmm_getObjectIndex(SM_TSERIES, ts_id, &ts_ind);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_getObjectIndex(SM_NODE, node_id, &node_ind);
+    BOOST_REQUIRE(error == ERR_NONE);
+
+    // Nothing to restore yet and no run to save
+    error = swmm_restoreState();
+    BOOST_CHECK_EQUAL(error, ERR_HOTSTART_FILE_READ);
+    error = swmm_saveState();
+    BOOST_CHECK_EQUAL(error, ERR_API_SIM_NRUNNING);
+
+    // Bad time series data
+    error = swmm_replaceTimeseries(-1, 2, dates, values);
+    BOOST_CHECK_EQUAL(error, ERR_API_TSERIES_INDEX);
+    error = swmm_replaceTimeseries(ts_ind, 0, dates, values);
+    BOOST_CHECK_EQUAL(error, ERR_API_OUTBOUNDS);
+
+    // Save the state six hours into the run
+    error = swmm_start(0);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_replaceTimeseries(ts_ind, 2, dates, values);
+    BOOST_CHECK_EQUAL(error, ERR_API_SIM_NRUNNING);
+    do
+    {
+        error = swmm_step(&elapsedTime);
+        BOOST_REQUIRE(error == ERR_NONE);
+        if (saved_depth == 0.0 && elapsedTime >= 0.25)
+        {
+            error = swmm_saveState();
+            BOOST_REQUIRE(error == ERR_NONE);
+            error = swmm_getCurrentDateTime(&year, &month, &day, &hour,
+                &minute, &second);
+            BOOST_REQUIRE(error == ERR_NONE);
+            error = swmm_getNodeResult(node_ind, SM_NODEDEPTH, &saved_depth);
+            BOOST_REQUIRE(error == ERR_NONE);
+        }
+    }while (elapsedTime != 0 && !error);
+    swmm_end();
+    BOOST_REQUIRE(saved_depth > 0.0);
+
+    // Without rainfall the second run starts where the first was saved
+    error = swmm_replaceTimeseries(ts_ind, 2, dates, values);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_restoreState();
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_setSimulationDateTime(SM_STARTDATE, year, month, day, hour,
+        minute, second);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_start(0);
+    BOOST_REQUIRE(error == ERR_NONE);
+
+    error = swmm_getNodeResult(node_ind, SM_NODEDEPTH, &depth);
+    BOOST_REQUIRE(error == ERR_NONE);
+    BOOST_CHECK_SMALL(depth - saved_depth, 0.0001);
+    swmm_end();
+
+    // The saved state is used by only one run
+    error = swmm_start(0);
+    BOOST_REQUIRE(error == ERR_NONE);
+    error = swmm_getNodeResult(node_ind, SM_NODEDEPTH, &depth);
+    BOOST_REQUIRE(error == ERR_NONE);
+    BOOST_CHECK_SMALL(depth, 0.0001);
+    swmm_end();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,299 @@
+/*
+ ******************************************************************************
+ Project:      OWA SWMM
+ Version:      5.1.15
+ Module:       test_xsect.cpp
+ Description:  tests for cross section geometry tables
+ Authors:      see AUTHORS
+ Copyright:    see AUTHORS
+ License:      see LICENSE
+ Last Updated: 10/17/2026
+ ******************************************************************************
+*/
+
+#include <math.h>
+
+#include <boost/test/unit_test.hpp>
+
+extern "C" {
+#include "consts.h"
+#include "enums.h"
+#include "datetime.h"
+#include "objects.h"
+#include "funcs.h"
+#define EXTERN extern
+#include "globals.h"
+}
+
+#include "test_solver.hpp"
+
+
+// Number of points at which each table is compared with root finding
+#define N_POINTS 1000
+
+// Allowed difference between table lookups and the original root finding
+// methods: a fraction of full area for area and a depth (ft) for critical
+// depth (twice the tolerance used by the Ridder root finder).
+#define AREA_TOL  0.001
+#define YCRIT_TOL 0.002
+
+#define DATA_PATH_GEOM "test_geom.inp"
+
+// Allowed errors of geometry found from the irregular and custom shape
+// tables: area and width vary exactly like those of the trapezoidal test
+// channels between entries while hyd. radius is interpolated to within
+// 0.1 percent of its full value.
+#define GEOM_TOL  1.0e-6
+#define HRAD_TOL  0.002
+
+
+struct ShapeParams {
+    int    type;
+    double p[4];
+};
+
+// Shapes whose inverse functions have no closed form or tabulated inverse
+static const ShapeParams Shapes[] = {
+    {RECT_CLOSED,     {2.0, 3.0,  0.0, 0.0}},
+    {RECT_OPEN,       {2.0, 3.0,  0.0, 0.0}},
+    {TRAPEZOIDAL,     {2.0, 3.0,  1.0, 1.0}},
+    {TRAPEZOIDAL,     {1.0, 10.0, 2.0, 2.0}},
+    {TRIANGULAR,      {2.0, 4.0,  0.0, 0.0}},
+    {PARABOLIC,       {2.0, 4.0,  0.0, 0.0}},
+    {POWERFUNC,       {2.0, 4.0,  3.0, 0.0}},
+    {RECT_TRIANG,     {1.0, 8.0,  0.2, 0.0}},
+    {RECT_ROUND,      {1.0, 8.0,  5.0, 0.0}},
+    {MOD_BASKET,      {2.0, 3.0,  1.5, 0.0}},
+    {FILLED_CIRCULAR, {2.0, 1.2,  0.0, 0.0}}
+};
+
+#define N_SHAPES (int)(sizeof(Shapes) / sizeof(Shapes[0]))
+
+
+// Sets up a cross section with its tables and a copy of it without them
+// so that lookups fall back to root finding.
+static void setXsects(const ShapeParams& shape, TXsect* xTbl, TXsect* xIter)
+{
+    double p[4];
+    for (int i = 0; i < 4; i++) p[i] = shape.p[i];
+    BOOST_REQUIRE(xsect_setParams(xTbl, shape.type, p, 1.0));
+    *xIter = *xTbl;
+    xIter->aOfS = NULL;
+    xIter->yCrit = NULL;
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_xsect)
+
+// Area at a section factor up to its full value
+BOOST_AUTO_TEST_CASE(area_of_section_factor){
+    TXsect xTbl, xIter;
+    double s, a1, a2;
+
+    for (int k = 0; k < N_SHAPES; k++)
+    {
+        setXsects(Shapes[k], &xTbl, &xIter);
+        BOOST_REQUIRE(xTbl.aOfS != NULL);
+        for (int i = 1; i < N_POINTS; i++)
+        {
+            s = xTbl.sFull * (double)i / (double)N_POINTS;
+            a1 = xsect_getAofS(&xTbl, s);
+            a2 = xsect_getAofS(&xIter, s);
+            BOOST_CHECK_SMALL((a1 - a2) / xTbl.aFull, AREA_TOL);
+        }
+    }
+    xsect_deleteTables();
+}
+
+// Critical depth at flows up to 95% of the table's max. flow (above which
+// both methods approach their own limiting depths)
+BOOST_AUTO_TEST_CASE(critical_depth){
+    TXsect xTbl, xIter;
+    double q, y1, y2;
+    int nTables = 0;
+
+    for (int k = 0; k < N_SHAPES; k++)
+    {
+        setXsects(Shapes[k], &xTbl, &xIter);
+        if ( xTbl.yCrit == NULL ) continue;
+        nTables++;
+        for (int i = 1; i < N_POINTS; i++)
+        {
+            q = 0.95 * xTbl.yCrit->xMax * (double)i / (double)N_POINTS;
+            y1 = xsect_getYcrit(&xTbl, q);
+            y2 = xsect_getYcrit(&xIter, q);
+            BOOST_CHECK_SMALL(y1 - y2, YCRIT_TOL);
+        }
+    }
+    BOOST_CHECK_EQUAL(nTables, 5);
+    xsect_deleteTables();
+}
+
+// Standard shapes near the size of a circle keep using root finding
+BOOST_AUTO_TEST_CASE(no_table_for_standard_shapes){
+    TXsect x;
+    double p[4] = {2.0, 0.0, 0.0, 0.0};
+
+    BOOST_REQUIRE(xsect_setParams(&x, CIRCULAR, p, 1.0));
+    BOOST_CHECK(x.aOfS == NULL);
+    BOOST_CHECK(x.yCrit == NULL);
+    BOOST_REQUIRE(xsect_setParams(&x, EGGSHAPED, p, 1.0));
+    BOOST_CHECK(x.aOfS == NULL);
+    BOOST_CHECK(x.yCrit == NULL);
+    xsect_deleteTables();
+}
+
+// Batched section factors and derivatives equal those of xsect_getSofA and
+// xsect_getdSdA, including at the very small areas that use special forms
+BOOST_AUTO_TEST_CASE(batched_section_factor){
+    static const ShapeParams batched[] = {
+        {CIRCULAR,       {2.0, 0.0, 0.0, 0.0}},
+        {EGGSHAPED,      {2.0, 0.0, 0.0, 0.0}},
+        {HORSESHOE,      {2.0, 0.0, 0.0, 0.0}},
+        {GOTHIC,         {2.0, 0.0, 0.0, 0.0}},
+        {CATENARY,       {2.0, 0.0, 0.0, 0.0}},
+        {SEMIELLIPTICAL, {2.0, 0.0, 0.0, 0.0}},
+        {BASKETHANDLE,   {2.0, 0.0, 0.0, 0.0}},
+        {SEMICIRCULAR,   {2.0, 0.0, 0.0, 0.0}},
+        {RECT_CLOSED,    {2.0, 3.0, 0.0, 0.0}},
+        {RECT_OPEN,      {2.0, 3.0, 0.0, 0.0}},
+        {TRAPEZOIDAL,    {2.0, 3.0, 1.0, 1.0}},
+        {TRIANGULAR,     {2.0, 4.0, 0.0, 0.0}}
+    };
+    const int nShapes = (int)(sizeof(batched) / sizeof(batched[0]));
+    const int n = N_POINTS + 4;
+    TXsect  x[nShapes];
+    TXsect* xs[n];
+    double  p[4], a[n], s[n], dsda[n];
+
+    for (int k = 0; k < nShapes; k++)
+    {
+        for (int i = 0; i < 4; i++) p[i] = batched[k].p[i];
+        BOOST_REQUIRE(xsect_setParams(&x[k], batched[k].type, p, 1.0));
+        for (int i = 0; i < n; i++) xs[i] = &x[k];
+
+        // --- areas up to full plus a few very small ones
+        for (int i = 0; i <= N_POINTS; i++)
+            a[i] = x[k].aFull * (double)i / (double)N_POINTS;
+        a[N_POINTS+1] = x[k].aFull * 1.0e-6;
+        a[N_POINTS+2] = x[k].aFull * 2.0e-5;
+        a[N_POINTS+3] = x[k].aFull * 1.0e-31;
+
+        BOOST_REQUIRE(xsect_getSanddSdA(batched[k].type, xs, n, a, s, dsda));
+        for (int i = 0; i < n; i++)
+        {
+            BOOST_CHECK_EQUAL(s[i], xsect_getSofA(&x[k], a[i]));
+            BOOST_CHECK_EQUAL(dsda[i], xsect_getdSdA(&x[k], a[i]));
+        }
+    }
+
+    // --- other shapes are left to the single section functions
+    BOOST_CHECK(!xsect_getSanddSdA(PARABOLIC, xs, 0, a, s, dsda));
+    xsect_deleteTables();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+// Trapezoidal channel 2 ft deep with a 2 ft bottom width and 1:1 side slopes
+// described by an irregular transect (C1) and a closed custom shape (C2)
+struct FixtureGeom : FixtureOpenClose {
+    FixtureGeom() : FixtureOpenClose(DATA_PATH_GEOM) {}
+};
+
+static double trapArea(double y)  { return 2.0*y + y*y; }
+static double trapWidth(double y) { return 2.0 + 2.0*y; }
+static double trapPerim(double y) { return 2.0 + 2.0*sqrt(2.0)*y; }
+
+static TXsect* getXsect(const char* id)
+{
+    int index;
+    BOOST_REQUIRE(swmm_getObjectIndex(SM_LINK, (char *)id, &index) == 0);
+    return &Link[index].xsect;
+}
+
+// Relative difference between a and b
+static double relDiff(double a, double b)
+{
+    return fabs(a - b) / fabs(b);
+}
+
+BOOST_AUTO_TEST_SUITE(test_geom_tables)
+
+// Area, depth and width looked up at depths below full
+BOOST_FIXTURE_TEST_CASE(lookups, FixtureGeom){
+    const char* ids[] = {"C1", "C2"};
+    TXsect* x;
+    double y, a;
+
+    for (int k = 0; k < 2; k++)
+    {
+        x = getXsect(ids[k]);
+        BOOST_REQUIRE_CLOSE(x->yFull, 2.0, 1.0e-6);
+        for (int i = 1; i < 100; i++)
+        {
+            y = x->yFull * (double)i / 100.0;
+            a = trapArea(y);
+            BOOST_CHECK_SMALL(relDiff(xsect_getAofY(x, y), a), GEOM_TOL);
+            BOOST_CHECK_SMALL(relDiff(xsect_getYofA(x, a), y), GEOM_TOL);
+
+            // --- a transect's width is held at its value at 4% of full
+            //     depth below that depth
+            if ( i > 4 ) BOOST_CHECK_SMALL(relDiff(xsect_getWofY(x, y),
+                                           trapWidth(y)), GEOM_TOL);
+        }
+    }
+}
+
+// Hyd. radius looked up at depths below full
+BOOST_FIXTURE_TEST_CASE(hyd_radius, FixtureGeom){
+    TXsect* x;
+    double y, r;
+
+    // --- a transect's hyd. radius comes from the conveyance of its
+    //     sub-sections, so compare with its uniform table's exact entries
+    x = getXsect("C1");
+    for (int i = 1; i < N_TRANSECT_TBL; i++)
+    {
+        y = x->yFull * (double)i / (double)(N_TRANSECT_TBL-1);
+        r = Transect[x->transect].hradTbl[i] * x->rFull;
+        BOOST_CHECK_SMALL((xsect_getRofY(x, y) - r) / x->rFull, HRAD_TOL);
+    }
+
+    // --- a custom shape's hyd. radius is area over wetted perimeter
+    x = getXsect("C2");
+    for (int i = 1; i < 100; i++)
+    {
+        y = x->yFull * (double)i / 100.0;
+        r = trapArea(y) / trapPerim(y);
+        BOOST_CHECK_SMALL((xsect_getRofY(x, y) - r) / x->rFull, HRAD_TOL);
+    }
+}
+
+// Max. section factor and the area where it occurs are consistent with the
+// section factor found from the same tables used for lookups
+BOOST_FIXTURE_TEST_CASE(max_section_factor, FixtureGeom){
+    TXsect* x;
+    double y, s, sMax;
+
+    // --- open channel's section factor increases with depth
+    x = getXsect("C1");
+    BOOST_CHECK_SMALL(relDiff(x->sMax, x->sFull), GEOM_TOL);
+    BOOST_CHECK_SMALL(relDiff(xsect_getAmax(x), x->aFull), GEOM_TOL);
+
+    // --- closed channel's section factor peaks just below full depth
+    x = getXsect("C2");
+    sMax = 0.0;
+    for (int i = 1; i < 1000; i++)
+    {
+        y = x->yFull * (double)i / 1000.0;
+        s = trapArea(y) * pow(trapArea(y) / trapPerim(y), 2./3.);
+        if ( s > sMax ) sMax = s;
+    }
+    BOOST_CHECK(x->sMax > x->sFull);
+    BOOST_CHECK_SMALL(relDiff(x->sMax, sMax), HRAD_TOL);
+    BOOST_CHECK_SMALL(relDiff(xsect_getSofA(x, xsect_getAmax(x)), x->sMax),
+                      HRAD_TOL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()